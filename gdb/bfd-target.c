@@ -50,9 +50,7 @@ target_bfd_xfer_partial (struct target_ops *ops,
 	struct target_bfd_data *data = ops->to_data;
 	return section_table_xfer_memory_partial (readbuf, writebuf,
 						  offset, len,
-						  data->table.sections,
-						  data->table.sections_end,
-						  NULL);
+						  &data->table, NULL);
       }
     default:
       return -1;
@@ -72,6 +70,7 @@ target_bfd_xclose (struct target_ops *t, int quitting)
   struct target_bfd_data *data = t->to_data;
 
   bfd_close (data->bfd);
+  clear_section_table_index (&data->table);
   xfree (data->table.sections);
   xfree (data);
   xfree (t);
@@ -2752,6 +2752,50 @@ software_breakpoint_inserted_here_p (struct address_space *aspace, CORE_ADDR pc)
   return 0;
 }
 
+/* Return a user breakpoint inserted at PC that would stop the program
+   in its current state: it is enabled, and its condition, if any, is
+   true in the current frame.  Return NULL if there is none.  Unlike
+   bpstat_stop_status, this does not update hit counts or ignore
+   counts, so it can be asked again and again of a program that is
+   being re-executed.  */
+
+struct breakpoint *
+user_breakpoint_stops_here (struct address_space *aspace, CORE_ADDR pc)
+{
+  struct bp_location *bl, **blp_tmp;
+
+  ALL_BP_LOCATIONS (bl, blp_tmp)
+    {
+      struct breakpoint *b = bl->owner;
+
+      if (b->type != bp_breakpoint && b->type != bp_hardware_breakpoint)
+	continue;
+
+      if (!bl->inserted || !bl->enabled || bl->shlib_disabled
+	  || !breakpoint_enabled (b)
+	  || !breakpoint_address_match (bl->pspace->aspace, bl->address,
+					aspace, pc))
+	continue;
+
+      if (bl->cond != NULL)
+	{
+	  int value_is_zero;
+
+	  select_frame (get_current_frame ());
+	  value_is_zero
+	    = catch_errors (breakpoint_cond_eval, bl->cond,
+			    "Error in testing breakpoint condition:\n",
+			    RETURN_MASK_ALL);
+	  if (value_is_zero)
+	    continue;
+	}
+
+      return b;
+    }
+
+  return NULL;
+}
+
 int
 hardware_watchpoint_inserted_in_range (struct address_space *aspace,
 				       CORE_ADDR addr, ULONGEST len)
@@ -0,0 +1,80 @@
+/* Searching memory for a byte pattern, for GDB and gdbserver.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef GDBSERVER
+#include "server.h"
+#else
+#include "defs.h"
+#include "gdb_string.h"
+#endif
+
+#include "search-buffer.h"
+
+/* Number of bytes of the search buffer search_buffer looks at to
+   pick the byte to anchor the search on.  */
+#define SEARCH_SAMPLE_SIZE 1024
+
+/* Return the first occurrence of the PATTERN_LEN bytes at PATTERN in
+   the BUF_LEN bytes at BUF, or NULL, like memmem.  Program memory is
+   dominated by a few byte values, zero above all, so anchor the search
+   on the pattern byte that is rarest in a sample of BUF.  Candidates
+   are found with memchr, which the C library vectorizes, and checked
+   with memcmp.  If candidates turn out to be frequent, memmem takes
+   over, which bounds the worst case.  */
+
+gdb_byte *
+search_buffer (gdb_byte *buf, size_t buf_len,
+	       const gdb_byte *pattern, size_t pattern_len)
+{
+  unsigned int counts[256];
+  size_t sample_len, anchor, i, misses = 0;
+  gdb_byte *p, *end;
+
+  if (pattern_len == 0 || pattern_len > buf_len)
+    return memmem (buf, buf_len, pattern, pattern_len);
+
+  memset (counts, 0, sizeof (counts));
+  sample_len = buf_len < SEARCH_SAMPLE_SIZE ? buf_len : SEARCH_SAMPLE_SIZE;
+  for (i = 0; i < sample_len; i++)
+    counts[buf[i]]++;
+
+  anchor = 0;
+  for (i = 1; i < pattern_len; i++)
+    if (counts[pattern[i]] < counts[pattern[anchor]])
+      anchor = i;
+
+  p = buf + anchor;
+  end = buf + buf_len - pattern_len + anchor + 1;
+  while (p < end)
+    {
+      p = memchr (p, pattern[anchor], end - p);
+      if (p == NULL)
+	return NULL;
+      if (memcmp (p - anchor, pattern, pattern_len) == 0)
+	return p - anchor;
+
+      /* More than one false candidate every 64 bytes or so.  */
+      if (++misses > 16 + (p - buf) / 64)
+	return memmem (p - anchor + 1, buf + buf_len - (p - anchor + 1),
+		       pattern, pattern_len);
+      p++;
+    }
+
+  return NULL;
+}
@@ -0,0 +1,38 @@
+/* Searching memory for a byte pattern, for GDB and gdbserver.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef COMMON_SEARCH_BUFFER_H
+#define COMMON_SEARCH_BUFFER_H
+
+/* Memory is searched in chunks of this many bytes at first.
+   NOTE: also defined in find.c testcase.  */
+#define SEARCH_CHUNK_SIZE 16000
+
+/* The chunk size doubles, up to this, for as long as nothing is
+   found, so that long searches read memory in large blocks while
+   short ones don't read much past what they need.  */
+#define SEARCH_MAX_CHUNK_SIZE (1024 * 1024)
+
+/* Return the first occurrence of the PATTERN_LEN bytes at PATTERN in
+   the BUF_LEN bytes at BUF, or NULL, like memmem.  */
+
+extern gdb_byte *search_buffer (gdb_byte *buf, size_t buf_len,
+				const gdb_byte *pattern, size_t pattern_len);
+
+#endif /* COMMON_SEARCH_BUFFER_H */
@@ -47,6 +47,9 @@
 #include "filenames.h"
 #include "progspace.h"
 #include "objfiles.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 
 #ifndef O_LARGEFILE
@@ -77,6 +80,14 @@ struct gdbarch *core_gdbarch = NULL;
    unix child targets.  */
 static struct target_section_table *core_data;
 
+/* The whole core file, mapped into GDB's address space, and its size.
+   Memory and register reads copy straight from the mapping instead of
+   going through BFD, which seeks and reads the file for every access.
+   CORE_MAP is NULL if the file could not be mapped, or may be written
+   to.  */
+static gdb_byte *core_map;
+static bfd_size_type core_map_size;
+
 /* True if we needed to fake the pid of the loaded core inferior.  */
 static int core_has_fake_pid = 0;
 
@@ -216,6 +227,14 @@ core_close (int quitting)
          comments in clear_solib in solib.c. */
       clear_solib ();
 
+#ifdef HAVE_MMAP
+      if (core_map != NULL)
+	munmap (core_map, core_map_size);
+#endif
+      core_map = NULL;
+      core_map_size = 0;
+
+      clear_section_table_index (core_data);
       xfree (core_data->sections);
       xfree (core_data);
       core_data = NULL;
@@ -236,6 +255,57 @@ core_close_cleanup (void *ignore)
   core_close (0/*ignored*/);
 }
 
+/* Map the whole of core_bfd into memory, if possible.  Failing that,
+   everything is read through BFD.  */
+
+static void
+core_map_file (void)
+{
+#ifdef HAVE_MMAP
+  bfd_size_type size;
+  void *map;
+
+  /* BFD may buffer writes we wouldn't see through the mapping.  */
+  if (write_files)
+    return;
+
+  size = bfd_get_size (core_bfd);
+  if (size == 0 || (size_t) size != size)
+    return;
+
+  map = bfd_mmap (core_bfd, 0, size, PROT_READ, MAP_PRIVATE, 0);
+  if (map == MAP_FAILED)
+    return;
+
+  core_map = map;
+  core_map_size = size;
+#endif
+}
+
+/* Read SIZE bytes at OFFSET within SECTION of core_bfd into BUF.
+   Return nonzero on success.  */
+
+static int
+core_get_section_contents (asection *section, void *buf, file_ptr offset,
+			   bfd_size_type size)
+{
+  flagword flags = bfd_get_section_flags (core_bfd, section);
+
+  if (core_map != NULL
+      && (flags & SEC_HAS_CONTENTS) != 0
+      && (flags & SEC_IN_MEMORY) == 0
+      && offset >= 0
+      && offset + size <= bfd_section_size (core_bfd, section)
+      && section->filepos >= 0
+      && section->filepos + offset + size <= core_map_size)
+    {
+      memcpy (buf, core_map + section->filepos + offset, size);
+      return 1;
+    }
+
+  return bfd_get_section_contents (core_bfd, section, buf, offset, size);
+}
+
 /* Look for sections whose names start with `.reg/' so that we can extract the
    list of threads in a core file.  */
 
@@ -376,6 +446,8 @@ core_open (char *filename, int from_tty)
     error (_("\"%s\": Can't find sections: %s"),
 	   bfd_get_filename (core_bfd), bfd_errmsg (bfd_get_error ()));
 
+  core_map_file ();
+
   /* If we have no exec file, try to set the architecture from the
      core file.  We don't do this unconditionally since an exec file
      typically contains more information that helps us determine the
@@ -549,8 +621,7 @@ get_core_register_section (struct regcache *regcache,
 
   size = bfd_section_size (core_bfd, section);
   contents = alloca (size);
-  if (! bfd_get_section_contents (core_bfd, section, contents,
-				  (file_ptr) 0, size))
+  if (! core_get_section_contents (section, contents, (file_ptr) 0, size))
     {
       warning (_("Couldn't read %s registers from `%s' section in core file."),
 	       human_name, name);
@@ -677,11 +748,25 @@ core_xfer_partial (struct target_ops *ops, enum target_object object,
   switch (object)
     {
     case TARGET_OBJECT_MEMORY:
+      if (readbuf != NULL && core_map != NULL)
+	{
+	  struct target_section *p;
+
+	  /* Find the load segment through the section table's address
+	     index, and copy from the mapping.  */
+	  p = section_table_lookup (core_data, offset, NULL);
+	  if (p == NULL)
+	    return 0;
+	  if (offset + len > p->endaddr)
+	    len = p->endaddr - offset;
+	  if (!core_get_section_contents (p->the_bfd_section, readbuf,
+					  offset - p->addr, len))
+	    return 0;
+	  return len;
+	}
       return section_table_xfer_memory_partial (readbuf, writebuf,
 						offset, len,
-						core_data->sections,
-						core_data->sections_end,
-						NULL);
+						core_data, NULL);
 
     case TARGET_OBJECT_AUXV:
       if (readbuf)
@@ -25,6 +25,7 @@
 #include "gdbcore.h"
 #include "target.h"
 #include "inferior.h"
+#include "memattr.h"
 #include "splay-tree.h"
 
 /* The data cache could lead to incorrect results because it doesn't
@@ -36,23 +37,27 @@
    comes from the actual caching mechanism, but the major gain is in
    the reduction of the remote protocol overhead; instead of reading
    or writing a large area of memory in 4 byte requests, the cache
-   bundles up the requests into LINE_SIZE chunks, reducing overhead
+   bundles up the requests into line size chunks, reducing overhead
    significantly.  This is most useful when accessing a large amount
    of data, such as when performing a backtrace.
 
    The cache is a splay tree along with a linked list for replacement.
-   Each block caches a LINE_SIZE area of memory.  Within each line we
+   Each block caches a line size area of memory.  Within each line we
    remember the address of the line (which must be a multiple of
-   LINE_SIZE) and the actual data block.
+   the line size) and the actual data block.
 
-   Lines are only allocated as needed, so DCACHE_SIZE really specifies the
-   *maximum* number of lines in the cache.
+   Lines are only allocated as needed, so the cache size really
+   specifies the *maximum* number of lines in the cache.
 
-   At present, the cache is write-through rather than writeback: as soon
-   as data is written to the cache, it is also immediately written to
-   the target.  Therefore, cache lines are never "dirty".  Whether a given
-   line is valid or not depends on where it is stored in the dcache_struct;
-   there is no per-block valid flag.  */
+   By default, the cache is write-through: as soon as data is written
+   to the cache, it is also immediately written to the target.  With
+   "set dcache write-back on", writes only go to the cache, and the
+   dirty bytes are written to the target, coalesced into as few
+   transfers as possible, by dcache_flush.  The target layer calls
+   that before resuming the inferior and before any memory access
+   that bypasses the cache.  A line allocated by a write is not read
+   from the target, so only its dirty bytes are meaningful until it
+   is read.  */
 
 /* NOTE: Interaction of dcache and memory region attributes
 
@@ -69,22 +74,25 @@
    region defined for the .text segment and a rw/non-cacheable memory
    region defined for the .data segment.  */
 
-/* The maximum number of lines stored.  The total size of the cache is
-   equal to DCACHE_SIZE times LINE_SIZE.  */
-#define DCACHE_SIZE 4096
+/* The default maximum number of lines stored.  The total size of the
+   cache is equal to the number of lines times the line size.  */
+#define DCACHE_DEFAULT_SIZE 4096
 
-/* The size of a cache line.  Smaller values reduce the time taken to
-   read a single byte and make the cache more granular, but increase
-   overhead and reduce the effectiveness of the cache as a prefetcher.  */
-#define LINE_SIZE_POWER 6
-#define LINE_SIZE (1 << LINE_SIZE_POWER)
+/* The default size of a cache line.  Smaller values reduce the time
+   taken to read a single byte and make the cache more granular, but
+   increase overhead and reduce the effectiveness of the cache as a
+   prefetcher.  */
+#define DCACHE_DEFAULT_LINE_SIZE 64
 
-/* Each cache block holds LINE_SIZE bytes of data
-   starting at a multiple-of-LINE_SIZE address.  */
+/* The largest line size accepted by "set dcache line-size".  */
+#define DCACHE_MAX_LINE_SIZE 65536
 
-#define LINE_SIZE_MASK  ((LINE_SIZE - 1))
-#define XFORM(x) 	((x) & LINE_SIZE_MASK)
-#define MASK(x)         ((x) & ~LINE_SIZE_MASK)
+/* Each cache block holds line_size bytes of data
+   starting at a multiple-of-line_size address.  */
+
+#define LINE_SIZE_MASK(dcache)  ((dcache)->line_size - 1)
+#define XFORM(dcache, x) 	((x) & LINE_SIZE_MASK (dcache))
+#define MASK(dcache, x)         ((x) & ~LINE_SIZE_MASK (dcache))
 
 struct dcache_block
 {
@@ -93,8 +101,22 @@ struct dcache_block
   struct dcache_block *next;
 
   CORE_ADDR addr;		/* address of data */
-  gdb_byte data[LINE_SIZE];	/* bytes at given address */
   int refs;			/* # hits */
+
+  /* Nonzero if DATA holds the target's memory.  A line allocated by
+     a write-back store is not valid until it has been read.  */
+  int valid;
+
+  /* Bytes [DIRTY_LO, DIRTY_HI) of DATA have not been written to the
+     target yet.  The line is clean if they are equal.  */
+  int dirty_lo;
+  int dirty_hi;
+
+  /* Nonzero if the line lies in a read-only memory region with the
+     cache attribute; it is kept when the inferior resumes.  */
+  int readonly;
+
+  gdb_byte data[1];		/* line_size bytes at given address */
 };
 
 struct dcache_struct
@@ -108,6 +130,10 @@ struct dcache_struct
 
   /* The number of in-use lines in the cache.  */
   int size;
+  CORE_ADDR line_size;  /* current line_size.  */
+
+  /* The number of dirty lines in the cache.  */
+  int ndirty;
 
   /* The ptid of last inferior to use cache or null_ptid.  */
   ptid_t ptid;
@@ -127,6 +153,12 @@ void _initialize_dcache (void);
 
 static int dcache_enabled_p = 0; /* OBSOLETE */
 
+static unsigned dcache_size = DCACHE_DEFAULT_SIZE;
+
+static unsigned dcache_line_size = DCACHE_DEFAULT_LINE_SIZE;
+
+static int dcache_write_back_p = 0;
+
 static void
 show_dcache_enabled_p (struct ui_file *file, int from_tty,
 		       struct cmd_list_element *c, const char *value)
@@ -220,7 +252,16 @@ invalidate_block (struct dcache_block *block, void *param)
   append_block (&dcache->freelist, block);
 }
 
-/* Free all the data cache blocks, thus discarding all cached data.  */
+/* BLOCK_FUNC routine for dcache_free.  */
+
+static void
+free_block (struct dcache_block *block, void *param)
+{
+  xfree (block);
+}
+
+/* Free all the data cache blocks, thus discarding all cached data,
+   including any that was not written back yet.  */
 
 void
 dcache_invalidate (DCACHE *dcache)
@@ -229,7 +270,50 @@ dcache_invalidate (DCACHE *dcache)
 
   dcache->oldest = NULL;
   dcache->size = 0;
+  dcache->ndirty = 0;
   dcache->ptid = null_ptid;
+
+  /* If the line size has changed, we must free all the blocks.  */
+  if (dcache->line_size != dcache_line_size)
+    {
+      for_each_block (&dcache->freelist, free_block, NULL);
+      dcache->freelist = NULL;
+      dcache->line_size = dcache_line_size;
+    }
+}
+
+/* BLOCK_FUNC function for dcache_invalidate_volatile.  */
+
+static void
+invalidate_volatile_block (struct dcache_block *block, void *param)
+{
+  DCACHE *dcache = (DCACHE *) param;
+
+  if (block->readonly && block->valid)
+    return;
+
+  splay_tree_remove (dcache->tree, (splay_tree_key) block->addr);
+  remove_block (&dcache->oldest, block);
+  append_block (&dcache->freelist, block);
+  dcache->size--;
+}
+
+/* Discard the cached data that the inferior may change while it
+   runs, that is everything but the lines of read-only memory
+   regions.  Dirty lines must have been flushed already.  */
+
+void
+dcache_invalidate_volatile (DCACHE *dcache)
+{
+  gdb_assert (dcache->ndirty == 0);
+
+  if (dcache->line_size != dcache_line_size)
+    {
+      dcache_invalidate (dcache);
+      return;
+    }
+
+  for_each_block (&dcache->oldest, invalidate_volatile_block, dcache);
 }
 
 /* Invalidate the line associated with ADDR.  */
@@ -241,6 +325,8 @@ dcache_invalidate_line (DCACHE *dcache, CORE_ADDR addr)
 
   if (db)
     {
+      if (db->dirty_lo != db->dirty_hi)
+	dcache->ndirty--;
       splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
       remove_block (&dcache->oldest, db);
       append_block (&dcache->freelist, db);
@@ -257,7 +343,7 @@ dcache_hit (DCACHE *dcache, CORE_ADDR addr)
   struct dcache_block *db;
 
   splay_tree_node node = splay_tree_lookup (dcache->tree,
-					    (splay_tree_key) MASK (addr));
+					    (splay_tree_key) MASK (dcache, addr));
 
   if (!node)
     return NULL;
@@ -267,24 +353,17 @@ dcache_hit (DCACHE *dcache, CORE_ADDR addr)
   return db;
 }
 
-/* Fill a cache line from target memory.
-   The result is 1 for success, 0 if the (entire) cache line
-   wasn't readable.  */
+/* Read LEN bytes of target memory at MEMADDR into MYADDR, skipping
+   write-only memory regions.  The result is 1 for success, 0 if the
+   (entire) range wasn't readable.  */
 
 static int
-dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+dcache_read_memory (CORE_ADDR memaddr, gdb_byte *myaddr, LONGEST len)
 {
-  CORE_ADDR memaddr;
-  gdb_byte *myaddr;
-  int len;
-  int res;
-  int reg_len;
+  LONGEST res;
+  LONGEST reg_len;
   struct mem_region *region;
 
-  len = LINE_SIZE;
-  memaddr = db->addr;
-  myaddr  = db->data;
-
   while (len > 0)
     {
       /* Don't overrun if this block is right at the end of the region.  */
@@ -294,9 +373,11 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
       else
 	reg_len = region->hi - memaddr;
 
-      /* Skip non-readable regions.  The cache attribute can be ignored,
-         since we may be loading this for a stack access.  */
-      if (region->attrib.mode == MEM_WO)
+      /* Skip non-readable regions, and regions that must never be
+	 cached, such as memory-mapped I/O.  The cache attribute can
+	 otherwise be ignored, since we may be loading this for a
+	 stack access.  */
+      if (region->attrib.mode == MEM_WO || region->attrib.nocache)
 	{
 	  memaddr += reg_len;
 	  myaddr  += reg_len;
@@ -317,18 +398,95 @@ dcache_read_line (DCACHE *dcache, struct dcache_block *db)
   return 1;
 }
 
+/* Fill a cache line from target memory, keeping any bytes of it that
+   were not written back yet.
+   The result is 1 for success, 0 if the (entire) cache line
+   wasn't readable.  */
+
+static int
+dcache_read_line (DCACHE *dcache, struct dcache_block *db)
+{
+  if (db->dirty_lo == db->dirty_hi)
+    {
+      if (!dcache_read_memory (db->addr, db->data, dcache->line_size))
+	return 0;
+    }
+  else
+    {
+      gdb_byte *buf = xmalloc (dcache->line_size);
+      struct cleanup *old_chain = make_cleanup (xfree, buf);
+
+      if (!dcache_read_memory (db->addr, buf, dcache->line_size))
+	{
+	  do_cleanups (old_chain);
+	  return 0;
+	}
+      memcpy (db->data, buf, db->dirty_lo);
+      memcpy (db->data + db->dirty_hi, buf + db->dirty_hi,
+	      dcache->line_size - db->dirty_hi);
+      do_cleanups (old_chain);
+    }
+
+  db->valid = 1;
+  return 1;
+}
+
+/* Write the dirty bytes of line DB back to the target.  The line is
+   clean afterwards, even if that failed.  */
+
+static void
+dcache_write_line (DCACHE *dcache, struct dcache_block *db)
+{
+  CORE_ADDR memaddr = db->addr + db->dirty_lo;
+  int len = db->dirty_hi - db->dirty_lo;
+  LONGEST res;
+
+  if (len == 0)
+    return;
+
+  db->dirty_lo = db->dirty_hi = 0;
+  dcache->ndirty--;
+
+  res = target_write (&current_target, TARGET_OBJECT_RAW_MEMORY,
+		      NULL, db->data + (memaddr - db->addr), memaddr, len);
+  if (res < len)
+    memory_error (EIO, memaddr + max (res, 0));
+}
+
+/* Return nonzero if the line at ADDR lies within a read-only memory
+   region that has the cache attribute, or within code the target lets
+   us keep.  Such lines are kept across resumes.  */
+
+static int
+dcache_readonly_line_p (DCACHE *dcache, CORE_ADDR addr)
+{
+  struct mem_region *region = lookup_mem_region (addr);
+
+  if (region->attrib.mode == MEM_RO
+      && region->attrib.cache
+      && (region->hi == 0 || addr + dcache->line_size <= region->hi))
+    return 1;
+
+  return (!region->attrib.nocache
+	  && (region->hi == 0 || addr + dcache->line_size <= region->hi)
+	  && target_cached_code_p (addr, dcache->line_size));
+}
+
 /* Get a free cache block, put or keep it on the valid list,
-   and return its address.  */
+   and return its address.  The block is not valid; the caller
+   fills it in.  */
 
 static struct dcache_block *
 dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
 {
   struct dcache_block *db;
 
-  if (dcache->size >= DCACHE_SIZE)
+  if (dcache->size >= dcache_size)
     {
-      /* Evict the least recently allocated line.  */
+      /* Evict the least recently allocated line, writing back what
+	 it still holds for the target.  */
       db = dcache->oldest;
+      dcache_write_line (dcache, db);
       remove_block (&dcache->oldest, db);
 
       splay_tree_remove (dcache->tree, (splay_tree_key) db->addr);
@@ -339,13 +497,17 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
       if (db)
 	remove_block (&dcache->freelist, db);
       else
-	db = xmalloc (sizeof (struct dcache_block));
+	db = xmalloc (offsetof (struct dcache_block, data)
+		      + dcache->line_size);
 
       dcache->size++;
     }
 
-  db->addr = MASK (addr);
+  db->addr = MASK (dcache, addr);
   db->refs = 0;
+  db->valid = 0;
+  db->dirty_lo = db->dirty_hi = 0;
+  db->readonly = dcache_readonly_line_p (dcache, db->addr);
 
   /* Put DB at the end of the list, it's the newest.  */
   append_block (&dcache->oldest, db);
@@ -356,48 +518,460 @@ dcache_alloc (DCACHE *dcache, CORE_ADDR addr)
   return db;
 }
 
-/* Using the data cache DCACHE, store in *PTR the contents of the byte at
-   address ADDR in the remote machine.  
+/* Fill in the lines of DCACHE covering the LEN bytes at MEMADDR that
+   are not in the cache, when they form more than one run of
+   consecutive lines: all the runs are read with a single
+   target_read_memory_regions call, instead of one read per run.  Runs
+   that are not plain cacheable memory, or that cannot be read, are
+   left to the caller.  */
+
+static void
+dcache_read_missing_lines (DCACHE *dcache, CORE_ADDR memaddr, int len)
+{
+  CORE_ADDR last_line = MASK (dcache, memaddr + len - 1);
+  CORE_ADDR line;
+  int line_size = dcache->line_size;
+  struct mem_region_read *regions;
+  struct cleanup *old_chain;
+  gdb_byte *buf;
+  int nregions = 0, nlines = 0, i, j;
+
+  /* Count the runs of missing lines, giving up if there is only one,
+     or if the cache can't hold them all.  */
+  for (line = MASK (dcache, memaddr); line <= last_line; line += line_size)
+    {
+      if (splay_tree_lookup (dcache->tree, (splay_tree_key) line))
+	continue;
+      if (nlines == 0
+	  || splay_tree_lookup (dcache->tree,
+				(splay_tree_key) (line - line_size)))
+	nregions++;
+      nlines++;
+      if (line == last_line)
+	break;
+    }
+  if (nregions < 2 || nlines > dcache_size)
+    return;
+
+  regions = xmalloc (nregions * sizeof (*regions));
+  old_chain = make_cleanup (xfree, regions);
+  buf = xmalloc (nlines * line_size);
+  make_cleanup (xfree, buf);
+
+  nregions = 0;
+  nlines = 0;
+  for (line = MASK (dcache, memaddr); line <= last_line; line += line_size)
+    {
+      if (!splay_tree_lookup (dcache->tree, (splay_tree_key) line))
+	{
+	  if (nregions > 0
+	      && (regions[nregions - 1].addr + regions[nregions - 1].len
+		  == line))
+	    regions[nregions - 1].len += line_size;
+	  else
+	    {
+	      regions[nregions].addr = line;
+	      regions[nregions].len = line_size;
+	      regions[nregions].buf = buf + nlines * line_size;
+	      nregions++;
+	    }
+	  nlines++;
+	}
+      if (line == last_line)
+	break;
+    }
+
+  /* Leave out the runs that dcache_read_memory would not read as a
+     whole.  */
+  for (i = 0, j = 0; i < nregions; i++)
+    {
+      struct mem_region *region = lookup_mem_region (regions[i].addr);
+
+      if (region->attrib.mode != MEM_WO && !region->attrib.nocache
+	  && (region->hi == 0
+	      || regions[i].addr + regions[i].len <= region->hi))
+	regions[j++] = regions[i];
+    }
+  nregions = j;
+
+  if (nregions > 1)
+    {
+      target_read_memory_regions (regions, nregions);
+
+      for (i = 0; i < nregions; i++)
+	{
+	  if (regions[i].status != 0)
+	    continue;
+
+	  for (j = 0; j < regions[i].len; j += line_size)
+	    {
+	      struct dcache_block *db = dcache_alloc (dcache,
+						      regions[i].addr + j);
+
+	      memcpy (db->data, regions[i].buf + j, line_size);
+	      db->valid = 1;
+	    }
+	}
+    }
+
+  do_cleanups (old_chain);
+}
+
+/* Using the data cache DCACHE, copy the LEN bytes at address MEMADDR
+   in the remote machine to MYADDR.  Each line is looked up once and
+   copied as a whole; a run of consecutive lines that are not in the
+   cache is fetched from the target with a single read, and so are
+   several such runs (see dcache_read_missing_lines).
 
-   Returns 1 for success, 0 for error.  */
+   Returns the number of bytes copied, which is less than LEN only if
+   a line couldn't be read.  */
 
 static int
-dcache_peek_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+dcache_peek_memory (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr,
+		    int len)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  CORE_ADDR last_line = MASK (dcache, memaddr + len - 1);
+  int line_size = dcache->line_size;
+  int done = 0;
 
-  if (!db)
+  dcache_read_missing_lines (dcache, memaddr, len);
+
+  while (done < len)
     {
-      db = dcache_alloc (dcache, addr);
+      CORE_ADDR addr = memaddr + done;
+      CORE_ADDR line = MASK (dcache, addr);
+      int offset = XFORM (dcache, addr);
+      int chunk = min (len - done, line_size - offset);
+      struct dcache_block *db = dcache_hit (dcache, addr);
+      gdb_byte *buf = NULL;
+      struct cleanup *old_chain;
+      int nlines, i;
+
+      if (db)
+	{
+	  /* A line allocated by a write-back store holds nothing but
+	     the bytes written; read in the rest.  */
+	  if (!db->valid && !dcache_read_line (dcache, db))
+	    return done;
+
+	  memcpy (myaddr + done, db->data + offset, chunk);
+	  done += chunk;
+	  continue;
+	}
 
-      if (!dcache_read_line (dcache, db))
-         return 0;
+      /* Find out how many of the following lines are missing too, but
+	 don't read more than the cache can hold.  */
+      for (nlines = 1;
+	   nlines < dcache_size && line + nlines * line_size <= last_line;
+	   nlines++)
+	if (splay_tree_lookup (dcache->tree,
+			       (splay_tree_key) (line + nlines * line_size)))
+	  break;
+
+      /* dcache_alloc and dcache_read_line can throw; don't leak the
+	 buffer when they do.  */
+      old_chain = make_cleanup (null_cleanup, NULL);
+      if (nlines > 1)
+	{
+	  buf = xmalloc (nlines * line_size);
+	  make_cleanup (xfree, buf);
+
+	  /* If that fails, go line by line to find where the readable
+	     memory ends.  */
+	  if (!dcache_read_memory (line, buf, nlines * line_size))
+	    buf = NULL;
+	}
+
+      for (i = 0; i < nlines; i++, line += line_size)
+	{
+	  db = dcache_alloc (dcache, line);
+
+	  if (buf != NULL)
+	    {
+	      memcpy (db->data, buf + i * line_size, line_size);
+	      db->valid = 1;
+	    }
+	  else if (!dcache_read_line (dcache, db))
+	    {
+	      /* Discard the line so we don't have a partially read
+		 line.  */
+	      dcache_invalidate_line (dcache, line);
+	      do_cleanups (old_chain);
+	      return done;
+	    }
+
+	  addr = memaddr + done;
+	  offset = XFORM (dcache, addr);
+	  chunk = min (len - done, line_size - offset);
+	  memcpy (myaddr + done, db->data + offset, chunk);
+	  done += chunk;
+	}
+
+      do_cleanups (old_chain);
     }
 
-  *ptr = db->data[XFORM (addr)];
-  return 1;
+  return done;
 }
 
-/* Write the byte at PTR into ADDR in the data cache.
+/* Copy the LEN bytes at MYADDR into the data cache at address MEMADDR.
 
    The caller is responsible for also promptly writing the data
    through to target memory.
 
-   If addr is not in cache, this function does nothing; writing to
-   an area of memory which wasn't present in the cache doesn't cause
-   it to be loaded in.
+   Only lines already in the cache are updated; writing to an area
+   of memory which wasn't present in the cache doesn't cause it to be
+   loaded in.  */
+
+static void
+dcache_poke_memory (DCACHE *dcache, CORE_ADDR memaddr,
+		    const gdb_byte *myaddr, int len)
+{
+  while (len > 0)
+    {
+      int offset = XFORM (dcache, memaddr);
+      int chunk = min (len, dcache->line_size - offset);
+      struct dcache_block *db = dcache_hit (dcache, memaddr);
+
+      if (db)
+	memcpy (db->data + offset, myaddr, chunk);
+
+      memaddr += chunk;
+      myaddr += chunk;
+      len -= chunk;
+    }
+}
+
+/* Store the LEN bytes at MYADDR into the data cache at address
+   MEMADDR, without writing them to the target; dcache_flush does
+   that later.  Lines not in the cache are allocated, but not read.  */
+
+static void
+dcache_store_memory (DCACHE *dcache, CORE_ADDR memaddr,
+		     const gdb_byte *myaddr, int len)
+{
+  while (len > 0)
+    {
+      int offset = XFORM (dcache, memaddr);
+      int chunk = min (len, dcache->line_size - offset);
+      struct dcache_block *db = dcache_hit (dcache, memaddr);
+
+      if (!db)
+	db = dcache_alloc (dcache, memaddr);
+
+      /* Only one dirty range is kept per line.  If the new bytes
+	 don't touch it, write the old range back first.  */
+      if (db->dirty_lo != db->dirty_hi
+	  && (offset > db->dirty_hi || offset + chunk < db->dirty_lo))
+	dcache_write_line (dcache, db);
+
+      memcpy (db->data + offset, myaddr, chunk);
+
+      if (db->dirty_lo == db->dirty_hi)
+	{
+	  db->dirty_lo = offset;
+	  db->dirty_hi = offset + chunk;
+	  dcache->ndirty++;
+	}
+      else
+	{
+	  db->dirty_lo = min (db->dirty_lo, offset);
+	  db->dirty_hi = max (db->dirty_hi, offset + chunk);
+	}
+
+      memaddr += chunk;
+      myaddr += chunk;
+      len -= chunk;
+    }
+}
 
-   Always return 1 (meaning success) to simplify dcache_xfer_memory.  */
+/* splay_tree_foreach callback for dcache_write_back.  DATA points to the
+   next free slot of an array of blocks.  */
 
 static int
-dcache_poke_byte (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr)
+dcache_collect_dirty (splay_tree_node node, void *data)
 {
-  struct dcache_block *db = dcache_hit (dcache, addr);
+  struct dcache_block *db = (struct dcache_block *) node->value;
+  struct dcache_block ***next = data;
 
-  if (db)
-    db->data[XFORM (addr)] = *ptr;
+  if (db->dirty_lo != db->dirty_hi)
+    *(*next)++ = db;
 
-  return 1;
+  return 0;
+}
+
+/* A range of memory written back by dcache_write_back: LEN bytes at ADDR,
+   found at OFFSET in the flush buffer.  */
+
+struct dcache_run
+{
+  CORE_ADDR addr;
+  int offset;
+  int len;
+};
+
+/* Write all the bytes of DCACHE that were not written to the target
+   yet back to it, merging dirty ranges that are contiguous in memory
+   into a single transfer.  The cache is clean afterwards, even if
+   some of the writes failed; an error is thrown for the first one
+   that did.  */
+
+static void
+dcache_write_back (DCACHE *dcache)
+{
+  struct dcache_block **lines, **next;
+  struct dcache_run *runs;
+  struct cleanup *old_chain;
+  gdb_byte *buf;
+  int nlines, nruns, len, i;
+  CORE_ADDR failed = 0;
+  int failed_p = 0;
+
+  if (dcache->ndirty == 0)
+    return;
+
+  /* Collect the dirty lines in address order.  */
+  lines = xmalloc (dcache->ndirty * sizeof (*lines));
+  old_chain = make_cleanup (xfree, lines);
+  next = lines;
+  splay_tree_foreach (dcache->tree, dcache_collect_dirty, &next);
+  nlines = next - lines;
+  gdb_assert (nlines == dcache->ndirty);
+
+  /* Gather their dirty bytes into runs, and mark them clean before
+     anything can go wrong.  */
+  buf = xmalloc (nlines * dcache->line_size);
+  make_cleanup (xfree, buf);
+  runs = xmalloc (nlines * sizeof (*runs));
+  make_cleanup (xfree, runs);
+
+  nruns = 0;
+  len = 0;
+  for (i = 0; i < nlines; i++)
+    {
+      struct dcache_block *db = lines[i];
+      CORE_ADDR start = db->addr + db->dirty_lo;
+      int n = db->dirty_hi - db->dirty_lo;
+
+      if (nruns == 0
+	  || runs[nruns - 1].addr + runs[nruns - 1].len != start)
+	{
+	  runs[nruns].addr = start;
+	  runs[nruns].offset = len;
+	  runs[nruns].len = 0;
+	  nruns++;
+	}
+
+      memcpy (buf + len, db->data + db->dirty_lo, n);
+      runs[nruns - 1].len += n;
+      len += n;
+      db->dirty_lo = db->dirty_hi = 0;
+    }
+  dcache->ndirty = 0;
+
+  for (i = 0; i < nruns; i++)
+    {
+      LONGEST res = target_write (&current_target, TARGET_OBJECT_RAW_MEMORY,
+				  NULL, buf + runs[i].offset,
+				  runs[i].addr, runs[i].len);
+
+      if (res < runs[i].len && !failed_p)
+	{
+	  failed = runs[i].addr + max (res, 0);
+	  failed_p = 1;
+	}
+    }
+
+  do_cleanups (old_chain);
+
+  if (failed_p)
+    memory_error (EIO, failed);
+}
+
+/* Write back what DCACHE holds for the inferior it was last used
+   with, even if that is not the current one.  */
+
+void
+dcache_flush (DCACHE *dcache)
+{
+  struct cleanup *old_chain;
+
+  if (dcache->ndirty == 0)
+    return;
+
+  old_chain = save_inferior_ptid ();
+  inferior_ptid = dcache->ptid;
+  dcache_write_back (dcache);
+  do_cleanups (old_chain);
+}
+
+/* Write back DCACHE if any of the bytes it holds back lie within the
+   LEN bytes at MEMADDR.  This keeps a memory access that bypasses the
+   cache from overtaking the writes, without giving up coalescing for
+   unrelated accesses.  */
+
+void
+dcache_flush_range (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len)
+{
+  splay_tree_node n;
+  CORE_ADDR line;
+
+  if (dcache->ndirty == 0 || len == 0)
+    return;
+
+  line = MASK (dcache, memaddr);
+  n = splay_tree_lookup (dcache->tree, (splay_tree_key) line);
+  if (n == NULL)
+    n = splay_tree_successor (dcache->tree, (splay_tree_key) line);
+
+  for (; n != NULL && (n->key <= memaddr || n->key - memaddr < len);
+       n = splay_tree_successor (dcache->tree, n->key))
+    {
+      struct dcache_block *db = (struct dcache_block *) n->value;
+      CORE_ADDR start = db->addr + db->dirty_lo;
+
+      if (db->dirty_lo != db->dirty_hi
+	  && db->addr + db->dirty_hi > memaddr
+	  && (start <= memaddr || start - memaddr < len))
+	{
+	  dcache_flush (dcache);
+	  return;
+	}
+    }
+}
+
+/* Make DCACHE hold data for PTID, flushing it if it was last used
+   with another inferior.  The threads of a process share its memory,
+   so switching between them keeps the cached data.  */
+
+static void
+dcache_set_ptid (DCACHE *dcache, ptid_t ptid)
+{
+  if (ptid_get_pid (ptid) != ptid_get_pid (dcache->ptid))
+    {
+      dcache_flush (dcache);
+      dcache_invalidate (dcache);
+    }
+  dcache->ptid = ptid;
+}
+
+/* Write back and discard everything DCACHE holds, for instance before
+   resuming the inferior or after the memory map changed.  */
+
+void
+dcache_write_back_and_invalidate (DCACHE *dcache)
+{
+  dcache_flush (dcache);
+  dcache_invalidate (dcache);
+}
+
+/* Discard everything DCACHE holds for process PID, including any
+   data not written back; the process is gone.  */
+
+void
+dcache_discard_pid (DCACHE *dcache, int pid)
+{
+  if (ptid_get_pid (dcache->ptid) == pid)
+    dcache_invalidate (dcache);
 }
 
 static int
@@ -427,20 +1001,14 @@ dcache_init (void)
   dcache->oldest = NULL;
   dcache->freelist = NULL;
   dcache->size = 0;
+  dcache->line_size = dcache_line_size;
+  dcache->ndirty = 0;
   dcache->ptid = null_ptid;
   last_cache = dcache;
 
   return dcache;
 }
 
-/* BLOCK_FUNC routine for dcache_free.  */
-
-static void
-free_block (struct dcache_block *block, void *param)
-{
-  free (block);
-}
-
 /* Free a data cache.  */
 
 void
@@ -470,61 +1038,35 @@ dcache_xfer_memory (struct target_ops *ops, DCACHE *dcache,
 		    CORE_ADDR memaddr, gdb_byte *myaddr,
 		    int len, int should_write)
 {
-  int i;
   int res;
-  int (*xfunc) (DCACHE *dcache, CORE_ADDR addr, gdb_byte *ptr);
-
-  xfunc = should_write ? dcache_poke_byte : dcache_peek_byte;
 
   /* If this is a different inferior from what we've recorded,
      flush the cache.  */
+  dcache_set_ptid (dcache, inferior_ptid);
+
+  if (!should_write)
+    return dcache_peek_memory (dcache, memaddr, myaddr, len);
 
-  if (! ptid_equal (inferior_ptid, dcache->ptid))
+  if (dcache_write_back_p)
     {
-      dcache_invalidate (dcache);
-      dcache->ptid = inferior_ptid;
+      dcache_store_memory (dcache, memaddr, myaddr, len);
+      return len;
     }
 
   /* Do write-through first, so that if it fails, we don't write to
      the cache at all.  */
 
-  if (should_write)
-    {
-      res = target_write (ops, TARGET_OBJECT_RAW_MEMORY,
-			  NULL, myaddr, memaddr, len);
-      if (res <= 0)
-	return res;
-      /* Update LEN to what was actually written.  */
-      len = res;
-    }
-      
-  for (i = 0; i < len; i++)
-    {
-      if (!xfunc (dcache, memaddr + i, myaddr + i))
-	{
-	  /* That failed.  Discard its cache line so we don't have a
-	     partially read line.  */
-	  dcache_invalidate_line (dcache, memaddr + i);
-	  /* If we're writing, we still wrote LEN bytes.  */
-	  if (should_write)
-	    return len;
-	  else
-	    return i;
-	}
-    }
-    
+  res = target_write (ops, TARGET_OBJECT_RAW_MEMORY,
+		      NULL, myaddr, memaddr, len);
+  if (res <= 0)
+    return res;
+
+  /* Update LEN to what was actually written.  */
+  len = res;
+  dcache_poke_memory (dcache, memaddr, myaddr, len);
   return len;
 }
 
-/* FIXME: There would be some benefit to making the cache write-back and
-   moving the writeback operation to a higher layer, as it could occur
-   after a sequence of smaller writes have been completed (as when a stack
-   frame is constructed for an inferior function call).  Note that only
-   moving it up one level to target_xfer_memory[_partial]() is not
-   sufficient since we want to coalesce memory transfers that are
-   "logically" connected but not actually a single call to one of the
-   memory transfer functions.  */
-
 /* Just update any cache lines which are already present.  This is called
    by memory_xfer_partial in cases where the access would otherwise not go
    through the cache.  */
@@ -532,10 +1074,36 @@ dcache_xfer_memory (struct target_ops *ops, DCACHE *dcache,
 void
 dcache_update (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr, int len)
 {
-  int i;
+  dcache_poke_memory (dcache, memaddr, myaddr, len);
+}
+
+/* Store LEN bytes at MEMADDR in inferior PTID, from debugger address
+   MYADDR, into the data cache, as if they had just been read from the
+   target.  This is for memory obtained some other way, such as along
+   with a stop reply.  Only whole cache lines are stored, and lines
+   holding bytes not written back yet are left alone.  */
+
+void
+dcache_fill (DCACHE *dcache, ptid_t ptid, CORE_ADDR memaddr,
+	     const gdb_byte *myaddr, int len)
+{
+  int line_size = dcache->line_size;
+  CORE_ADDR addr = MASK (dcache, memaddr + line_size - 1);
+  int offset = addr - memaddr;
 
-  for (i = 0; i < len; i++)
-    dcache_poke_byte (dcache, memaddr + i, myaddr + i);
+  dcache_set_ptid (dcache, ptid);
+
+  for (; offset + line_size <= len; offset += line_size, addr += line_size)
+    {
+      struct dcache_block *db = dcache_hit (dcache, addr);
+
+      if (!db)
+	db = dcache_alloc (dcache, addr);
+      else if (db->dirty_lo != db->dirty_hi)
+	continue;
+      memcpy (db->data, myaddr + offset, line_size);
+      db->valid = 1;
+    }
 }
 
 static void
@@ -570,13 +1138,16 @@ dcache_print_line (int index)
 
   printf_filtered (_("Line %d: address %s [%d hits]\n"),
 		   index, paddress (target_gdbarch, db->addr), db->refs);
+  if (db->dirty_lo != db->dirty_hi)
+    printf_filtered (_("Bytes %d to %d not written back\n"),
+		     db->dirty_lo, db->dirty_hi - 1);
 
-  for (j = 0; j < LINE_SIZE; j++)
+  for (j = 0; j < last_cache->line_size; j++)
     {
       printf_filtered ("%02x ", db->data[j]);
 
       /* Print a newline every 16 bytes (48 characters) */
-      if ((j % 16 == 15) && (j != LINE_SIZE - 1))
+      if ((j % 16 == 15) && (j != last_cache->line_size - 1))
 	printf_filtered ("\n");
     }
   printf_filtered ("\n");
@@ -603,8 +1174,8 @@ dcache_info (char *exp, int tty)
       return;
     }
 
-  printf_filtered (_("Dcache line width %d, maximum size %d\n"),
-		   LINE_SIZE, DCACHE_SIZE);
+  printf_filtered (_("Dcache line width %u, maximum size %u\n"),
+		   dcache_line_size, dcache_size);
 
   if (!last_cache || ptid_equal (last_cache->ptid, null_ptid))
     {
@@ -624,8 +1195,9 @@ dcache_info (char *exp, int tty)
     {
       struct dcache_block *db = (struct dcache_block *) n->value;
 
-      printf_filtered (_("Line %d: address %s [%d hits]\n"),
-		       i, paddress (target_gdbarch, db->addr), db->refs);
+      printf_filtered (_("Line %d: address %s [%d hits]%s\n"),
+		       i, paddress (target_gdbarch, db->addr), db->refs,
+		       db->dirty_lo != db->dirty_hi ? _(" dirty") : "");
       i++;
       refcount += db->refs;
 
@@ -635,6 +1207,93 @@ dcache_info (char *exp, int tty)
   printf_filtered (_("Cache state: %d active lines, %d hits\n"), i, refcount);
 }
 
+/* Called after "set dcache size" changes the size.  */
+
+static void
+set_dcache_size (char *args, int from_tty,
+		 struct cmd_list_element *c)
+{
+  if (dcache_size == 0)
+    {
+      dcache_size = DCACHE_DEFAULT_SIZE;
+      error (_("Dcache size must be greater than 0."));
+    }
+
+  if (last_cache)
+    dcache_write_back_and_invalidate (last_cache);
+}
+
+/* Called after "set dcache line-size" changes the line size.  */
+
+static void
+set_dcache_line_size (char *args, int from_tty,
+		      struct cmd_list_element *c)
+{
+  if (dcache_line_size < 2
+      || (dcache_line_size & (dcache_line_size - 1)) != 0
+      || dcache_line_size > DCACHE_MAX_LINE_SIZE)
+    {
+      unsigned d = dcache_line_size;
+
+      dcache_line_size = last_cache ? last_cache->line_size
+				    : DCACHE_DEFAULT_LINE_SIZE;
+      error (_("Invalid dcache line size: %u (must be power of 2, "
+	       "at most %d)."), d, DCACHE_MAX_LINE_SIZE);
+    }
+
+  if (last_cache)
+    dcache_write_back_and_invalidate (last_cache);
+}
+
+/* Called after "set dcache write-back" changes.  Turning write-back
+   off writes back anything still pending.  */
+
+static void
+set_dcache_write_back (char *args, int from_tty,
+		       struct cmd_list_element *c)
+{
+  if (!dcache_write_back_p && last_cache)
+    dcache_flush (last_cache);
+}
+
+static void
+show_dcache_size (struct ui_file *file, int from_tty,
+		  struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Number of dcache lines is %s.\n"), value);
+}
+
+static void
+show_dcache_line_size (struct ui_file *file, int from_tty,
+		       struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Dcache line size is %s.\n"), value);
+}
+
+static void
+show_dcache_write_back (struct ui_file *file, int from_tty,
+			struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Dcache write-back is %s.\n"), value);
+}
+
+static struct cmd_list_element *dcache_set_list;
+static struct cmd_list_element *dcache_show_list;
+
+static void
+set_dcache_command (char *arg, int from_tty)
+{
+  printf_unfiltered (
+     "\"set dcache\" must be followed by the name of a subcommand.\n");
+  help_list (dcache_set_list, "set dcache ", -1, gdb_stdout);
+}
+
+static void
+show_dcache_command (char *args, int from_tty)
+{
+  cmd_show_list (dcache_show_list, from_tty, "");
+}
+
 void
 _initialize_dcache (void)
 {
@@ -656,4 +1315,45 @@ Print information on the dcache performance.\n\
 With no arguments, this command prints the cache configuration and a\n\
 summary of each line in the cache.  Use \"info dcache <lineno> to dump\"\n\
 the contents of a given line."));
+
+  add_prefix_cmd ("dcache", class_obscure, set_dcache_command, _("\
+Use this command to set the data cache parameters."),
+		  &dcache_set_list, "set dcache ", /*allow_unknown*/0,
+		  &setlist);
+  add_prefix_cmd ("dcache", class_obscure, show_dcache_command, _("\
+Show the data cache parameters."),
+		  &dcache_show_list, "show dcache ", /*allow_unknown*/0,
+		  &showlist);
+
+  add_setshow_zuinteger_cmd ("size", class_obscure,
+			     &dcache_size, _("\
+Set number of dcache lines."), _("\
+Show number of dcache lines."), _("\
+The cache holds at most this many lines.\n\
+Changing it discards the cache contents."),
+			     set_dcache_size,
+			     show_dcache_size,
+			     &dcache_set_list, &dcache_show_list);
+
+  add_setshow_zuinteger_cmd ("line-size", class_obscure,
+			     &dcache_line_size, _("\
+Set dcache line size in bytes (must be power of 2)."), _("\
+Show dcache line size."), _("\
+Memory is read from the target in blocks of this many bytes.\n\
+Changing it discards the cache contents."),
+			     set_dcache_line_size,
+			     show_dcache_line_size,
+			     &dcache_set_list, &dcache_show_list);
+
+  add_setshow_boolean_cmd ("write-back", class_obscure,
+			   &dcache_write_back_p, _("\
+Set whether writes to cached memory are deferred."), _("\
+Show whether writes to cached memory are deferred."), _("\
+When on, writes to cached memory are kept in the dcache and written\n\
+to the target, merged into as few transfers as possible, just before\n\
+the inferior resumes or memory is accessed without the cache.\n\
+When off, the cache is write-through."),
+			   set_dcache_write_back,
+			   show_dcache_write_back,
+			   &dcache_set_list, &dcache_show_list);
 }
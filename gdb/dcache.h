@@ -41,4 +41,24 @@ int dcache_xfer_memory (struct target_ops *ops, DCACHE *cache, CORE_ADDR mem,
 void dcache_update (DCACHE *dcache, CORE_ADDR memaddr, gdb_byte *myaddr,
 		    int len);
 
+/* Write back the data stored with "set dcache write-back on".  */
+void dcache_flush (DCACHE *dcache);
+
+/* Likewise, but only if some of it lies within LEN bytes at MEMADDR.  */
+void dcache_flush_range (DCACHE *dcache, CORE_ADDR memaddr, ULONGEST len);
+
+/* Write back and then invalidate DCACHE.  */
+void dcache_write_back_and_invalidate (DCACHE *dcache);
+
+/* Invalidate what the inferior may change while running: everything
+   but read-only memory regions with the cache attribute.  DCACHE
+   must have been flushed.  */
+void dcache_invalidate_volatile (DCACHE *dcache);
+
+/* Discard DCACHE's data if it belongs to process PID.  */
+void dcache_discard_pid (DCACHE *dcache, int pid);
+
+void dcache_fill (DCACHE *dcache, ptid_t ptid, CORE_ADDR memaddr,
+		  const gdb_byte *myaddr, int len);
+
 #endif /* DCACHE_H */
@@ -30,6 +30,7 @@
 #include "gdbtypes.h"
 #include "symtab.h"
 #include "objfiles.h"
+#include "progspace.h"
 #include "regcache.h"
 #include "value.h"
 
@@ -37,6 +38,7 @@
 #include "gdb_string.h"
 
 #include "complaints.h"
+#include "exceptions.h"
 #include "dwarf2-frame.h"
 
 struct comp_unit;
@@ -116,6 +118,10 @@ struct dwarf2_fde
   /* True if this FDE is read from a .eh_frame instead of a .debug_frame
      section.  */
   unsigned char eh_frame_p;
+
+  /* The rows of the CFI table described by this FDE, built the first
+     time a frame is unwound with it.  */
+  struct dwarf2_frame_rows *rows;
 };
 
 struct dwarf2_fde_table
@@ -412,15 +418,17 @@ execute_stack_op (const gdb_byte *exp, ULONGEST len, int addr_size,
 }
 
 
-static void
+/* Execute the CFA instructions from INSN_PTR to INSN_END of FDE on
+   the frame state FS, for as long as FS->pc does not go past PC.
+   Return a pointer to the first instruction not executed.  */
+
+static const gdb_byte *
 execute_cfa_program (struct dwarf2_fde *fde, const gdb_byte *insn_ptr,
-		     const gdb_byte *insn_end, struct frame_info *this_frame,
-		     struct dwarf2_frame_state *fs)
+		     const gdb_byte *insn_end, struct gdbarch *gdbarch,
+		     CORE_ADDR pc, struct dwarf2_frame_state *fs)
 {
   int eh_frame_p = fde->eh_frame_p;
-  CORE_ADDR pc = get_frame_pc (this_frame);
   int bytes_read;
-  struct gdbarch *gdbarch = get_frame_arch (this_frame);
   enum bfd_endian byte_order = gdbarch_byte_order (gdbarch);
 
   while (insn_ptr < insn_end && fs->pc <= pc)
@@ -696,9 +704,7 @@ bad CFI data; mismatched DW_CFA_restore_state at %s"),
 	}
     }
 
-  /* Don't allow remember/restore between CIE and FDE programs.  */
-  dwarf2_frame_state_free_regs (fs->regs.prev);
-  fs->regs.prev = NULL;
+  return insn_ptr;
 }
 
 
@@ -886,6 +892,212 @@ dwarf2_frame_find_quirks (struct dwarf2_frame_state *fs,
 }
 
 
+/* A row of the CFI table of an FDE: the rules for computing the CFA
+   and the saved registers, from PC up to the PC of the next row.  */
+
+struct dwarf2_frame_row
+{
+  /* The first PC of the row, not relocated.  */
+  CORE_ADDR pc;
+
+  /* The rules; REGS.prev is always NULL.  */
+  struct dwarf2_frame_state_reg_info regs;
+};
+
+/* The CFI table of an FDE, so that unwinding a frame needs a search
+   of its rows rather than running the CIE and FDE programs.  */
+
+struct dwarf2_frame_rows
+{
+  /* The architecture the table was built for.  */
+  struct gdbarch *gdbarch;
+
+  /* The rows, sorted by PC.  If there are none, the programs could
+     not be run all the way through, and must be run up to the PC of
+     each frame as it is unwound.  */
+  struct dwarf2_frame_row *rows;
+  int num_rows;
+};
+
+/* Growable array of rows, for building a table.  */
+
+struct dwarf2_frame_row_list
+{
+  struct dwarf2_frame_row *rows;
+  int num_rows;
+  int max_rows;
+};
+
+/* Add the rules of FS as a row starting at PC to LIST, copying the
+   register rules to OBSTACK.  */
+
+static void
+dwarf2_frame_add_row (struct dwarf2_frame_row_list *list,
+		      struct obstack *obstack, CORE_ADDR pc,
+		      struct dwarf2_frame_state *fs)
+{
+  struct dwarf2_frame_row *row;
+  size_t size = fs->regs.num_regs * sizeof (struct dwarf2_frame_state_reg);
+
+  if (list->num_rows == list->max_rows)
+    {
+      list->max_rows = list->max_rows ? 2 * list->max_rows : 8;
+      list->rows = xrealloc (list->rows,
+			     list->max_rows * sizeof (list->rows[0]));
+    }
+
+  row = &list->rows[list->num_rows++];
+  row->pc = pc;
+  row->regs = fs->regs;
+  row->regs.prev = NULL;
+  row->regs.reg = NULL;
+  if (size != 0)
+    {
+      row->regs.reg = obstack_alloc (obstack, size);
+      memcpy (row->regs.reg, fs->regs.reg, size);
+    }
+}
+
+/* Run the CFA instructions from INSN_PTR to INSN_END of FDE on FS,
+   adding a row to LIST each time they advance the PC.  OFFSET is the
+   offset of the FDE's objfile.  Return the PC of the last row,
+   which is still open.  */
+
+static CORE_ADDR
+dwarf2_frame_run_rows (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+		       const gdb_byte *insn_ptr, const gdb_byte *insn_end,
+		       struct dwarf2_frame_state *fs,
+		       struct dwarf2_frame_row_list *list,
+		       struct obstack *obstack, CORE_ADDR offset,
+		       CORE_ADDR start)
+{
+  while (insn_ptr < insn_end)
+    {
+      /* Run the instructions up to the first one that takes the PC
+	 past START; the state then holds for [START, FS->pc).  */
+      insn_ptr = execute_cfa_program (fde, insn_ptr, insn_end, gdbarch,
+				      start, fs);
+      if (fs->pc > start)
+	{
+	  dwarf2_frame_add_row (list, obstack, start - offset, fs);
+	  start = fs->pc;
+	}
+    }
+
+  return start;
+}
+
+/* Fill ROWS with the CFI table of FDE, whose objfile has offset
+   OFFSET.  Throw an error if the CFI is bad.  */
+
+static void
+dwarf2_frame_build_rows (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+			 CORE_ADDR offset, struct dwarf2_frame_rows *rows)
+{
+  struct obstack *obstack = &fde->cie->unit->objfile->objfile_obstack;
+  struct dwarf2_frame_row_list list;
+  struct dwarf2_frame_state *fs;
+  struct cleanup *old_chain;
+  CORE_ADDR start;
+
+  memset (&list, 0, sizeof (list));
+  old_chain = make_cleanup (free_current_contents, &list.rows);
+
+  fs = XZALLOC (struct dwarf2_frame_state);
+  make_cleanup (dwarf2_frame_state_free, fs);
+
+  fs->pc = fde->initial_location + offset;
+  fs->data_align = fde->cie->data_alignment_factor;
+  fs->code_align = fde->cie->code_alignment_factor;
+  fs->retaddr_column = fde->cie->return_address_register;
+  dwarf2_frame_find_quirks (fs, fde);
+
+  start = dwarf2_frame_run_rows (gdbarch, fde, fde->cie->initial_instructions,
+				 fde->cie->end, fs, &list, obstack, offset,
+				 fs->pc);
+
+  /* Don't allow remember/restore between CIE and FDE programs.  */
+  dwarf2_frame_state_free_regs (fs->regs.prev);
+  fs->regs.prev = NULL;
+
+  /* Save the initialized register set.  */
+  fs->initial = fs->regs;
+  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+
+  start = dwarf2_frame_run_rows (gdbarch, fde, fde->instructions, fde->end,
+				 fs, &list, obstack, offset, start);
+
+  /* The last row holds up to the end of the FDE.  */
+  dwarf2_frame_add_row (&list, obstack, start - offset, fs);
+
+  rows->rows = obstack_alloc (obstack, list.num_rows * sizeof (list.rows[0]));
+  memcpy (rows->rows, list.rows, list.num_rows * sizeof (list.rows[0]));
+  rows->num_rows = list.num_rows;
+
+  do_cleanups (old_chain);
+}
+
+/* Return the CFI table of FDE, whose objfile has offset OFFSET, for
+   GDBARCH, building it if this is the first time.  Return NULL if
+   there is no table, and the CFA programs must be run instead.  */
+
+static struct dwarf2_frame_rows *
+dwarf2_frame_fde_rows (struct gdbarch *gdbarch, struct dwarf2_fde *fde,
+		       CORE_ADDR offset)
+{
+  struct dwarf2_frame_rows *rows = fde->rows;
+
+  if (rows == NULL)
+    {
+      volatile struct gdb_exception ex;
+
+      rows = OBSTACK_ZALLOC (&fde->cie->unit->objfile->objfile_obstack,
+			     struct dwarf2_frame_rows);
+      rows->gdbarch = gdbarch;
+
+      /* Errors will be reported again, at the right PC, when the
+	 programs are run for a frame.  */
+      TRY_CATCH (ex, RETURN_MASK_ERROR)
+	{
+	  dwarf2_frame_build_rows (gdbarch, fde, offset, rows);
+	}
+      if (ex.reason < 0)
+	{
+	  rows->rows = NULL;
+	  rows->num_rows = 0;
+	}
+
+      fde->rows = rows;
+    }
+
+  if (rows->num_rows == 0 || rows->gdbarch != gdbarch)
+    return NULL;
+  return rows;
+}
+
+/* Return the row of ROWS that holds at PC, which is not relocated.  */
+
+static struct dwarf2_frame_row *
+dwarf2_frame_find_row (struct dwarf2_frame_rows *rows, CORE_ADDR pc)
+{
+  int lo = 0, hi = rows->num_rows;
+
+  /* Find the last row starting at or before PC; the first row starts
+     at the beginning of the FDE.  */
+  while (hi - lo > 1)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (rows->rows[mid].pc <= pc)
+	lo = mid;
+      else
+	hi = mid;
+    }
+
+  return &rows->rows[lo];
+}
+
+
 struct dwarf2_frame_cache
 {
   /* DWARF Call Frame Address.  */
@@ -908,6 +1120,51 @@ struct dwarf2_frame_cache
   CORE_ADDR text_offset;
 };
 
+/* The registers of the innermost frame come straight from the target.
+   Tell the regcache which of them the rules in FS are about to read,
+   so that a target which fetches registers one at a time can fetch
+   them together instead.  */
+
+static void
+dwarf2_frame_prefetch_regs (struct frame_info *this_frame,
+			    struct dwarf2_frame_state *fs)
+{
+  volatile struct gdb_exception ex;
+  struct gdbarch *gdbarch = get_frame_arch (this_frame);
+  ULONGEST column;
+  int *regnums;
+  int count = 0;
+
+  if (frame_relative_level (this_frame) != 0)
+    return;
+
+  regnums = alloca ((fs->regs.num_regs + 2) * sizeof (int));
+
+  if (fs->regs.cfa_how == CFA_REG_OFFSET)
+    regnums[count++] = gdbarch_dwarf2_reg_to_regnum (gdbarch,
+						     fs->regs.cfa_reg);
+
+  for (column = 0; column < fs->regs.num_regs; column++)
+    if (fs->regs.reg[column].how == DWARF2_FRAME_REG_SAVED_REG)
+      regnums[count++]
+	= gdbarch_dwarf2_reg_to_regnum (gdbarch, fs->regs.reg[column].loc.reg);
+
+  /* Unless the return address was saved elsewhere, it is still in its
+     own column.  */
+  column = fs->retaddr_column;
+  if (column >= fs->regs.num_regs
+      || fs->regs.reg[column].how == DWARF2_FRAME_REG_UNSPECIFIED
+      || fs->regs.reg[column].how == DWARF2_FRAME_REG_SAME_VALUE)
+    regnums[count++] = gdbarch_dwarf2_reg_to_regnum (gdbarch, column);
+
+  /* This is only an optimization; any error will be reported by the
+     unwinder when it actually reads the register.  */
+  TRY_CATCH (ex, RETURN_MASK_ERROR)
+    {
+      regcache_raw_prefetch (get_current_regcache (), count, regnums);
+    }
+}
+
 static struct dwarf2_frame_cache *
 dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
 {
@@ -918,6 +1175,7 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   struct dwarf2_frame_cache *cache;
   struct dwarf2_frame_state *fs;
   struct dwarf2_fde *fde;
+  struct dwarf2_frame_rows *rows;
 
   if (*this_cache)
     return *this_cache;
@@ -961,16 +1219,39 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   /* Check for "quirks" - known bugs in producers.  */
   dwarf2_frame_find_quirks (fs, fde);
 
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, this_frame, fs);
+  rows = dwarf2_frame_fde_rows (gdbarch, fde, cache->text_offset);
+  if (rows != NULL)
+    {
+      /* Take the rules from the FDE's CFI table.  */
+      struct dwarf2_frame_row *row;
+
+      row = dwarf2_frame_find_row (rows, (get_frame_pc (this_frame)
+					  - cache->text_offset));
+      fs->pc = row->pc + cache->text_offset;
+      fs->regs = row->regs;
+      fs->regs.reg = dwarf2_frame_state_copy_regs (&row->regs);
+    }
+  else
+    {
+      CORE_ADDR pc = get_frame_pc (this_frame);
 
-  /* Save the initialized register set.  */
-  fs->initial = fs->regs;
-  fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+      /* First decode all the insns in the CIE.  */
+      execute_cfa_program (fde, fde->cie->initial_instructions,
+			   fde->cie->end, gdbarch, pc, fs);
+
+      /* Don't allow remember/restore between CIE and FDE programs.  */
+      dwarf2_frame_state_free_regs (fs->regs.prev);
+      fs->regs.prev = NULL;
+
+      /* Save the initialized register set.  */
+      fs->initial = fs->regs;
+      fs->initial.reg = dwarf2_frame_state_copy_regs (&fs->regs);
+
+      /* Then decode the insns in the FDE up to our target PC.  */
+      execute_cfa_program (fde, fde->instructions, fde->end, gdbarch, pc, fs);
+    }
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, fde->instructions, fde->end, this_frame, fs);
+  dwarf2_frame_prefetch_regs (this_frame, fs);
 
   /* Calculate the CFA.  */
   switch (fs->regs.cfa_how)
@@ -1586,20 +1867,129 @@ bsearch_fde_cmp (const void *key, const void *element)
   return 1;
 }
 
-/* Find the FDE for *PC.  Return a pointer to the FDE, and store the
-   inital location associated with it into *PC.  */
+/* The address range covered by the FDEs of one objfile.  */
 
-static struct dwarf2_fde *
-dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+struct dwarf2_frame_extent
 {
+  /* The range, relocated.  */
+  CORE_ADDR low;
+  CORE_ADDR high;
+
   struct objfile *objfile;
+  struct dwarf2_fde_table *fde_table;
+
+  /* The offset of the objfile's text section.  */
+  CORE_ADDR offset;
+
+  /* The position of the objfile in the list of objfiles.  */
+  int order;
+};
+
+/* A maximal group of extents that overlap each other, such as those
+   of an objfile and of its separate debug info.  */
+
+struct dwarf2_frame_cluster
+{
+  CORE_ADDR low;
+  CORE_ADDR high;
+
+  /* The extents of the group, in objfile order, as a slice of the
+     index's EXTENTS.  */
+  int first;
+  int count;
+};
+
+/* An index of the FDE tables of all the objfiles of a program space,
+   so that finding the FDE for a PC takes a search of the clusters and
+   usually of a single FDE table, instead of a search of every
+   objfile's FDE table.  */
+
+struct dwarf2_frame_index
+{
+  /* Whether the index was built, and the objfiles generation it was
+     built for.  */
+  int valid_p;
+  unsigned int generation;
+
+  struct dwarf2_frame_extent *extents;
+  int num_extents;
+
+  /* The clusters, sorted by address; they do not overlap.  */
+  struct dwarf2_frame_cluster *clusters;
+  int num_clusters;
+
+  /* The FDE found by the last lookup, the relocated range it covers,
+     and the offset of its objfile.  Only set when that objfile is the
+     first of its cluster, so that any PC in the range would find the
+     same FDE.  */
+  struct dwarf2_fde *last_fde;
+  CORE_ADDR last_low;
+  CORE_ADDR last_high;
+  CORE_ADDR last_offset;
+};
+
+/* Per-program-space data key.  */
+static const struct program_space_data *dwarf2_frame_pspace_data;
+
+static void
+dwarf2_frame_free_index (struct dwarf2_frame_index *index)
+{
+  xfree (index->extents);
+  index->extents = NULL;
+  index->num_extents = 0;
+  xfree (index->clusters);
+  index->clusters = NULL;
+  index->num_clusters = 0;
+  index->last_fde = NULL;
+  index->valid_p = 0;
+}
+
+static void
+dwarf2_frame_pspace_data_cleanup (struct program_space *pspace, void *arg)
+{
+  struct dwarf2_frame_index *index = arg;
 
-  ALL_OBJFILES (objfile)
+  dwarf2_frame_free_index (index);
+  xfree (index);
+}
+
+static int
+qsort_extent_addr_cmp (const void *a, const void *b)
+{
+  const struct dwarf2_frame_extent *aa = a;
+  const struct dwarf2_frame_extent *bb = b;
+
+  if (aa->low != bb->low)
+    return aa->low < bb->low ? -1 : 1;
+  return aa->order - bb->order;
+}
+
+static int
+qsort_extent_order_cmp (const void *a, const void *b)
+{
+  const struct dwarf2_frame_extent *aa = a;
+  const struct dwarf2_frame_extent *bb = b;
+
+  return aa->order - bb->order;
+}
+
+/* Build INDEX from the objfiles of PSPACE, reading their frame
+   information if that was not done yet.  */
+
+static void
+dwarf2_frame_build_index (struct program_space *pspace,
+			  struct dwarf2_frame_index *index)
+{
+  struct objfile *objfile;
+  int n, order, i;
+
+  dwarf2_frame_free_index (index);
+
+  /* Read all the FDE tables first; this may throw.  */
+  n = 0;
+  ALL_PSPACE_OBJFILES (pspace, objfile)
     {
       struct dwarf2_fde_table *fde_table;
-      struct dwarf2_fde **p_fde;
-      CORE_ADDR offset;
-      CORE_ADDR seek_pc;
 
       fde_table = objfile_data (objfile, dwarf2_frame_objfile_data);
       if (fde_table == NULL)
@@ -1609,24 +1999,181 @@ dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
 	}
       gdb_assert (fde_table != NULL);
 
+      if (fde_table->num_entries != 0)
+	n++;
+    }
+
+  if (n != 0)
+    {
+      index->extents = xmalloc (n * sizeof (index->extents[0]));
+      index->clusters = xmalloc (n * sizeof (index->clusters[0]));
+    }
+
+  order = 0;
+  ALL_PSPACE_OBJFILES (pspace, objfile)
+    {
+      struct dwarf2_fde_table *fde_table;
+      struct dwarf2_frame_extent *ext;
+      CORE_ADDR high;
+
+      fde_table = objfile_data (objfile, dwarf2_frame_objfile_data);
+      order++;
       if (fde_table->num_entries == 0)
 	continue;
 
       gdb_assert (objfile->section_offsets);
-      offset = ANOFFSET (objfile->section_offsets, SECT_OFF_TEXT (objfile));
+      ext = &index->extents[index->num_extents++];
+      ext->objfile = objfile;
+      ext->fde_table = fde_table;
+      ext->offset = ANOFFSET (objfile->section_offsets,
+			      SECT_OFF_TEXT (objfile));
+      ext->order = order;
+
+      /* The table is sorted by start address, but an FDE may extend
+	 past the ones that follow it.  */
+      high = 0;
+      for (i = 0; i < fde_table->num_entries; i++)
+	{
+	  struct dwarf2_fde *fde = fde_table->entries[i];
+
+	  if (high < fde->initial_location + fde->address_range)
+	    high = fde->initial_location + fde->address_range;
+	}
+      ext->low = fde_table->entries[0]->initial_location + ext->offset;
+      ext->high = high + ext->offset;
+    }
+  gdb_assert (index->num_extents == n);
+
+  if (n != 0)
+    qsort (index->extents, n, sizeof (index->extents[0]),
+	   qsort_extent_addr_cmp);
+
+  /* Group the overlapping extents, and order each group as the
+     objfiles are, which is the order in which they are searched.  */
+  for (i = 0; i < n; i++)
+    {
+      struct dwarf2_frame_extent *ext = &index->extents[i];
+      struct dwarf2_frame_cluster *cluster;
+
+      if (index->num_clusters > 0)
+	{
+	  cluster = &index->clusters[index->num_clusters - 1];
+	  if (ext->low < cluster->high)
+	    {
+	      cluster->count++;
+	      if (cluster->high < ext->high)
+		cluster->high = ext->high;
+	      continue;
+	    }
+	}
+
+      cluster = &index->clusters[index->num_clusters++];
+      cluster->low = ext->low;
+      cluster->high = ext->high;
+      cluster->first = i;
+      cluster->count = 1;
+    }
+
+  for (i = 0; i < index->num_clusters; i++)
+    if (index->clusters[i].count > 1)
+      qsort (&index->extents[index->clusters[i].first],
+	     index->clusters[i].count, sizeof (index->extents[0]),
+	     qsort_extent_order_cmp);
 
-      gdb_assert (fde_table->num_entries > 0);
-      if (*pc < offset + fde_table->entries[0]->initial_location)
-        continue;
+  index->generation = objfiles_generation (pspace);
+  index->valid_p = 1;
+}
+
+/* Return the FDE index of PSPACE, (re)building it if the objfiles
+   changed since it was built.  */
+
+static struct dwarf2_frame_index *
+dwarf2_frame_get_index (struct program_space *pspace)
+{
+  struct dwarf2_frame_index *index;
+
+  index = program_space_data (pspace, dwarf2_frame_pspace_data);
+  if (index == NULL)
+    {
+      index = XZALLOC (struct dwarf2_frame_index);
+      set_program_space_data (pspace, dwarf2_frame_pspace_data, index);
+    }
+
+  if (!index->valid_p || index->generation != objfiles_generation (pspace))
+    dwarf2_frame_build_index (pspace, index);
 
-      seek_pc = *pc - offset;
+  return index;
+}
+
+static int
+bsearch_cluster_cmp (const void *key, const void *element)
+{
+  CORE_ADDR seek_pc = *(CORE_ADDR *) key;
+  const struct dwarf2_frame_cluster *cluster = element;
+
+  if (seek_pc < cluster->low)
+    return -1;
+  if (seek_pc < cluster->high)
+    return 0;
+  return 1;
+}
+
+/* Find the FDE for *PC.  Return a pointer to the FDE, and store the
+   inital location associated with it into *PC.  */
+
+static struct dwarf2_fde *
+dwarf2_frame_find_fde (CORE_ADDR *pc, CORE_ADDR *out_offset)
+{
+  struct dwarf2_frame_index *index;
+  struct dwarf2_frame_cluster *cluster;
+  int i;
+
+  index = dwarf2_frame_get_index (current_program_space);
+
+  if (index->last_fde != NULL
+      && *pc >= index->last_low && *pc < index->last_high)
+    {
+      *pc = index->last_low;
+      if (out_offset)
+	*out_offset = index->last_offset;
+      return index->last_fde;
+    }
+
+  if (index->num_clusters == 0)
+    return NULL;
+
+  cluster = bsearch (pc, index->clusters, index->num_clusters,
+		     sizeof (index->clusters[0]), bsearch_cluster_cmp);
+  if (cluster == NULL)
+    return NULL;
+
+  for (i = 0; i < cluster->count; i++)
+    {
+      struct dwarf2_frame_extent *ext = &index->extents[cluster->first + i];
+      struct dwarf2_fde_table *fde_table = ext->fde_table;
+      struct dwarf2_fde **p_fde;
+      CORE_ADDR seek_pc;
+
+      if (*pc < ext->low || *pc >= ext->high)
+	continue;
+
+      seek_pc = *pc - ext->offset;
       p_fde = bsearch (&seek_pc, fde_table->entries, fde_table->num_entries,
                        sizeof (fde_table->entries[0]), bsearch_fde_cmp);
       if (p_fde != NULL)
         {
-          *pc = (*p_fde)->initial_location + offset;
+          *pc = (*p_fde)->initial_location + ext->offset;
 	  if (out_offset)
-	    *out_offset = offset;
+	    *out_offset = ext->offset;
+
+	  if (i == 0)
+	    {
+	      index->last_fde = *p_fde;
+	      index->last_low = *pc;
+	      index->last_high = *pc + (*p_fde)->address_range;
+	      index->last_offset = ext->offset;
+	    }
+
           return *p_fde;
         }
     }
@@ -1896,6 +2443,7 @@ decode_frame_entry_1 (struct comp_unit *unit, gdb_byte *start, int eh_frame_p,
       fde = (struct dwarf2_fde *)
 	obstack_alloc (&unit->objfile->objfile_obstack,
 		       sizeof (struct dwarf2_fde));
+      fde->rows = NULL;
       fde->cie = find_cie (cie_table, cie_pointer);
       if (fde->cie == NULL)
 	{
@@ -2222,4 +2770,7 @@ _initialize_dwarf2_frame (void)
 {
   dwarf2_frame_data = gdbarch_data_register_pre_init (dwarf2_frame_init);
   dwarf2_frame_objfile_data = register_objfile_data ();
+  dwarf2_frame_pspace_data
+    = register_program_space_data_with_cleanup
+	(dwarf2_frame_pspace_data_cleanup);
 }
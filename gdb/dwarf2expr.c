@@ -27,6 +27,8 @@
 #include "gdbcore.h"
 #include "dwarf2.h"
 #include "dwarf2expr.h"
+#include "exceptions.h"
+#include "gdb_obstack.h"
 #include "gdb_assert.h"
 
 /* Local prototypes.  */
@@ -312,34 +314,818 @@ read_sleb128 (const gdb_byte *buf, const gdb_byte *buf_end, LONGEST * r)
 
 
 /* Check that the current operator is either at the end of an
-   expression, or that it is followed by a composition operator.  */
+   expression, or that it is followed by a composition operator.
+   NEXT_OP is the operator following it, or -1 at the end.  */
 
-void
-dwarf_expr_require_composition (const gdb_byte *op_ptr, const gdb_byte *op_end,
-				const char *op_name)
+static void
+require_composition (int next_op, const char *op_name)
 {
   /* It seems like DW_OP_GNU_uninit should be handled here.  However,
      it doesn't seem to make sense for DW_OP_*_value, and it was not
      checked at the other place that this function is called.  */
-  if (op_ptr != op_end && *op_ptr != DW_OP_piece && *op_ptr != DW_OP_bit_piece)
+  if (next_op != -1 && next_op != DW_OP_piece && next_op != DW_OP_bit_piece)
     error (_("DWARF-2 expression error: `%s' operations must be "
 	     "used either alone or in conjuction with DW_OP_piece "
 	     "or DW_OP_bit_piece."),
 	   op_name);
 }
 
-/* The engine for the expression evaluator.  Using the context in CTX,
-   evaluate the expression between OP_PTR and OP_END.  */
+/* Check that the current operator is either at the end of an
+   expression, or that it is followed by a composition operator.  */
 
-static void
-execute_stack_op (struct dwarf_expr_context *ctx,
-		  const gdb_byte *op_ptr, const gdb_byte *op_end)
+void
+dwarf_expr_require_composition (const gdb_byte *op_ptr, const gdb_byte *op_end,
+				const char *op_name)
+{
+  require_composition (op_ptr != op_end ? *op_ptr : -1, op_name);
+}
+
+/* An operation of a DWARF expression, with its operands decoded.  */
+
+struct dwarf_expr_op
+{
+  /* The operation.  */
+  enum dwarf_location_atom op;
+
+  /* The operation that follows it in the expression, or -1 if it is
+     the last one; some operations must be followed by particular
+     ones.  */
+  int next_op;
+
+  /* The operands.  Constants and the unsigned operand go in UARG,
+     offsets and the signed operand in SARG.  DW_OP_bregx puts the
+     register in UARG, and DW_OP_bit_piece the offset in SARG.  */
+  ULONGEST uarg;
+  LONGEST sarg;
+
+  /* The data of DW_OP_implicit_value.  */
+  const gdb_byte *data;
+
+  /* In a program, the index of the operation DW_OP_skip and DW_OP_bra
+     branch to.  */
+  int target;
+};
+
+/* A DWARF expression, decoded once so that evaluating it again needs
+   no decoding.  */
+
+struct dwarf_expr_program
+{
+  /* The expression.  */
+  const gdb_byte *data;
+  size_t len;
+
+  /* The address size it was decoded for.  */
+  int addr_size;
+
+  /* Non-zero if the expression could be decoded ahead of time.  If
+     not, it is interpreted from DATA when evaluated, so that any
+     error happens when it is reached, as usual.  */
+  int decoded_p;
+
+  /* The decoded operations.  */
+  struct dwarf_expr_op *ops;
+  int num_ops;
+};
+
+/* Decode the operation at OP_PTR, in an expression ending at OP_END
+   for a target with addresses of ADDR_SIZE bytes and BYTE_ORDER,
+   into *DOP.  Return a pointer past the operation.  */
+
+static const gdb_byte *
+decode_op (int addr_size, enum bfd_endian byte_order,
+	   const gdb_byte *op_ptr, const gdb_byte *op_end,
+	   struct dwarf_expr_op *dop)
+{
+  enum dwarf_location_atom op = *op_ptr++;
+  ULONGEST uoffset;
+  LONGEST offset;
+
+  dop->op = op;
+  dop->uarg = 0;
+  dop->sarg = 0;
+  dop->data = NULL;
+  dop->target = 0;
+
+  switch (op)
+    {
+    case DW_OP_addr:
+      dop->uarg = extract_unsigned_integer (op_ptr, addr_size, byte_order);
+      op_ptr += addr_size;
+      break;
+
+    case DW_OP_const1u:
+      dop->uarg = extract_unsigned_integer (op_ptr, 1, byte_order);
+      op_ptr += 1;
+      break;
+    case DW_OP_const1s:
+      dop->uarg = extract_signed_integer (op_ptr, 1, byte_order);
+      op_ptr += 1;
+      break;
+    case DW_OP_const2u:
+      dop->uarg = extract_unsigned_integer (op_ptr, 2, byte_order);
+      op_ptr += 2;
+      break;
+    case DW_OP_const2s:
+      dop->uarg = extract_signed_integer (op_ptr, 2, byte_order);
+      op_ptr += 2;
+      break;
+    case DW_OP_const4u:
+      dop->uarg = extract_unsigned_integer (op_ptr, 4, byte_order);
+      op_ptr += 4;
+      break;
+    case DW_OP_const4s:
+      dop->uarg = extract_signed_integer (op_ptr, 4, byte_order);
+      op_ptr += 4;
+      break;
+    case DW_OP_const8u:
+      dop->uarg = extract_unsigned_integer (op_ptr, 8, byte_order);
+      op_ptr += 8;
+      break;
+    case DW_OP_const8s:
+      dop->uarg = extract_signed_integer (op_ptr, 8, byte_order);
+      op_ptr += 8;
+      break;
+    case DW_OP_constu:
+      op_ptr = read_uleb128 (op_ptr, op_end, &uoffset);
+      dop->uarg = uoffset;
+      break;
+    case DW_OP_consts:
+      op_ptr = read_sleb128 (op_ptr, op_end, &offset);
+      dop->uarg = offset;
+      break;
+
+    case DW_OP_regx:
+    case DW_OP_plus_uconst:
+    case DW_OP_piece:
+      op_ptr = read_uleb128 (op_ptr, op_end, &dop->uarg);
+      break;
+
+    case DW_OP_implicit_value:
+      op_ptr = read_uleb128 (op_ptr, op_end, &dop->uarg);
+      if (op_ptr + dop->uarg > op_end)
+	error (_("DW_OP_implicit_value: too few bytes available."));
+      dop->data = op_ptr;
+      op_ptr += dop->uarg;
+      break;
+
+    case DW_OP_breg0:
+    case DW_OP_breg1:
+    case DW_OP_breg2:
+    case DW_OP_breg3:
+    case DW_OP_breg4:
+    case DW_OP_breg5:
+    case DW_OP_breg6:
+    case DW_OP_breg7:
+    case DW_OP_breg8:
+    case DW_OP_breg9:
+    case DW_OP_breg10:
+    case DW_OP_breg11:
+    case DW_OP_breg12:
+    case DW_OP_breg13:
+    case DW_OP_breg14:
+    case DW_OP_breg15:
+    case DW_OP_breg16:
+    case DW_OP_breg17:
+    case DW_OP_breg18:
+    case DW_OP_breg19:
+    case DW_OP_breg20:
+    case DW_OP_breg21:
+    case DW_OP_breg22:
+    case DW_OP_breg23:
+    case DW_OP_breg24:
+    case DW_OP_breg25:
+    case DW_OP_breg26:
+    case DW_OP_breg27:
+    case DW_OP_breg28:
+    case DW_OP_breg29:
+    case DW_OP_breg30:
+    case DW_OP_breg31:
+    case DW_OP_fbreg:
+      op_ptr = read_sleb128 (op_ptr, op_end, &dop->sarg);
+      break;
+
+    case DW_OP_bregx:
+      op_ptr = read_uleb128 (op_ptr, op_end, &dop->uarg);
+      op_ptr = read_sleb128 (op_ptr, op_end, &dop->sarg);
+      break;
+
+    case DW_OP_pick:
+      dop->sarg = *op_ptr++;
+      break;
+
+    case DW_OP_deref:
+      dop->uarg = addr_size;
+      break;
+    case DW_OP_deref_size:
+      dop->uarg = *op_ptr++;
+      break;
+
+    case DW_OP_skip:
+    case DW_OP_bra:
+      dop->sarg = extract_signed_integer (op_ptr, 2, byte_order);
+      op_ptr += 2;
+      break;
+
+    case DW_OP_bit_piece:
+      op_ptr = read_uleb128 (op_ptr, op_end, &dop->uarg);
+      op_ptr = read_uleb128 (op_ptr, op_end, &uoffset);
+      dop->sarg = uoffset;
+      break;
+
+    case DW_OP_call2:
+      dop->uarg = extract_unsigned_integer (op_ptr, 2, byte_order);
+      op_ptr += 2;
+      break;
+    case DW_OP_call4:
+      dop->uarg = extract_unsigned_integer (op_ptr, 4, byte_order);
+      op_ptr += 4;
+      break;
+
+    case DW_OP_lit0:
+    case DW_OP_lit1:
+    case DW_OP_lit2:
+    case DW_OP_lit3:
+    case DW_OP_lit4:
+    case DW_OP_lit5:
+    case DW_OP_lit6:
+    case DW_OP_lit7:
+    case DW_OP_lit8:
+    case DW_OP_lit9:
+    case DW_OP_lit10:
+    case DW_OP_lit11:
+    case DW_OP_lit12:
+    case DW_OP_lit13:
+    case DW_OP_lit14:
+    case DW_OP_lit15:
+    case DW_OP_lit16:
+    case DW_OP_lit17:
+    case DW_OP_lit18:
+    case DW_OP_lit19:
+    case DW_OP_lit20:
+    case DW_OP_lit21:
+    case DW_OP_lit22:
+    case DW_OP_lit23:
+    case DW_OP_lit24:
+    case DW_OP_lit25:
+    case DW_OP_lit26:
+    case DW_OP_lit27:
+    case DW_OP_lit28:
+    case DW_OP_lit29:
+    case DW_OP_lit30:
+    case DW_OP_lit31:
+    case DW_OP_reg0:
+    case DW_OP_reg1:
+    case DW_OP_reg2:
+    case DW_OP_reg3:
+    case DW_OP_reg4:
+    case DW_OP_reg5:
+    case DW_OP_reg6:
+    case DW_OP_reg7:
+    case DW_OP_reg8:
+    case DW_OP_reg9:
+    case DW_OP_reg10:
+    case DW_OP_reg11:
+    case DW_OP_reg12:
+    case DW_OP_reg13:
+    case DW_OP_reg14:
+    case DW_OP_reg15:
+    case DW_OP_reg16:
+    case DW_OP_reg17:
+    case DW_OP_reg18:
+    case DW_OP_reg19:
+    case DW_OP_reg20:
+    case DW_OP_reg21:
+    case DW_OP_reg22:
+    case DW_OP_reg23:
+    case DW_OP_reg24:
+    case DW_OP_reg25:
+    case DW_OP_reg26:
+    case DW_OP_reg27:
+    case DW_OP_reg28:
+    case DW_OP_reg29:
+    case DW_OP_reg30:
+    case DW_OP_reg31:
+    case DW_OP_stack_value:
+    case DW_OP_dup:
+    case DW_OP_drop:
+    case DW_OP_swap:
+    case DW_OP_over:
+    case DW_OP_rot:
+    case DW_OP_abs:
+    case DW_OP_neg:
+    case DW_OP_not:
+    case DW_OP_and:
+    case DW_OP_div:
+    case DW_OP_minus:
+    case DW_OP_mod:
+    case DW_OP_mul:
+    case DW_OP_or:
+    case DW_OP_plus:
+    case DW_OP_shl:
+    case DW_OP_shr:
+    case DW_OP_shra:
+    case DW_OP_xor:
+    case DW_OP_le:
+    case DW_OP_ge:
+    case DW_OP_eq:
+    case DW_OP_lt:
+    case DW_OP_gt:
+    case DW_OP_ne:
+    case DW_OP_call_frame_cfa:
+    case DW_OP_GNU_push_tls_address:
+    case DW_OP_nop:
+    case DW_OP_GNU_uninit:
+      /* No operands.  */
+      break;
+
+    default:
+      error (_("Unhandled dwarf expression opcode 0x%x"), op);
+    }
+
+  dop->next_op = op_ptr < op_end ? *op_ptr : -1;
+  return op_ptr;
+}
+
+/* Execute the decoded operation DOP using the context in CTX.  Return
+   non-zero if it is a branch that is taken.  */
+
+static int
+execute_op (struct dwarf_expr_context *ctx, const struct dwarf_expr_op *dop)
 {
 #define sign_ext(x) ((LONGEST) (((x) ^ sign_bit) - sign_bit))
   ULONGEST sign_bit = (ctx->addr_size >= sizeof (ULONGEST) ? 0
 		       : ((ULONGEST) 1) << (ctx->addr_size * 8 - 1));
-  enum bfd_endian byte_order = gdbarch_byte_order (ctx->gdbarch);
+  enum dwarf_location_atom op = dop->op;
+  ULONGEST result;
+  /* Assume the value is not in stack memory.
+     Code that knows otherwise sets this to 1.
+     Some arithmetic on stack addresses can probably be assumed to still
+     be a stack address, but we skip this complication for now.
+     This is just an optimization, so it's always ok to punt
+     and leave this as 0.  */
+  int in_stack_memory = 0;
+  LONGEST offset;
+
+  switch (op)
+    {
+    case DW_OP_lit0:
+    case DW_OP_lit1:
+    case DW_OP_lit2:
+    case DW_OP_lit3:
+    case DW_OP_lit4:
+    case DW_OP_lit5:
+    case DW_OP_lit6:
+    case DW_OP_lit7:
+    case DW_OP_lit8:
+    case DW_OP_lit9:
+    case DW_OP_lit10:
+    case DW_OP_lit11:
+    case DW_OP_lit12:
+    case DW_OP_lit13:
+    case DW_OP_lit14:
+    case DW_OP_lit15:
+    case DW_OP_lit16:
+    case DW_OP_lit17:
+    case DW_OP_lit18:
+    case DW_OP_lit19:
+    case DW_OP_lit20:
+    case DW_OP_lit21:
+    case DW_OP_lit22:
+    case DW_OP_lit23:
+    case DW_OP_lit24:
+    case DW_OP_lit25:
+    case DW_OP_lit26:
+    case DW_OP_lit27:
+    case DW_OP_lit28:
+    case DW_OP_lit29:
+    case DW_OP_lit30:
+    case DW_OP_lit31:
+      result = op - DW_OP_lit0;
+      break;
+
+    case DW_OP_addr:
+      result = dop->uarg;
+      /* Some versions of GCC emit DW_OP_addr before
+	 DW_OP_GNU_push_tls_address.  In this case the value is an
+	 index, not an address.  We don't support things like
+	 branching between the address and the TLS op.  */
+      if (dop->next_op != DW_OP_GNU_push_tls_address)
+	result += ctx->offset;
+      break;
+
+    case DW_OP_const1u:
+    case DW_OP_const1s:
+    case DW_OP_const2u:
+    case DW_OP_const2s:
+    case DW_OP_const4u:
+    case DW_OP_const4s:
+    case DW_OP_const8u:
+    case DW_OP_const8s:
+    case DW_OP_constu:
+    case DW_OP_consts:
+      result = dop->uarg;
+      break;
+
+    /* The DW_OP_reg operations are required to occur alone in
+       location expressions.  */
+    case DW_OP_reg0:
+    case DW_OP_reg1:
+    case DW_OP_reg2:
+    case DW_OP_reg3:
+    case DW_OP_reg4:
+    case DW_OP_reg5:
+    case DW_OP_reg6:
+    case DW_OP_reg7:
+    case DW_OP_reg8:
+    case DW_OP_reg9:
+    case DW_OP_reg10:
+    case DW_OP_reg11:
+    case DW_OP_reg12:
+    case DW_OP_reg13:
+    case DW_OP_reg14:
+    case DW_OP_reg15:
+    case DW_OP_reg16:
+    case DW_OP_reg17:
+    case DW_OP_reg18:
+    case DW_OP_reg19:
+    case DW_OP_reg20:
+    case DW_OP_reg21:
+    case DW_OP_reg22:
+    case DW_OP_reg23:
+    case DW_OP_reg24:
+    case DW_OP_reg25:
+    case DW_OP_reg26:
+    case DW_OP_reg27:
+    case DW_OP_reg28:
+    case DW_OP_reg29:
+    case DW_OP_reg30:
+    case DW_OP_reg31:
+      if (dop->next_op != -1
+	  && dop->next_op != DW_OP_piece
+	  && dop->next_op != DW_OP_bit_piece
+	  && dop->next_op != DW_OP_GNU_uninit)
+	error (_("DWARF-2 expression error: DW_OP_reg operations must be "
+		 "used either alone or in conjuction with DW_OP_piece "
+		 "or DW_OP_bit_piece."));
+
+      result = op - DW_OP_reg0;
+      ctx->location = DWARF_VALUE_REGISTER;
+      break;
+
+    case DW_OP_regx:
+      require_composition (dop->next_op, "DW_OP_regx");
+
+      result = dop->uarg;
+      ctx->location = DWARF_VALUE_REGISTER;
+      break;
+
+    case DW_OP_implicit_value:
+      ctx->len = dop->uarg;
+      ctx->data = dop->data;
+      ctx->location = DWARF_VALUE_LITERAL;
+      require_composition (dop->next_op, "DW_OP_implicit_value");
+      return 0;
+
+    case DW_OP_stack_value:
+      ctx->location = DWARF_VALUE_STACK;
+      require_composition (dop->next_op, "DW_OP_stack_value");
+      return 0;
+
+    case DW_OP_breg0:
+    case DW_OP_breg1:
+    case DW_OP_breg2:
+    case DW_OP_breg3:
+    case DW_OP_breg4:
+    case DW_OP_breg5:
+    case DW_OP_breg6:
+    case DW_OP_breg7:
+    case DW_OP_breg8:
+    case DW_OP_breg9:
+    case DW_OP_breg10:
+    case DW_OP_breg11:
+    case DW_OP_breg12:
+    case DW_OP_breg13:
+    case DW_OP_breg14:
+    case DW_OP_breg15:
+    case DW_OP_breg16:
+    case DW_OP_breg17:
+    case DW_OP_breg18:
+    case DW_OP_breg19:
+    case DW_OP_breg20:
+    case DW_OP_breg21:
+    case DW_OP_breg22:
+    case DW_OP_breg23:
+    case DW_OP_breg24:
+    case DW_OP_breg25:
+    case DW_OP_breg26:
+    case DW_OP_breg27:
+    case DW_OP_breg28:
+    case DW_OP_breg29:
+    case DW_OP_breg30:
+    case DW_OP_breg31:
+      result = (ctx->read_reg) (ctx->baton, op - DW_OP_breg0);
+      result += dop->sarg;
+      break;
+    case DW_OP_bregx:
+      result = (ctx->read_reg) (ctx->baton, dop->uarg);
+      result += dop->sarg;
+      break;
+    case DW_OP_fbreg:
+      {
+	const gdb_byte *datastart;
+	size_t datalen;
+	unsigned int before_stack_len;
+
+	/* Rather than create a whole new context, we simply
+	   record the stack length before execution, then reset it
+	   afterwards, effectively erasing whatever the recursive
+	   call put there.  */
+	before_stack_len = ctx->stack_len;
+	/* FIXME: cagney/2003-03-26: This code should be using
+	   get_frame_base_address(), and then implement a dwarf2
+	   specific this_base method.  */
+	(ctx->get_frame_base) (ctx->baton, &datastart, &datalen);
+	dwarf_expr_eval (ctx, datastart, datalen);
+	if (ctx->location == DWARF_VALUE_MEMORY)
+	  result = dwarf_expr_fetch_address (ctx, 0);
+	else if (ctx->location == DWARF_VALUE_REGISTER)
+	  result = (ctx->read_reg) (ctx->baton, dwarf_expr_fetch (ctx, 0));
+	else
+	  error (_("Not implemented: computing frame base using explicit value operator"));
+	result = result + dop->sarg;
+	in_stack_memory = 1;
+	ctx->stack_len = before_stack_len;
+	ctx->location = DWARF_VALUE_MEMORY;
+      }
+      break;
+
+    case DW_OP_dup:
+      result = dwarf_expr_fetch (ctx, 0);
+      in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, 0);
+      break;
+
+    case DW_OP_drop:
+      dwarf_expr_pop (ctx);
+      return 0;
+
+    case DW_OP_pick:
+      offset = dop->sarg;
+      result = dwarf_expr_fetch (ctx, offset);
+      in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, offset);
+      break;
+
+    case DW_OP_swap:
+      {
+	struct dwarf_stack_value t1, t2;
+
+	if (ctx->stack_len < 2)
+	   error (_("Not enough elements for DW_OP_swap. Need 2, have %d."),
+		  ctx->stack_len);
+	t1 = ctx->stack[ctx->stack_len - 1];
+	t2 = ctx->stack[ctx->stack_len - 2];
+	ctx->stack[ctx->stack_len - 1] = t2;
+	ctx->stack[ctx->stack_len - 2] = t1;
+	return 0;
+      }
+
+    case DW_OP_over:
+      result = dwarf_expr_fetch (ctx, 1);
+      in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, 1);
+      break;
+
+    case DW_OP_rot:
+      {
+	struct dwarf_stack_value t1, t2, t3;
+
+	if (ctx->stack_len < 3)
+	   error (_("Not enough elements for DW_OP_rot. Need 3, have %d."),
+		  ctx->stack_len);
+	t1 = ctx->stack[ctx->stack_len - 1];
+	t2 = ctx->stack[ctx->stack_len - 2];
+	t3 = ctx->stack[ctx->stack_len - 3];
+	ctx->stack[ctx->stack_len - 1] = t2;
+	ctx->stack[ctx->stack_len - 2] = t3;
+	ctx->stack[ctx->stack_len - 3] = t1;
+	return 0;
+      }
+
+    case DW_OP_deref:
+    case DW_OP_deref_size:
+      {
+	int addr_size = dop->uarg;
+	gdb_byte *buf = alloca (addr_size);
+	CORE_ADDR addr = dwarf_expr_fetch_address (ctx, 0);
+	dwarf_expr_pop (ctx);
+
+	(ctx->read_mem) (ctx->baton, buf, addr, addr_size);
+	result = extract_unsigned_integer (buf, addr_size,
+					   gdbarch_byte_order (ctx->gdbarch));
+	break;
+      }
+
+    case DW_OP_abs:
+    case DW_OP_neg:
+    case DW_OP_not:
+    case DW_OP_plus_uconst:
+      /* Unary operations.  */
+      result = dwarf_expr_fetch (ctx, 0);
+      dwarf_expr_pop (ctx);
+
+      switch (op)
+	{
+	case DW_OP_abs:
+	  if (sign_ext (result) < 0)
+	    result = -result;
+	  break;
+	case DW_OP_neg:
+	  result = -result;
+	  break;
+	case DW_OP_not:
+	  result = ~result;
+	  break;
+	case DW_OP_plus_uconst:
+	  result += dop->uarg;
+	  break;
+	}
+      break;
+
+    case DW_OP_and:
+    case DW_OP_div:
+    case DW_OP_minus:
+    case DW_OP_mod:
+    case DW_OP_mul:
+    case DW_OP_or:
+    case DW_OP_plus:
+    case DW_OP_shl:
+    case DW_OP_shr:
+    case DW_OP_shra:
+    case DW_OP_xor:
+    case DW_OP_le:
+    case DW_OP_ge:
+    case DW_OP_eq:
+    case DW_OP_lt:
+    case DW_OP_gt:
+    case DW_OP_ne:
+      {
+	/* Binary operations.  */
+	ULONGEST first, second;
+
+	second = dwarf_expr_fetch (ctx, 0);
+	dwarf_expr_pop (ctx);
+
+	first = dwarf_expr_fetch (ctx, 0);
+	dwarf_expr_pop (ctx);
+
+	switch (op)
+	  {
+	  case DW_OP_and:
+	    result = first & second;
+	    break;
+	  case DW_OP_div:
+	    if (!second)
+	      error (_("Division by zero"));
+	    result = sign_ext (first) / sign_ext (second);
+	    break;
+	  case DW_OP_minus:
+	    result = first - second;
+	    break;
+	  case DW_OP_mod:
+	    if (!second)
+	      error (_("Division by zero"));
+	    result = first % second;
+	    break;
+	  case DW_OP_mul:
+	    result = first * second;
+	    break;
+	  case DW_OP_or:
+	    result = first | second;
+	    break;
+	  case DW_OP_plus:
+	    result = first + second;
+	    break;
+	  case DW_OP_shl:
+	    result = first << second;
+	    break;
+	  case DW_OP_shr:
+	    result = first >> second;
+	    break;
+	  case DW_OP_shra:
+	    result = sign_ext (first) >> second;
+	    break;
+	  case DW_OP_xor:
+	    result = first ^ second;
+	    break;
+	  case DW_OP_le:
+	    result = sign_ext (first) <= sign_ext (second);
+	    break;
+	  case DW_OP_ge:
+	    result = sign_ext (first) >= sign_ext (second);
+	    break;
+	  case DW_OP_eq:
+	    result = sign_ext (first) == sign_ext (second);
+	    break;
+	  case DW_OP_lt:
+	    result = sign_ext (first) < sign_ext (second);
+	    break;
+	  case DW_OP_gt:
+	    result = sign_ext (first) > sign_ext (second);
+	    break;
+	  case DW_OP_ne:
+	    result = sign_ext (first) != sign_ext (second);
+	    break;
+	  default:
+	    internal_error (__FILE__, __LINE__,
+			    _("Can't be reached."));
+	  }
+      }
+      break;
+
+    case DW_OP_call_frame_cfa:
+      result = (ctx->get_frame_cfa) (ctx->baton);
+      in_stack_memory = 1;
+      break;
+
+    case DW_OP_GNU_push_tls_address:
+      /* Variable is at a constant offset in the thread-local
+      storage block into the objfile for the current thread and
+      the dynamic linker module containing this expression. Here
+      we return returns the offset from that base.  The top of the
+      stack has the offset from the beginning of the thread
+      control block at which the variable is located.  Nothing
+      should follow this operator, so the top of stack would be
+      returned.  */
+      result = dwarf_expr_fetch (ctx, 0);
+      dwarf_expr_pop (ctx);
+      result = (ctx->get_tls_address) (ctx->baton, result);
+      break;
+
+    case DW_OP_skip:
+      return 1;
+
+    case DW_OP_bra:
+      {
+	int taken = dwarf_expr_fetch (ctx, 0) != 0;
+
+	dwarf_expr_pop (ctx);
+	return taken;
+      }
+
+    case DW_OP_nop:
+      return 0;
+
+    case DW_OP_piece:
+      /* Record the piece.  */
+      add_piece (ctx, 8 * dop->uarg, 0);
+
+      /* Pop off the address/regnum, and reset the location
+	 type.  */
+      if (ctx->location != DWARF_VALUE_LITERAL
+	  && ctx->location != DWARF_VALUE_OPTIMIZED_OUT)
+	dwarf_expr_pop (ctx);
+      ctx->location = DWARF_VALUE_MEMORY;
+      return 0;
+
+    case DW_OP_bit_piece:
+      /* Record the piece.  */
+      add_piece (ctx, dop->uarg, dop->sarg);
+
+      /* Pop off the address/regnum, and reset the location
+	 type.  */
+      if (ctx->location != DWARF_VALUE_LITERAL
+	  && ctx->location != DWARF_VALUE_OPTIMIZED_OUT)
+	dwarf_expr_pop (ctx);
+      ctx->location = DWARF_VALUE_MEMORY;
+      return 0;
+
+    case DW_OP_GNU_uninit:
+      if (dop->next_op != -1)
+	error (_("DWARF-2 expression error: DW_OP_GNU_uninit must always "
+	       "be the very last op."));
+
+      ctx->initialized = 0;
+      return 0;
+
+    case DW_OP_call2:
+    case DW_OP_call4:
+      ctx->dwarf_call (ctx, dop->uarg);
+      return 0;
+
+    default:
+      error (_("Unhandled dwarf expression opcode 0x%x"), op);
+    }
+
+  /* Most things push a result value.  */
+  dwarf_expr_push (ctx, result, in_stack_memory);
+  return 0;
+#undef sign_ext
+}
+
+/* Prepare CTX for evaluating an expression.  */
 
+static void
+execute_begin (struct dwarf_expr_context *ctx)
+{
   ctx->location = DWARF_VALUE_MEMORY;
   ctx->initialized = 1;  /* Default is initialized.  */
 
@@ -347,544 +1133,193 @@ execute_stack_op (struct dwarf_expr_context *ctx,
     error (_("DWARF-2 expression error: Loop detected (%d)."),
 	   ctx->recursion_depth);
   ctx->recursion_depth++;
+}
+
+/* Finish evaluating an expression in CTX.  */
+
+static void
+execute_end (struct dwarf_expr_context *ctx)
+{
+  ctx->recursion_depth--;
+  gdb_assert (ctx->recursion_depth >= 0);
+}
+
+/* The engine for the expression evaluator.  Using the context in CTX,
+   evaluate the expression between OP_PTR and OP_END.  */
+
+static void
+execute_stack_op (struct dwarf_expr_context *ctx,
+		  const gdb_byte *op_ptr, const gdb_byte *op_end)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (ctx->gdbarch);
+
+  execute_begin (ctx);
 
   while (op_ptr < op_end)
     {
-      enum dwarf_location_atom op = *op_ptr++;
-      ULONGEST result;
-      /* Assume the value is not in stack memory.
-	 Code that knows otherwise sets this to 1.
-	 Some arithmetic on stack addresses can probably be assumed to still
-	 be a stack address, but we skip this complication for now.
-	 This is just an optimization, so it's always ok to punt
-	 and leave this as 0.  */
-      int in_stack_memory = 0;
-      ULONGEST uoffset, reg;
-      LONGEST offset;
+      struct dwarf_expr_op dop;
 
-      switch (op)
-	{
-	case DW_OP_lit0:
-	case DW_OP_lit1:
-	case DW_OP_lit2:
-	case DW_OP_lit3:
-	case DW_OP_lit4:
-	case DW_OP_lit5:
-	case DW_OP_lit6:
-	case DW_OP_lit7:
-	case DW_OP_lit8:
-	case DW_OP_lit9:
-	case DW_OP_lit10:
-	case DW_OP_lit11:
-	case DW_OP_lit12:
-	case DW_OP_lit13:
-	case DW_OP_lit14:
-	case DW_OP_lit15:
-	case DW_OP_lit16:
-	case DW_OP_lit17:
-	case DW_OP_lit18:
-	case DW_OP_lit19:
-	case DW_OP_lit20:
-	case DW_OP_lit21:
-	case DW_OP_lit22:
-	case DW_OP_lit23:
-	case DW_OP_lit24:
-	case DW_OP_lit25:
-	case DW_OP_lit26:
-	case DW_OP_lit27:
-	case DW_OP_lit28:
-	case DW_OP_lit29:
-	case DW_OP_lit30:
-	case DW_OP_lit31:
-	  result = op - DW_OP_lit0;
-	  break;
+      op_ptr = decode_op (ctx->addr_size, byte_order, op_ptr, op_end, &dop);
+      if (execute_op (ctx, &dop))
+	op_ptr += dop.sarg;
+    }
 
-	case DW_OP_addr:
-	  result = extract_unsigned_integer (op_ptr,
-					     ctx->addr_size, byte_order);
-	  op_ptr += ctx->addr_size;
-	  /* Some versions of GCC emit DW_OP_addr before
-	     DW_OP_GNU_push_tls_address.  In this case the value is an
-	     index, not an address.  We don't support things like
-	     branching between the address and the TLS op.  */
-	  if (op_ptr >= op_end || *op_ptr != DW_OP_GNU_push_tls_address)
-	    result += ctx->offset;
-	  break;
+  execute_end (ctx);
+}
 
-	case DW_OP_const1u:
-	  result = extract_unsigned_integer (op_ptr, 1, byte_order);
-	  op_ptr += 1;
-	  break;
-	case DW_OP_const1s:
-	  result = extract_signed_integer (op_ptr, 1, byte_order);
-	  op_ptr += 1;
-	  break;
-	case DW_OP_const2u:
-	  result = extract_unsigned_integer (op_ptr, 2, byte_order);
-	  op_ptr += 2;
-	  break;
-	case DW_OP_const2s:
-	  result = extract_signed_integer (op_ptr, 2, byte_order);
-	  op_ptr += 2;
-	  break;
-	case DW_OP_const4u:
-	  result = extract_unsigned_integer (op_ptr, 4, byte_order);
-	  op_ptr += 4;
-	  break;
-	case DW_OP_const4s:
-	  result = extract_signed_integer (op_ptr, 4, byte_order);
-	  op_ptr += 4;
-	  break;
-	case DW_OP_const8u:
-	  result = extract_unsigned_integer (op_ptr, 8, byte_order);
-	  op_ptr += 8;
-	  break;
-	case DW_OP_const8s:
-	  result = extract_signed_integer (op_ptr, 8, byte_order);
-	  op_ptr += 8;
-	  break;
-	case DW_OP_constu:
-	  op_ptr = read_uleb128 (op_ptr, op_end, &uoffset);
-	  result = uoffset;
-	  break;
-	case DW_OP_consts:
-	  op_ptr = read_sleb128 (op_ptr, op_end, &offset);
-	  result = offset;
-	  break;
+/* Evaluate the decoded operations of PROGRAM using the context in
+   CTX.  */
 
-	/* The DW_OP_reg operations are required to occur alone in
-	   location expressions.  */
-	case DW_OP_reg0:
-	case DW_OP_reg1:
-	case DW_OP_reg2:
-	case DW_OP_reg3:
-	case DW_OP_reg4:
-	case DW_OP_reg5:
-	case DW_OP_reg6:
-	case DW_OP_reg7:
-	case DW_OP_reg8:
-	case DW_OP_reg9:
-	case DW_OP_reg10:
-	case DW_OP_reg11:
-	case DW_OP_reg12:
-	case DW_OP_reg13:
-	case DW_OP_reg14:
-	case DW_OP_reg15:
-	case DW_OP_reg16:
-	case DW_OP_reg17:
-	case DW_OP_reg18:
-	case DW_OP_reg19:
-	case DW_OP_reg20:
-	case DW_OP_reg21:
-	case DW_OP_reg22:
-	case DW_OP_reg23:
-	case DW_OP_reg24:
-	case DW_OP_reg25:
-	case DW_OP_reg26:
-	case DW_OP_reg27:
-	case DW_OP_reg28:
-	case DW_OP_reg29:
-	case DW_OP_reg30:
-	case DW_OP_reg31:
-	  if (op_ptr != op_end 
-	      && *op_ptr != DW_OP_piece
-	      && *op_ptr != DW_OP_bit_piece
-	      && *op_ptr != DW_OP_GNU_uninit)
-	    error (_("DWARF-2 expression error: DW_OP_reg operations must be "
-		     "used either alone or in conjuction with DW_OP_piece "
-		     "or DW_OP_bit_piece."));
-
-	  result = op - DW_OP_reg0;
-	  ctx->location = DWARF_VALUE_REGISTER;
-	  break;
+static void
+execute_program (struct dwarf_expr_context *ctx,
+		 const struct dwarf_expr_program *program)
+{
+  int i = 0;
 
-	case DW_OP_regx:
-	  op_ptr = read_uleb128 (op_ptr, op_end, &reg);
-	  dwarf_expr_require_composition (op_ptr, op_end, "DW_OP_regx");
+  execute_begin (ctx);
 
-	  result = reg;
-	  ctx->location = DWARF_VALUE_REGISTER;
-	  break;
-
-	case DW_OP_implicit_value:
-	  {
-	    ULONGEST len;
-
-	    op_ptr = read_uleb128 (op_ptr, op_end, &len);
-	    if (op_ptr + len > op_end)
-	      error (_("DW_OP_implicit_value: too few bytes available."));
-	    ctx->len = len;
-	    ctx->data = op_ptr;
-	    ctx->location = DWARF_VALUE_LITERAL;
-	    op_ptr += len;
-	    dwarf_expr_require_composition (op_ptr, op_end,
-					    "DW_OP_implicit_value");
-	  }
-	  goto no_push;
-
-	case DW_OP_stack_value:
-	  ctx->location = DWARF_VALUE_STACK;
-	  dwarf_expr_require_composition (op_ptr, op_end, "DW_OP_stack_value");
-	  goto no_push;
-
-	case DW_OP_breg0:
-	case DW_OP_breg1:
-	case DW_OP_breg2:
-	case DW_OP_breg3:
-	case DW_OP_breg4:
-	case DW_OP_breg5:
-	case DW_OP_breg6:
-	case DW_OP_breg7:
-	case DW_OP_breg8:
-	case DW_OP_breg9:
-	case DW_OP_breg10:
-	case DW_OP_breg11:
-	case DW_OP_breg12:
-	case DW_OP_breg13:
-	case DW_OP_breg14:
-	case DW_OP_breg15:
-	case DW_OP_breg16:
-	case DW_OP_breg17:
-	case DW_OP_breg18:
-	case DW_OP_breg19:
-	case DW_OP_breg20:
-	case DW_OP_breg21:
-	case DW_OP_breg22:
-	case DW_OP_breg23:
-	case DW_OP_breg24:
-	case DW_OP_breg25:
-	case DW_OP_breg26:
-	case DW_OP_breg27:
-	case DW_OP_breg28:
-	case DW_OP_breg29:
-	case DW_OP_breg30:
-	case DW_OP_breg31:
-	  {
-	    op_ptr = read_sleb128 (op_ptr, op_end, &offset);
-	    result = (ctx->read_reg) (ctx->baton, op - DW_OP_breg0);
-	    result += offset;
-	  }
-	  break;
-	case DW_OP_bregx:
-	  {
-	    op_ptr = read_uleb128 (op_ptr, op_end, &reg);
-	    op_ptr = read_sleb128 (op_ptr, op_end, &offset);
-	    result = (ctx->read_reg) (ctx->baton, reg);
-	    result += offset;
-	  }
-	  break;
-	case DW_OP_fbreg:
-	  {
-	    const gdb_byte *datastart;
-	    size_t datalen;
-	    unsigned int before_stack_len;
-
-	    op_ptr = read_sleb128 (op_ptr, op_end, &offset);
-	    /* Rather than create a whole new context, we simply
-	       record the stack length before execution, then reset it
-	       afterwards, effectively erasing whatever the recursive
-	       call put there.  */
-	    before_stack_len = ctx->stack_len;
-	    /* FIXME: cagney/2003-03-26: This code should be using
-               get_frame_base_address(), and then implement a dwarf2
-               specific this_base method.  */
-	    (ctx->get_frame_base) (ctx->baton, &datastart, &datalen);
-	    dwarf_expr_eval (ctx, datastart, datalen);
-	    if (ctx->location == DWARF_VALUE_MEMORY)
-	      result = dwarf_expr_fetch_address (ctx, 0);
-	    else if (ctx->location == DWARF_VALUE_REGISTER)
-	      result = (ctx->read_reg) (ctx->baton, dwarf_expr_fetch (ctx, 0));
-	    else
-	      error (_("Not implemented: computing frame base using explicit value operator"));
-	    result = result + offset;
-	    in_stack_memory = 1;
-	    ctx->stack_len = before_stack_len;
-	    ctx->location = DWARF_VALUE_MEMORY;
-	  }
-	  break;
+  while (i < program->num_ops)
+    {
+      const struct dwarf_expr_op *dop = &program->ops[i];
 
-	case DW_OP_dup:
-	  result = dwarf_expr_fetch (ctx, 0);
-	  in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, 0);
-	  break;
+      if (execute_op (ctx, dop))
+	i = dop->target;
+      else
+	i++;
+    }
 
-	case DW_OP_drop:
-	  dwarf_expr_pop (ctx);
-	  goto no_push;
+  execute_end (ctx);
+}
 
-	case DW_OP_pick:
-	  offset = *op_ptr++;
-	  result = dwarf_expr_fetch (ctx, offset);
-	  in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, offset);
-	  break;
-	  
-	case DW_OP_swap:
-	  {
-	    struct dwarf_stack_value t1, t2;
-
-	    if (ctx->stack_len < 2)
-	       error (_("Not enough elements for DW_OP_swap. Need 2, have %d."),
-		      ctx->stack_len);
-	    t1 = ctx->stack[ctx->stack_len - 1];
-	    t2 = ctx->stack[ctx->stack_len - 2];
-	    ctx->stack[ctx->stack_len - 1] = t2;
-	    ctx->stack[ctx->stack_len - 2] = t1;
-	    goto no_push;
-	  }
+/* Decode the expression of PROGRAM, of LEN bytes at DATA, into OPS
+   and NUM_OPS, xmalloc'ed, and START, the offset of each operation
+   plus a final entry for the end.  Throw an error if it cannot be
+   decoded.  */
 
-	case DW_OP_over:
-	  result = dwarf_expr_fetch (ctx, 1);
-	  in_stack_memory = dwarf_expr_fetch_in_stack_memory (ctx, 1);
-	  break;
+static void
+decode_program (struct dwarf_expr_program *program,
+		enum bfd_endian byte_order, int *start)
+{
+  const gdb_byte *op_ptr = program->data;
+  const gdb_byte *op_end = program->data + program->len;
+  int i, n = 0;
 
-	case DW_OP_rot:
-	  {
-	    struct dwarf_stack_value t1, t2, t3;
-
-	    if (ctx->stack_len < 3)
-	       error (_("Not enough elements for DW_OP_rot. Need 3, have %d."),
-		      ctx->stack_len);
-	    t1 = ctx->stack[ctx->stack_len - 1];
-	    t2 = ctx->stack[ctx->stack_len - 2];
-	    t3 = ctx->stack[ctx->stack_len - 3];
-	    ctx->stack[ctx->stack_len - 1] = t2;
-	    ctx->stack[ctx->stack_len - 2] = t3;
-	    ctx->stack[ctx->stack_len - 3] = t1;
-	    goto no_push;
-	  }
+  while (op_ptr < op_end)
+    {
+      start[n] = op_ptr - program->data;
+      op_ptr = decode_op (program->addr_size, byte_order, op_ptr, op_end,
+			  &program->ops[n]);
+      n++;
+
+      /* Operands with a fixed size are not checked against the end
+	 of the expression when decoding.  */
+      if (op_ptr > op_end)
+	error (_("Corrupted DWARF expression."));
+    }
+  start[n] = program->len;
+  program->num_ops = n;
 
-	case DW_OP_deref:
-	case DW_OP_deref_size:
-	  {
-	    int addr_size = (op == DW_OP_deref ? ctx->addr_size : *op_ptr++);
-	    gdb_byte *buf = alloca (addr_size);
-	    CORE_ADDR addr = dwarf_expr_fetch_address (ctx, 0);
-	    dwarf_expr_pop (ctx);
+  /* Turn the byte offsets of the branches into operation indices.  */
+  for (i = 0; i < n; i++)
+    {
+      struct dwarf_expr_op *dop = &program->ops[i];
+      LONGEST dest;
+      int lo, hi;
 
-	    (ctx->read_mem) (ctx->baton, buf, addr, addr_size);
-	    result = extract_unsigned_integer (buf, addr_size, byte_order);
-	    break;
-	  }
+      if (dop->op != DW_OP_skip && dop->op != DW_OP_bra)
+	continue;
 
-	case DW_OP_abs:
-	case DW_OP_neg:
-	case DW_OP_not:
-	case DW_OP_plus_uconst:
-	  /* Unary operations.  */
-	  result = dwarf_expr_fetch (ctx, 0);
-	  dwarf_expr_pop (ctx);
-
-	  switch (op)
-	    {
-	    case DW_OP_abs:
-	      if (sign_ext (result) < 0)
-		result = -result;
-	      break;
-	    case DW_OP_neg:
-	      result = -result;
-	      break;
-	    case DW_OP_not:
-	      result = ~result;
-	      break;
-	    case DW_OP_plus_uconst:
-	      op_ptr = read_uleb128 (op_ptr, op_end, &reg);
-	      result += reg;
-	      break;
-	    }
-	  break;
+      dest = start[i + 1] + dop->sarg;
+      if (dest >= (LONGEST) program->len)
+	{
+	  /* Branching past the end ends the evaluation.  */
+	  dop->target = n;
+	  continue;
+	}
+      if (dest < 0)
+	error (_("Corrupted DWARF expression."));
 
-	case DW_OP_and:
-	case DW_OP_div:
-	case DW_OP_minus:
-	case DW_OP_mod:
-	case DW_OP_mul:
-	case DW_OP_or:
-	case DW_OP_plus:
-	case DW_OP_shl:
-	case DW_OP_shr:
-	case DW_OP_shra:
-	case DW_OP_xor:
-	case DW_OP_le:
-	case DW_OP_ge:
-	case DW_OP_eq:
-	case DW_OP_lt:
-	case DW_OP_gt:
-	case DW_OP_ne:
-	  {
-	    /* Binary operations.  */
-	    ULONGEST first, second;
-
-	    second = dwarf_expr_fetch (ctx, 0);
-	    dwarf_expr_pop (ctx);
-
-	    first = dwarf_expr_fetch (ctx, 0);
-	    dwarf_expr_pop (ctx);
-
-	    switch (op)
-	      {
-	      case DW_OP_and:
-		result = first & second;
-		break;
-	      case DW_OP_div:
-		if (!second)
-		  error (_("Division by zero"));
-		result = sign_ext (first) / sign_ext (second);
-                break;
-	      case DW_OP_minus:
-		result = first - second;
-		break;
-	      case DW_OP_mod:
-		if (!second)
-		  error (_("Division by zero"));
-		result = first % second;
-		break;
-	      case DW_OP_mul:
-		result = first * second;
-		break;
-	      case DW_OP_or:
-		result = first | second;
-		break;
-	      case DW_OP_plus:
-		result = first + second;
-		break;
-	      case DW_OP_shl:
-		result = first << second;
-		break;
-	      case DW_OP_shr:
-		result = first >> second;
-                break;
-	      case DW_OP_shra:
-		result = sign_ext (first) >> second;
-		break;
-	      case DW_OP_xor:
-		result = first ^ second;
-		break;
-	      case DW_OP_le:
-		result = sign_ext (first) <= sign_ext (second);
-		break;
-	      case DW_OP_ge:
-		result = sign_ext (first) >= sign_ext (second);
-		break;
-	      case DW_OP_eq:
-		result = sign_ext (first) == sign_ext (second);
-		break;
-	      case DW_OP_lt:
-		result = sign_ext (first) < sign_ext (second);
-		break;
-	      case DW_OP_gt:
-		result = sign_ext (first) > sign_ext (second);
-		break;
-	      case DW_OP_ne:
-		result = sign_ext (first) != sign_ext (second);
-		break;
-	      default:
-		internal_error (__FILE__, __LINE__,
-				_("Can't be reached."));
-	      }
-	  }
-	  break;
+      lo = 0;
+      hi = n;
+      while (lo < hi)
+	{
+	  int mid = lo + (hi - lo) / 2;
 
-	case DW_OP_call_frame_cfa:
-	  result = (ctx->get_frame_cfa) (ctx->baton);
-	  in_stack_memory = 1;
-	  break;
+	  if (start[mid] < dest)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+      if (lo == n || start[lo] != dest)
+	error (_("Corrupted DWARF expression."));
+      dop->target = lo;
+    }
+}
 
-	case DW_OP_GNU_push_tls_address:
-	  /* Variable is at a constant offset in the thread-local
-	  storage block into the objfile for the current thread and
-	  the dynamic linker module containing this expression. Here
-	  we return returns the offset from that base.  The top of the
-	  stack has the offset from the beginning of the thread
-	  control block at which the variable is located.  Nothing
-	  should follow this operator, so the top of stack would be
-	  returned.  */
-	  result = dwarf_expr_fetch (ctx, 0);
-	  dwarf_expr_pop (ctx);
-	  result = (ctx->get_tls_address) (ctx->baton, result);
-	  break;
+/* Decode the expression of LEN bytes at DATA once for all, for a
+   target with addresses of ADDR_SIZE bytes and the byte order of
+   GDBARCH, so that evaluating it with dwarf_expr_eval_program needs no
+   decoding.  The result is allocated on OBSTACK.  */
 
-	case DW_OP_skip:
-	  offset = extract_signed_integer (op_ptr, 2, byte_order);
-	  op_ptr += 2;
-	  op_ptr += offset;
-	  goto no_push;
-
-	case DW_OP_bra:
-	  offset = extract_signed_integer (op_ptr, 2, byte_order);
-	  op_ptr += 2;
-	  if (dwarf_expr_fetch (ctx, 0) != 0)
-	    op_ptr += offset;
-	  dwarf_expr_pop (ctx);
-	  goto no_push;
-
-	case DW_OP_nop:
-	  goto no_push;
-
-        case DW_OP_piece:
-          {
-            ULONGEST size;
-
-            /* Record the piece.  */
-            op_ptr = read_uleb128 (op_ptr, op_end, &size);
-	    add_piece (ctx, 8 * size, 0);
-
-            /* Pop off the address/regnum, and reset the location
-	       type.  */
-	    if (ctx->location != DWARF_VALUE_LITERAL
-		&& ctx->location != DWARF_VALUE_OPTIMIZED_OUT)
-	      dwarf_expr_pop (ctx);
-            ctx->location = DWARF_VALUE_MEMORY;
-          }
-          goto no_push;
-
-	case DW_OP_bit_piece:
-	  {
-	    ULONGEST size, offset;
-
-            /* Record the piece.  */
-	    op_ptr = read_uleb128 (op_ptr, op_end, &size);
-	    op_ptr = read_uleb128 (op_ptr, op_end, &offset);
-	    add_piece (ctx, size, offset);
-
-            /* Pop off the address/regnum, and reset the location
-	       type.  */
-	    if (ctx->location != DWARF_VALUE_LITERAL
-		&& ctx->location != DWARF_VALUE_OPTIMIZED_OUT)
-	      dwarf_expr_pop (ctx);
-            ctx->location = DWARF_VALUE_MEMORY;
-	  }
-	  goto no_push;
+struct dwarf_expr_program *
+dwarf_expr_compile (struct obstack *obstack, struct gdbarch *gdbarch,
+		    int addr_size, const gdb_byte *data, size_t len)
+{
+  struct dwarf_expr_program *program;
+  struct dwarf_expr_op *ops;
+  int *start;
+  struct cleanup *old_chain;
+  volatile struct gdb_exception ex;
+
+  program = OBSTACK_ZALLOC (obstack, struct dwarf_expr_program);
+  program->data = data;
+  program->len = len;
+  program->addr_size = addr_size;
+
+  /* An expression has at most one operation per byte.  */
+  ops = xmalloc ((len + 1) * sizeof (*ops));
+  old_chain = make_cleanup (xfree, ops);
+  start = xmalloc ((len + 1) * sizeof (*start));
+  make_cleanup (xfree, start);
+
+  program->ops = ops;
+  TRY_CATCH (ex, RETURN_MASK_ERROR)
+    {
+      decode_program (program, gdbarch_byte_order (gdbarch), start);
+    }
 
-	case DW_OP_GNU_uninit:
-	  if (op_ptr != op_end)
-	    error (_("DWARF-2 expression error: DW_OP_GNU_uninit must always "
-		   "be the very last op."));
+  if (ex.reason < 0)
+    {
+      program->ops = NULL;
+      program->num_ops = 0;
+    }
+  else
+    {
+      program->ops = obstack_alloc (obstack,
+				    program->num_ops * sizeof (*ops));
+      memcpy (program->ops, ops, program->num_ops * sizeof (*ops));
+      program->decoded_p = 1;
+    }
 
-	  ctx->initialized = 0;
-	  goto no_push;
+  do_cleanups (old_chain);
+  return program;
+}
 
-	case DW_OP_call2:
-	  result = extract_unsigned_integer (op_ptr, 2, byte_order);
-	  op_ptr += 2;
-	  ctx->dwarf_call (ctx, result);
-	  goto no_push;
+/* Evaluate PROGRAM, as returned by dwarf_expr_compile, using the
+   context CTX.  */
 
-	case DW_OP_call4:
-	  result = extract_unsigned_integer (op_ptr, 4, byte_order);
-	  op_ptr += 4;
-	  ctx->dwarf_call (ctx, result);
-	  goto no_push;
+void
+dwarf_expr_eval_program (struct dwarf_expr_context *ctx,
+			 const struct dwarf_expr_program *program)
+{
+  int old_recursion_depth = ctx->recursion_depth;
 
-	default:
-	  error (_("Unhandled dwarf expression opcode 0x%x"), op);
-	}
+  if (program->decoded_p && program->addr_size == ctx->addr_size)
+    execute_program (ctx, program);
+  else
+    execute_stack_op (ctx, program->data, program->data + program->len);
 
-      /* Most things push a result value.  */
-      dwarf_expr_push (ctx, result, in_stack_memory);
-    no_push:;
-    }
+  /* CTX RECURSION_DEPTH becomes invalid if an exception was thrown here.  */
 
-  ctx->recursion_depth--;
-  gdb_assert (ctx->recursion_depth >= 0);
-#undef sign_ext
+  gdb_assert (ctx->recursion_depth == old_recursion_depth);
 }
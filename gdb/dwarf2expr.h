@@ -23,6 +23,9 @@
 #if !defined (DWARF2EXPR_H)
 #define DWARF2EXPR_H
 
+struct dwarf_expr_program;
+struct obstack;
+
 /* The location of a value.  */
 enum dwarf_value_location
 {
@@ -203,6 +206,13 @@ void dwarf_expr_push (struct dwarf_expr_context *ctx, ULONGEST value,
 void dwarf_expr_pop (struct dwarf_expr_context *ctx);
 void dwarf_expr_eval (struct dwarf_expr_context *ctx, const gdb_byte *addr,
 		      size_t len);
+struct dwarf_expr_program *dwarf_expr_compile (struct obstack *obstack,
+					       struct gdbarch *gdbarch,
+					       int addr_size,
+					       const gdb_byte *data,
+					       size_t len);
+void dwarf_expr_eval_program (struct dwarf_expr_context *ctx,
+			      const struct dwarf_expr_program *program);
 ULONGEST dwarf_expr_fetch (struct dwarf_expr_context *ctx, int n);
 CORE_ADDR dwarf_expr_fetch_address (struct dwarf_expr_context *ctx, int n);
 int dwarf_expr_fetch_in_stack_memory (struct dwarf_expr_context *ctx, int n);
@@ -48,17 +48,57 @@ static void
 dwarf_expr_frame_base_1 (struct symbol *framefunc, CORE_ADDR pc,
 			 const gdb_byte **start, size_t *length);
 
-/* A helper function for dealing with location lists.  Given a
-   symbol baton (BATON) and a pc value (PC), find the appropriate
-   location expression, set *LOCEXPR_LENGTH, and return a pointer
-   to the beginning of the expression.  Returns NULL on failure.
+/* An entry of a location list.  */
 
-   For now, only return the first matching location expression; there
-   can be more than one in the list.  */
+struct dwarf2_loclist_entry
+{
+  /* The range of PCs where the entry applies, not counting the text
+     offset of the compilation unit.  */
+  CORE_ADDR low;
+  CORE_ADDR high;
 
-static const gdb_byte *
-find_location_expression (struct dwarf2_loclist_baton *baton,
-			  size_t *locexpr_length, CORE_ADDR pc)
+  /* The location expression.  */
+  const gdb_byte *data;
+  size_t size;
+
+  /* The expression decoded for evaluation, or NULL if it was not
+     evaluated yet.  */
+  struct dwarf_expr_program *program;
+};
+
+/* The entries of a location list, read once so that finding the
+   entry for a PC does not walk the list.  */
+
+struct dwarf2_loclist_index
+{
+  struct dwarf2_loclist_entry *entries;
+  int num_entries;
+
+  /* Non-zero if the entries are sorted by address and do not overlap,
+     so that they can be bsearched.  Otherwise they are in list order,
+     and the first one that matches wins.  */
+  int sorted_p;
+
+  /* Non-zero if the list is corrupted after its last entry.  */
+  int corrupted_p;
+};
+
+static int
+loclist_entry_cmp (const void *a, const void *b)
+{
+  const struct dwarf2_loclist_entry *aa = a;
+  const struct dwarf2_loclist_entry *bb = b;
+
+  if (aa->low != bb->low)
+    return aa->low < bb->low ? -1 : 1;
+  return 0;
+}
+
+/* Read the entries of the location list of BATON into a new index,
+   allocated on the objfile obstack.  */
+
+static struct dwarf2_loclist_index *
+build_loclist_index (struct dwarf2_loclist_baton *baton)
 {
   CORE_ADDR low, high;
   const gdb_byte *loc_ptr, *buf_end;
@@ -69,9 +109,17 @@ find_location_expression (struct dwarf2_loclist_baton *baton,
   unsigned int addr_size = dwarf2_per_cu_addr_size (baton->per_cu);
   int signed_addr_p = bfd_get_sign_extend_vma (objfile->obfd);
   CORE_ADDR base_mask = ~(~(CORE_ADDR)1 << (addr_size * 8 - 1));
-  /* Adjust base_address for relocatable objects.  */
-  CORE_ADDR base_offset = dwarf2_per_cu_text_offset (baton->per_cu);
-  CORE_ADDR base_address = baton->base_address + base_offset;
+  /* The base address, not counting the text offset.  */
+  CORE_ADDR base_address = baton->base_address;
+  struct dwarf2_loclist_index *index;
+  struct dwarf2_loclist_entry *entries = NULL;
+  int num_entries = 0, max_entries = 0;
+  struct cleanup *old_chain;
+  int i;
+
+  index = OBSTACK_ZALLOC (&objfile->objfile_obstack,
+			  struct dwarf2_loclist_index);
+  old_chain = make_cleanup (free_current_contents, &entries);
 
   loc_ptr = baton->data;
   buf_end = baton->data + baton->size;
@@ -79,7 +127,10 @@ find_location_expression (struct dwarf2_loclist_baton *baton,
   while (1)
     {
       if (buf_end - loc_ptr < 2 * addr_size)
-	error (_("find_location_expression: Corrupted DWARF expression."));
+	{
+	  index->corrupted_p = 1;
+	  break;
+	}
 
       if (signed_addr_p)
 	low = extract_signed_integer (loc_ptr, addr_size, byte_order);
@@ -96,13 +147,13 @@ find_location_expression (struct dwarf2_loclist_baton *baton,
       /* A base-address-selection entry.  */
       if ((low & base_mask) == base_mask)
 	{
-	  base_address = high + base_offset;
+	  base_address = high;
 	  continue;
 	}
 
       /* An end-of-list entry.  */
       if (low == 0 && high == 0)
-	return NULL;
+	break;
 
       /* Otherwise, a location expression entry.  */
       low += base_address;
@@ -111,14 +162,143 @@ find_location_expression (struct dwarf2_loclist_baton *baton,
       length = extract_unsigned_integer (loc_ptr, 2, byte_order);
       loc_ptr += 2;
 
-      if (pc >= low && pc < high)
+      /* An empty range never matches.  */
+      if (low < high)
 	{
-	  *locexpr_length = length;
-	  return loc_ptr;
+	  struct dwarf2_loclist_entry *entry;
+
+	  if (num_entries == max_entries)
+	    {
+	      max_entries = max_entries ? 2 * max_entries : 8;
+	      entries = xrealloc (entries, max_entries * sizeof (*entries));
+	    }
+	  entry = &entries[num_entries++];
+	  entry->low = low;
+	  entry->high = high;
+	  entry->data = loc_ptr;
+	  entry->size = length;
+	  entry->program = NULL;
 	}
 
       loc_ptr += length;
     }
+
+  index->num_entries = num_entries;
+  index->entries = obstack_alloc (&objfile->objfile_obstack,
+				  num_entries * sizeof (*entries));
+  memcpy (index->entries, entries, num_entries * sizeof (*entries));
+
+  /* Sort a copy of the entries; if they turn out to overlap, searching
+     them in list order is the only way to find the same entry as a
+     walk of the list would.  */
+  if (num_entries > 1)
+    {
+      qsort (entries, num_entries, sizeof (*entries), loclist_entry_cmp);
+      for (i = 1; i < num_entries; i++)
+	if (entries[i - 1].high > entries[i].low)
+	  break;
+      if (i == num_entries)
+	{
+	  memcpy (index->entries, entries, num_entries * sizeof (*entries));
+	  index->sorted_p = 1;
+	}
+    }
+  else
+    index->sorted_p = 1;
+
+  do_cleanups (old_chain);
+  return index;
+}
+
+static int
+bsearch_loclist_entry_cmp (const void *key, const void *element)
+{
+  CORE_ADDR pc = *(CORE_ADDR *) key;
+  const struct dwarf2_loclist_entry *entry = element;
+
+  if (pc < entry->low)
+    return -1;
+  if (pc < entry->high)
+    return 0;
+  return 1;
+}
+
+/* Given a symbol baton (BATON) and a pc value (PC), find the entry of
+   its location list that applies at PC.  Returns NULL if there is
+   none.  */
+
+static struct dwarf2_loclist_entry *
+find_location_entry (struct dwarf2_loclist_baton *baton, CORE_ADDR pc)
+{
+  struct dwarf2_loclist_index *index = baton->index;
+  struct dwarf2_loclist_entry *entry = NULL;
+
+  if (index == NULL)
+    {
+      index = build_loclist_index (baton);
+      baton->index = index;
+    }
+
+  /* Compare with the ranges as they appear in the list.  */
+  pc -= dwarf2_per_cu_text_offset (baton->per_cu);
+
+  if (index->num_entries == 0)
+    ;
+  else if (index->sorted_p)
+    entry = bsearch (&pc, index->entries, index->num_entries,
+		     sizeof (index->entries[0]), bsearch_loclist_entry_cmp);
+  else
+    {
+      int i;
+
+      for (i = 0; i < index->num_entries; i++)
+	if (pc >= index->entries[i].low && pc < index->entries[i].high)
+	  {
+	    entry = &index->entries[i];
+	    break;
+	  }
+    }
+
+  /* Walking the list would have run into the corruption.  */
+  if (entry == NULL && index->corrupted_p)
+    error (_("find_location_expression: Corrupted DWARF expression."));
+
+  return entry;
+}
+
+/* A helper function for dealing with location lists.  Given a
+   symbol baton (BATON) and a pc value (PC), find the appropriate
+   location expression, set *LOCEXPR_LENGTH, and return a pointer
+   to the beginning of the expression.  Returns NULL on failure.
+
+   For now, only return the first matching location expression; there
+   can be more than one in the list.  */
+
+static const gdb_byte *
+find_location_expression (struct dwarf2_loclist_baton *baton,
+			  size_t *locexpr_length, CORE_ADDR pc)
+{
+  struct dwarf2_loclist_entry *entry = find_location_entry (baton, pc);
+
+  if (entry == NULL)
+    return NULL;
+
+  *locexpr_length = entry->size;
+  return entry->data;
+}
+
+/* Decode the location expression of SIZE bytes at DATA, from the
+   compilation unit PER_CU, for evaluation.  */
+
+static struct dwarf_expr_program *
+compile_location_expression (struct dwarf2_per_cu_data *per_cu,
+			     const gdb_byte *data, size_t size)
+{
+  struct objfile *objfile = dwarf2_per_cu_objfile (per_cu);
+
+  return dwarf_expr_compile (&objfile->objfile_obstack,
+			     get_objfile_arch (objfile),
+			     dwarf2_per_cu_addr_size (per_cu), data, size);
 }
 
 /* This is the baton used when performing dwarf2 expression
@@ -879,11 +1059,13 @@ static struct lval_funcs pieced_value_funcs = {
 
 /* Evaluate a location description, starting at DATA and with length
    SIZE, to find the current location of variable of TYPE in the context
-   of FRAME.  */
+   of FRAME.  If PROGRAM is not NULL, it is the description decoded by
+   compile_location_expression.  */
 
 static struct value *
 dwarf2_evaluate_loc_desc (struct type *type, struct frame_info *frame,
 			  const gdb_byte *data, unsigned short size,
+			  const struct dwarf_expr_program *program,
 			  struct dwarf2_per_cu_data *per_cu)
 {
   struct value *retval;
@@ -917,7 +1099,10 @@ dwarf2_evaluate_loc_desc (struct type *type, struct frame_info *frame,
   ctx->get_tls_address = dwarf_expr_tls_address;
   ctx->dwarf_call = dwarf_expr_dwarf_call;
 
-  dwarf_expr_eval (ctx, data, size);
+  if (program != NULL)
+    dwarf_expr_eval_program (ctx, program);
+  else
+    dwarf_expr_eval (ctx, data, size);
   if (ctx->num_pieces > 0)
     {
       struct piece_closure *c;
@@ -1879,8 +2064,14 @@ locexpr_read_variable (struct symbol *symbol, struct frame_info *frame)
   struct dwarf2_locexpr_baton *dlbaton = SYMBOL_LOCATION_BATON (symbol);
   struct value *val;
 
+  if (dlbaton->program == NULL)
+    dlbaton->program = compile_location_expression (dlbaton->per_cu,
+						    dlbaton->data,
+						    dlbaton->size);
+
   val = dwarf2_evaluate_loc_desc (SYMBOL_TYPE (symbol), frame, dlbaton->data,
-				  dlbaton->size, dlbaton->per_cu);
+				  dlbaton->size, dlbaton->program,
+				  dlbaton->per_cu);
 
   return val;
 }
@@ -2456,22 +2647,27 @@ static struct value *
 loclist_read_variable (struct symbol *symbol, struct frame_info *frame)
 {
   struct dwarf2_loclist_baton *dlbaton = SYMBOL_LOCATION_BATON (symbol);
+  struct dwarf2_loclist_entry *entry;
   struct value *val;
-  const gdb_byte *data;
-  size_t size;
 
-  data = find_location_expression (dlbaton, &size,
-				   frame ? get_frame_address_in_block (frame)
-				   : 0);
-  if (data == NULL)
+  entry = find_location_entry (dlbaton,
+			       frame ? get_frame_address_in_block (frame) : 0);
+  if (entry == NULL)
     {
       val = allocate_value (SYMBOL_TYPE (symbol));
       VALUE_LVAL (val) = not_lval;
       set_value_optimized_out (val, 1);
     }
   else
-    val = dwarf2_evaluate_loc_desc (SYMBOL_TYPE (symbol), frame, data, size,
-				    dlbaton->per_cu);
+    {
+      if (entry->program == NULL)
+	entry->program = compile_location_expression (dlbaton->per_cu,
+						      entry->data,
+						      entry->size);
+      val = dwarf2_evaluate_loc_desc (SYMBOL_TYPE (symbol), frame,
+				      entry->data, entry->size,
+				      entry->program, dlbaton->per_cu);
+    }
 
   return val;
 }
@@ -24,6 +24,8 @@
 struct symbol_computed_ops;
 struct objfile;
 struct dwarf2_per_cu_data;
+struct dwarf_expr_program;
+struct dwarf2_loclist_index;
 
 /* This header is private to the DWARF-2 reader.  It is shared between
    dwarf2read.c and dwarf2loc.c.  */
@@ -65,6 +67,10 @@ struct dwarf2_locexpr_baton
   /* The compilation unit containing the symbol whose location
      we're computing.  */
   struct dwarf2_per_cu_data *per_cu;
+
+  /* The location expression decoded for evaluation, or NULL if it was
+     not evaluated yet.  */
+  struct dwarf_expr_program *program;
 };
 
 struct dwarf2_loclist_baton
@@ -82,6 +88,10 @@ struct dwarf2_loclist_baton
   /* The compilation unit containing the symbol whose location
      we're computing.  */
   struct dwarf2_per_cu_data *per_cu;
+
+  /* The entries of the location list, or NULL if it was not used
+     yet.  */
+  struct dwarf2_loclist_index *index;
 };
 
 extern const struct symbol_computed_ops dwarf2_locexpr_funcs;
@@ -9087,6 +9087,7 @@ dwarf2_const_value (struct attribute *attr, struct symbol *sym,
 			       sizeof (struct dwarf2_locexpr_baton));
 	baton->per_cu = cu->per_cu;
 	gdb_assert (baton->per_cu);
+	baton->program = NULL;
 
 	baton->size = 2 + cu_header->addr_size;
 	data = obstack_alloc (&objfile->objfile_obstack, baton->size);
@@ -10980,6 +10981,7 @@ dwarf2_fetch_die_location_block (unsigned int offset,
       retval.size = DW_BLOCK (attr)->size;
     }
   retval.per_cu = cu->per_cu;
+  retval.program = NULL;
   return retval;
 }
 
@@ -11995,6 +11997,7 @@ dwarf2_symbol_mark_computed (struct attribute *attr, struct symbol *sym,
 			     sizeof (struct dwarf2_loclist_baton));
       baton->per_cu = cu->per_cu;
       gdb_assert (baton->per_cu);
+      baton->index = NULL;
 
       dwarf2_read_section (dwarf2_per_objfile->objfile,
 			   &dwarf2_per_objfile->loc);
@@ -12019,6 +12022,7 @@ dwarf2_symbol_mark_computed (struct attribute *attr, struct symbol *sym,
 			     sizeof (struct dwarf2_locexpr_baton));
       baton->per_cu = cu->per_cu;
       gdb_assert (baton->per_cu);
+      baton->program = NULL;
 
       if (attr_form_is_block (attr))
 	{
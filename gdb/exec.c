@@ -155,7 +155,8 @@ exec_close_1 (int quitting)
     {
       set_current_program_space (ss);
 
-      /* Delete all target sections.  */
+      /* Delete all target sections, and the code cached from them.  */
+      target_dcache_invalidate ();
       resize_section_table
 	(current_target_sections,
 	 -resize_section_table (current_target_sections, 0));
@@ -406,6 +407,8 @@ resize_section_table (struct target_section_table *table, int num_added)
   old_value = table->sections;
   old_count = table->sections_end - table->sections;
 
+  clear_section_table_index (table);
+
   new_count = num_added + old_count;
 
   if (new_count)
@@ -496,6 +499,10 @@ remove_target_sections (bfd *abfd)
     {
       int old_count;
 
+      /* Code cached from these sections is no longer what the
+	 addresses hold.  */
+      target_dcache_invalidate ();
+
       old_count = resize_section_table (table, dest - src);
 
       /* If we don't have any more sections to read memory from,
@@ -571,11 +578,161 @@ map_vmap (bfd *abfd, bfd *arch)
 }
 
 
+/* The index of a section table, sorted by address.  Sections may
+   overlap, for instance overlay sections, and lookups must find the
+   first matching section in table order, as a linear search would.
+   Each entry therefore also records the highest end address among the
+   entries up to and including it; a lookup walks back from the last
+   section starting at or below the address for as long as that bound
+   shows an earlier section may still contain it.  */
+
+struct target_section_index_entry
+{
+  struct target_section *section;
+  CORE_ADDR maxend;
+};
+
+struct target_section_index
+{
+  /* Nonzero if no two sections of the table overlap.  A lookup can
+     then stop at the first section found, and remember it.  */
+  int disjoint;
+
+  /* The section the last lookup without a section name found, or
+     NULL.  Only used when the sections are disjoint.  */
+  struct target_section *last_hit;
+
+  int count;
+  struct target_section_index_entry entries[1];
+};
+
+void
+clear_section_table_index (struct target_section_table *table)
+{
+  xfree (table->index);
+  table->index = NULL;
+}
+
+/* qsort comparison function for target_section_index entries.  Ties
+   are broken by the position in the table.  */
+
+static int
+compare_section_index_entries (const void *ap, const void *bp)
+{
+  const struct target_section_index_entry *a = ap;
+  const struct target_section_index_entry *b = bp;
+
+  if (a->section->addr < b->section->addr)
+    return -1;
+  else if (a->section->addr > b->section->addr)
+    return 1;
+  else if (a->section < b->section)
+    return -1;
+  else if (a->section > b->section)
+    return 1;
+  else
+    return 0;
+}
+
+/* Return the index of TABLE, building it if needed.  */
+
+static struct target_section_index *
+get_section_table_index (struct target_section_table *table)
+{
+  struct target_section_index *index;
+  struct target_section *p;
+  CORE_ADDR maxend = 0;
+  int i, count;
+
+  if (table->index != NULL)
+    return table->index;
+
+  index = xmalloc (sizeof (struct target_section_index)
+		   + (table->sections_end - table->sections)
+		   * sizeof (struct target_section_index_entry));
+  count = 0;
+  for (p = table->sections; p < table->sections_end; p++)
+    /* Empty sections never contain anything.  */
+    if (p->addr < p->endaddr)
+      index->entries[count++].section = p;
+
+  qsort (index->entries, count, sizeof (index->entries[0]),
+	 compare_section_index_entries);
+
+  index->disjoint = 1;
+  for (i = 0; i < count; i++)
+    {
+      struct target_section *sec = index->entries[i].section;
+
+      if (i > 0 && sec->addr < maxend)
+	index->disjoint = 0;
+      if (sec->endaddr > maxend)
+	maxend = sec->endaddr;
+      index->entries[i].maxend = maxend;
+    }
+
+  index->count = count;
+  index->last_hit = NULL;
+  table->index = index;
+  return index;
+}
+
+struct target_section *
+section_table_lookup (struct target_section_table *table, CORE_ADDR addr,
+		      const char *section_name)
+{
+  struct target_section_index *index;
+  struct target_section *found = NULL;
+  int lo, hi;
+
+  if (table->sections == table->sections_end)
+    return NULL;
+
+  index = get_section_table_index (table);
+
+  if (section_name == NULL && index->last_hit != NULL
+      && addr >= index->last_hit->addr && addr < index->last_hit->endaddr)
+    return index->last_hit;
+
+  /* Find the first entry starting above ADDR.  */
+  lo = 0;
+  hi = index->count;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      if (index->entries[mid].section->addr <= addr)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* Walk back over the entries that may contain ADDR.  */
+  while (--lo >= 0 && index->entries[lo].maxend > addr)
+    {
+      struct target_section *p = index->entries[lo].section;
+
+      if (addr >= p->endaddr)
+	continue;
+      if (section_name
+	  && strcmp (section_name, p->the_bfd_section->name) != 0)
+	continue;		/* not the section we need */
+      if (found == NULL || p < found)
+	found = p;
+      if (index->disjoint)
+	break;
+    }
+
+  if (section_name == NULL && index->disjoint && found != NULL)
+    index->last_hit = found;
+
+  return found;
+}
+
 int
 section_table_xfer_memory_partial (gdb_byte *readbuf, const gdb_byte *writebuf,
 				   ULONGEST offset, LONGEST len,
-				   struct target_section *sections,
-				   struct target_section *sections_end,
+				   struct target_section_table *table,
 				   const char *section_name)
 {
   int res;
@@ -586,48 +743,21 @@ section_table_xfer_memory_partial (gdb_byte *readbuf, const gdb_byte *writebuf,
   if (len <= 0)
     internal_error (__FILE__, __LINE__, _("failed internal consistency check"));
 
-  for (p = sections; p < sections_end; p++)
-    {
-      if (section_name && strcmp (section_name, p->the_bfd_section->name) != 0)
-	continue;		/* not the section we need */
-      if (memaddr >= p->addr)
-        {
-	  if (memend <= p->endaddr)
-	    {
-	      /* Entire transfer is within this section.  */
-	      if (writebuf)
-		res = bfd_set_section_contents (p->bfd, p->the_bfd_section,
-						writebuf, memaddr - p->addr,
-						len);
-	      else
-		res = bfd_get_section_contents (p->bfd, p->the_bfd_section,
-						readbuf, memaddr - p->addr,
-						len);
-	      return (res != 0) ? len : 0;
-	    }
-	  else if (memaddr >= p->endaddr)
-	    {
-	      /* This section ends before the transfer starts.  */
-	      continue;
-	    }
-	  else
-	    {
-	      /* This section overlaps the transfer.  Just do half.  */
-	      len = p->endaddr - memaddr;
-	      if (writebuf)
-		res = bfd_set_section_contents (p->bfd, p->the_bfd_section,
-						writebuf, memaddr - p->addr,
-						len);
-	      else
-		res = bfd_get_section_contents (p->bfd, p->the_bfd_section,
-						readbuf, memaddr - p->addr,
-						len);
-	      return (res != 0) ? len : 0;
-	    }
-        }
-    }
+  p = section_table_lookup (table, memaddr, section_name);
+  if (p == NULL)
+    return 0;			/* We can't help */
 
-  return 0;			/* We can't help */
+  /* If this section only overlaps the transfer, just do half.  */
+  if (memend > p->endaddr)
+    len = p->endaddr - memaddr;
+
+  if (writebuf)
+    res = bfd_set_section_contents (p->bfd, p->the_bfd_section,
+				    writebuf, memaddr - p->addr, len);
+  else
+    res = bfd_get_section_contents (p->bfd, p->the_bfd_section,
+				    readbuf, memaddr - p->addr, len);
+  return (res != 0) ? len : 0;
 }
 
 struct target_section_table *
@@ -647,9 +777,7 @@ exec_xfer_partial (struct target_ops *ops, enum target_object object,
   if (object == TARGET_OBJECT_MEMORY)
     return section_table_xfer_memory_partial (readbuf, writebuf,
 					      offset, len,
-					      table->sections,
-					      table->sections_end,
-					      NULL);
+					      table, NULL);
   else
     return -1;
 }
@@ -780,6 +908,7 @@ set_section_command (char *args, int from_tty)
 	  offset = secaddr - p->addr;
 	  p->addr += offset;
 	  p->endaddr += offset;
+	  clear_section_table_index (table);
 	  if (from_tty)
 	    exec_files_info (&exec_ops);
 	  return;
@@ -811,6 +940,7 @@ exec_set_section_address (const char *filename, int index, CORE_ADDR address)
 	  p->addr = address;
 	}
     }
+  clear_section_table_index (table);
 }
 
 /* If mourn is being called in all the right places, this could be say
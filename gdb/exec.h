@@ -43,11 +43,22 @@ extern int build_section_table (struct bfd *, struct target_section **,
 
 extern int resize_section_table (struct target_section_table *, int);
 
+/* Discard the address index of TABLE.  Call this after changing the
+   sections of TABLE or their addresses.  */
+
+extern void clear_section_table_index (struct target_section_table *table);
+
+/* Return the first section of TABLE that contains ADDR, or NULL.  If
+   SECTION_NAME is not NULL, only consider sections with that name.  */
+
+extern struct target_section *
+  section_table_lookup (struct target_section_table *table, CORE_ADDR addr,
+			const char *section_name);
+
 /* Read or write from mappable sections of BFD executable files.
 
    Request to transfer up to LEN 8-bit bytes of the target sections
-   defined by SECTIONS and SECTIONS_END.  The OFFSET specifies the
-   starting address.
+   of TABLE.  The OFFSET specifies the starting address.
    If SECTION_NAME is not NULL, only access sections with that same
    name.
 
@@ -62,8 +73,7 @@ extern int resize_section_table (struct target_section_table *, int);
 
 extern int section_table_xfer_memory_partial (gdb_byte *, const gdb_byte *,
 					      ULONGEST, LONGEST,
-					      struct target_section *,
-					      struct target_section *,
+					      struct target_section_table *,
 					      const char *);
 
 /* Set the loaded address of a section.  */
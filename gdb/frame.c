@@ -44,6 +44,7 @@
 #include "block.h"
 #include "inline-frame.h"
 #include  "tracepoint.h"
+#include "hashtab.h"
 
 static struct frame_info *get_prev_frame_1 (struct frame_info *this_frame);
 static struct frame_info *get_prev_frame_raw (struct frame_info *this_frame);
@@ -129,18 +130,67 @@ struct frame_info
   enum unwind_stop_reason stop_reason;
 };
 
-/* A frame stash used to speed up frame lookups.  */
+/* A frame stash used to speed up frame lookups.  It holds every frame
+   whose ID was computed since the frame cache was last flushed, hashed
+   by frame ID.  */
 
-/* We currently only stash one frame at a time, as this seems to be
-   sufficient for now.  */
-static struct frame_info *frame_stash = NULL;
+static htab_t frame_stash;
 
-/* Add the following FRAME to the frame stash.  */
+/* Return the hash code of frame ID ID.  The code and special addresses
+   of an ID can be wildcards, so only the parts that frame_id_eq always
+   compares go into the hash.  */
+
+static hashval_t
+frame_id_hash (const struct frame_id *id)
+{
+  hashval_t hash = 0;
+
+  /* All outermost frame markers are equal.  */
+  if (!id->stack_addr_p)
+    return hash;
+
+  hash = iterative_hash (&id->stack_addr, sizeof (id->stack_addr), hash);
+  hash = iterative_hash (&id->inline_depth, sizeof (id->inline_depth), hash);
+  return hash;
+}
+
+/* Hash function for the frame stash.  */
+
+static hashval_t
+frame_stash_hash (const void *p)
+{
+  const struct frame_info *frame = p;
+
+  return frame_id_hash (&frame->this_id.value);
+}
+
+/* Equality function for the frame stash.  The key is a frame ID.  */
+
+static int
+frame_stash_eq (const void *p, const void *key)
+{
+  const struct frame_info *frame = p;
+  const struct frame_id *id = key;
+
+  return frame_id_eq (frame->this_id.value, *id);
+}
+
+/* Add the following FRAME to the frame stash.  If another frame with
+   an equal ID is already there, it is kept, so that lookups find the
+   innermost such frame, as a search of the frame chain would.  */
 
 static void
 frame_stash_add (struct frame_info *frame)
 {
-  frame_stash = frame;
+  void **slot;
+
+  gdb_assert (frame->this_id.p);
+
+  slot = htab_find_slot_with_hash (frame_stash, &frame->this_id.value,
+				   frame_id_hash (&frame->this_id.value),
+				   INSERT);
+  if (*slot == NULL)
+    *slot = frame;
 }
 
 /* Search the frame stash for an entry with the given frame ID.
@@ -149,10 +199,7 @@ frame_stash_add (struct frame_info *frame)
 static struct frame_info *
 frame_stash_find (struct frame_id id)
 {
-  if (frame_stash && frame_id_eq (frame_stash->this_id.value, id))
-    return frame_stash;
-
-  return NULL;
+  return htab_find_with_hash (frame_stash, &id, frame_id_hash (&id));
 }
 
 /* Invalidate the frame stash by removing all entries in it.  */
@@ -160,7 +207,7 @@ frame_stash_find (struct frame_id id)
 static void
 frame_stash_invalidate (void)
 {
-  frame_stash = NULL;
+  htab_empty (frame_stash);
 }
 
 /* Flag to control debugging.  */
@@ -342,9 +389,9 @@ get_frame_id (struct frame_info *fi)
 	  fprint_frame_id (gdb_stdlog, fi->this_id.value);
 	  fprintf_unfiltered (gdb_stdlog, " }\n");
 	}
-    }
 
-  frame_stash_add (fi);
+      frame_stash_add (fi);
+    }
 
   return fi->this_id.value;
 }
@@ -1332,6 +1379,7 @@ create_new_frame (CORE_ADDR addr, CORE_ADDR pc)
 
   fi->this_id.p = 1;
   fi->this_id.value = frame_id_build (addr, pc);
+  frame_stash_add (fi);
 
   if (frame_debug)
     {
@@ -2220,6 +2268,8 @@ _initialize_frame (void)
 {
   obstack_init (&frame_cache_obstack);
 
+  frame_stash = htab_create (100, frame_stash_hash, frame_stash_eq, NULL);
+
   observer_attach_target_changed (frame_observer_target_changed);
 
   add_prefix_cmd ("backtrace", class_maintenance, set_backtrace_cmd, _("\
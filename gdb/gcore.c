@@ -30,29 +30,38 @@
 #include "completer.h"
 #include "gcore.h"
 #include "cli/cli-decode.h"
+#include "cli/cli-dump.h"
 #include "gdb_assert.h"
 #include <fcntl.h>
+#include <ctype.h>
 #include "regcache.h"
 #include "regset.h"
+#include "gdb_string.h"
+#ifdef HAVE_ZLIB_H
+#include <zlib.h>
+#endif
 
 /* The largest amount of memory to read from the target at once.  We
    must throttle it to limit the amount of memory used by GDB during
    generate-core-file for programs with large resident data.  */
 #define MAX_COPY_BYTES (1024 * 1024)
 
+/* Blocks of this many zero bytes are not written to the core file,
+   leaving holes that read back as zeros.  Most of the memory of a
+   large process is typically untouched, zero-filled pages.  */
+#define GCORE_HOLE_SIZE 4096
+
 static const char *default_gcore_target (void);
 static enum bfd_architecture default_gcore_arch (void);
 static unsigned long default_gcore_mach (void);
 static int gcore_memory_sections (bfd *);
 
-/* create_gcore_bfd -- helper for gcore_command (exported).
-   Open a new bfd core file for output, and return the handle.  */
+/* Set up OBFD, just opened for output as FILENAME, as a core file.
+   Throw an error if OBFD is NULL, that is, if opening it failed.  */
 
-bfd *
-create_gcore_bfd (char *filename)
+static bfd *
+init_gcore_bfd (bfd *obfd, char *filename)
 {
-  bfd *obfd = bfd_openw (filename, default_gcore_target ());
-
   if (!obfd)
     error (_("Failed to open '%s' for output."), filename);
   bfd_set_format (obfd, bfd_core);
@@ -60,6 +69,16 @@ create_gcore_bfd (char *filename)
   return obfd;
 }
 
+/* create_gcore_bfd -- helper for gcore_command (exported).
+   Open a new bfd core file for output, and return the handle.  */
+
+bfd *
+create_gcore_bfd (char *filename)
+{
+  return init_gcore_bfd (bfd_openw (filename, default_gcore_target ()),
+			 filename);
+}
+
 /* write_gcore_file -- helper for gcore_command (exported).
    Compose and write the corefile data to the core file.  */
 
@@ -113,6 +132,59 @@ do_bfd_delete_cleanup (void *arg)
   unlink (filename);
 }
 
+/* Cleanup that removes the file named ARG.  */
+
+static void
+do_unlink_cleanup (void *arg)
+{
+  unlink (arg);
+}
+
+#ifdef HAVE_ZLIB_H
+
+/* Compress the file named FROM into the gzip file named TO.  */
+
+static void
+gcore_compress_file (const char *from, const char *to)
+{
+  struct cleanup *old_chain;
+  gdb_byte *buf;
+  FILE *in;
+  gzFile out;
+  size_t n;
+
+  in = fopen (from, FOPEN_RB);
+  if (in == NULL)
+    perror_with_name (from);
+  old_chain = make_cleanup_fclose (in);
+
+  out = gzopen (to, "wb");
+  if (out == NULL)
+    error (_("Failed to open '%s' for output."), to);
+
+  buf = xmalloc (MAX_COPY_BYTES);
+  make_cleanup (xfree, buf);
+
+  while ((n = fread (buf, 1, MAX_COPY_BYTES, in)) > 0)
+    if (gzwrite (out, buf, n) != (int) n)
+      {
+	gzclose (out);
+	error (_("Failed to write compressed corefile '%s'."), to);
+      }
+
+  if (ferror (in))
+    {
+      gzclose (out);
+      perror_with_name (from);
+    }
+  if (gzclose (out) != Z_OK)
+    error (_("Failed to write compressed corefile '%s'."), to);
+
+  do_cleanups (old_chain);
+}
+
+#endif /* HAVE_ZLIB_H */
+
 /* gcore_command -- implements the 'gcore' command.
    Generate a core file from the inferior process.  */
 
@@ -120,40 +192,116 @@ static void
 gcore_command (char *args, int from_tty)
 {
   struct cleanup *old_chain;
-  char *corefilename, corefilename_buffer[40];
+  char *corefilename, corefilename_buffer[44];
+  char *bfdfilename;
+  int compress = 0;
   bfd *obfd;
 
   /* No use generating a corefile without a target process.  */
   if (!target_has_execution)
     noprocess ();
 
+  /* "-z" asks for a compressed corefile.  */
+  if (args != NULL)
+    {
+      args = skip_spaces (args);
+      if (strncmp (args, "-z", 2) == 0
+	  && (args[2] == '\0' || isspace (args[2])))
+	{
+	  compress = 1;
+	  args = skip_spaces (args + 2);
+	}
+    }
+
   if (args && *args)
     corefilename = args;
   else
     {
-      /* Default corefile name is "core.PID".  */
-      sprintf (corefilename_buffer, "core.%d", PIDGET (inferior_ptid));
+      /* Default corefile name is "core.PID", or "core.PID.gz".  */
+      sprintf (corefilename_buffer, compress ? "core.%d.gz" : "core.%d",
+	       PIDGET (inferior_ptid));
       corefilename = corefilename_buffer;
     }
 
-  if (info_verbose)
-    fprintf_filtered (gdb_stdout,
-		      "Opening corefile '%s' for output.\n", corefilename);
+#ifndef HAVE_ZLIB_H
+  if (compress)
+    error (_("Cannot write a compressed corefile: "
+	     "GDB was built without zlib."));
+#endif
+
+  /* A compressed corefile is compressed from a complete one, written
+     to a temporary file first.  BFD seeks around the file it writes,
+     so it can't write through the compressor directly.  The temporary
+     file is created next to the corefile, under a name no existing
+     file has.  */
+  if (compress)
+    {
+      int fd;
+
+      bfdfilename = xstrprintf ("%s.XXXXXX", corefilename);
+      old_chain = make_cleanup (xfree, bfdfilename);
+      fd = mkstemps (bfdfilename, 0);
+      if (fd < 0)
+	perror_with_name (corefilename);
+
+      if (info_verbose)
+	fprintf_filtered (gdb_stdout,
+			  "Opening corefile '%s' for output.\n", bfdfilename);
+
+      obfd = bfd_fopen (bfdfilename, default_gcore_target (), FOPEN_WB, fd);
+      if (obfd == NULL)
+	{
+	  close (fd);
+	  unlink (bfdfilename);
+	}
+      obfd = init_gcore_bfd (obfd, bfdfilename);
+    }
+  else
+    {
+      bfdfilename = xstrdup (corefilename);
+      old_chain = make_cleanup (xfree, bfdfilename);
+
+      if (info_verbose)
+	fprintf_filtered (gdb_stdout,
+			  "Opening corefile '%s' for output.\n", bfdfilename);
 
-  /* Open the output file.  */
-  obfd = create_gcore_bfd (corefilename);
+      /* Open the output file.  */
+      obfd = create_gcore_bfd (bfdfilename);
+    }
 
   /* Need a cleanup that will close and delete the file.  */
-  old_chain = make_cleanup (do_bfd_delete_cleanup, obfd);
+  make_cleanup (do_bfd_delete_cleanup, obfd);
 
   /* Call worker function.  */
   write_gcore_file (obfd);
 
+  /* The BFD is closed below; the file itself must still go away if
+     compressing it fails.  */
+  discard_cleanups (old_chain);
+  old_chain = make_cleanup (xfree, bfdfilename);
+  if (!bfd_close (obfd))
+    {
+      unlink (bfdfilename);
+      error (_("Failed to write corefile '%s': %s"), bfdfilename,
+	     bfd_errmsg (bfd_get_error ()));
+    }
+
+#ifdef HAVE_ZLIB_H
+  if (compress)
+    {
+      struct cleanup *unlink_chain;
+
+      make_cleanup (do_unlink_cleanup, bfdfilename);
+      unlink_chain = make_cleanup (do_unlink_cleanup, corefilename);
+      gcore_compress_file (bfdfilename, corefilename);
+      discard_cleanups (unlink_chain);
+    }
+#endif
+
   /* Succeeded.  */
   fprintf_filtered (gdb_stdout, "Saved corefile %s\n", corefilename);
 
-  discard_cleanups (old_chain);
-  bfd_close (obfd);
+  do_cleanups (old_chain);
 }
 
 static unsigned long
@@ -512,13 +660,58 @@ objfile_find_memory_regions (int (*func) (CORE_ADDR, unsigned long,
   return 0;
 }
 
+/* Return nonzero if the LEN bytes at BUF are all zero.  */
+
+static int
+all_zeros_p (const gdb_byte *buf, bfd_size_type len)
+{
+  return len == 0 || (buf[0] == 0 && memcmp (buf, buf + 1, len - 1) == 0);
+}
+
+/* Write the SIZE bytes at BUF to OSEC of OBFD, at OFFSET within the
+   section, skipping blocks of zeros.  Set *END to the offset past the
+   last byte written.  Return zero on failure.  */
+
+static int
+gcore_write_contents (bfd *obfd, asection *osec, const gdb_byte *buf,
+		      file_ptr offset, bfd_size_type size, file_ptr *end)
+{
+  bfd_size_type start = 0, pos = 0;
+
+  while (pos < size)
+    {
+      bfd_size_type n = min (size - pos, GCORE_HOLE_SIZE);
+
+      if (all_zeros_p (buf + pos, n))
+	{
+	  if (start < pos
+	      && !bfd_set_section_contents (obfd, osec, buf + start,
+					    offset + start, pos - start))
+	    return 0;
+	  if (start < pos)
+	    *end = offset + pos;
+	  start = pos + n;
+	}
+      pos += n;
+    }
+
+  if (start < size)
+    {
+      if (!bfd_set_section_contents (obfd, osec, buf + start,
+				     offset + start, size - start))
+	return 0;
+      *end = offset + size;
+    }
+
+  return 1;
+}
+
 static void
-gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
+gcore_copy_callback (bfd *obfd, asection *osec, void *data)
 {
+  gdb_byte *memhunk = data;
   bfd_size_type size, total_size = bfd_section_size (obfd, osec);
-  file_ptr offset = 0;
-  struct cleanup *old_chain = NULL;
-  void *memhunk;
+  file_ptr offset = 0, end = 0;
 
   /* Read-only sections are marked; we don't have to copy their contents.  */
   if ((bfd_get_section_flags (obfd, osec) & SEC_LOAD) == 0)
@@ -529,8 +722,6 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
     return;
 
   size = min (total_size, MAX_COPY_BYTES);
-  memhunk = xmalloc (size);
-  old_chain = make_cleanup (xfree, memhunk);
 
   while (total_size > 0)
     {
@@ -545,31 +736,47 @@ gcore_copy_callback (bfd *obfd, asection *osec, void *ignored)
 		   paddress (target_gdbarch, bfd_section_vma (obfd, osec)));
 	  break;
 	}
-      if (!bfd_set_section_contents (obfd, osec, memhunk, offset, size))
+      if (!gcore_write_contents (obfd, osec, memhunk, offset, size, &end))
 	{
 	  warning (_("Failed to write corefile contents (%s)."),
 		   bfd_errmsg (bfd_get_error ()));
-	  break;
+	  return;
 	}
 
       total_size -= size;
       offset += size;
     }
 
-  do_cleanups (old_chain);	/* Frees MEMHUNK.  */
+  /* If the section ends with a hole, write its last byte so that the
+     file is not cut short.  */
+  size = bfd_section_size (obfd, osec);
+  if (size > 0 && end < size)
+    {
+      gdb_byte zero = 0;
+
+      if (!bfd_set_section_contents (obfd, osec, &zero, size - 1, 1))
+	warning (_("Failed to write corefile contents (%s)."),
+		 bfd_errmsg (bfd_get_error ()));
+    }
 }
 
 static int
 gcore_memory_sections (bfd *obfd)
 {
+  struct cleanup *old_chain;
+  gdb_byte *memhunk;
+
   if (target_find_memory_regions (gcore_create_callback, obfd) != 0)
     return 0;			/* FIXME: error return/msg?  */
 
   /* Record phdrs for section-to-segment mapping.  */
   bfd_map_over_sections (obfd, make_output_phdrs, NULL);
 
-  /* Copy memory region contents.  */
-  bfd_map_over_sections (obfd, gcore_copy_callback, NULL);
+  /* Copy memory region contents, through a single buffer.  */
+  memhunk = xmalloc (MAX_COPY_BYTES);
+  old_chain = make_cleanup (xfree, memhunk);
+  bfd_map_over_sections (obfd, gcore_copy_callback, memhunk);
+  do_cleanups (old_chain);
 
   return 1;
 }
@@ -582,7 +789,9 @@ _initialize_gcore (void)
 {
   add_com ("generate-core-file", class_files, gcore_command, _("\
 Save a core file with the current state of the debugged process.\n\
-Argument is optional filename.  Default filename is 'core.<process_id>'."));
+Usage: generate-core-file [-z] [FILENAME]\n\
+Default filename is 'core.<process_id>'.  With -z, the core file is\n\
+compressed with gzip, and the default filename is 'core.<process_id>.gz'."));
 
   add_com_alias ("gcore", "generate-core-file", class_files, 1);
   exec_set_find_memory_regions (objfile_find_memory_regions);
@@ -295,6 +295,7 @@ linux_add_process (int pid, int attached)
 
   proc = add_process (pid, attached);
   proc->private = xcalloc (1, sizeof (*proc->private));
+  proc->private->mem_fd = -1;
 
   if (the_low_target.new_process != NULL)
     proc->private->arch_private = the_low_target.new_process ();
@@ -900,6 +901,8 @@ linux_mourn (struct process_info *process)
 
   /* Freeing all private data.  */
   priv = process->private;
+  if (priv->mem_fd != -1)
+    close (priv->mem_fd);
   free (priv->arch_private);
   free (priv);
   process->private = NULL;
@@ -3964,6 +3967,51 @@ linux_store_registers (struct regcache *regcache, int regno)
 }
 
 
+/* Return a file descriptor open on /proc/PID/mem for the current
+   process, opening it on first use.  Returns -1 if the file cannot be
+   opened.  */
+
+static int
+linux_proc_mem_fd (void)
+{
+  struct process_info_private *priv = current_process ()->private;
+
+  if (priv->mem_fd == -1)
+    {
+      char filename[64];
+
+      /* Any LWP of the process will do; the kernel resolves the file
+	 to the address space, which is shared by all of them.  */
+      sprintf (filename, "/proc/%ld/mem",
+	       lwpid_of (get_thread_lwp (current_inferior)));
+      priv->mem_fd = open (filename, O_RDONLY | O_LARGEFILE);
+      if (priv->mem_fd != -1)
+	fcntl (priv->mem_fd, F_SETFD, FD_CLOEXEC);
+    }
+
+  return priv->mem_fd;
+}
+
+/* Read LEN bytes at MEMADDR from FD, open on /proc/PID/mem, into
+   MYADDR.  Return the number of bytes read, or -1 with errno set.  */
+
+static ssize_t
+linux_proc_mem_read (int fd, CORE_ADDR memaddr, unsigned char *myaddr,
+		     int len)
+{
+  /* If pread64 is available, use it.  It's faster if the kernel
+     supports it (only one syscall), and it's 64-bit safe even on
+     32-bit platforms (for instance, SPARC debugging a SPARC64
+     application).  */
+#ifdef HAVE_PREAD64
+  return pread64 (fd, myaddr, len, memaddr);
+#else
+  if (lseek (fd, memaddr, SEEK_SET) == -1)
+    return -1;
+  return read (fd, myaddr, len);
+#endif
+}
+
 /* Copy LEN bytes from inferior's memory starting at MEMADDR
    to debugger memory starting at MYADDR.  */
 
@@ -3981,38 +4029,33 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   register PTRACE_XFER_TYPE *buffer
     = (PTRACE_XFER_TYPE *) alloca (count * sizeof (PTRACE_XFER_TYPE));
   int fd;
-  char filename[64];
+  ssize_t ret;
   int pid = lwpid_of (get_thread_lwp (current_inferior));
 
-  /* Try using /proc.  Don't bother for one word.  */
-  if (len >= 3 * sizeof (long))
+  /* Try using /proc.  The file is kept open, so this costs a single
+     syscall even for one word.  */
+  fd = linux_proc_mem_fd ();
+  if (fd != -1)
     {
-      /* We could keep this file open and cache it - possibly one per
-	 thread.  That requires some juggling, but is even faster.  */
-      sprintf (filename, "/proc/%d/mem", pid);
-      fd = open (filename, O_RDONLY | O_LARGEFILE);
-      if (fd == -1)
-	goto no_proc;
-
-      /* If pread64 is available, use it.  It's faster if the kernel
-	 supports it (only one syscall), and it's 64-bit safe even on
-	 32-bit platforms (for instance, SPARC debugging a SPARC64
-	 application).  */
-#ifdef HAVE_PREAD64
-      if (pread64 (fd, myaddr, len, memaddr) != len)
-#else
-      if (lseek (fd, memaddr, SEEK_SET) == -1 || read (fd, myaddr, len) != len)
-#endif
+      ret = linux_proc_mem_read (fd, memaddr, myaddr, len);
+      if (ret == len)
+	return 0;
+
+      /* An unreadable address fails with EIO, and a partial read
+	 stops at the first unreadable page; the descriptor is fine in
+	 both cases.  Reading nothing at all, or ESRCH, means the
+	 address space it was opened on is gone, e.g. because the
+	 process exec'd.  Reopen it and try once more.  */
+      if (ret == 0 || (ret == -1 && errno == ESRCH))
 	{
 	  close (fd);
-	  goto no_proc;
+	  current_process ()->private->mem_fd = -1;
+	  fd = linux_proc_mem_fd ();
+	  if (fd != -1 && linux_proc_mem_read (fd, memaddr, myaddr, len) == len)
+	    return 0;
 	}
-
-      close (fd);
-      return 0;
     }
 
- no_proc:
   /* Read all the longwords */
   for (i = 0; i < count; i++, addr += sizeof (PTRACE_XFER_TYPE))
     {
@@ -4033,6 +4076,67 @@ linux_read_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return 0;
 }
 
+/* Read several memory regions at once.  process_vm_readv transfers a
+   whole batch of regions in a single syscall; regions it cannot read,
+   or all of them if the syscall is unavailable, go through
+   linux_read_memory one at a time.  */
+
+static void
+linux_read_memory_regions (struct mem_region_read *regions, int count)
+{
+  int i = 0;
+
+#ifdef __NR_process_vm_readv
+  struct iovec local[64], remote[64];
+  int pid = lwpid_of (get_thread_lwp (current_inferior));
+
+  while (i < count)
+    {
+      long ret;
+      int j, n;
+
+      for (n = 0; n < 64 && i + n < count; n++)
+	{
+	  local[n].iov_base = regions[i + n].buf;
+	  local[n].iov_len = regions[i + n].len;
+	  remote[n].iov_base = (void *) (uintptr_t) regions[i + n].addr;
+	  remote[n].iov_len = regions[i + n].len;
+	}
+
+      ret = syscall (__NR_process_vm_readv, pid, local, n, remote, n, 0);
+      if (ret < 0)
+	{
+	  /* EFAULT means the first region is unreadable; anything else
+	     (ENOSYS, EPERM) means the syscall is of no use.  */
+	  if (errno != EFAULT)
+	    break;
+	  ret = 0;
+	}
+
+      /* The transfer stops at the first region that could not be
+	 read completely.  */
+      for (j = 0; j < n && ret >= regions[i + j].len; j++)
+	{
+	  ret -= regions[i + j].len;
+	  regions[i + j].status = 0;
+	}
+      i += j;
+
+      if (j < n)
+	{
+	  regions[i].status = linux_read_memory (regions[i].addr,
+						 regions[i].buf,
+						 regions[i].len);
+	  i++;
+	}
+    }
+#endif
+
+  for (; i < count; i++)
+    regions[i].status = linux_read_memory (regions[i].addr, regions[i].buf,
+					   regions[i].len);
+}
+
 /* Copy LEN bytes of data from debugger memory at MYADDR to inferior's
    memory at MEMADDR.  On failure (cannot write to the inferior)
    returns the value of errno.  */
@@ -4064,6 +4168,22 @@ linux_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
 	       val, (long)memaddr);
     }
 
+#ifdef __NR_process_vm_writev
+  /* Writable memory can be written in a single syscall.  Read-only
+     mappings, such as program text when inserting breakpoints, are
+     refused, and have to be poked with ptrace below.  */
+  {
+    struct iovec local, remote;
+
+    local.iov_base = (void *) myaddr;
+    local.iov_len = len;
+    remote.iov_base = (void *) (uintptr_t) memaddr;
+    remote.iov_len = len;
+    if (syscall (__NR_process_vm_writev, pid, &local, 1, &remote, 1, 0) == len)
+      return 0;
+  }
+#endif
+
   /* Fill start and end extra bytes of buffer with existing memory data.  */
 
   errno = 0;
@@ -5119,7 +5239,8 @@ static struct target_ops linux_target_ops = {
   linux_cancel_breakpoints,
   linux_stabilize_threads,
   linux_install_fast_tracepoint_jump_pad,
-  linux_emit_ops
+  linux_emit_ops,
+  linux_read_memory_regions
 };
 
 static void
@@ -56,6 +56,10 @@ struct process_info_private
   /* libthread_db-specific additions.  Not NULL if this process has loaded
      thread_db, and it is active.  */
   struct thread_db *thread_db;
+
+  /* File descriptor open on /proc/PID/mem, kept open across memory
+     accesses, or -1 if it has not been opened yet.  */
+  int mem_fd;
 };
 
 struct lwp_info;
@@ -203,6 +203,12 @@ register_cache_size (void)
   return register_bytes;
 }
 
+int
+register_count (void)
+{
+  return num_registers;
+}
+
 #ifndef IN_PROCESS_AGENT
 
 void
@@ -213,6 +219,37 @@ registers_to_string (struct regcache *regcache, char *buf)
   convert_int_to_ascii (registers, buf, register_bytes);
 }
 
+int
+register_list_to_string (struct regcache *regcache, char *list, char *buf,
+			 int buf_size)
+{
+  char *out = buf;
+
+  while (*list != '\0')
+    {
+      ULONGEST regno;
+
+      list = unpack_varlen_hex (list, &regno);
+      if (regno >= num_registers
+	  || (*list != ';' && *list != '\0'))
+	return -1;
+      if (*list == ';')
+	list++;
+
+      /* Leave room for the separator and the terminating NUL.  */
+      if ((out - buf) + 2 * register_size (regno) + 2 > buf_size)
+	return -1;
+
+      if (out != buf)
+	*out++ = ';';
+      collect_register_as_string (regcache, regno, out);
+      out += 2 * register_size (regno);
+    }
+
+  *out = '\0';
+  return 0;
+}
+
 void
 registers_from_string (struct regcache *regcache, char *buf)
 {
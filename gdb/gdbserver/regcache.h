@@ -59,6 +59,14 @@ void regcache_invalidate (void);
 
 void registers_to_string (struct regcache *regcache, char *buf);
 
+/* Convert the registers named in LIST, a ';'-separated list of hex
+   register numbers, to a ';'-separated string of register values in
+   BUF, which holds BUF_SIZE bytes.  Return 0 on success, or -1 if LIST
+   is malformed, names an unknown register, or doesn't fit in BUF.  */
+
+int register_list_to_string (struct regcache *regcache, char *list,
+			     char *buf, int buf_size);
+
 /* Convert a string to register values and fill our register cache.  */
 
 void registers_from_string (struct regcache *regcache, char *buf);
@@ -75,6 +83,10 @@ int register_size (int n);
 
 int register_cache_size (void);
 
+/* Return the number of registers in the current register set.  */
+
+int register_count (void);
+
 int find_regno (const char *name);
 
 /* The following two variables are set by auto-generated
@@ -1189,6 +1189,76 @@ outreg (struct regcache *regcache, int regno, char *buf)
   return buf;
 }
 
+/* Append to BUF the registers and the stack memory that GDB asked
+   for with QExpedite, as long as the reply stays below LIMIT.  Return
+   the new end of BUF.  */
+
+static char *
+outexpedited (struct regcache *regcache, char *buf, char *limit)
+{
+  unsigned char *mem;
+  CORE_ADDR sp, start;
+  int i, len;
+
+  for (i = 0; i < num_expedite_regs; i++)
+    {
+      int regno = expedite_regs[i];
+      const char **regp;
+
+      /* Four hex digits of register number, ':' and ';'.  */
+      if (regno < 0 || regno >= register_count ()
+	  || buf + 6 + 2 * register_size (regno) > limit)
+	continue;
+
+      /* Skip the registers we always send.  */
+      for (regp = gdbserver_expedite_regs; *regp; regp++)
+	if (find_regno (*regp) == regno)
+	  break;
+      if (*regp == NULL)
+	buf = outreg (regcache, regno, buf);
+    }
+
+  if (expedite_sp_regno < 0 || expedite_sp_regno >= register_count ())
+    return buf;
+
+  /* The stub runs on the target, so the register is in host order.  */
+  if (register_size (expedite_sp_regno) == sizeof (ULONGEST))
+    {
+      ULONGEST val;
+
+      collect_register (regcache, expedite_sp_regno, &val);
+      sp = val;
+    }
+  else if (register_size (expedite_sp_regno) == sizeof (unsigned int))
+    {
+      unsigned int val;
+
+      collect_register (regcache, expedite_sp_regno, &val);
+      sp = val;
+    }
+  else
+    return buf;
+
+  start = sp - expedite_stack_below;
+  len = expedite_stack_below + expedite_stack_above;
+
+  /* "memory:", up to sixteen digits of address, ',' and ';'.  */
+  if (len <= 0 || buf + 25 + 2 * len > limit)
+    return buf;
+
+  mem = xmalloc (len);
+  if (read_inferior_memory (start, mem, len) == 0)
+    {
+      buf += sprintf (buf, "memory:%s,", paddress (start));
+      convert_int_to_ascii (mem, buf, len);
+      buf += 2 * len;
+      *buf++ = ';';
+    }
+  free (mem);
+
+  return buf;
+}
+
 void
 new_thread_notify (int id)
 {
@@ -1274,6 +1344,9 @@ prepare_resume_reply (char *buf, ptid_t ptid,
 	    buf = outreg (regcache, find_regno (*regp), buf);
 	    regp ++;
 	  }
+
+	/* Leave room for the thread, core and library fields.  */
+	buf = outexpedited (regcache, buf, buf + PBUFSIZ / 2);
 	*buf = '\0';
 
 	/* Formerly, if the debugger had not used any thread features
@@ -18,6 +18,7 @@
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
 #include "server.h"
+#include "search-buffer.h"
 
 #if HAVE_UNISTD_H
 #include <unistd.h>
@@ -91,6 +92,16 @@ int disable_packet_Tthread;
 int disable_packet_qC;
 int disable_packet_qfThreadInfo;
 
+/* Registers GDB asked to have included in every stop reply, on top
+   of the architecture's own expedited registers, and the window of
+   stack memory around register EXPEDITE_SP_REGNO to include with
+   them.  Set by the QExpedite packet.  */
+int *expedite_regs;
+int num_expedite_regs;
+int expedite_sp_regno = -1;
+int expedite_stack_below;
+int expedite_stack_above;
+
 /* Last status reported to GDB.  */
 static struct target_waitstatus last_status;
 static ptid_t last_ptid;
@@ -408,6 +419,62 @@ handle_general_set (char *own_buf)
       return;
     }
 
+  if (strncmp ("QExpedite:", own_buf, strlen ("QExpedite:")) == 0)
+    {
+      char *p = own_buf + strlen ("QExpedite:");
+      ULONGEST regno, below = 0, above = 0, sp_regno = -1;
+      int *regs = NULL;
+      int count = 0;
+
+      while (*p != '\0' && *p != ';')
+	{
+	  p = unpack_varlen_hex (p, &regno);
+	  if (*p == ',')
+	    p++;
+	  else if (*p != ';' && *p != '\0')
+	    regno = (ULONGEST) -1;
+
+	  if (regno >= (ULONGEST) register_count ())
+	    {
+	      free (regs);
+	      write_enn (own_buf);
+	      return;
+	    }
+
+	  regs = xrealloc (regs, (count + 1) * sizeof (int));
+	  regs[count++] = regno;
+	}
+
+      if (*p == ';' && p[1] != '\0')
+	{
+	  p = unpack_varlen_hex (p + 1, &sp_regno);
+	  if (*p == ',')
+	    p = unpack_varlen_hex (p + 1, &below);
+	  if (*p == ',')
+	    p = unpack_varlen_hex (p + 1, &above);
+
+	  /* The window goes into the stop reply as hex, which must fit
+	     in a packet together with the registers.  */
+	  if (*p != '\0' || sp_regno >= (ULONGEST) register_count ()
+	      || below > PBUFSIZ / 4 || above > PBUFSIZ / 4)
+	    {
+	      free (regs);
+	      write_enn (own_buf);
+	      return;
+	    }
+	}
+
+      free (expedite_regs);
+      expedite_regs = regs;
+      num_expedite_regs = count;
+      expedite_sp_regno = sp_regno;
+      expedite_stack_below = below;
+      expedite_stack_above = above;
+
+      write_ok (own_buf);
+      return;
+    }
+
   if (strcmp (own_buf, "QStartNoAckMode") == 0)
     {
       if (remote_debug)
@@ -561,10 +628,12 @@ write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
 static int
 handle_search_memory_1 (CORE_ADDR start_addr, CORE_ADDR search_space_len,
 			gdb_byte *pattern, unsigned pattern_len,
-			gdb_byte *search_buf,
+			gdb_byte **search_bufp,
 			unsigned chunk_size, unsigned search_buf_size,
 			CORE_ADDR *found_addrp)
 {
+  gdb_byte *search_buf = *search_bufp;
+
   /* Prime the search buffer.  */
 
   if (read_memory (start_addr, search_buf, search_buf_size) != 0)
@@ -587,7 +656,8 @@ handle_search_memory_1 (CORE_ADDR start_addr, CORE_ADDR search_space_len,
 				  ? search_space_len
 				  : search_buf_size);
 
-      found_ptr = memmem (search_buf, nr_search_bytes, pattern, pattern_len);
+      found_ptr = search_buffer (search_buf, nr_search_bytes,
+				 pattern, pattern_len);
 
       if (found_ptr != NULL)
 	{
@@ -613,6 +683,25 @@ handle_search_memory_1 (CORE_ADDR start_addr, CORE_ADDR search_space_len,
 	  /* Copy the trailing part of the previous iteration to the front
 	     of the buffer for the next iteration.  */
 	  memcpy (search_buf, search_buf + chunk_size, keep_len);
+	  start_addr += chunk_size;
+
+	  /* Nothing found yet; read more at a time.  */
+	  if (chunk_size < SEARCH_MAX_CHUNK_SIZE
+	      && search_space_len - keep_len > chunk_size)
+	    {
+	      gdb_byte *new_buf;
+
+	      chunk_size = (2 * chunk_size < SEARCH_MAX_CHUNK_SIZE
+			    ? 2 * chunk_size : SEARCH_MAX_CHUNK_SIZE);
+	      search_buf_size = chunk_size + keep_len;
+	      new_buf = realloc (search_buf, search_buf_size);
+	      if (new_buf == NULL)
+		{
+		  warning ("Unable to allocate memory to perform the search.");
+		  return -1;
+		}
+	      search_buf = *search_bufp = new_buf;
+	    }
 
 	  nr_to_read = (search_space_len - keep_len < chunk_size
 			? search_space_len - keep_len
@@ -625,8 +714,6 @@ handle_search_memory_1 (CORE_ADDR start_addr, CORE_ADDR search_space_len,
 		       (long) read_addr);
 	      return -1;
 	    }
-
-	  start_addr += chunk_size;
 	}
     }
 
@@ -644,8 +731,6 @@ handle_search_memory (char *own_buf, int packet_len)
   CORE_ADDR search_space_len;
   gdb_byte *pattern;
   unsigned int pattern_len;
-  /* NOTE: also defined in find.c testcase.  */
-#define SEARCH_CHUNK_SIZE 16000
   const unsigned chunk_size = SEARCH_CHUNK_SIZE;
   /* Buffer to hold memory contents for searching.  */
   gdb_byte *search_buf;
@@ -689,7 +774,7 @@ handle_search_memory (char *own_buf, int packet_len)
 
   found = handle_search_memory_1 (start_addr, search_space_len,
 				  pattern, pattern_len,
-				  search_buf, chunk_size, search_buf_size,
+				  &search_buf, chunk_size, search_buf_size,
 				  &found_addr);
 
   if (found > 0)
@@ -1438,6 +1523,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       sprintf (own_buf, "PacketSize=%x;QPassSignals+", PBUFSIZ - 1);
 
+      strcat (own_buf, ";QExpedite+");
+
       /* We do not have any hook to indicate whether the target backend
 	 supports qXfer:libraries:read, so always report it.  */
       strcat (own_buf, ";qXfer:libraries:read+");
@@ -1471,6 +1558,9 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 
       strcat (own_buf, ";qXfer:threads:read+");
 
+      strcat (own_buf, ";qFetchRegs+");
+      strcat (own_buf, ";qReadMemRegions+");
+
       if (target_supports_tracepoints ())
 	{
 	  strcat (own_buf, ";ConditionalTracepoints+");
@@ -1486,6 +1576,123 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  /* Fetch an explicit list of registers.  */
+  if (strncmp ("qFetchRegs:", own_buf, 11) == 0)
+    {
+      char *list;
+      struct regcache *regcache;
+      int ret;
+
+      require_running (own_buf);
+
+      /* The reply overwrites the request.  */
+      list = xstrdup (own_buf + 11);
+      if (current_traceframe >= 0)
+	{
+	  regcache = new_register_cache ();
+	  if (fetch_traceframe_registers (current_traceframe,
+					  regcache, -1) == 0)
+	    ret = register_list_to_string (regcache, list, own_buf, PBUFSIZ);
+	  else
+	    ret = -1;
+	  free_register_cache (regcache);
+	}
+      else
+	{
+	  set_desired_inferior (1);
+	  regcache = get_thread_regcache (current_inferior, 1);
+	  ret = register_list_to_string (regcache, list, own_buf, PBUFSIZ);
+	}
+
+      if (ret != 0)
+	write_enn (own_buf);
+      free (list);
+      return;
+    }
+
+  /* Read several memory regions in one go.  */
+  if (strncmp ("qReadMemRegions:", own_buf, 16) == 0)
+    {
+      struct mem_region_read *regions;
+      unsigned char *data;
+      char *p;
+      int count, i, total;
+
+      require_running (own_buf);
+
+      count = 1;
+      for (p = own_buf + 16; *p != '\0'; p++)
+	if (*p == ';')
+	  count++;
+      regions = xmalloc (count * sizeof (*regions));
+
+      /* Parse the list, and make sure the reply will fit: two hex
+	 digits per byte, plus the separators.  */
+      total = 0;
+      p = own_buf + 16;
+      for (i = 0; i < count; i++)
+	{
+	  ULONGEST addr, len;
+
+	  p = unpack_varlen_hex (p, &addr);
+	  if (*p++ != ',')
+	    break;
+	  p = unpack_varlen_hex (p, &len);
+	  if (*p != (i == count - 1 ? '\0' : ';'))
+	    break;
+	  p++;
+
+	  if (len > PBUFSIZ / 2)
+	    break;
+	  total += len;
+	  if (2 * total + count > PBUFSIZ - 1)
+	    break;
+
+	  regions[i].addr = addr;
+	  regions[i].len = len;
+	}
+
+      if (i < count)
+	{
+	  free (regions);
+	  write_enn (own_buf);
+	  return;
+	}
+
+      data = xmalloc (total > 0 ? total : 1);
+      total = 0;
+      for (i = 0; i < count; i++)
+	{
+	  regions[i].buf = data + total;
+	  total += regions[i].len;
+	}
+
+      if (current_traceframe >= 0)
+	for (i = 0; i < count; i++)
+	  regions[i].status = read_memory (regions[i].addr, regions[i].buf,
+					   regions[i].len);
+      else
+	read_inferior_memory_regions (regions, count);
+
+      /* An unreadable region is reported as an empty field.  */
+      p = own_buf;
+      for (i = 0; i < count; i++)
+	{
+	  if (i > 0)
+	    *p++ = ';';
+	  if (regions[i].status == 0)
+	    {
+	      convert_int_to_ascii (regions[i].buf, p, regions[i].len);
+	      p += 2 * regions[i].len;
+	    }
+	}
+      *p = '\0';
+
+      free (data);
+      free (regions);
+      return;
+    }
+
   /* Thread-local storage support.  */
   if (the_target->get_tls_address != NULL
       && strncmp ("qGetTLSAddr:", own_buf, 12) == 0)
@@ -2569,6 +2776,9 @@ main (int argc, char *argv[])
     {
       noack_mode = 0;
       multi_process = 0;
+      /* A new GDB says for itself what it wants expedited.  */
+      num_expedite_regs = 0;
+      expedite_sp_regno = -1;
       /* Be sure we're out of tfind mode.  */
       current_traceframe = -1;
 
@@ -331,6 +331,12 @@ extern int disable_packet_Tthread;
 extern int disable_packet_qC;
 extern int disable_packet_qfThreadInfo;
 
+extern int *expedite_regs;
+extern int num_expedite_regs;
+extern int expedite_sp_regno;
+extern int expedite_stack_below;
+extern int expedite_stack_above;
+
 extern int multi_process;
 extern int non_stop;
 
@@ -62,6 +62,24 @@ read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len)
   return res;
 }
 
+void
+read_inferior_memory_regions (struct mem_region_read *regions, int count)
+{
+  int i;
+
+  if (the_target->read_memory_regions != NULL)
+    (*the_target->read_memory_regions) (regions, count);
+  else
+    for (i = 0; i < count; i++)
+      regions[i].status = (*the_target->read_memory) (regions[i].addr,
+						      regions[i].buf,
+						      regions[i].len);
+
+  for (i = 0; i < count; i++)
+    if (regions[i].status == 0)
+      check_mem_read (regions[i].addr, regions[i].buf, regions[i].len);
+}
+
 int
 write_inferior_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
 		       int len)
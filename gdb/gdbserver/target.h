@@ -57,6 +57,22 @@ struct thread_resume
   int sig;
 };
 
+/* One region of inferior memory to read, as part of a
+   read_memory_regions request.  */
+
+struct mem_region_read
+{
+  /* The region's start address and length.  */
+  CORE_ADDR addr;
+  int len;
+
+  /* Where to store the region's contents.  */
+  unsigned char *buf;
+
+  /* Set to 0 if the whole region was read, or to errno on failure.  */
+  int status;
+};
+
 /* Generally, what has the program done?  */
 enum target_waitkind
   {
@@ -355,6 +371,13 @@ struct target_ops
   /* Return the bytecode operations vector for the current inferior.
      Returns NULL if bytecode compilation is not supported.  */
   struct emit_ops *(*emit_ops) (void);
+
+  /* Read the COUNT memory regions described by REGIONS, filling in
+     each region's status.  This should generally be called through
+     read_inferior_memory_regions, which handles breakpoint shadowing.
+     NULL if the target has no faster way to do this than calling
+     read_memory once per region.  */
+  void (*read_memory_regions) (struct mem_region_read *regions, int count);
 };
 
 extern struct target_ops *the_target;
@@ -470,6 +493,9 @@ ptid_t mywait (ptid_t ptid, struct target_waitstatus *ourstatus, int options,
 
 int read_inferior_memory (CORE_ADDR memaddr, unsigned char *myaddr, int len);
 
+void read_inferior_memory_regions (struct mem_region_read *regions,
+				   int count);
+
 int write_inferior_memory (CORE_ADDR memaddr, const unsigned char *myaddr,
 			   int len);
 
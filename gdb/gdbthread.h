@@ -191,6 +191,13 @@ struct thread_info
   /* Function that is called to free PRIVATE.  If this is NULL, then
      xfree will be called on PRIVATE.  */
   void (*private_dtor) (struct private_thread_info *);
+
+  /* The previous thread in the thread list, and the next threads in
+     the buckets of the hash tables that index the list by ptid and by
+     thread number.  These fields are internal to thread.c.  */
+  struct thread_info *prev;
+  struct thread_info *ptid_hash_next;
+  struct thread_info *num_hash_next;
 };
 
 /* Create an empty thread list, or empty the existing one.  */
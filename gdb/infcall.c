@@ -450,6 +450,7 @@ call_function_by_hand (struct value *function, int nargs, struct value **args)
   CORE_ADDR bp_addr;
   struct frame_id dummy_id;
   struct cleanup *args_cleanup;
+  struct cleanup *stack_writes_cleanup;
   struct frame_info *frame;
   struct gdbarch *gdbarch;
   struct cleanup *terminate_bp_cleanup;
@@ -593,6 +594,13 @@ call_function_by_hand (struct value *function, int nargs, struct value **args)
   /* The actual breakpoint (at BP_ADDR) is inserted separatly so there
      is no need to write that out.  */
 
+  /* Nearly everything written to memory from here until the dummy
+     frame is complete goes onto the stack.  Let the stack cache
+     collect those writes, so that with "set dcache write-back on" they
+     reach the target in a few large transfers when the inferior is
+     resumed, instead of one small transfer each.  */
+  stack_writes_cleanup = target_begin_stack_writes ();
+
   switch (gdbarch_call_dummy_location (gdbarch))
     {
     case ON_STACK:
@@ -729,6 +737,7 @@ call_function_by_hand (struct value *function, int nargs, struct value **args)
 				sp, struct_return, struct_addr);
 
   do_cleanups (args_cleanup);
+  do_cleanups (stack_writes_cleanup);
 
   /* Set up a frame ID for the dummy frame so we can pass it to
      set_momentary_breakpoint.  We need to give the breakpoint a frame
@@ -1906,6 +1906,27 @@ default_print_registers_info (struct gdbarch *gdbarch,
 		      + gdbarch_num_pseudo_regs (gdbarch);
   gdb_byte buffer[MAX_REGISTER_SIZE];
 
+  /* Let the target fetch the raw registers we are about to print in
+     one go.  */
+  if (regnum == -1)
+    {
+      volatile struct gdb_exception ex;
+      struct reggroup *group = print_all ? all_reggroup : general_reggroup;
+      int *regnums = alloca (gdbarch_num_regs (gdbarch) * sizeof (int));
+      int nregs = 0;
+
+      for (i = 0; i < gdbarch_num_regs (gdbarch); i++)
+	if (gdbarch_register_reggroup_p (gdbarch, i, group))
+	  regnums[nregs++] = i;
+
+      /* This is only an optimization; any error will be reported when
+	 the register is printed.  */
+      TRY_CATCH (ex, RETURN_MASK_ERROR)
+	{
+	  regcache_raw_prefetch (get_current_regcache (), nregs, regnums);
+	}
+    }
+
   for (i = 0; i < numregs; i++)
     {
       /* Decide between printing all regs, non-float / vector regs, or
@@ -1889,6 +1889,12 @@ proceed (CORE_ADDR addr, enum target_signal siggnal, int step)
       return;
     }
 
+  /* A target that goes backward by re-executing the program does so
+     now, while nothing is running; the stop it arrives at is then
+     reported by the resume and wait below.  */
+  if (execution_direction == EXEC_REVERSE)
+    target_prepare_to_resume_reverse (step);
+
   regcache = get_current_regcache ();
   gdbarch = get_regcache_arch (regcache);
   aspace = get_regcache_aspace (regcache);
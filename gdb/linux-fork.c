@@ -30,12 +30,19 @@
 #include "linux-fork.h"
 #include "linux-nat.h"
 #include "gdbthread.h"
+#include "breakpoint.h"
+#include "observer.h"
+#include "exceptions.h"
+#include "record.h"
+#include "block.h"
+#include "language.h"
 
 #include <sys/ptrace.h>
 #include "gdb_wait.h"
 #include <sys/param.h>
 #include "gdb_dirent.h"
 #include <ctype.h>
+#include <limits.h>
 
 struct fork_info *fork_list;
 static int highest_fork_num;
@@ -43,6 +50,21 @@ static int highest_fork_num;
 /* Prevent warning from -Wmissing-prototypes.  */
 extern void _initialize_linux_fork (void);
 
+/* A stop of the program on its way from an automatic checkpoint to a
+   later position in its history: where it stopped, its registers
+   there, and the condition of the breakpoint that stopped it, if any.
+   The position is found again by re-executing the program from the
+   checkpoint and counting these stops, in order.  */
+
+typedef struct auto_checkpoint_stop
+{
+  CORE_ADDR pc;
+  struct regcache *regs;
+  char *cond_string;
+} auto_checkpoint_stop_s;
+
+DEF_VEC_O (auto_checkpoint_stop_s);
+
 /* Fork list data structure:  */
 struct fork_info
 {
@@ -55,8 +77,59 @@ struct fork_info
   int clobber_regs;		/* True if we should restore saved regs.  */
   off_t *filepos;		/* Set of open file descriptors' offsets.  */
   int maxfd;
+  int auto_num;			/* Position of an automatic checkpoint
+				   in the program's history, or 0.  */
+  VEC (auto_checkpoint_stop_s) *stops;	/* The stops since the automatic
+					   checkpoint before this one.  */
 };
 
+/* Automatic checkpoints.  When enabled, a checkpoint is taken every
+   AUTO_CHECKPOINT_INTERVAL times the program stops, and at most
+   AUTO_CHECKPOINT_LIMIT of them are kept.  They are numbered by their
+   position in the program's history, so that "reverse-continue" can
+   re-execute the program from the nearest one before the current
+   position.  */
+
+static int auto_checkpoint_p = 0;
+static int auto_checkpoint_interval = 1;
+static unsigned int auto_checkpoint_limit = 16;
+
+/* The position of the newest automatic checkpoint.  */
+static int highest_auto_num;
+
+/* The newest automatic checkpoint strictly before the position of the
+   current process, and the automatic checkpoint at that very position,
+   if any.  Checkpoints after both are in the future of the current
+   process; they are discarded when it runs forward again.  */
+static int auto_base_num;
+static int auto_current_num;
+
+/* The stops since AUTO_BASE_NUM, unless the current process is at
+   AUTO_CURRENT_NUM.  */
+static VEC (auto_checkpoint_stop_s) *auto_current_stops;
+
+/* Number of stops since the last automatic checkpoint.  */
+static int auto_checkpoint_stops;
+
+/* Non-zero while we are taking, deleting or re-executing from
+   automatic checkpoints.  */
+static int auto_checkpoint_busy;
+
+/* The stop that going backward arrived at, and whether it is yet to
+   be reported by the native target.  */
+static int reverse_event_pending;
+static ptid_t reverse_event_ptid;
+static struct target_waitstatus reverse_event_status;
+
+/* Non-zero if the program last stopped going backward.  Such a stop
+   neither takes an automatic checkpoint nor rewrites the history.  */
+static int reverse_stop_p;
+
+static struct fork_info *find_auto_checkpoint (int num);
+static struct fork_info *find_auto_checkpoint_before (int num);
+static void free_auto_checkpoint_stops (VEC (auto_checkpoint_stop_s) **);
+static void linux_fork_forget_auto_checkpoint (struct fork_info *fp);
+
 /* Fork list methods:  */
 
 int
@@ -111,6 +184,7 @@ free_fork (struct fork_info *fp)
 	regcache_xfree (fp->savedregs);
       if (fp->filepos)
 	xfree (fp->filepos);
+      free_auto_checkpoint_stops (&fp->stops);
       xfree (fp);
     }
 }
@@ -129,6 +203,9 @@ delete_fork (ptid_t ptid)
   if (!fp)
     return;
 
+  if (fp->auto_num != 0)
+    linux_fork_forget_auto_checkpoint (fp);
+
   if (fpprev)
     fpprev->next = fp->next;
   else
@@ -188,6 +265,160 @@ find_fork_pid (pid_t pid)
   return NULL;
 }
 
+/* Find the automatic checkpoint at position NUM.  */
+static struct fork_info *
+find_auto_checkpoint (int num)
+{
+  struct fork_info *fp;
+
+  if (num == 0)
+    return NULL;
+
+  for (fp = fork_list; fp; fp = fp->next)
+    if (fp->auto_num == num)
+      return fp;
+
+  return NULL;
+}
+
+/* Find the newest automatic checkpoint before position NUM.  */
+static struct fork_info *
+find_auto_checkpoint_before (int num)
+{
+  struct fork_info *fp, *best = NULL;
+
+  for (fp = fork_list; fp; fp = fp->next)
+    if (fp->auto_num != 0 && fp->auto_num < num
+	&& (best == NULL || fp->auto_num > best->auto_num))
+      best = fp;
+
+  return best;
+}
+
+/* Find the oldest automatic checkpoint after position NUM.  */
+static struct fork_info *
+find_auto_checkpoint_after (int num)
+{
+  struct fork_info *fp, *best = NULL;
+
+  for (fp = fork_list; fp; fp = fp->next)
+    if (fp->auto_num > num
+	&& (best == NULL || fp->auto_num < best->auto_num))
+      best = fp;
+
+  return best;
+}
+
+/* Free the stops in *STOPSP.  */
+
+static void
+free_auto_checkpoint_stops (VEC (auto_checkpoint_stop_s) **stopsp)
+{
+  struct auto_checkpoint_stop *stop;
+  int ix;
+
+  for (ix = 0; VEC_iterate (auto_checkpoint_stop_s, *stopsp, ix, stop); ix++)
+    {
+      regcache_xfree (stop->regs);
+      xfree (stop->cond_string);
+    }
+  VEC_free (auto_checkpoint_stop_s, *stopsp);
+}
+
+static void
+free_auto_checkpoint_stops_cleanup (void *arg)
+{
+  free_auto_checkpoint_stops (arg);
+}
+
+/* Append a copy of the first COUNT stops in FROM to *STOPSP.  */
+
+static void
+copy_auto_checkpoint_stops (VEC (auto_checkpoint_stop_s) **stopsp,
+			    VEC (auto_checkpoint_stop_s) *from, int count)
+{
+  struct auto_checkpoint_stop *stop, copy;
+  int ix;
+
+  for (ix = 0;
+       ix < count && VEC_iterate (auto_checkpoint_stop_s, from, ix, stop);
+       ix++)
+    {
+      copy.pc = stop->pc;
+      copy.regs = regcache_dup (stop->regs);
+      copy.cond_string = stop->cond_string ? xstrdup (stop->cond_string) : NULL;
+      VEC_safe_push (auto_checkpoint_stop_s, *stopsp, &copy);
+    }
+}
+
+/* Put a copy of the stops in FIRST before those in *STOPSP.  */
+
+static void
+prepend_auto_checkpoint_stops (VEC (auto_checkpoint_stop_s) **stopsp,
+			       VEC (auto_checkpoint_stop_s) *first)
+{
+  VEC (auto_checkpoint_stop_s) *stops = NULL;
+  struct auto_checkpoint_stop *stop;
+  int ix;
+
+  copy_auto_checkpoint_stops (&stops, first,
+			      VEC_length (auto_checkpoint_stop_s, first));
+  for (ix = 0; VEC_iterate (auto_checkpoint_stop_s, *stopsp, ix, stop); ix++)
+    VEC_safe_push (auto_checkpoint_stop_s, stops, stop);
+  VEC_free (auto_checkpoint_stop_s, *stopsp);
+  *stopsp = stops;
+}
+
+/* FP stops being an automatic checkpoint.  The positions after it are
+   now reached from the checkpoint before it, through its stops.  */
+
+static void
+linux_fork_forget_auto_checkpoint (struct fork_info *fp)
+{
+  struct fork_info *before = find_auto_checkpoint_before (fp->auto_num);
+  struct fork_info *after = find_auto_checkpoint_after (fp->auto_num);
+
+  if (after != NULL)
+    prepend_auto_checkpoint_stops (&after->stops, fp->stops);
+
+  if (fp->auto_num == auto_current_num)
+    {
+      free_auto_checkpoint_stops (&auto_current_stops);
+      copy_auto_checkpoint_stops (&auto_current_stops, fp->stops,
+				  VEC_length (auto_checkpoint_stop_s,
+					      fp->stops));
+      auto_current_num = 0;
+    }
+  else if (fp->auto_num == auto_base_num)
+    {
+      prepend_auto_checkpoint_stops (&auto_current_stops, fp->stops);
+      auto_base_num = before ? before->auto_num : 0;
+    }
+
+  fp->auto_num = 0;
+}
+
+/* The checkpoint FP is about to become the current process, and to
+   run.  It no longer holds a position in the program's history; the
+   current process is now where FP was, after the automatic checkpoint
+   before it, if any.  */
+
+static void
+linux_fork_resume_checkpoint (struct fork_info *fp)
+{
+  struct fork_info *before;
+
+  before = fp->auto_num ? find_auto_checkpoint_before (fp->auto_num) : NULL;
+  if (fp->auto_num != 0)
+    linux_fork_forget_auto_checkpoint (fp);
+
+  free_auto_checkpoint_stops (&auto_current_stops);
+  auto_current_stops = fp->stops;
+  fp->stops = NULL;
+  auto_base_num = before ? before->auto_num : 0;
+  auto_current_num = 0;
+}
+
 static ptid_t
 fork_id_to_ptid (int num)
 {
@@ -203,6 +434,14 @@ init_fork_list (void)
 {
   struct fork_info *fp, *fpnext;
 
+  highest_auto_num = 0;
+  auto_base_num = 0;
+  auto_current_num = 0;
+  auto_checkpoint_stops = 0;
+  free_auto_checkpoint_stops (&auto_current_stops);
+  reverse_event_pending = 0;
+  reverse_stop_p = 0;
+
   if (!fork_list)
     return;
 
@@ -371,6 +610,7 @@ linux_fork_mourn_inferior (void)
      inferior_ptid yet.  */
   gdb_assert (fork_list);
 
+  linux_fork_resume_checkpoint (fork_list);
   fork_load_infrun_state (fork_list);
   printf_filtered (_("[Switching to %s]\n"),
 		   target_pid_to_str (inferior_ptid));
@@ -579,6 +819,8 @@ info_checkpoints_command (char *arg, int from_tty)
       printf_filtered ("%d %s", fp->num, target_pid_to_str (fp->ptid));
       if (fp->num == 0)
 	printf_filtered (_(" (main process)"));
+      if (fp->auto_num != 0)
+	printf_filtered (_(" (automatic)"));
       printf_filtered (_(" at "));
       fputs_filtered (paddress (gdbarch, pc), gdb_stdout);
 
@@ -623,8 +865,11 @@ linux_fork_checkpointing_p (int pid)
   return (checkpointing_pid == pid);
 }
 
-static void
-checkpoint_command (char *args, int from_tty)
+/* Make the current process fork, and keep the child stopped as a
+   checkpoint of its current state.  Return the new checkpoint.  */
+
+static struct fork_info *
+checkpoint_fork (int from_tty)
 {
   struct objfile *fork_objf;
   struct gdbarch *gdbarch;
@@ -680,12 +925,20 @@ checkpoint_command (char *args, int from_tty)
     error (_("Failed to find new fork"));
   fork_save_infrun_state (fp, 1);
   fp->parent_ptid = last_target_ptid;
+  return fp;
 }
 
 static void
-linux_fork_context (struct fork_info *newfp, int from_tty)
+checkpoint_command (char *args, int from_tty)
+{
+  checkpoint_fork (from_tty);
+}
+
+/* Switch to the process NEWFP.  */
+
+static void
+linux_fork_switch (struct fork_info *newfp)
 {
-  /* Now we attempt to switch processes.  */
   struct fork_info *oldfp;
 
   gdb_assert (newfp != NULL);
@@ -697,6 +950,14 @@ linux_fork_context (struct fork_info *newfp, int from_tty)
   remove_breakpoints ();
   fork_load_infrun_state (newfp);
   insert_breakpoints ();
+}
+
+static void
+linux_fork_context (struct fork_info *newfp, int from_tty)
+{
+  /* Now we attempt to switch processes.  */
+  linux_fork_resume_checkpoint (newfp);
+  linux_fork_switch (newfp);
 
   printf_filtered (_("Switching to %s\n"),
 		   target_pid_to_str (inferior_ptid));
@@ -719,6 +980,652 @@ restart_command (char *args, int from_tty)
   linux_fork_context (fp, from_tty);
 }
 
+/* Automatic checkpoints, and reverse execution by re-executing the
+   program from them.  */
+
+/* Kill the process FP, which is not the current one, and forget it.
+   Unlike "delete checkpoint", this does not make its parent reap it:
+   automatic checkpoints and the copies re-executed from them come and
+   go too often to afford an inferior call each time.  */
+
+static void
+linux_fork_kill (struct fork_info *fp)
+{
+  pid_t pid = ptid_get_pid (fp->ptid);
+  pid_t ret;
+  int status;
+
+  gdb_assert (!ptid_equal (fp->ptid, inferior_ptid));
+
+  do
+    {
+      kill (pid, SIGKILL);
+      ret = waitpid (pid, &status, 0);
+    }
+  while (ret == pid && WIFSTOPPED (status));
+
+  delete_fork (fp->ptid);
+}
+
+/* Return non-zero if the registers in A and B have the same contents.  */
+
+static int
+regcaches_equal_p (struct regcache *a, struct regcache *b)
+{
+  struct gdbarch *gdbarch = get_regcache_arch (a);
+  gdb_byte abuf[MAX_REGISTER_SIZE], bbuf[MAX_REGISTER_SIZE];
+  int regnum;
+
+  for (regnum = 0; regnum < gdbarch_num_regs (gdbarch); regnum++)
+    {
+      regcache_raw_read (a, regnum, abuf);
+      regcache_raw_read (b, regnum, bbuf);
+      if (memcmp (abuf, bbuf, register_size (gdbarch, regnum)) != 0)
+	return 0;
+    }
+
+  return 1;
+}
+
+/* Return non-zero if the program being re-executed, arrived at PC
+   with the registers in REGCACHE, is making the stop STOP again.  Other
+   arrivals with the same registers are told apart by the condition of
+   the breakpoint that stopped the program the first time; the count of
+   stops does the rest.  */
+
+static int
+auto_checkpoint_stop_matches_p (struct auto_checkpoint_stop *stop,
+				struct regcache *regcache, CORE_ADDR pc)
+{
+  volatile struct gdb_exception e;
+  int matches = 1;
+
+  if (pc != stop->pc || !regcaches_equal_p (regcache, stop->regs))
+    return 0;
+
+  if (stop->cond_string == NULL)
+    return 1;
+
+  /* The breakpoint may have been deleted since; parse its condition
+     again.  If that no longer works, go by the registers alone.  */
+  TRY_CATCH (e, RETURN_MASK_ERROR)
+    {
+      char *s = stop->cond_string;
+      struct expression *expr = parse_exp_1 (&s, block_for_pc (pc), 0);
+      struct cleanup *old_chain = make_cleanup (free_current_contents, &expr);
+
+      select_frame (get_current_frame ());
+      matches = value_true (evaluate_expression (expr));
+      do_cleanups (old_chain);
+    }
+
+  return matches;
+}
+
+static void
+remove_raw_breakpoint_cleanup (void *arg)
+{
+  void **bpp = arg;
+
+  if (*bpp != NULL)
+    {
+      deprecated_remove_raw_breakpoint (target_gdbarch, *bpp);
+      *bpp = NULL;
+    }
+}
+
+/* Kill the process whose ptid ARG points to, unless it is the current
+   one or already gone.  */
+
+static void
+kill_fork_cleanup (void *arg)
+{
+  ptid_t *ptidp = arg;
+  struct fork_info *fp = find_fork_ptid (*ptidp);
+
+  if (fp != NULL && !ptid_equal (fp->ptid, inferior_ptid))
+    linux_fork_kill (fp);
+}
+
+/* Switch back to the process whose ptid ARG points to.  */
+
+static void
+switch_fork_cleanup (void *arg)
+{
+  ptid_t *ptidp = arg;
+  struct fork_info *fp = find_fork_ptid (*ptidp);
+
+  if (fp != NULL && !ptid_equal (fp->ptid, inferior_ptid))
+    linux_fork_switch (fp);
+}
+
+/* Re-execute the program from a copy of the checkpoint FROM until it
+   has made the stops in STOPS again, arriving at the position they
+   lead to.  Whenever a user breakpoint would have stopped it on the
+   way, make it fork there, keeping only the newest of these
+   checkpoints.  Return that checkpoint and set *HIT_STOPS to the stops
+   leading to it from FROM, or return NULL if nothing was hit.  FROM is
+   the current process on return; the copy is gone.  */
+
+static struct fork_info *
+linux_fork_replay (struct fork_info *from,
+		   VEC (auto_checkpoint_stop_s) *stops,
+		   VEC (auto_checkpoint_stop_s) **hit_stops)
+{
+  struct fork_info *copy;
+  struct auto_checkpoint_stop *stop, hit_stop;
+  struct regcache *regcache;
+  struct gdbarch *gdbarch;
+  struct address_space *aspace;
+  struct breakpoint *b;
+  struct target_waitstatus ws;
+  struct cleanup *old_chain, *copy_chain;
+  enum target_signal sig = TARGET_SIGNAL_0;
+  ptid_t from_ptid, copy_ptid, hit_ptid = null_ptid;
+  CORE_ADDR pc;
+  void *raw_bp = NULL;
+  int step, next = 0, is_stop;
+
+  *hit_stops = NULL;
+  if (!ptid_equal (from->ptid, inferior_ptid))
+    linux_fork_switch (from);
+  if (VEC_empty (auto_checkpoint_stop_s, stops))
+    return NULL;
+  stop = VEC_index (auto_checkpoint_stop_s, stops, 0);
+
+  from_ptid = from->ptid;
+  copy = checkpoint_fork (0);
+  copy_ptid = copy->ptid;
+  linux_fork_switch (copy);
+
+  /* Unless we get to return it, the newest checkpoint at a hit goes
+     too.  */
+  old_chain = make_cleanup (kill_fork_cleanup, &hit_ptid);
+  copy_chain = make_cleanup (kill_fork_cleanup, &copy_ptid);
+  make_cleanup (switch_fork_cleanup, &from_ptid);
+
+  regcache = get_current_regcache ();
+  gdbarch = get_regcache_arch (regcache);
+  aspace = get_regcache_aspace (regcache);
+  pc = regcache_read_pc (regcache);
+
+  make_cleanup (remove_raw_breakpoint_cleanup, &raw_bp);
+  if (!breakpoint_inserted_here_p (aspace, stop->pc))
+    raw_bp = deprecated_insert_raw_breakpoint (gdbarch, aspace, stop->pc);
+
+  /* Arriving at the checkpoint's own position was the last event
+     before the checkpoint was taken, not the first one after it.  */
+  step = breakpoint_inserted_here_p (aspace, pc)
+	 || (raw_bp != NULL && pc == stop->pc);
+
+  while (1)
+    {
+      int stepped = step;
+
+      if (step)
+	{
+	  remove_raw_breakpoint_cleanup (&raw_bp);
+	  remove_breakpoints ();
+	}
+      target_resume (inferior_ptid, step, sig);
+      sig = TARGET_SIGNAL_0;
+      target_wait (inferior_ptid, &ws, 0);
+      set_executing (inferior_ptid, 0);
+      set_running (inferior_ptid, 0);
+      registers_changed ();
+
+      if (step)
+	{
+	  insert_breakpoints ();
+	  if (!breakpoint_inserted_here_p (aspace, stop->pc))
+	    raw_bp = deprecated_insert_raw_breakpoint (gdbarch, aspace,
+						       stop->pc);
+	  step = 0;
+	}
+
+      switch (ws.kind)
+	{
+	case TARGET_WAITKIND_STOPPED:
+	  break;
+
+	case TARGET_WAITKIND_FORKED:
+	case TARGET_WAITKIND_VFORKED:
+	  /* The program forked again while being re-executed; let the
+	     new child go.  */
+	  detach_breakpoints (ptid_get_pid (ws.value.related_pid));
+	  ptrace (PTRACE_DETACH, ptid_get_pid (ws.value.related_pid), 0, 0);
+	  continue;
+
+	case TARGET_WAITKIND_SPURIOUS:
+	  continue;
+
+	case TARGET_WAITKIND_EXITED:
+	case TARGET_WAITKIND_SIGNALLED:
+	  /* The copy is gone; go back to the checkpoint.  */
+	  mark_breakpoints_out ();
+	  fork_load_infrun_state (from);
+	  delete_fork (copy_ptid);
+	  error (_("The program exited while being re-executed "
+		   "from checkpoint %d."), from->num);
+
+	default:
+	  error (_("Unexpected event while re-executing "
+		   "from checkpoint %d."), from->num);
+	}
+
+      if (ws.value.sig != TARGET_SIGNAL_TRAP)
+	{
+	  /* Deliver the signals the program got the first time.  */
+	  if (signal_pass_state (ws.value.sig))
+	    sig = ws.value.sig;
+	  continue;
+	}
+      if (stepped)
+	continue;
+
+      regcache = get_current_regcache ();
+      pc = regcache_read_pc (regcache) - gdbarch_decr_pc_after_break (gdbarch);
+      if (!breakpoint_inserted_here_p (aspace, pc)
+	  && (raw_bp == NULL || pc != stop->pc))
+	continue;
+      regcache_write_pc (regcache, pc);
+
+      is_stop = auto_checkpoint_stop_matches_p (stop, regcache, pc);
+      if (is_stop)
+	{
+	  if (++next == VEC_length (auto_checkpoint_stop_s, stops))
+	    break;
+	  stop = VEC_index (auto_checkpoint_stop_s, stops, next);
+	}
+
+      b = user_breakpoint_stops_here (aspace, pc);
+      if (b != NULL)
+	{
+	  /* This may be the last hit; keep it, so that coming back to
+	     it does not take another re-execution.  */
+	  free_auto_checkpoint_stops (hit_stops);
+	  copy_auto_checkpoint_stops (hit_stops, stops, next);
+	  if (!is_stop)
+	    {
+	      hit_stop.pc = pc;
+	      hit_stop.regs = regcache_dup (get_current_regcache ());
+	      hit_stop.cond_string = (b->cond_string
+				      ? xstrdup (b->cond_string) : NULL);
+	      VEC_safe_push (auto_checkpoint_stop_s, *hit_stops, &hit_stop);
+	    }
+
+	  remove_raw_breakpoint_cleanup (&raw_bp);
+	  kill_fork_cleanup (&hit_ptid);
+	  hit_ptid = checkpoint_fork (0)->ptid;
+	}
+
+      step = 1;
+    }
+
+  /* Go back to FROM, and kill the copy.  */
+  do_cleanups (copy_chain);
+  discard_cleanups (old_chain);
+
+  return find_fork_ptid (hit_ptid);
+}
+
+/* Delete the oldest automatic checkpoints until no more than the limit
+   are left.  The ones the current process is at or after are kept.  */
+
+static void
+linux_fork_trim_auto_checkpoints (void)
+{
+  struct fork_info *fp, *oldest;
+  unsigned int count;
+
+  while (auto_checkpoint_limit != 0)
+    {
+      count = 0;
+      oldest = NULL;
+      for (fp = fork_list; fp; fp = fp->next)
+	if (fp->auto_num != 0)
+	  {
+	    count++;
+	    if (fp->auto_num != auto_base_num
+		&& fp->auto_num != auto_current_num
+		&& (oldest == NULL || fp->auto_num < oldest->auto_num))
+	      oldest = fp;
+	  }
+      if (count <= auto_checkpoint_limit || oldest == NULL)
+	break;
+      linux_fork_kill (oldest);
+    }
+}
+
+/* State of a "reverse-continue" in progress, for cleaning up after an
+   error.  */
+
+struct reverse_continue_state
+{
+  /* The process that was current when the command started.  */
+  ptid_t live_ptid;
+};
+
+static void
+reverse_continue_cleanup (void *arg)
+{
+  struct reverse_continue_state *state = arg;
+  struct fork_info *live = find_fork_ptid (state->live_ptid);
+  struct fork_info *fp = find_fork_ptid (inferior_ptid);
+
+  if (live != NULL && fp != NULL && fp != live)
+    {
+      linux_fork_switch (live);
+      /* Unless it is a checkpoint, the process we were in was a copy
+	 being re-executed.  */
+      if (fp->auto_num == 0)
+	linux_fork_kill (fp);
+    }
+}
+
+/* Return non-zero if the program can go backward by re-executing it
+   from automatic checkpoints.  This is the to_can_execute_reverse
+   method of the GNU/Linux native target.  */
+
+int
+linux_fork_can_execute_reverse (void)
+{
+  return (auto_checkpoint_p && highest_auto_num != 0
+	  && target_has_execution
+	  && find_fork_ptid (inferior_ptid) != NULL
+	  && find_auto_checkpoint_before (INT_MAX) != NULL
+	  && thread_count () <= 1);
+}
+
+static void
+reverse_direction_cleanup (void *arg)
+{
+  execution_direction = EXEC_REVERSE;
+}
+
+/* Go back to the previous breakpoint hit by re-executing the program
+   from the newest automatic checkpoint before the current position,
+   and stopping at the last breakpoint hit before it.  If there is
+   none, try the checkpoint before that, and so on.  The stop arrived
+   at is left for linux_fork_reverse_event to report.  This is the
+   to_prepare_to_resume_reverse method of the GNU/Linux native target;
+   infrun calls it before resuming anything, so re-executing the
+   program may use inferior calls to take checkpoints.  */
+
+void
+linux_fork_prepare_to_resume_reverse (int step)
+{
+  struct reverse_continue_state state;
+  struct thread_info *tp;
+  struct fork_info *live, *from, *before, *hit;
+  VEC (auto_checkpoint_stop_s) *stops, *new_stops = NULL;
+  struct cleanup *old_chain, *state_chain;
+  int live_in_history, base_num, new_base_num, new_current_num;
+
+  /* Process record goes backward by itself.  */
+  if (RECORD_IS_USED)
+    return;
+
+  if (!linux_fork_can_execute_reverse ())
+    error (_("Target %s does not support this command."), target_shortname);
+
+  tp = inferior_thread ();
+  if (step || tp->step_range_end != 0 || tp->step_resume_breakpoint != NULL)
+    error (_("Re-executing from checkpoints only supports "
+	     "\"reverse-continue\"."));
+
+  live = find_fork_ptid (inferior_ptid);
+  gdb_assert (live != NULL);
+
+  /* The current process is kept as the newest checkpoint, unless it is
+     already one, or it is in the past of the newest checkpoint.  */
+  before = find_auto_checkpoint_before (INT_MAX);
+  live_in_history = (auto_current_num != 0
+		     || auto_base_num != before->auto_num);
+
+  old_chain = make_cleanup_restore_integer (&auto_checkpoint_busy);
+  auto_checkpoint_busy = 1;
+
+  /* The program is re-executed forward, with inferior calls to take
+     the checkpoints.  */
+  make_cleanup (reverse_direction_cleanup, NULL);
+  execution_direction = EXEC_FORWARD;
+
+  make_cleanup (free_auto_checkpoint_stops_cleanup, &new_stops);
+
+  /* The stops that lead to the current position.  */
+  if (auto_current_num != 0)
+    stops = find_auto_checkpoint (auto_current_num)->stops;
+  else
+    stops = auto_current_stops;
+  base_num = auto_base_num;
+
+  state.live_ptid = live->ptid;
+  state_chain = make_cleanup (reverse_continue_cleanup, &state);
+
+  reverse_event_status.kind = TARGET_WAITKIND_STOPPED;
+  reverse_event_status.value.sig = TARGET_SIGNAL_TRAP;
+
+  while (1)
+    {
+      from = find_auto_checkpoint (base_num);
+      if (from == NULL)
+	{
+	  /* No breakpoint was hit since the oldest checkpoint; stop
+	     there.  */
+	  from = find_auto_checkpoint_before (INT_MAX);
+	  while ((before = find_auto_checkpoint_before (from->auto_num)))
+	    from = before;
+	  linux_fork_switch (from);
+	  linux_fork_switch (checkpoint_fork (0));
+	  new_current_num = from->auto_num;
+	  new_base_num = 0;
+	  reverse_event_status.kind = TARGET_WAITKIND_NO_HISTORY;
+	  break;
+	}
+
+      hit = linux_fork_replay (from, stops, &new_stops);
+      if (hit != NULL)
+	{
+	  linux_fork_switch (hit);
+	  new_current_num = 0;
+	  new_base_num = from->auto_num;
+	  break;
+	}
+
+      /* Nothing was hit after FROM; the program may have been stopped
+	 by a breakpoint at FROM itself.  */
+      before = find_auto_checkpoint_before (from->auto_num);
+      base_num = before ? before->auto_num : 0;
+
+      if (user_breakpoint_stops_here
+	    (get_regcache_aspace (get_current_regcache ()),
+	     regcache_read_pc (get_current_regcache ())) != NULL)
+	{
+	  linux_fork_switch (checkpoint_fork (0));
+	  new_current_num = from->auto_num;
+	  new_base_num = base_num;
+	  break;
+	}
+
+      stops = from->stops;
+    }
+
+  /* We have arrived; the old current process is not needed to undo
+     anything any more, unless it is the end of the history.  */
+  discard_cleanups (state_chain);
+  live = find_fork_ptid (state.live_ptid);
+  if (live_in_history)
+    {
+      linux_fork_kill (live);
+      free_auto_checkpoint_stops (&auto_current_stops);
+    }
+  else
+    {
+      live->auto_num = ++highest_auto_num;
+      live->stops = auto_current_stops;
+    }
+  auto_current_stops = new_stops;
+  new_stops = NULL;
+  auto_base_num = new_base_num;
+  auto_current_num = new_current_num;
+  linux_fork_trim_auto_checkpoints ();
+  do_cleanups (old_chain);
+
+  reverse_event_ptid = inferior_ptid;
+  reverse_event_pending = 1;
+  reverse_stop_p = 1;
+}
+
+/* Resume in reverse.  linux_fork_prepare_to_resume_reverse found the
+   stop to arrive at already, unless infrun is going on backward from
+   a stop it did not want to report.  */
+
+void
+linux_fork_resume_reverse (void)
+{
+  if (!reverse_event_pending)
+    error (_("Cannot go further backward without re-executing "
+	     "the program; use \"reverse-continue\" again."));
+}
+
+/* If going backward arrived at a stop that was not reported yet,
+   return non-zero and fill in *PTID and *STATUS with it.  */
+
+int
+linux_fork_reverse_event (ptid_t *ptid, struct target_waitstatus *status)
+{
+  if (!reverse_event_pending)
+    return 0;
+
+  reverse_event_pending = 0;
+  *ptid = reverse_event_ptid;
+  *status = reverse_event_status;
+  return 1;
+}
+
+/* Add the stop the program just made, which BS tells about, to those
+   since the newest automatic checkpoint.  */
+
+static void
+linux_fork_record_stop (struct bpstats *bs)
+{
+  struct auto_checkpoint_stop stop;
+  struct regcache *regcache = get_current_regcache ();
+
+  stop.pc = regcache_read_pc (regcache);
+  stop.regs = regcache_dup (regcache);
+  stop.cond_string = NULL;
+
+  for (; bs != NULL; bs = bs->next)
+    if (bs->stop && bs->breakpoint_at != NULL
+	&& (bs->breakpoint_at->owner->type == bp_breakpoint
+	    || bs->breakpoint_at->owner->type == bp_hardware_breakpoint))
+      {
+	if (bs->breakpoint_at->owner->cond_string != NULL)
+	  stop.cond_string = xstrdup (bs->breakpoint_at->owner->cond_string);
+	break;
+      }
+
+  VEC_safe_push (auto_checkpoint_stop_s, auto_current_stops, &stop);
+}
+
+/* Take an automatic checkpoint when the program stops, if one is
+   due, and keep track of the stops since the last one.  */
+
+static void
+linux_fork_normal_stop (struct bpstats *bs, int print_frame)
+{
+  struct cleanup *old_chain;
+  struct fork_info *fp;
+  volatile struct gdb_exception e;
+  int newest;
+
+  if (reverse_stop_p)
+    {
+      reverse_stop_p = 0;
+      return;
+    }
+
+  if (!auto_checkpoint_p || auto_checkpoint_busy
+      || !target_has_execution || RECORD_IS_USED
+      || ptid_equal (inferior_ptid, null_ptid)
+      || find_lwp_pid (inferior_ptid) == NULL
+      || thread_count () > 1)
+    return;
+
+  old_chain = make_cleanup_restore_integer (&auto_checkpoint_busy);
+  auto_checkpoint_busy = 1;
+
+  TRY_CATCH (e, RETURN_MASK_ERROR)
+    {
+      /* The program ran forward from where it was, so any later
+	 checkpoints belong to a history that is being rewritten.  */
+      newest = max (auto_base_num, auto_current_num);
+      while ((fp = find_auto_checkpoint_before (INT_MAX)) != NULL
+	     && fp->auto_num > newest)
+	linux_fork_kill (fp);
+      auto_base_num = newest;
+      auto_current_num = 0;
+
+      if (auto_base_num != 0)
+	linux_fork_record_stop (bs);
+
+      /* Always keep a checkpoint at the start of the history.  */
+      if (++auto_checkpoint_stops >= auto_checkpoint_interval
+	  || find_auto_checkpoint_before (INT_MAX) == NULL)
+	{
+	  fp = checkpoint_fork (0);
+	  fp->auto_num = ++highest_auto_num;
+	  fp->stops = auto_current_stops;
+	  auto_current_stops = NULL;
+	  auto_current_num = fp->auto_num;
+	  auto_checkpoint_stops = 0;
+	  linux_fork_trim_auto_checkpoints ();
+	}
+    }
+  if (e.reason < 0)
+    warning (_("Could not take an automatic checkpoint: %s"), e.message);
+
+  do_cleanups (old_chain);
+}
+
+static void
+show_auto_checkpoint (struct ui_file *file, int from_tty,
+		      struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Automatic checkpoints are %s.\n"), value);
+}
+
+/* Called after "set auto-checkpoint-interval" changes the interval.  */
+
+static void
+set_auto_checkpoint_interval (char *args, int from_tty,
+			      struct cmd_list_element *c)
+{
+  if (auto_checkpoint_interval <= 0)
+    {
+      auto_checkpoint_interval = 1;
+      error (_("Auto-checkpoint interval must be greater than 0."));
+    }
+}
+
+static void
+show_auto_checkpoint_interval (struct ui_file *file, int from_tty,
+			       struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+An automatic checkpoint is taken every %s stops.\n"), value);
+}
+
+static void
+show_auto_checkpoint_limit (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("\
+The number of automatic checkpoints kept is %s.\n"), value);
+}
+
 void
 _initialize_linux_fork (void)
 {
@@ -756,4 +1663,36 @@ Detach from a checkpoint (experimental)."),
 
   add_info ("checkpoints", info_checkpoints_command,
 	    _("IDs of currently known checkpoints."));
+
+  add_setshow_boolean_cmd ("auto-checkpoint", class_obscure,
+			   &auto_checkpoint_p, _("\
+Set whether checkpoints are taken automatically."), _("\
+Show whether checkpoints are taken automatically."), _("\
+When on, a checkpoint is taken whenever the program stops, and\n\
+\"reverse-continue\" goes back to the previous breakpoint hit by\n\
+re-executing the program from the nearest earlier checkpoint."),
+			   NULL,
+			   show_auto_checkpoint,
+			   &setlist, &showlist);
+
+  add_setshow_zinteger_cmd ("auto-checkpoint-interval", class_obscure,
+			    &auto_checkpoint_interval, _("\
+Set how often checkpoints are taken automatically."), _("\
+Show how often checkpoints are taken automatically."), _("\
+An automatic checkpoint is taken every N times the program stops."),
+			    set_auto_checkpoint_interval,
+			    show_auto_checkpoint_interval,
+			    &setlist, &showlist);
+
+  add_setshow_uinteger_cmd ("auto-checkpoint-limit", class_obscure,
+			    &auto_checkpoint_limit, _("\
+Set the number of automatic checkpoints kept."), _("\
+Show the number of automatic checkpoints kept."), _("\
+When there are more, the oldest ones are deleted.\n\
+If zero, all automatic checkpoints are kept."),
+			    NULL,
+			    show_auto_checkpoint_limit,
+			    &setlist, &showlist);
+
+  observer_attach_normal_stop (linux_fork_normal_stop);
 }
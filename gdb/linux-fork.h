@@ -18,6 +18,7 @@
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
 struct fork_info;
+struct target_waitstatus;
 extern struct fork_info *add_fork (pid_t);
 extern struct fork_info *find_fork_pid (pid_t);
 extern void linux_fork_killall (void);
@@ -25,6 +26,10 @@ extern void linux_fork_mourn_inferior (void);
 extern void linux_fork_detach (char *, int);
 extern int forks_exist_p (void);
 extern int linux_fork_checkpointing_p (int);
+extern int linux_fork_can_execute_reverse (void);
+extern void linux_fork_prepare_to_resume_reverse (int);
+extern void linux_fork_resume_reverse (void);
+extern int linux_fork_reverse_event (ptid_t *, struct target_waitstatus *);
 
 extern int detach_fork;
 
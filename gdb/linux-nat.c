@@ -56,6 +56,7 @@
 #include "terminal.h"
 #include <sys/vfs.h>
 #include "solib.h"
+#include "hashtab.h"
 
 #ifndef SPUFS_MAGIC
 #define SPUFS_MAGIC 0x23c9b64e
@@ -359,7 +360,6 @@ static void restore_child_signals_mask (sigset_t *prev_mask);
 struct lwp_info;
 static struct lwp_info *add_lwp (ptid_t ptid);
 static void purge_lwp_list (int pid);
-static struct lwp_info *find_lwp_pid (ptid_t ptid);
 
 
 /* Trivial list manipulation functions to keep track of a list of
@@ -585,6 +585,16 @@ linux_supports_tracefork (int pid)
   return linux_supports_tracefork_flag;
 }
 
+/* Return non-zero if the kernel reports clone events to us, so that
+   we learn about every new LWP without help from the thread
+   library.  */
+
+int
+linux_nat_reports_clone_events (void)
+{
+  return linux_supports_tracefork_flag > 0;
+}
+
 static int
 linux_supports_tracevforkdone (int pid)
 {
@@ -1029,8 +1039,35 @@ linux_child_set_syscall_catchpoint (int pid, int needed, int any_count,
      threads will run out of processes, even if the threads exit,
      because the "zombies" stay around.  */
 
-/* List of known LWPs.  */
-struct lwp_info *lwp_list;
+/* Table of known LWPs.  LWP_ARRAY is a dense array, for iterating
+   over all of them; LWP_HTAB indexes the same LWPs by LWP id, so that
+   looking one up does not take time proportional to the number of
+   threads.  */
+struct lwp_info **lwp_array;
+int lwp_array_count;
+static int lwp_array_size;
+static htab_t lwp_htab;
+
+/* The number of known LWPs of each process, for num_lwps.  There are
+   seldom more than a couple of processes, so a list will do.  */
+struct lwp_process_count
+{
+  int pid;
+  int count;
+  struct lwp_process_count *next;
+};
+static struct lwp_process_count *lwp_process_counts;
+
+/* A walk over LWP_ARRAY by iterate_over_lwps, which is going from the
+   end of the array down and has reached INDEX.  Walks in progress are
+   chained from LWP_WALKS, innermost first, so that remove_lwp can keep
+   their position right.  */
+struct lwp_walk
+{
+  int index;
+  struct lwp_walk *outer;
+};
+static struct lwp_walk *lwp_walks;
 
 
 /* Original signal mask.  */
@@ -1102,31 +1139,106 @@ status_to_str (int status)
   return buf;
 }
 
-/* Remove all LWPs belong to PID from the lwp list.  */
+/* Hash function for the LWP table; the LWP id is unique system-wide,
+   so it is all we need.  */
+
+static hashval_t
+hash_lwp (const void *p)
+{
+  const struct lwp_info *lp = p;
+
+  return GET_LWP (lp->ptid);
+}
+
+/* Equality function for the LWP table.  Lookups pass a pointer to the
+   LWP id as the key.  */
+
+static int
+eq_lwp (const void *a, const void *b)
+{
+  const struct lwp_info *lp = a;
+  const int *lwp = b;
+
+  return GET_LWP (lp->ptid) == *lwp;
+}
+
+/* Return the entry counting the LWPs of process PID, creating it if
+   CREATE is non-zero.  */
+
+static struct lwp_process_count *
+lwp_process_count (int pid, int create)
+{
+  struct lwp_process_count *pc;
+
+  for (pc = lwp_process_counts; pc != NULL; pc = pc->next)
+    if (pc->pid == pid)
+      return pc;
+
+  if (!create)
+    return NULL;
+
+  pc = XZALLOC (struct lwp_process_count);
+  pc->pid = pid;
+  pc->next = lwp_process_counts;
+  lwp_process_counts = pc;
+  return pc;
+}
+
+/* Remove LP from the LWP table and free it.  */
 
 static void
-purge_lwp_list (int pid)
+remove_lwp (struct lwp_info *lp)
 {
-  struct lwp_info *lp, *lpprev, *lpnext;
+  int lwp = GET_LWP (lp->ptid);
+  struct lwp_process_count *pc, **pcp;
+  struct lwp_walk *walk;
+  void **slot;
+  int i;
 
-  lpprev = NULL;
+  slot = htab_find_slot_with_hash (lwp_htab, &lwp, lwp, NO_INSERT);
+  if (slot != NULL && *slot == lp)
+    htab_clear_slot (lwp_htab, slot);
 
-  for (lp = lwp_list; lp; lp = lpnext)
+  /* Close the gap, keeping the array in order, so that walks in
+     progress neither skip an LWP nor visit one twice.  A walk that
+     has yet to reach LP's slot has one LWP fewer to go.  */
+  for (i = lp->index; i < lwp_array_count - 1; i++)
     {
-      lpnext = lp->next;
+      lwp_array[i] = lwp_array[i + 1];
+      lwp_array[i]->index = i;
+    }
+  lwp_array_count--;
 
-      if (ptid_get_pid (lp->ptid) == pid)
-	{
-	  if (lp == lwp_list)
-	    lwp_list = lp->next;
-	  else
-	    lpprev->next = lp->next;
+  for (walk = lwp_walks; walk != NULL; walk = walk->outer)
+    if (lp->index < walk->index)
+      walk->index--;
 
-	  xfree (lp);
-	}
-      else
-	lpprev = lp;
-    }
+  for (pcp = &lwp_process_counts; *pcp != NULL; pcp = &(*pcp)->next)
+    if ((*pcp)->pid == GET_PID (lp->ptid))
+      {
+	pc = *pcp;
+	if (--pc->count == 0)
+	  {
+	    *pcp = pc->next;
+	    xfree (pc);
+	  }
+	break;
+      }
+
+  xfree (lp);
+}
+
+/* Remove all LWPs belong to PID from the lwp list.  */
+
+static void
+purge_lwp_list (int pid)
+{
+  int i;
+
+  /* Going from the end keeps the moves in remove_lwp short.  */
+  for (i = lwp_array_count - 1; i >= 0; i--)
+    if (ptid_get_pid (lwp_array[i]->ptid) == pid)
+      remove_lwp (lwp_array[i]);
 }
 
 /* Return the number of known LWPs in the tgid given by PID.  */
@@ -1134,14 +1246,9 @@ purge_lwp_list (int pid)
 static int
 num_lwps (int pid)
 {
-  int count = 0;
-  struct lwp_info *lp;
-
-  for (lp = lwp_list; lp; lp = lp->next)
-    if (ptid_get_pid (lp->ptid) == pid)
-      count++;
+  struct lwp_process_count *pc = lwp_process_count (pid, 0);
 
-  return count;
+  return pc != NULL ? pc->count : 0;
 }
 
 /* Add the LWP specified by PID to the list.  Return a pointer to the
@@ -1152,6 +1259,8 @@ static struct lwp_info *
 add_lwp (ptid_t ptid)
 {
   struct lwp_info *lp;
+  int lwp = GET_LWP (ptid);
+  void **slot;
 
   gdb_assert (is_lwp (ptid));
 
@@ -1164,8 +1273,22 @@ add_lwp (ptid_t ptid)
   lp->ptid = ptid;
   lp->core = -1;
 
-  lp->next = lwp_list;
-  lwp_list = lp;
+  if (lwp_htab == NULL)
+    lwp_htab = htab_create (64, hash_lwp, eq_lwp, NULL);
+  /* Should there be a stale entry for the same LWP, the new one
+     shadows it.  */
+  slot = htab_find_slot_with_hash (lwp_htab, &lwp, lwp, INSERT);
+  *slot = lp;
+
+  if (lwp_array_count == lwp_array_size)
+    {
+      lwp_array_size = lwp_array_size ? 2 * lwp_array_size : 64;
+      lwp_array = xrealloc (lwp_array,
+			    lwp_array_size * sizeof (struct lwp_info *));
+    }
+  lp->index = lwp_array_count;
+  lwp_array[lwp_array_count++] = lp;
+  lwp_process_count (GET_PID (ptid), 1)->count++;
 
   if (num_lwps (GET_PID (ptid)) > 1 && linux_nat_new_thread != NULL)
     linux_nat_new_thread (ptid);
@@ -1178,32 +1301,25 @@ add_lwp (ptid_t ptid)
 static void
 delete_lwp (ptid_t ptid)
 {
-  struct lwp_info *lp, *lpprev;
-
-  lpprev = NULL;
-
-  for (lp = lwp_list; lp; lpprev = lp, lp = lp->next)
-    if (ptid_equal (lp->ptid, ptid))
-      break;
+  int lwp = GET_LWP (ptid);
+  struct lwp_info *lp;
 
-  if (!lp)
+  if (lwp_htab == NULL)
     return;
 
-  if (lpprev)
-    lpprev->next = lp->next;
-  else
-    lwp_list = lp->next;
+  lp = htab_find_with_hash (lwp_htab, &lwp, lwp);
+  if (lp == NULL || !ptid_equal (lp->ptid, ptid))
+    return;
 
-  xfree (lp);
+  remove_lwp (lp);
 }
 
 /* Return a pointer to the structure describing the LWP corresponding
    to PID.  If no corresponding LWP could be found, return NULL.  */
 
-static struct lwp_info *
+struct lwp_info *
 find_lwp_pid (ptid_t ptid)
 {
-  struct lwp_info *lp;
   int lwp;
 
   if (is_lwp (ptid))
@@ -1211,11 +1327,10 @@ find_lwp_pid (ptid_t ptid)
   else
     lwp = GET_PID (ptid);
 
-  for (lp = lwp_list; lp; lp = lp->next)
-    if (lwp == GET_LWP (lp->ptid))
-      return lp;
+  if (lwp_htab == NULL)
+    return NULL;
 
-  return NULL;
+  return htab_find_with_hash (lwp_htab, &lwp, lwp);
 }
 
 /* Call CALLBACK with its second argument set to DATA for every LWP in
@@ -1223,25 +1338,45 @@ find_lwp_pid (ptid_t ptid)
    pointer to the structure describing that LWP immediately.
    Otherwise return NULL.  */
 
+static void
+pop_lwp_walk (void *arg)
+{
+  struct lwp_walk *walk = arg;
+
+  lwp_walks = walk->outer;
+}
+
 struct lwp_info *
 iterate_over_lwps (ptid_t filter,
 		   int (*callback) (struct lwp_info *, void *),
 		   void *data)
 {
-  struct lwp_info *lp, *lpnext;
+  struct lwp_info *result = NULL;
+  struct cleanup *old_chain;
+  struct lwp_walk walk;
+
+  /* Walk the array from the end, newest LWP first.  CALLBACK may
+     delete any LWP (see remove_lwp); those it adds are not visited.  */
+  walk.outer = lwp_walks;
+  lwp_walks = &walk;
+  old_chain = make_cleanup (pop_lwp_walk, &walk);
 
-  for (lp = lwp_list; lp; lp = lpnext)
+  for (walk.index = lwp_array_count - 1; walk.index >= 0; walk.index--)
     {
-      lpnext = lp->next;
+      struct lwp_info *lp = lwp_array[walk.index];
 
       if (ptid_match (lp->ptid, filter))
 	{
 	  if ((*callback) (lp, data))
-	    return lp;
+	    {
+	      result = lp;
+	      break;
+	    }
 	}
     }
 
-  return NULL;
+  do_cleanups (old_chain);
+  return result;
 }
 
 /* Update our internal state when changing from one checkpoint to
@@ -1878,6 +2013,21 @@ linux_nat_resume (struct target_ops *ops,
 			signo ? strsignal (signo) : "0",
 			target_pid_to_str (inferior_ptid));
 
+  /* Going backward is done by re-executing the program from
+     automatic checkpoints before resuming; the stop arrived at is
+     already known.  */
+  if (execution_direction == EXEC_REVERSE)
+    {
+      linux_fork_resume_reverse ();
+      if (target_can_async_p ())
+	{
+	  target_async (inferior_event_handler, 0);
+	  /* Tell the event loop we have something to process.  */
+	  async_file_mark ();
+	}
+      return;
+    }
+
   block_child_signals (&prev_mask);
 
   /* A specific PTID means `step only this process id'.  */
@@ -2233,31 +2383,31 @@ linux_handle_extended_wait (struct lwp_info *lp, int status,
 	  else
 	    status = 0;
 
-	  if (non_stop)
-	    {
-	      /* Add the new thread to GDB's lists as soon as possible
-		 so that:
+	  /* Add the new thread to GDB's lists as soon as possible so
+	     that:
 
-		 1) the frontend doesn't have to wait for a stop to
-		 display them, and,
+	     1) the frontend doesn't have to wait for a stop to display
+	     them,
 
-		 2) we tag it with the correct running state.  */
+	     2) we tag it with the correct running state, and,
 
-	      /* If the thread_db layer is active, let it know about
-		 this new thread, and add it to GDB's list.  */
-	      if (!thread_db_attach_lwp (new_lp->ptid))
-		{
-		  /* We're not using thread_db.  Add it to GDB's
-		     list.  */
-		  target_post_attach (GET_LWP (new_lp->ptid));
-		  add_thread (new_lp->ptid);
-		}
+	     3) the thread_db layer doesn't need thread event
+	     breakpoints, or a sweep over the whole thread list, to
+	     notice it.  */
 
-	      if (!stopping)
-		{
-		  set_running (new_lp->ptid, 1);
-		  set_executing (new_lp->ptid, 1);
-		}
+	  /* If the thread_db layer is active, let it know about this
+	     new thread, and add it to GDB's list.  */
+	  if (!thread_db_attach_lwp (new_lp->ptid))
+	    {
+	      /* We're not using thread_db.  Add it to GDB's list.  */
+	      target_post_attach (GET_LWP (new_lp->ptid));
+	      add_thread (new_lp->ptid);
+	    }
+
+	  if (!stopping)
+	    {
+	      set_running (new_lp->ptid, 1);
+	      set_executing (new_lp->ptid, 1);
 	    }
 
 	  /* Note the need to use the low target ops to resume, to
@@ -2949,19 +3099,18 @@ resumed_callback (struct lwp_info *lp, void *data)
 static int
 stop_and_resume_callback (struct lwp_info *lp, void *data)
 {
-  struct lwp_info *ptr;
-
   if (!lp->stopped && !lp->signalled)
     {
+      ptid_t ptid = lp->ptid;
+
       stop_callback (lp, NULL);
       stop_wait_callback (lp, NULL);
       /* Resume if the lwp still exists.  */
-      for (ptr = lwp_list; ptr; ptr = ptr->next)
-	if (lp == ptr)
-	  {
-	    resume_callback (lp, NULL);
-	    resume_set_callback (lp, NULL);
-	  }
+      if (find_lwp_pid (ptid) == lp)
+	{
+	  resume_callback (lp, NULL);
+	  resume_set_callback (lp, NULL);
+	}
     }
   return 0;
 }
@@ -3691,6 +3840,14 @@ linux_nat_wait (struct target_ops *ops,
   if (target_can_async_p ())
     async_file_flush ();
 
+  /* Report the stop that going backward arrived at.  */
+  if (linux_fork_reverse_event (&event_ptid, ourstatus))
+    {
+      if (target_can_async_p ())
+	target_async (inferior_event_handler, 0);
+      return event_ptid;
+    }
+
   /* Resume LWPs that are currently stopped without any pending status
      to report, but are resumed from the core's perspective.  LWPs get
      in this state if we find them stopping at a time we're not
@@ -5623,6 +5780,9 @@ linux_nat_add_target (struct target_ops *t)
 
   t->to_core_of_thread = linux_nat_core_of_thread;
 
+  t->to_can_execute_reverse = linux_fork_can_execute_reverse;
+  t->to_prepare_to_resume_reverse = linux_fork_prepare_to_resume_reverse;
+
   /* We don't change the stratum; this target will sit at
      process_stratum and thread_db will set at thread_stratum.  This
      is a little strange, since this is a multi-threaded-capable
@@ -92,21 +92,24 @@ struct lwp_info
   /* The processor core this LWP was last seen on.  */
   int core;
 
-  /* Next LWP in list.  */
-  struct lwp_info *next;
+  /* This LWP's position in LWP_ARRAY.  */
+  int index;
 };
 
-/* The global list of LWPs, for ALL_LWPS.  Unlike the threads list,
-   there is always at least one LWP on the list while the GNU/Linux
-   native target is active.  */
-extern struct lwp_info *lwp_list;
+/* The global table of LWPs, for ALL_LWPS.  The first LWP_ARRAY_COUNT
+   entries of LWP_ARRAY point to the known LWPs, in no particular
+   order.  Unlike the threads list, there is always at least one LWP in
+   the table while the GNU/Linux native target is active.  */
+extern struct lwp_info **lwp_array;
+extern int lwp_array_count;
 
 /* Iterate over the PTID each active thread (light-weight process).  There
    must be at least one.  */
 #define ALL_LWPS(LP, PTID)						\
-  for ((LP) = lwp_list, (PTID) = (LP)->ptid;				\
+  for ((LP) = lwp_array[lwp_array_count - 1], (PTID) = (LP)->ptid;	\
        (LP) != NULL;							\
-       (LP) = (LP)->next, (PTID) = (LP) ? (LP)->ptid : (PTID))
+       (LP) = (LP)->index > 0 ? lwp_array[(LP)->index - 1] : NULL,	\
+	 (PTID) = (LP) ? (LP)->ptid : (PTID))
 
 #define GET_LWP(ptid)		ptid_get_lwp (ptid)
 #define GET_PID(ptid)		ptid_get_pid (ptid)
@@ -133,6 +136,13 @@ extern void linux_enable_event_reporting (ptid_t ptid);
 
 extern int lin_lwp_attach_lwp (ptid_t ptid);
 
+/* Return the LWP info for PTID, or NULL if we don't know about it.  */
+extern struct lwp_info *find_lwp_pid (ptid_t ptid);
+
+/* Return non-zero if linux-nat sees every new LWP through clone
+   events.  */
+extern int linux_nat_reports_clone_events (void);
+
 /* Iterator function for lin-lwp's lwp list.  */
 struct lwp_info *iterate_over_lwps (ptid_t filter,
 				    int (*callback) (struct lwp_info *,
@@ -2248,3 +2248,271 @@ Do you want to stop the program?"),
 
   return 0;
 }
+
+/* Map the system call numbers of the asm-generic Linux interface,
+   used by new ports such as RISC-V, to enum gdb_syscall.  Entries of
+   -1 are calls that record_linux_system_call does not know about.
+   Several calls only exist in their newer form here, and are recorded
+   like the older call they extend (dup3 as dup2, pipe2 as pipe, and
+   so on), since they write the same memory.  */
+
+static const int linux_generic_syscall_map[] =
+{
+  gdb_sys_io_setup,		/* 0 io_setup */
+  gdb_sys_io_destroy,		/* 1 io_destroy */
+  gdb_sys_io_submit,		/* 2 io_submit */
+  gdb_sys_io_cancel,		/* 3 io_cancel */
+  gdb_sys_io_getevents,		/* 4 io_getevents */
+  gdb_sys_setxattr,		/* 5 setxattr */
+  gdb_sys_lsetxattr,		/* 6 lsetxattr */
+  gdb_sys_fsetxattr,		/* 7 fsetxattr */
+  gdb_sys_getxattr,		/* 8 getxattr */
+  gdb_sys_lgetxattr,		/* 9 lgetxattr */
+  gdb_sys_fgetxattr,		/* 10 fgetxattr */
+  gdb_sys_listxattr,		/* 11 listxattr */
+  gdb_sys_llistxattr,		/* 12 llistxattr */
+  gdb_sys_flistxattr,		/* 13 flistxattr */
+  gdb_sys_removexattr,		/* 14 removexattr */
+  gdb_sys_lremovexattr,		/* 15 lremovexattr */
+  gdb_sys_fremovexattr,		/* 16 fremovexattr */
+  gdb_sys_getcwd,		/* 17 getcwd */
+  gdb_sys_lookup_dcookie,	/* 18 lookup_dcookie */
+  -1,				/* 19 eventfd2 */
+  gdb_sys_epoll_create,		/* 20 epoll_create1 */
+  gdb_sys_epoll_ctl,		/* 21 epoll_ctl */
+  gdb_sys_epoll_pwait,		/* 22 epoll_pwait */
+  gdb_sys_dup,			/* 23 dup */
+  gdb_sys_dup2,			/* 24 dup3 */
+  gdb_sys_fcntl,		/* 25 fcntl */
+  gdb_sys_inotify_init,		/* 26 inotify_init1 */
+  gdb_sys_inotify_add_watch,	/* 27 inotify_add_watch */
+  gdb_sys_inotify_rm_watch,	/* 28 inotify_rm_watch */
+  gdb_sys_ioctl,		/* 29 ioctl */
+  gdb_sys_ioprio_set,		/* 30 ioprio_set */
+  gdb_sys_ioprio_get,		/* 31 ioprio_get */
+  gdb_sys_flock,		/* 32 flock */
+  gdb_sys_mknodat,		/* 33 mknodat */
+  gdb_sys_mkdirat,		/* 34 mkdirat */
+  gdb_sys_unlinkat,		/* 35 unlinkat */
+  gdb_sys_symlinkat,		/* 36 symlinkat */
+  gdb_sys_linkat,		/* 37 linkat */
+  gdb_sys_renameat,		/* 38 renameat */
+  gdb_sys_umount,		/* 39 umount2 */
+  gdb_sys_mount,		/* 40 mount */
+  gdb_sys_pivot_root,		/* 41 pivot_root */
+  gdb_sys_nfsservctl,		/* 42 nfsservctl */
+  gdb_sys_statfs,		/* 43 statfs */
+  gdb_sys_fstatfs,		/* 44 fstatfs */
+  gdb_sys_truncate,		/* 45 truncate */
+  gdb_sys_ftruncate,		/* 46 ftruncate */
+  -1,				/* 47 fallocate */
+  gdb_sys_faccessat,		/* 48 faccessat */
+  gdb_sys_chdir,		/* 49 chdir */
+  gdb_sys_fchdir,		/* 50 fchdir */
+  gdb_sys_chroot,		/* 51 chroot */
+  gdb_sys_fchmod,		/* 52 fchmod */
+  gdb_sys_fchmodat,		/* 53 fchmodat */
+  gdb_sys_fchownat,		/* 54 fchownat */
+  gdb_sys_fchown,		/* 55 fchown */
+  gdb_sys_openat,		/* 56 openat */
+  gdb_sys_close,		/* 57 close */
+  gdb_sys_vhangup,		/* 58 vhangup */
+  gdb_sys_pipe,			/* 59 pipe2 */
+  gdb_sys_quotactl,		/* 60 quotactl */
+  gdb_sys_getdents64,		/* 61 getdents64 */
+  gdb_sys_lseek,		/* 62 lseek */
+  gdb_sys_read,			/* 63 read */
+  gdb_sys_write,		/* 64 write */
+  gdb_sys_readv,		/* 65 readv */
+  gdb_sys_writev,		/* 66 writev */
+  gdb_sys_pread64,		/* 67 pread64 */
+  gdb_sys_pwrite64,		/* 68 pwrite64 */
+  -1,				/* 69 preadv */
+  -1,				/* 70 pwritev */
+  gdb_sys_sendfile,		/* 71 sendfile */
+  gdb_sys_pselect6,		/* 72 pselect6 */
+  gdb_sys_ppoll,		/* 73 ppoll */
+  -1,				/* 74 signalfd4 */
+  gdb_sys_vmsplice,		/* 75 vmsplice */
+  gdb_sys_splice,		/* 76 splice */
+  gdb_sys_tee,			/* 77 tee */
+  gdb_sys_readlinkat,		/* 78 readlinkat */
+  gdb_sys_newfstatat,		/* 79 newfstatat */
+  gdb_sys_newfstat,		/* 80 fstat */
+  gdb_sys_sync,			/* 81 sync */
+  gdb_sys_fsync,		/* 82 fsync */
+  gdb_sys_fdatasync,		/* 83 fdatasync */
+  gdb_sys_sync_file_range,	/* 84 sync_file_range */
+  -1,				/* 85 timerfd_create */
+  -1,				/* 86 timerfd_settime */
+  -1,				/* 87 timerfd_gettime */
+  -1,				/* 88 utimensat */
+  gdb_sys_acct,			/* 89 acct */
+  gdb_sys_capget,		/* 90 capget */
+  gdb_sys_capset,		/* 91 capset */
+  gdb_sys_personality,		/* 92 personality */
+  gdb_sys_exit,			/* 93 exit */
+  gdb_sys_exit_group,		/* 94 exit_group */
+  gdb_sys_waitid,		/* 95 waitid */
+  gdb_sys_set_tid_address,	/* 96 set_tid_address */
+  gdb_sys_unshare,		/* 97 unshare */
+  gdb_sys_futex,		/* 98 futex */
+  gdb_sys_set_robust_list,	/* 99 set_robust_list */
+  gdb_sys_get_robust_list,	/* 100 get_robust_list */
+  gdb_sys_nanosleep,		/* 101 nanosleep */
+  gdb_sys_getitimer,		/* 102 getitimer */
+  gdb_sys_setitimer,		/* 103 setitimer */
+  gdb_sys_kexec_load,		/* 104 kexec_load */
+  gdb_sys_init_module,		/* 105 init_module */
+  gdb_sys_delete_module,	/* 106 delete_module */
+  gdb_sys_timer_create,		/* 107 timer_create */
+  gdb_sys_timer_gettime,	/* 108 timer_gettime */
+  gdb_sys_timer_getoverrun,	/* 109 timer_getoverrun */
+  gdb_sys_timer_settime,	/* 110 timer_settime */
+  gdb_sys_timer_delete,		/* 111 timer_delete */
+  gdb_sys_clock_settime,	/* 112 clock_settime */
+  gdb_sys_clock_gettime,	/* 113 clock_gettime */
+  gdb_sys_clock_getres,		/* 114 clock_getres */
+  gdb_sys_clock_nanosleep,	/* 115 clock_nanosleep */
+  gdb_sys_syslog,		/* 116 syslog */
+  gdb_sys_ptrace,		/* 117 ptrace */
+  gdb_sys_sched_setparam,	/* 118 sched_setparam */
+  gdb_sys_sched_setscheduler,	/* 119 sched_setscheduler */
+  gdb_sys_sched_getscheduler,	/* 120 sched_getscheduler */
+  gdb_sys_sched_getparam,	/* 121 sched_getparam */
+  gdb_sys_sched_setaffinity,	/* 122 sched_setaffinity */
+  gdb_sys_sched_getaffinity,	/* 123 sched_getaffinity */
+  gdb_sys_sched_yield,		/* 124 sched_yield */
+  gdb_sys_sched_get_priority_max,	/* 125 sched_get_priority_max */
+  gdb_sys_sched_get_priority_min,	/* 126 sched_get_priority_min */
+  gdb_sys_sched_rr_get_interval,	/* 127 sched_rr_get_interval */
+  gdb_sys_restart_syscall,	/* 128 restart_syscall */
+  gdb_sys_kill,			/* 129 kill */
+  gdb_sys_tkill,		/* 130 tkill */
+  gdb_sys_tgkill,		/* 131 tgkill */
+  gdb_sys_sigaltstack,		/* 132 sigaltstack */
+  gdb_sys_rt_sigsuspend,	/* 133 rt_sigsuspend */
+  gdb_sys_rt_sigaction,		/* 134 rt_sigaction */
+  gdb_sys_rt_sigprocmask,	/* 135 rt_sigprocmask */
+  gdb_sys_rt_sigpending,	/* 136 rt_sigpending */
+  gdb_sys_rt_sigtimedwait,	/* 137 rt_sigtimedwait */
+  gdb_sys_rt_sigqueueinfo,	/* 138 rt_sigqueueinfo */
+  gdb_sys_rt_sigreturn,		/* 139 rt_sigreturn */
+  gdb_sys_setpriority,		/* 140 setpriority */
+  gdb_sys_getpriority,		/* 141 getpriority */
+  gdb_sys_reboot,		/* 142 reboot */
+  gdb_sys_setregid,		/* 143 setregid */
+  gdb_sys_setgid,		/* 144 setgid */
+  gdb_sys_setreuid,		/* 145 setreuid */
+  gdb_sys_setuid,		/* 146 setuid */
+  gdb_sys_setresuid,		/* 147 setresuid */
+  gdb_sys_getresuid,		/* 148 getresuid */
+  gdb_sys_setresgid,		/* 149 setresgid */
+  gdb_sys_getresgid,		/* 150 getresgid */
+  gdb_sys_setfsuid,		/* 151 setfsuid */
+  gdb_sys_setfsgid,		/* 152 setfsgid */
+  gdb_sys_times,		/* 153 times */
+  gdb_sys_setpgid,		/* 154 setpgid */
+  gdb_sys_getpgid,		/* 155 getpgid */
+  gdb_sys_getsid,		/* 156 getsid */
+  gdb_sys_setsid,		/* 157 setsid */
+  gdb_sys_getgroups,		/* 158 getgroups */
+  gdb_sys_setgroups,		/* 159 setgroups */
+  gdb_sys_newuname,		/* 160 uname */
+  gdb_sys_sethostname,		/* 161 sethostname */
+  gdb_sys_setdomainname,	/* 162 setdomainname */
+  gdb_sys_getrlimit,		/* 163 getrlimit */
+  gdb_sys_setrlimit,		/* 164 setrlimit */
+  gdb_sys_getrusage,		/* 165 getrusage */
+  gdb_sys_umask,		/* 166 umask */
+  gdb_sys_prctl,		/* 167 prctl */
+  gdb_sys_getcpu,		/* 168 getcpu */
+  gdb_sys_gettimeofday,		/* 169 gettimeofday */
+  gdb_sys_settimeofday,		/* 170 settimeofday */
+  gdb_sys_adjtimex,		/* 171 adjtimex */
+  gdb_sys_getpid,		/* 172 getpid */
+  gdb_sys_getppid,		/* 173 getppid */
+  gdb_sys_getuid,		/* 174 getuid */
+  gdb_sys_geteuid,		/* 175 geteuid */
+  gdb_sys_getgid,		/* 176 getgid */
+  gdb_sys_getegid,		/* 177 getegid */
+  gdb_sys_gettid,		/* 178 gettid */
+  gdb_sys_sysinfo,		/* 179 sysinfo */
+  gdb_sys_mq_open,		/* 180 mq_open */
+  gdb_sys_mq_unlink,		/* 181 mq_unlink */
+  gdb_sys_mq_timedsend,		/* 182 mq_timedsend */
+  gdb_sys_mq_timedreceive,	/* 183 mq_timedreceive */
+  gdb_sys_mq_notify,		/* 184 mq_notify */
+  gdb_sys_mq_getsetattr,	/* 185 mq_getsetattr */
+  gdb_sys_msgget,		/* 186 msgget */
+  gdb_sys_msgctl,		/* 187 msgctl */
+  gdb_sys_msgrcv,		/* 188 msgrcv */
+  gdb_sys_msgsnd,		/* 189 msgsnd */
+  gdb_sys_semget,		/* 190 semget */
+  gdb_sys_semctl,		/* 191 semctl */
+  gdb_sys_semtimedop,		/* 192 semtimedop */
+  gdb_sys_semop,		/* 193 semop */
+  gdb_sys_shmget,		/* 194 shmget */
+  gdb_sys_shmctl,		/* 195 shmctl */
+  gdb_sys_shmat,		/* 196 shmat */
+  gdb_sys_shmdt,		/* 197 shmdt */
+  gdb_sys_socket,		/* 198 socket */
+  gdb_sys_socketpair,		/* 199 socketpair */
+  gdb_sys_bind,			/* 200 bind */
+  gdb_sys_listen,		/* 201 listen */
+  gdb_sys_accept,		/* 202 accept */
+  gdb_sys_connect,		/* 203 connect */
+  gdb_sys_getsockname,		/* 204 getsockname */
+  gdb_sys_getpeername,		/* 205 getpeername */
+  gdb_sys_sendto,		/* 206 sendto */
+  gdb_sys_recvfrom,		/* 207 recvfrom */
+  gdb_sys_setsockopt,		/* 208 setsockopt */
+  gdb_sys_getsockopt,		/* 209 getsockopt */
+  gdb_sys_shutdown,		/* 210 shutdown */
+  gdb_sys_sendmsg,		/* 211 sendmsg */
+  gdb_sys_recvmsg,		/* 212 recvmsg */
+  gdb_sys_readahead,		/* 213 readahead */
+  gdb_sys_brk,			/* 214 brk */
+  gdb_sys_munmap,		/* 215 munmap */
+  gdb_sys_mremap,		/* 216 mremap */
+  gdb_sys_add_key,		/* 217 add_key */
+  gdb_sys_request_key,		/* 218 request_key */
+  gdb_sys_keyctl,		/* 219 keyctl */
+  gdb_sys_clone,		/* 220 clone */
+  gdb_sys_execve,		/* 221 execve */
+  gdb_sys_mmap2,		/* 222 mmap */
+  gdb_sys_fadvise64,		/* 223 fadvise64 */
+  gdb_sys_swapon,		/* 224 swapon */
+  gdb_sys_swapoff,		/* 225 swapoff */
+  gdb_sys_mprotect,		/* 226 mprotect */
+  gdb_sys_msync,		/* 227 msync */
+  gdb_sys_mlock,		/* 228 mlock */
+  gdb_sys_munlock,		/* 229 munlock */
+  gdb_sys_mlockall,		/* 230 mlockall */
+  gdb_sys_munlockall,		/* 231 munlockall */
+  gdb_sys_mincore,		/* 232 mincore */
+  gdb_sys_madvise,		/* 233 madvise */
+  gdb_sys_remap_file_pages,	/* 234 remap_file_pages */
+  gdb_sys_mbind,		/* 235 mbind */
+  gdb_sys_get_mempolicy,	/* 236 get_mempolicy */
+  gdb_sys_set_mempolicy,	/* 237 set_mempolicy */
+  gdb_sys_migrate_pages,	/* 238 migrate_pages */
+  gdb_sys_move_pages,		/* 239 move_pages */
+  -1,				/* 240 rt_tgsigqueueinfo */
+  -1,				/* 241 perf_event_open */
+  gdb_sys_accept,		/* 242 accept4 */
+  -1,				/* 243 recvmmsg */
+};
+
+/* Return the enum gdb_syscall value for SYSCALL, a system call number
+   of the asm-generic Linux interface, or -1 if it is not supported.  */
+
+int
+record_linux_generic_syscall (ULONGEST syscall)
+{
+  if (syscall == 260)
+    return gdb_sys_wait4;
+  if (syscall >= ARRAY_SIZE (linux_generic_syscall_map))
+    return -1;
+  return linux_generic_syscall_map[syscall];
+}
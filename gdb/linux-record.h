@@ -537,4 +537,9 @@ enum gdb_syscall {
 extern int record_linux_system_call (enum gdb_syscall num, 
 				     struct regcache *regcache,
 				     struct linux_record_tdep *tdep);
+
+/* Map a system call number of the asm-generic Linux interface to
+   enum gdb_syscall.  */
+
+extern int record_linux_generic_syscall (ULONGEST syscall);
 #endif /* _LINUX_RECORD_H_ */
@@ -40,6 +40,7 @@
 #include "gdbcore.h"
 #include "observer.h"
 #include "linux-nat.h"
+#include "gdb_dirent.h"
 
 #include <signal.h>
 
@@ -111,6 +112,11 @@ struct thread_db_info
      be able to ignore such stale entries.  */
   int need_stale_parent_threads_check;
 
+  /* Non-zero once we have made sure we are attached to every LWP of
+     the process.  From then on, if linux-nat sees clone events, it
+     learns about every new LWP by itself.  */
+  int all_lwps_attached;
+
   /* Location of the thread creation event breakpoint.  The code at
      this location in the child process will be called by the pthread
      library whenever a new thread is created.  By setting a special
@@ -535,6 +541,13 @@ enable_thread_event_reporting (void)
 
   info = get_thread_db_info (GET_PID (inferior_ptid));
 
+  /* If linux-nat sees clone events, it hands us every new thread as
+     it is created, and notices thread exits by itself; the event
+     breakpoints would only cost us an extra stop of the whole
+     process per thread creation and exit.  */
+  if (linux_nat_reports_clone_events ())
+    return;
+
   /* We cannot use the thread event reporting facility if these
      functions aren't available.  */
   if (info->td_ta_event_addr_p == NULL
@@ -1049,11 +1062,15 @@ attach_thread (ptid_t ptid, const td_thrhandle_t *th_p,
 
   info = get_thread_db_info (GET_PID (ptid));
 
-  /* Enable thread event reporting for this thread.  */
-  err = info->td_thr_event_enable_p (th_p, 1);
-  if (err != TD_OK)
-    error (_("Cannot enable thread event reporting for %s: %s"),
-	   target_pid_to_str (ptid), thread_db_err_str (err));
+  /* Enable thread event reporting for this thread, unless we do not
+     use thread events at all.  */
+  if (!linux_nat_reports_clone_events ())
+    {
+      err = info->td_thr_event_enable_p (th_p, 1);
+      if (err != TD_OK)
+	error (_("Cannot enable thread event reporting for %s: %s"),
+	       target_pid_to_str (ptid), thread_db_err_str (err));
+    }
   return 1;
 }
 
@@ -1397,6 +1414,114 @@ find_new_threads_once (struct thread_db_info *info, int iteration,
   return data.new_threads;
 }
 
+/* Attach to every LWP of process PID listed in /proc/PID/task that
+   linux-nat does not know about yet, until a scan of the directory
+   finds no new LWP.  Returns zero if the directory can not be
+   read.  */
+
+static int
+attach_all_lwps (int pid)
+{
+  char pathname[128];
+  DIR *dir;
+  struct dirent *dp;
+  int new_lwps;
+
+  xsnprintf (pathname, sizeof (pathname), "/proc/%d/task", pid);
+
+  do
+    {
+      dir = opendir (pathname);
+      if (dir == NULL)
+	return 0;
+
+      new_lwps = 0;
+      while ((dp = readdir (dir)) != NULL)
+	{
+	  unsigned long lwp;
+	  char *end;
+	  ptid_t ptid;
+
+	  lwp = strtoul (dp->d_name, &end, 10);
+	  if (lwp == 0 || *end != '\0')
+	    continue;
+
+	  ptid = BUILD_LWP (lwp, pid);
+	  if (find_lwp_pid (ptid) != NULL)
+	    continue;
+
+	  if (lin_lwp_attach_lwp (ptid) == 0)
+	    new_lwps++;
+	}
+
+      closedir (dir);
+    }
+  while (new_lwps != 0);
+
+  return 1;
+}
+
+/* Callback for iterate_over_lwps, used by find_new_threads_lwps.
+   Map LP to its thread handle if we have no thread_db information
+   about it yet.  */
+
+static int
+find_new_threads_lwp_callback (struct lwp_info *lp, void *data)
+{
+  struct callback_data *cb_data = data;
+  struct thread_db_info *info = cb_data->info;
+  struct thread_info *tp;
+  td_thrhandle_t th;
+
+  tp = find_thread_ptid (lp->ptid);
+  if (tp != NULL && tp->private != NULL)
+    return 0;
+
+  /* We can only map LWPs that are stopped.  Running ones were handed
+     to us when they were created.  */
+  if (!lp->stopped)
+    return 0;
+
+  /* This fails if the LWP is not a thread of the threads library, or
+     if the library is not initialized yet.  */
+  if (info->td_ta_map_lwp2thr_p (info->thread_agent, GET_LWP (lp->ptid),
+				 &th) != TD_OK)
+    return 0;
+
+  find_new_threads_callback (&th, cb_data);
+  return 0;
+}
+
+/* Search for new threads of INFO's process without iterating over the
+   thread library's list of threads: make sure we are attached to
+   every LWP of the process, then map each LWP we have no thread_db
+   information about to its thread handle.  This only finds every
+   thread if linux-nat sees clone events.  Returns the number of new
+   threads found, or -1 if the process's LWPs can not be listed.  */
+
+static int
+find_new_threads_lwps (struct thread_db_info *info)
+{
+  struct callback_data data;
+
+  if (!info->all_lwps_attached)
+    {
+      if (!attach_all_lwps (info->pid))
+	return -1;
+      info->all_lwps_attached = 1;
+    }
+
+  data.info = info;
+  data.new_threads = 0;
+  iterate_over_lwps (pid_to_ptid (info->pid),
+		     find_new_threads_lwp_callback, &data);
+
+  if (info_verbose)
+    printf_filtered (_("Found %d new threads.\n"), data.new_threads);
+
+  return data.new_threads;
+}
+
 /* Search for new threads, accessing memory through stopped thread
    PTID.  If UNTIL_NO_NEW is true, repeat searching until several
    searches in a row do not discover any new threads.  */
@@ -1424,6 +1549,14 @@ thread_db_find_new_threads_2 (ptid_t ptid, int until_no_new)
   /* Access an lwp we know is stopped.  */
   info->proc_handle.ptid = ptid;
 
+  /* With clone events, linux-nat sees every new LWP, so we only need
+     to look at the LWPs we do not know the thread of yet.  This is
+     much cheaper than walking the thread library's list of threads
+     when there are many of them.  */
+  if (linux_nat_reports_clone_events ()
+      && find_new_threads_lwps (info) >= 0)
+    return;
+
   if (until_no_new)
     {
       /* Require 4 successive iterations which do not find any new threads.
@@ -34,6 +34,7 @@ const struct mem_attrib default_mem_attrib =
   MEM_WIDTH_UNSPECIFIED,
   0,				/* hwbreak */
   0,				/* cache */
+  0,				/* nocache */
   0,				/* verify */
   -1 /* Flash blocksize not specified.  */
 };
@@ -44,6 +45,7 @@ const struct mem_attrib unknown_mem_attrib =
   MEM_WIDTH_UNSPECIFIED,
   0,				/* hwbreak */
   0,				/* cache */
+  0,				/* nocache */
   0,				/* verify */
   -1 /* Flash blocksize not specified.  */
 };
@@ -387,9 +389,15 @@ mem_command (char *args, int from_tty)
 #endif
 
       else if (strcmp (tok, "cache") == 0)
-	attrib.cache = 1;
+	{
+	  attrib.cache = 1;
+	  attrib.nocache = 0;
+	}
       else if (strcmp (tok, "nocache") == 0)
-	attrib.cache = 0;
+	{
+	  attrib.cache = 0;
+	  attrib.nocache = 1;
+	}
 
 #if 0
       else if (strcmp (tok, "verify") == 0)
@@ -569,6 +577,7 @@ mem_enable_command (char *args, int from_tty)
 
   require_user_regions (from_tty);
 
+  target_dcache_flush ();
   target_dcache_invalidate ();
 
   if (p == 0)
@@ -623,6 +632,7 @@ mem_disable_command (char *args, int from_tty)
 
   require_user_regions (from_tty);
 
+  target_dcache_flush ();
   target_dcache_invalidate ();
 
   if (p == 0)
@@ -684,6 +694,7 @@ mem_delete_command (char *args, int from_tty)
 
   require_user_regions (from_tty);
 
+  target_dcache_flush ();
   target_dcache_invalidate ();
 
   if (p == 0)
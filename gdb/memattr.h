@@ -65,6 +65,10 @@ struct mem_attrib
   
   /* enables host-side caching of memory region data */
   int cache;
+
+  /* set by an explicit "nocache": the region's data is never cached,
+     not even for stack accesses (e.g. memory-mapped I/O) */
+  int nocache;
   
   /* enables memory verification.  after a write, memory is re-read
      to verify that the write was successful. */
@@ -69,6 +69,10 @@ struct objfile *rt_common_objfile;	/* For runtime common symbols */
 struct objfile_pspace_info
 {
   int objfiles_changed_p;
+
+  /* Incremented whenever objfiles are added, removed or relocated.  */
+  unsigned int generation;
+
   struct obj_section **sections;
   int num_sections;
 };
@@ -107,6 +111,27 @@ get_objfile_pspace_data (struct program_space *pspace)
   return info;
 }
 
+/* Record that the objfiles of PSPACE were added, removed or
+   relocated.  */
+
+static void
+objfiles_pspace_changed (struct program_space *pspace)
+{
+  struct objfile_pspace_info *info = get_objfile_pspace_data (pspace);
+
+  /* Rebuild section map next time we need it.  */
+  info->objfiles_changed_p = 1;
+  info->generation++;
+}
+
+/* See objfiles.h.  */
+
+unsigned int
+objfiles_generation (struct program_space *pspace)
+{
+  return get_objfile_pspace_data (pspace)->generation;
+}
+
 /* Records whether any objfiles appeared or disappeared since we last updated
    address to obj section map.  */
 
@@ -271,8 +296,7 @@ allocate_objfile (bfd *abfd, int flags)
   /* Save passed in flag bits. */
   objfile->flags |= flags;
 
-  /* Rebuild section map next time we need it.  */
-  get_objfile_pspace_data (objfile->pspace)->objfiles_changed_p = 1;
+  objfiles_pspace_changed (objfile->pspace);
 
   return objfile;
 }
@@ -665,8 +689,7 @@ free_objfile (struct objfile *objfile)
     htab_delete (objfile->demangled_names_hash);
   obstack_free (&objfile->objfile_obstack, 0);
 
-  /* Rebuild section map next time we need it.  */
-  get_objfile_pspace_data (objfile->pspace)->objfiles_changed_p = 1;
+  objfiles_pspace_changed (objfile->pspace);
 
   xfree (objfile);
 }
@@ -822,8 +845,7 @@ objfile_relocate1 (struct objfile *objfile,
       (objfile->section_offsets)->offsets[i] = ANOFFSET (new_offsets, i);
   }
 
-  /* Rebuild section map next time we need it.  */
-  get_objfile_pspace_data (objfile->pspace)->objfiles_changed_p = 1;
+  objfiles_pspace_changed (objfile->pspace);
 
   /* Update the table in exec_ops, used to read memory.  */
   ALL_OBJFILE_OSECTIONS (objfile, s)
@@ -1473,8 +1495,7 @@ objfile_data (struct objfile *objfile, const struct objfile_data *data)
 void
 objfiles_changed (void)
 {
-  /* Rebuild section map next time we need it.  */
-  get_objfile_pspace_data (current_program_space)->objfiles_changed_p = 1;
+  objfiles_pspace_changed (current_program_space);
 }
 
 /* Close ABFD, and warn if that fails.  */
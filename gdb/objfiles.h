@@ -495,6 +495,12 @@ extern int have_full_symbols (void);
 
 extern void objfiles_changed (void);
 
+/* Return a number that changes whenever objfiles are added to PSPACE,
+   removed from it or relocated, so that data derived from all the
+   objfiles of a program space can tell when it is stale.  */
+
+extern unsigned int objfiles_generation (struct program_space *pspace);
+
 /* This operation deletes all objfile entries that represent solibs that
    weren't explicitly loaded by the user, via e.g., the add-symbol-file
    command.
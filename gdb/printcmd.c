@@ -48,6 +48,8 @@
 #include "solist.h"
 #include "parser-defs.h"
 #include "charset.h"
+#include "regcache.h"
+#include "user-regs.h"
 #include "arch-utils.h"
 
 #ifdef TUI
@@ -1761,11 +1763,74 @@ do_one_display (struct display *d)
 /* Display all of the values on the auto-display chain which can be
    evaluated in the current scope.  */
 
+/* Ask the target to fetch, in one go, the raw registers that the
+   enabled display expressions name directly (e.g. "display $pc"), so
+   that evaluating the displays doesn't fetch them one at a time.  */
+
+static void
+prefetch_display_registers (void)
+{
+  volatile struct gdb_exception ex;
+  struct regcache *regcache;
+  struct gdbarch *gdbarch;
+  struct display *d;
+  int *regnums;
+  char *seen;
+  int num_regs, nregs = 0;
+
+  if (display_chain == NULL || !target_has_registers)
+    return;
+
+  regcache = get_current_regcache ();
+  gdbarch = get_regcache_arch (regcache);
+  num_regs = gdbarch_num_regs (gdbarch);
+  regnums = alloca (num_regs * sizeof (int));
+  seen = alloca (num_regs);
+  memset (seen, 0, num_regs);
+
+  for (d = display_chain; d; d = d->next)
+    {
+      struct expression *exp = d->exp;
+      int endpos, pos, oplen, args;
+
+      if (!d->enabled_p || exp == NULL || exp->gdbarch != gdbarch)
+	continue;
+
+      for (endpos = exp->nelts; endpos > 0; endpos = pos)
+	{
+	  operator_length (exp, endpos, &oplen, &args);
+	  pos = endpos - oplen;
+
+	  if (exp->elts[pos].opcode == OP_REGISTER)
+	    {
+	      const char *name = &exp->elts[pos + 2].string;
+	      int regnum = user_reg_map_name_to_regnum (gdbarch, name,
+							strlen (name));
+
+	      if (regnum >= 0 && regnum < num_regs && !seen[regnum])
+		{
+		  seen[regnum] = 1;
+		  regnums[nregs++] = regnum;
+		}
+	    }
+	}
+    }
+
+  /* This is only an optimization; any error will be reported by the
+     display that actually reads the register.  */
+  TRY_CATCH (ex, RETURN_MASK_ERROR)
+    {
+      regcache_raw_prefetch (regcache, nregs, regnums);
+    }
+}
+
 void
 do_displays (void)
 {
   struct display *d;
 
+  prefetch_display_registers ();
+
   for (d = display_chain; d; d = d->next)
     do_one_display (d);
 }
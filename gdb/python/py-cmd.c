@@ -121,6 +121,7 @@ cmdpy_function (struct cmd_list_element *command, char *args, int from_tty)
   struct cleanup *cleanup;
 
   cleanup = ensure_python_env (get_current_arch (), current_language);
+  make_cleanup_pretty_printers_changed ();
 
   if (! obj)
     error (_("Invalid invocation of Python command object."));
@@ -206,6 +207,7 @@ cmdpy_completer (struct cmd_list_element *command, char *text, char *word)
   struct cleanup *cleanup;
 
   cleanup = ensure_python_env (get_current_arch (), current_language);
+  make_cleanup_pretty_printers_changed ();
 
   if (! obj)
     error (_("Invalid invocation of Python command object."));
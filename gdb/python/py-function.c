@@ -63,6 +63,7 @@ fnpy_call (struct gdbarch *gdbarch, const struct language_defn *language,
   struct cleanup *cleanup;
 
   cleanup = ensure_python_env (gdbarch, language);
+  make_cleanup_pretty_printers_changed ();
 
   args = convert_values_to_python (argc, argv);
 
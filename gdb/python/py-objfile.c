@@ -114,6 +114,7 @@ objfpy_set_printers (PyObject *o, PyObject *value, void *ignore)
   Py_INCREF (value);
   self->printers = value;
   Py_XDECREF (tmp);
+  gdbpy_pretty_printers_changed ();
 
   return 0;
 }
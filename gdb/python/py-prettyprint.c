@@ -23,64 +23,243 @@
 #include "symtab.h"
 #include "language.h"
 #include "valprint.h"
+#include "gdbtypes.h"
+#include "value.h"
+#include "hashtab.h"
+#include "observer.h"
 
 #include "python.h"
 
 #ifdef HAVE_PYTHON
 #include "python-internal.h"
 
-/* Helper function for find_pretty_printer which iterates over a list,
-   calls each function and inspects output.  This will return a
-   printer object if one recognizes VALUE.  If no printer is found, it
-   will return None.  On error, it will set the Python error and
-   return NULL.  */
+/* Pretty-printer lookup functions are searched for in the
+   pretty_printers lists of each objfile, then of the current program
+   space, then of the gdb module.  Most lookup functions decide whether
+   to return a printer by looking at the type of the value only; those
+   that say so by having a true "type_only" attribute allow the result
+   of the search to be remembered for each type, so that printing many
+   values of the same type does not call every lookup function for
+   every value.
+
+   The cache is only valid for the lookup functions that were searched
+   when it was filled in, so the lists are checked against the search
+   order that was last seen before the cache is used.  Walking the
+   lists means a Python call per lookup function, so this is only done
+   when the search order may be stale: at the start of each top-level
+   print, after Python code other than a pretty-printer has run, and
+   after an objfile is loaded.  Printing the elements of an array or
+   the fields of a structure reuses the search order of the value that
+   contains them.  */
+
+/* Flags of an entry of the search order.  */
+
+enum pp_search_flags
+  {
+    /* The entry is a list of lookup functions, rather than a lookup
+       function.  It is followed by the functions it holds.  */
+    PP_SEARCH_LIST = 1 << 0,
 
-static PyObject *
-search_pp_list (PyObject *list, PyObject *value)
+    /* The lookup function is enabled.  */
+    PP_SEARCH_ENABLED = 1 << 1,
+
+    /* The lookup function is type-only.  */
+    PP_SEARCH_TYPE_ONLY = 1 << 2
+  };
+
+struct pp_search_entry
 {
-  Py_ssize_t pp_list_size, list_index;
-  PyObject *function, *printer = NULL;
+  /* The list or lookup function.  The search order holds a reference
+     to it, so that its address is not reused by another object while
+     it is in the search order.  */
+  PyObject *object;
 
-  pp_list_size = PyList_Size (list);
-  for (list_index = 0; list_index < pp_list_size; list_index++)
+  /* A combination of enum pp_search_flags.  */
+  int flags;
+};
+
+/* The search order, as of the last call to find_pretty_printer.  */
+
+static struct pp_search_entry *pp_search_order;
+static int pp_search_order_len;
+static int pp_search_order_size;
+
+/* Incremented each time the search order changes.  */
+
+static unsigned int pp_search_order_generation;
+
+/* Non-zero if the pretty_printers lists may have changed since the
+   search order was last brought up to date.  */
+
+static int pp_search_order_stale = 1;
+
+/* The program space whose pretty_printers list is in the search
+   order.  */
+
+static struct program_space *pp_search_order_pspace;
+
+/* The result of searching the lookup functions for values of a
+   type.  */
+
+struct pp_cache_entry
+{
+  struct type *type;
+
+  /* The lookup function that returned a printer, or NULL if none
+     did.  This is a new reference.  */
+  PyObject *function;
+};
+
+/* The cache of search results, keyed by type.  Only the results of
+   searches that called type-only lookup functions alone are
+   recorded.  */
+
+static htab_t pp_cache;
+
+static hashval_t
+hash_pp_cache_entry (const void *p)
+{
+  const struct pp_cache_entry *entry = p;
+
+  return htab_hash_pointer (entry->type);
+}
+
+static int
+eq_pp_cache_entry (const void *p, const void *type)
+{
+  const struct pp_cache_entry *entry = p;
+
+  return entry->type == type;
+}
+
+static void
+free_pp_cache_entry (void *p)
+{
+  struct pp_cache_entry *entry = p;
+
+  Py_XDECREF (entry->function);
+  xfree (entry);
+}
+
+/* Return the pp_search_flags of the lookup function FUNCTION.  */
+
+static int
+pp_function_flags (PyObject *function)
+{
+  int flags = PP_SEARCH_ENABLED;
+
+  if (PyObject_HasAttr (function, gdbpy_enabled_cst))
     {
-      function = PyList_GetItem (list, list_index);
-      if (! function)
-	return NULL;
+      PyObject *attr = PyObject_GetAttr (function, gdbpy_enabled_cst);
 
-      /* Skip if disabled.  */
-      if (PyObject_HasAttr (function, gdbpy_enabled_cst)
-	  && ! PyObject_IsTrue (PyObject_GetAttr (function, gdbpy_enabled_cst)))
-	continue;
+      /* A function whose attribute cannot be read is enabled, as it
+	 always was.  */
+      if (attr == NULL)
+	PyErr_Clear ();
+      else
+	{
+	  if (PyObject_IsTrue (attr) == 0)
+	    flags &= ~PP_SEARCH_ENABLED;
+	  Py_DECREF (attr);
+	}
+    }
 
-      printer = PyObject_CallFunctionObjArgs (function, value, NULL);
-      if (! printer)
-	return NULL;
-      else if (printer != Py_None)
-	return printer;
+  if (PyObject_HasAttr (function, gdbpy_type_only_cst))
+    {
+      PyObject *attr = PyObject_GetAttr (function, gdbpy_type_only_cst);
 
-      Py_DECREF (printer);
+      if (attr == NULL)
+	PyErr_Clear ();
+      else
+	{
+	  if (PyObject_IsTrue (attr) > 0)
+	    flags |= PP_SEARCH_TYPE_ONLY;
+	  Py_DECREF (attr);
+	}
     }
 
-  Py_RETURN_NONE;
+  if (PyErr_Occurred ())
+    PyErr_Clear ();
+
+  return flags;
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in all objfiles.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+/* Make OBJECT, with flags FLAGS, entry *IX of the search order, and
+   increment *IX.  If this changes the search order, drop the entries
+   that follow and set *CHANGED.  */
 
-static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+static void
+pp_search_order_set (int *ix, PyObject *object, int flags, int *changed)
+{
+  struct pp_search_entry *entry;
+
+  if (*ix < pp_search_order_len
+      && pp_search_order[*ix].object == object
+      && pp_search_order[*ix].flags == flags)
+    {
+      (*ix)++;
+      return;
+    }
+
+  while (pp_search_order_len > *ix)
+    {
+      pp_search_order_len--;
+      Py_DECREF (pp_search_order[pp_search_order_len].object);
+    }
+
+  if (pp_search_order_len == pp_search_order_size)
+    {
+      pp_search_order_size
+	= pp_search_order_size ? 2 * pp_search_order_size : 16;
+      pp_search_order = xrealloc (pp_search_order,
+				  pp_search_order_size
+				  * sizeof (*pp_search_order));
+    }
+
+  entry = &pp_search_order[pp_search_order_len++];
+  Py_INCREF (object);
+  entry->object = object;
+  entry->flags = flags;
+
+  (*ix)++;
+  *changed = 1;
+}
+
+/* Add the list of lookup functions LIST, and the functions it holds,
+   at *IX in the search order.  */
+
+static void
+pp_search_order_add_list (int *ix, PyObject *list, int *changed)
+{
+  Py_ssize_t pp_list_size, list_index;
+
+  pp_search_order_set (ix, list, PP_SEARCH_LIST, changed);
+
+  pp_list_size = PyList_Size (list);
+  for (list_index = 0; list_index < pp_list_size; list_index++)
+    {
+      PyObject *function = PyList_GetItem (list, list_index);
+
+      pp_search_order_set (ix, function, pp_function_flags (function),
+			   changed);
+    }
+}
+
+/* Bring the search order up to date with the pretty_printers lists
+   of the objfiles, the current program space and the gdb module.  If
+   it changed, empty the cache.  */
+
+static void
+update_pp_search_order (void)
 {
-  PyObject *pp_list;
-  PyObject *function;
   struct objfile *obj;
+  PyObject *pspy, *pp_list;
+  int ix = 0, changed = 0;
 
   ALL_OBJFILES (obj)
   {
     PyObject *objf = objfile_to_objfile_object (obj);
+
     if (!objf)
       {
 	/* Ignore the error and continue.  */
@@ -89,68 +268,161 @@ find_pretty_printer_from_objfiles (PyObject *value)
       }
 
     pp_list = objfpy_get_printers (objf, NULL);
-    function = search_pp_list (pp_list, value);
-    Py_XDECREF (pp_list);
+    pp_search_order_add_list (&ix, pp_list, &changed);
+    Py_DECREF (pp_list);
+  }
 
-    /* If there is an error in any objfile list, abort the search and exit.  */
-    if (! function)
-      return NULL;
+  pspy = pspace_to_pspace_object (current_program_space);
+  if (pspy)
+    {
+      pp_list = pspy_get_printers (pspy, NULL);
+      pp_search_order_add_list (&ix, pp_list, &changed);
+      Py_DECREF (pp_list);
+    }
+  else
+    PyErr_Clear ();
 
-    if (function != Py_None)
-      return function;
-    
-    Py_DECREF (function);
-  }
+  /* Fetch the global pretty printer dictionary.  */
+  if (PyObject_HasAttrString (gdb_module, "pretty_printers"))
+    {
+      pp_list = PyObject_GetAttrString (gdb_module, "pretty_printers");
+      if (pp_list != NULL && PyList_Check (pp_list))
+	pp_search_order_add_list (&ix, pp_list, &changed);
+      Py_XDECREF (pp_list);
+    }
+  PyErr_Clear ();
 
-  Py_RETURN_NONE;
+  /* Functions removed from the end of the last list.  */
+  if (ix < pp_search_order_len)
+    {
+      while (pp_search_order_len > ix)
+	{
+	  pp_search_order_len--;
+	  Py_DECREF (pp_search_order[pp_search_order_len].object);
+	}
+      changed = 1;
+    }
+
+  if (changed)
+    {
+      pp_search_order_generation++;
+      if (pp_cache != NULL)
+	htab_empty (pp_cache);
+    }
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in the current program space.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+/* Record that the pretty_printers lists, or the enabled and type_only
+   attributes of their functions, may have changed.  The search order
+   is brought up to date before the next lookup.  */
 
-static PyObject *
-find_pretty_printer_from_progspace (PyObject *value)
+void
+gdbpy_pretty_printers_changed (void)
 {
-  PyObject *pp_list;
-  PyObject *function;
-  PyObject *obj = pspace_to_pspace_object (current_program_space);
+  pp_search_order_stale = 1;
+}
 
-  if (!obj)
-    return NULL;
-  pp_list = pspy_get_printers (obj, NULL);
-  function = search_pp_list (pp_list, value);
-  Py_XDECREF (pp_list);
-  return function;
+static void
+pretty_printers_changed_cleanup (void *ignore)
+{
+  gdbpy_pretty_printers_changed ();
+}
+
+/* Return a cleanup that calls gdbpy_pretty_printers_changed.  Code
+   that runs arbitrary Python code installs it, so that changes made
+   by that code are seen by the next lookup.  */
+
+struct cleanup *
+make_cleanup_pretty_printers_changed (void)
+{
+  return make_cleanup (pretty_printers_changed_cleanup, NULL);
+}
+
+/* The new_objfile observer.  The new objfile's list must be added to
+   the search order.  */
+
+static void
+pp_new_objfile (struct objfile *objfile)
+{
+  gdbpy_pretty_printers_changed ();
 }
 
-/* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in the gdb module.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+/* Call the enabled lookup functions of the search order on VALUE, and
+   return the first printer object returned.  If no printer is found,
+   return None.  On error, set the Python error and return NULL.  If
+   every function that was called is type-only, record the result for
+   values of type TYPE, unless TYPE is NULL.  */
 
 static PyObject *
-find_pretty_printer_from_gdb (PyObject *value)
+search_pp_functions (PyObject *value, struct type *type)
 {
-  PyObject *pp_list;
-  PyObject *function;
+  unsigned int generation = pp_search_order_generation;
+  PyObject *function = NULL, *printer = NULL;
+  int ix, type_only = 1;
 
-  /* Fetch the global pretty printer dictionary.  */
-  if (! PyObject_HasAttrString (gdb_module, "pretty_printers"))
-    Py_RETURN_NONE;
-  pp_list = PyObject_GetAttrString (gdb_module, "pretty_printers");
-  if (pp_list == NULL || ! PyList_Check (pp_list))
+  for (ix = 0; ix < pp_search_order_len; ix++)
     {
-      Py_XDECREF (pp_list);
-      Py_RETURN_NONE;
+      struct pp_search_entry *entry = &pp_search_order[ix];
+
+      if ((entry->flags & PP_SEARCH_LIST) != 0)
+	continue;
+
+      /* Skip if disabled.  */
+      if ((entry->flags & PP_SEARCH_ENABLED) == 0)
+	continue;
+
+      if ((entry->flags & PP_SEARCH_TYPE_ONLY) == 0)
+	type_only = 0;
+
+      function = entry->object;
+      Py_INCREF (function);
+      printer = PyObject_CallFunctionObjArgs (function, value, NULL);
+
+      /* The call may have led to another search, which changed the
+	 search order under our feet.  Carry on with the functions
+	 that are still there, but do not record the result.  */
+      if (generation != pp_search_order_generation)
+	type_only = 0;
+
+      if (! printer)
+	{
+	  Py_DECREF (function);
+	  return NULL;
+	}
+      else if (printer != Py_None)
+	break;
+
+      Py_DECREF (printer);
+      Py_DECREF (function);
+      function = NULL;
+      printer = NULL;
     }
 
-  function = search_pp_list (pp_list, value);
-  Py_XDECREF (pp_list);
-  return function;
+  if (type_only && type != NULL)
+    {
+      struct pp_cache_entry *entry;
+      void **slot;
+
+      if (pp_cache == NULL)
+	pp_cache = htab_create_alloc (127, hash_pp_cache_entry,
+				      eq_pp_cache_entry, free_pp_cache_entry,
+				      xcalloc, xfree);
+
+      slot = htab_find_slot_with_hash (pp_cache, type,
+				       htab_hash_pointer (type), INSERT);
+      if (*slot != NULL)
+	free_pp_cache_entry (*slot);
+      entry = XNEW (struct pp_cache_entry);
+      entry->type = type;
+      entry->function = function;
+      Py_XINCREF (function);
+      *slot = entry;
+    }
+
+  Py_XDECREF (function);
+
+  if (printer == NULL)
+    Py_RETURN_NONE;
+  return printer;
 }
 
 /* Find the pretty-printing constructor function for VALUE.  If no
@@ -160,24 +432,44 @@ find_pretty_printer_from_gdb (PyObject *value)
 static PyObject *
 find_pretty_printer (PyObject *value)
 {
-  PyObject *function;
+  struct value *v = value_object_to_value (value);
+  struct type *type = v != NULL ? value_type (v) : NULL;
+
+  if (pp_search_order_stale
+      || pp_search_order_pspace != current_program_space)
+    {
+      update_pp_search_order ();
+      pp_search_order_stale = 0;
+      pp_search_order_pspace = current_program_space;
+    }
 
-  /* Look at the pretty-printer dictionary for each objfile
-     in the current program-space.  */
-  function = find_pretty_printer_from_objfiles (value);
-  if (function == NULL || function != Py_None)
-    return function;
-  Py_DECREF (function);
-
-  /* Look at the pretty-printer dictionary for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
-  if (function == NULL || function != Py_None)
-    return function;
-  Py_DECREF (function);
-
-  /* Look at the pretty-printer dictionary in the gdb module.  */
-  function = find_pretty_printer_from_gdb (value);
-  return function;
+  if (type != NULL && pp_cache != NULL)
+    {
+      struct pp_cache_entry *entry;
+
+      entry = htab_find_with_hash (pp_cache, type, htab_hash_pointer (type));
+      if (entry != NULL && entry->function == NULL)
+	Py_RETURN_NONE;
+      if (entry != NULL)
+	{
+	  PyObject *function = entry->function;
+	  PyObject *printer;
+
+	  Py_INCREF (function);
+	  printer = PyObject_CallFunctionObjArgs (function, value, NULL);
+	  Py_DECREF (function);
+	  if (printer == NULL || printer != Py_None)
+	    return printer;
+	  Py_DECREF (printer);
+
+	  /* The function did not live up to its type_only attribute;
+	     search all the functions again.  */
+	  htab_remove_elt_with_hash (pp_cache, type,
+				     htab_hash_pointer (type));
+	}
+    }
+
+  return search_pp_functions (value, type);
 }
 
 /* Pretty-print a single value, via the printer object PRINTER.
@@ -619,6 +911,11 @@ apply_val_pretty_printer (struct type *type, const gdb_byte *valaddr,
   int is_py_none = 0;
   cleanups = ensure_python_env (gdbarch, language);
 
+  /* Printers of the elements of a value are looked up in the search
+     order used for the value itself.  */
+  if (recurse == 0)
+    gdbpy_pretty_printers_changed ();
+
   /* Instantiate the printer.  */
   if (valaddr)
     valaddr += embedded_offset;
@@ -712,6 +1009,7 @@ gdbpy_get_varobj_pretty_printer (struct value *value)
   if (! val_obj)
     return NULL;
 
+  gdbpy_pretty_printers_changed ();
   pretty_printer = find_pretty_printer (val_obj);
   Py_DECREF (val_obj);
   return pretty_printer;
@@ -738,10 +1036,17 @@ gdbpy_default_visualizer (PyObject *self, PyObject *args)
       return NULL;
     }
 
+  gdbpy_pretty_printers_changed ();
   cons = find_pretty_printer (val_obj);
   return cons;
 }
 
+void
+gdbpy_initialize_pretty_printers (void)
+{
+  observer_attach_new_objfile (pp_new_objfile);
+}
+
 #else /* HAVE_PYTHON */
 
 int
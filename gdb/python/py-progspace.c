@@ -121,6 +121,7 @@ pspy_set_printers (PyObject *o, PyObject *value, void *ignore)
   Py_INCREF (value);
   self->printers = value;
   Py_XDECREF (tmp);
+  gdbpy_pretty_printers_changed ();
 
   return 0;
 }
@@ -439,6 +439,225 @@ typy_get_sizeof (PyObject *self, void *closure)
   return PyLong_FromLong (TYPE_LENGTH (type));
 }
 
+/* Throw an error unless objects of type TYPE can be unpacked by
+   unpack_object.  This also resolves the opaque types TYPE refers
+   to, so that unpacking does not throw.  */
+static void
+check_unpack_type (struct type *type)
+{
+  int i;
+
+  CHECK_TYPEDEF (type);
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_INT:
+    case TYPE_CODE_CHAR:
+    case TYPE_CODE_BOOL:
+    case TYPE_CODE_ENUM:
+    case TYPE_CODE_RANGE:
+    case TYPE_CODE_PTR:
+    case TYPE_CODE_FLT:
+      return;
+
+    case TYPE_CODE_ARRAY:
+      if (TYPE_LENGTH (check_typedef (TYPE_TARGET_TYPE (type))) == 0)
+	break;
+      check_unpack_type (TYPE_TARGET_TYPE (type));
+      return;
+
+    case TYPE_CODE_STRUCT:
+      for (i = 0; i < TYPE_NFIELDS (type); i++)
+	{
+	  if (field_is_static (&TYPE_FIELD (type, i)))
+	    continue;
+	  if (i < TYPE_N_BASECLASSES (type)
+	      && BASETYPE_VIA_VIRTUAL (type, i))
+	    error (_("Objects with virtual base classes cannot be unpacked."));
+	  if (TYPE_FIELD_BITSIZE (type, i) == 0)
+	    check_unpack_type (TYPE_FIELD_TYPE (type, i));
+	}
+      return;
+    }
+
+  error (_("Objects of this type cannot be unpacked."));
+}
+
+static PyObject *unpack_object (struct type *type, const gdb_byte *valaddr);
+
+/* Return a Python integer holding VAL, which was read from an object of
+   type TYPE.  */
+static PyObject *
+unpack_integer (struct type *type, LONGEST val)
+{
+  if (TYPE_UNSIGNED (type) || TYPE_CODE (type) == TYPE_CODE_PTR)
+    return PyLong_FromUnsignedLongLong ((ULONGEST) val);
+  return PyLong_FromLongLong (val);
+}
+
+/* Return a Python tuple holding the fields of the structure of type
+   TYPE at VALADDR.  */
+static PyObject *
+unpack_struct (struct type *type, const gdb_byte *valaddr)
+{
+  PyObject *result;
+  int i, nfields = 0;
+
+  for (i = 0; i < TYPE_NFIELDS (type); i++)
+    if (!field_is_static (&TYPE_FIELD (type, i)))
+      nfields++;
+
+  result = PyTuple_New (nfields);
+  if (result == NULL)
+    return NULL;
+
+  nfields = 0;
+  for (i = 0; i < TYPE_NFIELDS (type); i++)
+    {
+      PyObject *item;
+
+      if (field_is_static (&TYPE_FIELD (type, i)))
+	continue;
+
+      if (TYPE_FIELD_BITSIZE (type, i) != 0)
+	item = unpack_integer (check_typedef (TYPE_FIELD_TYPE (type, i)),
+			       unpack_field_as_long (type, valaddr, i));
+      else
+	item = unpack_object (TYPE_FIELD_TYPE (type, i),
+			      valaddr + TYPE_FIELD_BITPOS (type, i) / 8);
+      if (item == NULL)
+	{
+	  Py_DECREF (result);
+	  return NULL;
+	}
+      PyTuple_SET_ITEM (result, nfields++, item);
+    }
+
+  return result;
+}
+
+/* Return a Python object holding the contents of the object of type
+   TYPE at VALADDR.  Integers, pointers and floating-point numbers
+   become Python numbers, structures become tuples of their non-static
+   fields, and arrays tuples of their elements.  TYPE must have been
+   checked with check_unpack_type.  On failure, set the Python error
+   and return NULL.  */
+static PyObject *
+unpack_object (struct type *type, const gdb_byte *valaddr)
+{
+  PyObject *result;
+  struct type *elt_type;
+  int invp, i, n;
+
+  type = check_typedef (type);
+  switch (TYPE_CODE (type))
+    {
+    case TYPE_CODE_FLT:
+      return PyFloat_FromDouble (unpack_double (type, valaddr, &invp));
+
+    case TYPE_CODE_STRUCT:
+      return unpack_struct (type, valaddr);
+
+    case TYPE_CODE_ARRAY:
+      elt_type = check_typedef (TYPE_TARGET_TYPE (type));
+      n = TYPE_LENGTH (type) / TYPE_LENGTH (elt_type);
+      result = PyTuple_New (n);
+      if (result == NULL)
+	return NULL;
+      for (i = 0; i < n; i++)
+	{
+	  PyObject *item;
+
+	  item = unpack_object (elt_type, valaddr + i * TYPE_LENGTH (elt_type));
+	  if (item == NULL)
+	    {
+	      Py_DECREF (result);
+	      return NULL;
+	    }
+	  PyTuple_SET_ITEM (result, i, item);
+	}
+      return result;
+
+    default:
+      return unpack_integer (type, unpack_long (type, valaddr));
+    }
+}
+
+/* Implementation of gdb.Type.unpack (buffer [, count [, offset]]).
+   Decode COUNT consecutive objects of this type from BUFFER, a Python
+   object supporting the buffer protocol, starting OFFSET bytes into
+   it, and return them in a list.  By default, decode as many objects
+   as BUFFER holds.  */
+static PyObject *
+typy_unpack (PyObject *self, PyObject *args, PyObject *kw)
+{
+  struct type *type = ((type_object *) self)->type;
+  PyObject *buffer_obj, *result;
+  const void *buffer;
+  Py_ssize_t buffer_size;
+  int count = -1, offset = 0, i;
+  volatile struct gdb_exception except;
+  static char *keywords[] = { "buffer", "count", "offset", NULL };
+
+  if (! PyArg_ParseTupleAndKeywords (args, kw, "O|ii", keywords,
+				     &buffer_obj, &count, &offset))
+    return NULL;
+
+  if (PyObject_AsReadBuffer (buffer_obj, &buffer, &buffer_size) == -1)
+    return NULL;
+
+  TRY_CATCH (except, RETURN_MASK_ALL)
+    {
+      check_unpack_type (type);
+    }
+  if (except.reason < 0)
+    {
+      PyErr_Format (PyExc_TypeError, "%s", except.message);
+      return NULL;
+    }
+
+  if (TYPE_LENGTH (type) == 0)
+    {
+      PyErr_SetString (PyExc_ValueError, _("The type has no size."));
+      return NULL;
+    }
+
+  if (offset < 0 || offset > buffer_size)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("The offset is outside the buffer."));
+      return NULL;
+    }
+
+  if (count < 0)
+    count = (buffer_size - offset) / TYPE_LENGTH (type);
+  else if (count > (buffer_size - offset) / TYPE_LENGTH (type))
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("The buffer is too small."));
+      return NULL;
+    }
+
+  result = PyList_New (count);
+  if (result == NULL)
+    return NULL;
+
+  for (i = 0; i < count; i++)
+    {
+      PyObject *item;
+
+      item = unpack_object (type, ((const gdb_byte *) buffer + offset
+				   + i * TYPE_LENGTH (type)));
+      if (item == NULL)
+	{
+	  Py_DECREF (result);
+	  return NULL;
+	}
+      PyList_SET_ITEM (result, i, item);
+    }
+
+  return result;
+}
+
 static struct type *
 typy_lookup_typename (char *type_name, struct block *block)
 {
@@ -815,6 +1034,9 @@ Return the target type of this type." },
   { "template_argument", typy_template_argument, METH_VARARGS,
     "template_argument (arg, [block]) -> Type\n\
 Return the type of a template argument." },
+  { "unpack", (PyCFunction) typy_unpack, METH_VARARGS | METH_KEYWORDS,
+    "unpack (buffer [, count [, offset]]) -> list\n\
+Decode objects of this type from a buffer." },
   { "unqualified", typy_unqualified, METH_NOARGS,
     "unqualified () -> Type\n\
 Return a variant of this type without const or volatile attributes." },
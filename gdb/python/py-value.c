@@ -447,6 +447,99 @@ valpy_hash (PyObject *self)
   return (long) (intptr_t) self;
 }
 
+/* Buffer protocol.  A value exposes its contents, fetched from the
+   inferior if they were not already, without copying them.  The
+   contents are read-only: changes to them would not reach the
+   inferior.  */
+
+/* Set *PTRPTR to the contents of the value SELF, and return their
+   length.  On error, set the Python error and return -1.  */
+static Py_ssize_t
+valpy_get_contents (PyObject *self, const gdb_byte **ptrptr)
+{
+  struct value *value = ((value_object *) self)->value;
+  Py_ssize_t length = 0;
+  volatile struct gdb_exception except;
+
+  TRY_CATCH (except, RETURN_MASK_ALL)
+    {
+      *ptrptr = value_contents (value);
+      length = TYPE_LENGTH (check_typedef (value_type (value)));
+    }
+  GDB_PY_SET_HANDLE_EXCEPTION (except);
+
+  return length;
+}
+
+static Py_ssize_t
+valpy_get_read_buffer (PyObject *self, Py_ssize_t segment, void **ptrptr)
+{
+  const gdb_byte *contents;
+  Py_ssize_t length;
+
+  if (segment)
+    {
+      PyErr_SetString (PyExc_SystemError,
+		       _("A value supports only one segment."));
+      return -1;
+    }
+
+  length = valpy_get_contents (self, &contents);
+  if (length >= 0)
+    *ptrptr = (void *) contents;
+  return length;
+}
+
+static Py_ssize_t
+valpy_get_seg_count (PyObject *self, Py_ssize_t *lenp)
+{
+  if (lenp)
+    {
+      const gdb_byte *contents;
+
+      *lenp = valpy_get_contents (self, &contents);
+      if (*lenp < 0)
+	{
+	  PyErr_Clear ();
+	  *lenp = 0;
+	}
+    }
+
+  return 1;
+}
+
+static Py_ssize_t
+valpy_get_char_buffer (PyObject *self, Py_ssize_t segment, char **ptrptr)
+{
+  void *ptr = NULL;
+  Py_ssize_t ret;
+
+  ret = valpy_get_read_buffer (self, segment, &ptr);
+  *ptrptr = (char *) ptr;
+
+  return ret;
+}
+
+#ifdef Py_TPFLAGS_HAVE_NEWBUFFER
+/* The new-style buffer protocol, used by memoryview.  */
+static int
+valpy_get_buffer (PyObject *self, Py_buffer *view, int flags)
+{
+  const gdb_byte *contents;
+  Py_ssize_t length;
+
+  length = valpy_get_contents (self, &contents);
+  if (length < 0)
+    return -1;
+
+  return PyBuffer_FillInfo (view, self, (void *) contents, length, 1, flags);
+}
+
+#define VALPY_TPFLAGS_HAVE_NEWBUFFER Py_TPFLAGS_HAVE_NEWBUFFER
+#else
+#define VALPY_TPFLAGS_HAVE_NEWBUFFER 0
+#endif
+
 enum valpy_opcode
 {
   VALPY_ADD,
@@ -1135,6 +1228,17 @@ static PyMappingMethods value_object_as_mapping = {
   valpy_setitem
 };
 
+static PyBufferProcs value_object_as_buffer = {
+  valpy_get_read_buffer,
+  NULL,
+  valpy_get_seg_count,
+  valpy_get_char_buffer,
+#ifdef Py_TPFLAGS_HAVE_NEWBUFFER
+  valpy_get_buffer,
+  NULL
+#endif
+};
+
 PyTypeObject value_object_type = {
   PyObject_HEAD_INIT (NULL)
   0,				  /*ob_size*/
@@ -1155,8 +1259,9 @@ PyTypeObject value_object_type = {
   valpy_str,			  /*tp_str*/
   0,				  /*tp_getattro*/
   0,				  /*tp_setattro*/
-  0,				  /*tp_as_buffer*/
-  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES,	/*tp_flags*/
+  &value_object_as_buffer,	  /*tp_as_buffer*/
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_CHECKTYPES
+  | VALPY_TPFLAGS_HAVE_NEWBUFFER, /*tp_flags*/
   "GDB value object",		  /* tp_doc */
   0,				  /* tp_traverse */
   0,				  /* tp_clear */
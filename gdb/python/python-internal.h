@@ -162,6 +162,7 @@ void gdbpy_initialize_lazy_string (void);
 void gdbpy_initialize_parameters (void);
 void gdbpy_initialize_thread (void);
 void gdbpy_initialize_inferior (void);
+void gdbpy_initialize_pretty_printers (void);
 
 struct cleanup *make_cleanup_py_decref (PyObject *py);
 
@@ -221,6 +222,8 @@ int gdbpy_is_value_object (PyObject *obj);
 PyObject *apply_varobj_pretty_printer (PyObject *print_obj,
 				       struct value **replacement);
 PyObject *gdbpy_get_varobj_pretty_printer (struct value *value);
+void gdbpy_pretty_printers_changed (void);
+struct cleanup *make_cleanup_pretty_printers_changed (void);
 char *gdbpy_get_display_hint (PyObject *printer);
 PyObject *gdbpy_default_visualizer (PyObject *self, PyObject *args);
 
@@ -229,6 +232,7 @@ extern PyObject *gdbpy_children_cst;
 extern PyObject *gdbpy_to_string_cst;
 extern PyObject *gdbpy_display_hint_cst;
 extern PyObject *gdbpy_enabled_cst;
+extern PyObject *gdbpy_type_only_cst;
 
 extern PyObject *gdbpy_gdberror_exc;
 
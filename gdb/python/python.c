@@ -57,6 +57,7 @@ PyObject *gdbpy_children_cst;
 PyObject *gdbpy_display_hint_cst;
 PyObject *gdbpy_doc_cst;
 PyObject *gdbpy_enabled_cst;
+PyObject *gdbpy_type_only_cst;
 
 /* The GdbError exception.  */
 PyObject *gdbpy_gdberror_exc;
@@ -151,6 +152,7 @@ eval_python_from_control_command (struct command_line *cmd)
     error (_("Invalid \"python\" block structure."));
 
   cleanup = ensure_python_env (get_current_arch (), current_language);
+  make_cleanup_pretty_printers_changed ();
 
   script = compute_python_string (cmd->body_list[0]);
   ret = PyRun_SimpleString (script);
@@ -172,6 +174,7 @@ python_command (char *arg, int from_tty)
   struct cleanup *cleanup;
 
   cleanup = ensure_python_env (get_current_arch (), current_language);
+  make_cleanup_pretty_printers_changed ();
   while (arg && *arg && isspace (*arg))
     ++arg;
   if (arg && *arg)
@@ -404,6 +407,7 @@ source_python_script (FILE *stream, const char *file)
   struct cleanup *cleanup;
 
   cleanup = ensure_python_env (get_current_arch (), current_language);
+  make_cleanup_pretty_printers_changed ();
 
   /* Note: If an exception occurs python will print the traceback and
      clear the error indicator.  */
@@ -514,6 +518,7 @@ source_python_script_for_objfile (struct objfile *objfile,
   struct cleanup *cleanups;
 
   cleanups = ensure_python_env (get_objfile_arch (objfile), current_language);
+  make_cleanup_pretty_printers_changed ();
   gdbpy_current_objfile = objfile;
 
   /* Note: If an exception occurs python will print the traceback and
@@ -720,6 +725,7 @@ Enables or disables printing of Python stack traces."),
   gdbpy_initialize_lazy_string ();
   gdbpy_initialize_thread ();
   gdbpy_initialize_inferior ();
+  gdbpy_initialize_pretty_printers ();
 
   PyRun_SimpleString ("import gdb");
   PyRun_SimpleString ("gdb.pretty_printers = []");
@@ -729,6 +735,7 @@ Enables or disables printing of Python stack traces."),
   gdbpy_display_hint_cst = PyString_FromString ("display_hint");
   gdbpy_doc_cst = PyString_FromString ("__doc__");
   gdbpy_enabled_cst = PyString_FromString ("enabled");
+  gdbpy_type_only_cst = PyString_FromString ("type_only");
 
   /* Create a couple objects which are used for Python's stdout and
      stderr.  */
@@ -56,52 +56,58 @@
 #define DEFAULT_RECORD_INSN_MAX_NUM	200000
 
 #define RECORD_IS_REPLAY \
-     (record_list->next || execution_direction == EXEC_REVERSE)
+     (!record_pos_end_p (&record_list) || execution_direction == EXEC_REVERSE)
 
 #define RECORD_FILE_MAGIC	netorder32(0x20091016)
 
 /* These are the core structs of the process record functionality.
 
-   A record_entry is a record of the value change of a register
+   A record is a record of the value change of a register
    ("record_reg") or a part of memory ("record_mem").  And each
-   instruction must have a struct record_entry ("record_end") that
-   indicates that this is the last struct record_entry of this
-   instruction.
+   instruction must have a record ("record_end") that indicates that
+   this is the last record of this instruction.
 
-   Each struct record_entry is linked to "record_list" by "prev" and
-   "next" pointers.  */
+   Every record starts with a struct record_header.  The value of a
+   record_reg or record_mem record follows its struct.  */
+
+struct record_header
+{
+  /* The type of this record, an enum record_type.  */
+  unsigned int type;
+
+  /* The size of the record before this one in the same block, which
+     is how the log is walked backward.  */
+  unsigned int prev_size;
+};
 
 struct record_mem_entry
 {
+  struct record_header h;
   CORE_ADDR addr;
   int len;
   /* Set this flag if target memory for this entry
      can no longer be accessed.  */
   int mem_entry_not_accessible;
-  union
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_reg_entry
 {
+  struct record_header h;
   unsigned short num;
   unsigned short len;
-  union 
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[2 * sizeof (gdb_byte *)];
-  } u;
 };
 
 struct record_end_entry
 {
-  enum target_signal sigval;
+  struct record_header h;
   ULONGEST insn_num;
+  enum target_signal sigval;
 };
 
+#define RECORD_REG(rec) ((struct record_reg_entry *) (rec))
+#define RECORD_MEM(rec) ((struct record_mem_entry *) (rec))
+#define RECORD_END(rec) ((struct record_end_entry *) (rec))
+
 enum record_type
 {
   record_end = 0,
@@ -111,42 +117,58 @@ enum record_type
 
 /* This is the data structure that makes up the execution log.
 
-   The execution log consists of a single linked list of entries
-   of type "struct record_entry".  It is doubly linked so that it
-   can be traversed in either direction.
-
-   The start of the list is anchored by a struct called
-   "record_first".  The pointer "record_list" either points to the
-   last entry that was added to the list (in record mode), or to the
-   next entry in the list that will be executed (in replay mode).
+   The execution log is a sequence of variable-length records, kept
+   back to back in large blocks so that recording an instruction
+   rarely allocates memory, and replaying walks memory sequentially.
+   The blocks are doubly linked so that the log can be traversed in
+   either direction.  No record spans two blocks; a record too large
+   for a block of RECORD_BLOCK_SIZE bytes gets a block of its own.
 
-   Each list element (struct record_entry), in addition to next and
-   prev pointers, consists of a union of three entry types: mem, reg,
-   and end.  A field called "type" determines which entry type is
-   represented by a given list element.
+   The start of the log is anchored by a record_end record called
+   "record_first", which is in no block.  The position "record_list"
+   either points to the last record that was added to the log (in
+   record mode), or to the next record in the log that will be
+   executed (in replay mode).
 
    Each instruction that is added to the execution log is represented
-   by a variable number of list elements ('entries').  The instruction
-   will have one "reg" entry for each register that is changed by 
-   executing the instruction (including the PC in every case).  It 
-   will also have one "mem" entry for each memory change.  Finally,
-   each instruction will have an "end" entry that separates it from
-   the changes associated with the next instruction.  */
-
-struct record_entry
-{
-  struct record_entry *prev;
-  struct record_entry *next;
-  enum record_type type;
-  union
-  {
-    /* reg */
-    struct record_reg_entry reg;
-    /* mem */
-    struct record_mem_entry mem;
-    /* end */
-    struct record_end_entry end;
-  } u;
+   by a variable number of records.  The instruction will have one
+   "reg" record for each register that is changed by executing the
+   instruction (including the PC in every case).  It will also have
+   one "mem" record for each memory change.  Finally, each instruction
+   will have an "end" record that separates it from the changes
+   associated with the next instruction.  */
+
+#define RECORD_BLOCK_SIZE (64 * 1024)
+
+/* Records are aligned to this many bytes within their block.  */
+#define RECORD_ALIGN 8
+#define RECORD_ALIGN_SIZE(size) \
+  (((size) + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1))
+
+struct record_block
+{
+  struct record_block *prev;
+  struct record_block *next;
+
+  /* The records.  DATA is SIZE bytes long, of which the first USED
+     are in use.  */
+  gdb_byte *data;
+  unsigned int size;
+  unsigned int used;
+
+  /* The offsets of the first and of the last record in DATA.  Records
+     before FIRST were released to make room for new ones.  */
+  unsigned int first;
+  unsigned int last;
+};
+
+/* A position in the execution log.  */
+
+struct record_pos
+{
+  /* The block holding REC, or NULL if REC is record_first.  */
+  struct record_block *block;
+  struct record_header *rec;
 };
 
 /* This is the debug switch for process record.  */
@@ -169,28 +191,37 @@ static struct target_section *record_core_start;
 static struct target_section *record_core_end;
 static struct record_core_buf_entry *record_core_buf_list = NULL;
 
-/* The following variables are used for managing the linked list that
-   represents the execution log.
+/* The following variables are used for managing the execution log.
 
-   record_first is the anchor that holds down the beginning of the list.
+   record_first is the anchor that holds down the beginning of the log.
+   record_first_block and record_last_block are the ends of the list
+   of blocks holding the other records.
 
    record_list serves two functions:
-     1) In record mode, it anchors the end of the list.
-     2) In replay mode, it traverses the list and points to
+     1) In record mode, it anchors the end of the log.
+     2) In replay mode, it traverses the log and points to
         the next instruction that must be emulated.
 
-   record_arch_list_head and record_arch_list_tail are used to manage
-   a separate list, which is used to build up the change elements of
-   the currently executing instruction during record mode.  When this
-   instruction has been completely annotated in the "arch list", it 
-   will be appended to the main execution log.  */
+   record_arch_buf is used to build up the records of the currently
+   executing instruction during record mode, RECORD_ARCH_BUF_USED
+   bytes of it.  When this instruction has been completely annotated
+   in the "arch list", its records are appended to the execution
+   log.  */
 
-static struct record_entry record_first;
-static struct record_entry *record_list = &record_first;
-static struct record_entry *record_arch_list_head = NULL;
-static struct record_entry *record_arch_list_tail = NULL;
+static struct record_end_entry record_first;
+static struct record_block *record_first_block = NULL;
+static struct record_block *record_last_block = NULL;
+static struct record_pos record_list = { NULL, &record_first.h };
 
-/* 1 ask user. 0 auto delete the last struct record_entry.  */
+static gdb_byte *record_arch_buf = NULL;
+static unsigned int record_arch_buf_size = 0;
+static unsigned int record_arch_buf_used = 0;
+
+/* A block released from the beginning of the log, kept to be reused
+   at its end.  */
+static struct record_block *record_spare_block = NULL;
+
+/* 1 ask user. 0 auto delete the last instruction of the log.  */
 static int record_stop_at_limit = 1;
 /* Maximum allowed number of insns in execution log.  */
 static unsigned int record_insn_max_num = DEFAULT_RECORD_INSN_MAX_NUM;
@@ -232,152 +263,261 @@ static int (*record_beneath_to_stopped_by_watchpoint) (void);
 static int (*record_beneath_to_stopped_data_address) (struct target_ops *,
 						      CORE_ADDR *);
 
-/* Alloc and free functions for record_reg, record_mem, and record_end 
-   entries.  */
+/* Return the size of record REC, padding included.  */
+
+static inline unsigned int
+record_size (const struct record_header *rec)
+{
+  switch (rec->type)
+    {
+    case record_reg:
+      return RECORD_ALIGN_SIZE (sizeof (struct record_reg_entry)
+				+ RECORD_REG (rec)->len);
+    case record_mem:
+      return RECORD_ALIGN_SIZE (sizeof (struct record_mem_entry)
+				+ RECORD_MEM (rec)->len);
+    case record_end:
+    default:
+      return RECORD_ALIGN_SIZE (sizeof (struct record_end_entry));
+    }
+}
 
-/* Alloc a record_reg record entry.  */
+/* Return the value storage location of a record.  */
 
-static inline struct record_entry *
-record_reg_alloc (struct regcache *regcache, int regnum)
+static inline gdb_byte *
+record_get_loc (struct record_header *rec)
 {
-  struct record_entry *rec;
-  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  switch (rec->type) {
+  case record_mem:
+    return (gdb_byte *) rec + sizeof (struct record_mem_entry);
+  case record_reg:
+    return (gdb_byte *) rec + sizeof (struct record_reg_entry);
+  case record_end:
+  default:
+    gdb_assert (0);
+    return NULL;
+  }
+}
 
-  rec = (struct record_entry *) xcalloc (1, sizeof (struct record_entry));
-  rec->type = record_reg;
-  rec->u.reg.num = regnum;
-  rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+/* Functions to walk the execution log.  */
 
-  return rec;
+/* Set POS to record_first.  */
+
+static inline void
+record_pos_first (struct record_pos *pos)
+{
+  pos->block = NULL;
+  pos->rec = &record_first.h;
 }
 
-/* Free a record_reg record entry.  */
+/* Set POS to the last record of the log.  */
 
 static inline void
-record_reg_release (struct record_entry *rec)
+record_pos_last (struct record_pos *pos)
 {
-  gdb_assert (rec->type == record_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  if (record_last_block == NULL)
+    record_pos_first (pos);
+  else
+    {
+      pos->block = record_last_block;
+      pos->rec = (struct record_header *) (record_last_block->data
+					   + record_last_block->last);
+    }
 }
 
-/* Alloc a record_mem record entry.  */
+/* Return non-zero if POS is the last record of the log.  */
 
-static inline struct record_entry *
-record_mem_alloc (CORE_ADDR addr, int len)
+static inline int
+record_pos_end_p (const struct record_pos *pos)
 {
-  struct record_entry *rec;
+  if (pos->block == NULL)
+    return record_first_block == NULL;
 
-  rec = (struct record_entry *) xcalloc (1, sizeof (struct record_entry));
-  rec->type = record_mem;
-  rec->u.mem.addr = addr;
-  rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
+  return (pos->block->next == NULL
+	  && (gdb_byte *) pos->rec == pos->block->data + pos->block->last);
+}
 
-  return rec;
+/* Move POS to the next record of the log.  Return zero, leaving POS
+   alone, if POS is the last record.  */
+
+static inline int
+record_pos_next (struct record_pos *pos)
+{
+  struct record_block *block = pos->block;
+
+  if (block != NULL
+      && (gdb_byte *) pos->rec != block->data + block->last)
+    {
+      pos->rec = (struct record_header *) ((gdb_byte *) pos->rec
+					   + record_size (pos->rec));
+      return 1;
+    }
+
+  block = block ? block->next : record_first_block;
+  if (block == NULL)
+    return 0;
+
+  pos->block = block;
+  pos->rec = (struct record_header *) (block->data + block->first);
+  return 1;
 }
 
-/* Free a record_mem record entry.  */
+/* Move POS to the previous record of the log.  Return zero, leaving
+   POS alone, if POS is record_first.  */
 
-static inline void
-record_mem_release (struct record_entry *rec)
+static inline int
+record_pos_prev (struct record_pos *pos)
 {
-  gdb_assert (rec->type == record_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  struct record_block *block = pos->block;
+
+  if (block == NULL)
+    return 0;
+
+  if ((gdb_byte *) pos->rec != block->data + block->first)
+    pos->rec = (struct record_header *) ((gdb_byte *) pos->rec
+					 - pos->rec->prev_size);
+  else if (block->prev != NULL)
+    {
+      pos->block = block->prev;
+      pos->rec = (struct record_header *) (block->prev->data
+					   + block->prev->last);
+    }
+  else
+    record_pos_first (pos);
+
+  return 1;
 }
 
-/* Alloc a record_end record entry.  */
+/* Functions to manage the blocks of the execution log.  */
 
-static inline struct record_entry *
-record_end_alloc (void)
+/* Append a new block with room for SIZE bytes to the log.  */
+
+static struct record_block *
+record_block_new (unsigned int size)
 {
-  struct record_entry *rec;
+  struct record_block *block;
 
-  rec = (struct record_entry *) xcalloc (1, sizeof (struct record_entry));
-  rec->type = record_end;
+  if (size <= RECORD_BLOCK_SIZE && record_spare_block != NULL)
+    {
+      block = record_spare_block;
+      record_spare_block = NULL;
+    }
+  else
+    {
+      block = XNEW (struct record_block);
+      block->size = max (size, RECORD_BLOCK_SIZE);
+      block->data = xmalloc (block->size);
+    }
 
-  return rec;
+  block->used = 0;
+  block->first = 0;
+  block->last = 0;
+  block->next = NULL;
+  block->prev = record_last_block;
+  if (record_last_block)
+    record_last_block->next = block;
+  else
+    record_first_block = block;
+  record_last_block = block;
+
+  return block;
 }
 
-/* Free a record_end record entry.  */
+/* Free BLOCK, which is not in the log.  */
 
-static inline void
-record_end_release (struct record_entry *rec)
+static void
+record_block_free (struct record_block *block)
 {
-  xfree (rec);
+  xfree (block->data);
+  xfree (block);
 }
 
-/* Free one record entry, any type.
-   Return entry->type, in case caller wants to know.  */
+/* Remove BLOCK from the log.  Keep it as the spare block if there
+   is none yet.  */
 
-static inline enum record_type
-record_entry_release (struct record_entry *rec)
+static void
+record_block_release (struct record_block *block)
 {
-  enum record_type type = rec->type;
+  if (block->prev)
+    block->prev->next = block->next;
+  else
+    record_first_block = block->next;
+  if (block->next)
+    block->next->prev = block->prev;
+  else
+    record_last_block = block->prev;
 
-  switch (type) {
-  case record_reg:
-    record_reg_release (rec);
-    break;
-  case record_mem:
-    record_mem_release (rec);
-    break;
-  case record_end:
-    record_end_release (rec);
-    break;
-  }
-  return type;
+  if (record_spare_block == NULL && block->size == RECORD_BLOCK_SIZE)
+    record_spare_block = block;
+  else
+    record_block_free (block);
 }
 
-/* Free all record entries in list pointed to by REC.  */
+/* Append a copy of the SIZE bytes record REC to the log, and point
+   record_list at it.  */
 
 static void
-record_list_release (struct record_entry *rec)
+record_list_append (const struct record_header *rec, unsigned int size)
 {
-  if (!rec)
-    return;
+  struct record_block *block = record_last_block;
+  struct record_header *copy;
 
-  while (rec->next)
-    rec = rec->next;
+  if (block == NULL || block->size - block->used < size)
+    block = record_block_new (size);
 
-  while (rec->prev)
-    {
-      rec = rec->prev;
-      record_entry_release (rec->next);
-    }
+  copy = (struct record_header *) (block->data + block->used);
+  memcpy (copy, rec, size);
+  copy->prev_size = block->used - block->last;
+  block->last = block->used;
+  block->used += size;
+
+  record_list.block = block;
+  record_list.rec = copy;
+}
 
-  if (rec == &record_first)
+/* Free the whole execution log.  */
+
+static void
+record_list_release (void)
+{
+  while (record_first_block)
+    record_block_release (record_first_block);
+
+  if (record_spare_block)
     {
-      record_insn_num = 0;
-      record_first.next = NULL;
+      record_block_free (record_spare_block);
+      record_spare_block = NULL;
     }
-  else
-    record_entry_release (rec);
+
+  record_insn_num = 0;
+  record_pos_first (&record_list);
 }
 
-/* Free all record entries forward of the given list position.  */
+/* Free all records forward of the given log position.  */
 
 static void
-record_list_release_following (struct record_entry *rec)
+record_list_release_following (struct record_pos *pos)
 {
-  struct record_entry *tmp = rec->next;
+  struct record_pos tmp = *pos;
 
-  rec->next = NULL;
-  while (tmp)
+  while (record_pos_next (&tmp))
+    if (tmp.rec->type == record_end)
+      {
+	record_insn_num--;
+	record_insn_count--;
+      }
+
+  if (pos->block == NULL)
     {
-      rec = tmp->next;
-      if (record_entry_release (tmp) == record_end)
-	{
-	  record_insn_num--;
-	  record_insn_count--;
-	}
-      tmp = rec;
+      while (record_first_block)
+	record_block_release (record_first_block);
+    }
+  else
+    {
+      while (record_last_block != pos->block)
+	record_block_release (record_last_block);
+      pos->block->last = (gdb_byte *) pos->rec - pos->block->data;
+      pos->block->used = pos->block->last + record_size (pos->rec);
     }
 }
 
@@ -389,24 +529,31 @@ record_list_release_following (struct record_entry *rec)
 static void
 record_list_release_first (void)
 {
-  struct record_entry *tmp;
-
-  if (!record_first.next)
-    return;
+  struct record_block *block;
 
   /* Loop until a record_end.  */
-  while (1)
+  while ((block = record_first_block) != NULL)
     {
-      /* Cut record_first.next out of the linked list.  */
-      tmp = record_first.next;
-      record_first.next = tmp->next;
-      tmp->next->prev = &record_first;
+      struct record_header *rec;
+      enum record_type type;
+
+      rec = (struct record_header *) (block->data + block->first);
+      type = rec->type;
 
-      /* tmp is now isolated, and can be deleted.  */
-      if (record_entry_release (tmp) == record_end)
+      /* Do not leave record_list pointing to a released record.  The
+	 state after the released instruction is the state before the
+	 first remaining one.  */
+      if (record_list.rec == rec)
+	record_pos_first (&record_list);
+
+      block->first += record_size (rec);
+      if (block->first == block->used)
+	record_block_release (block);
+
+      if (type == record_end)
 	break;	/* End loop at first record_end.  */
 
-      if (!record_first.next)
+      if (record_first_block == NULL)
 	{
 	  gdb_assert (record_insn_num == 1);
 	  break;	/* End loop when list is empty.  */
@@ -414,49 +561,111 @@ record_list_release_first (void)
     }
 }
 
-/* Add a struct record_entry to record_arch_list.  */
+/* Functions to build the records of the current instruction in
+   record_arch_buf.  */
 
-static void
-record_arch_list_add (struct record_entry *rec)
+/* Return room for a SIZE bytes record at the end of
+   record_arch_buf.  */
+
+static struct record_header *
+record_arch_list_add (unsigned int size)
 {
+  struct record_header *rec;
+
+  if (record_arch_buf_size - record_arch_buf_used < size)
+    {
+      record_arch_buf_size = max (2 * record_arch_buf_size,
+				  record_arch_buf_used + size);
+      record_arch_buf_size = max (record_arch_buf_size, 1024);
+      record_arch_buf = xrealloc (record_arch_buf, record_arch_buf_size);
+    }
+
+  rec = (struct record_header *) (record_arch_buf + record_arch_buf_used);
+  record_arch_buf_used += size;
+  memset (rec, 0, size);
+
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
 			"Process record: record_arch_list_add %s.\n",
 			host_address_to_string (rec));
 
-  if (record_arch_list_tail)
-    {
-      record_arch_list_tail->next = rec;
-      rec->prev = record_arch_list_tail;
-      record_arch_list_tail = rec;
-    }
-  else
+  return rec;
+}
+
+/* Discard the records of record_arch_buf.  */
+
+static void
+record_arch_list_release (void)
+{
+  record_arch_buf_used = 0;
+}
+
+/* Append the records of record_arch_buf to the execution log, and
+   point record_list at the last one.  */
+
+static void
+record_arch_list_commit (void)
+{
+  unsigned int offset, size;
+
+  for (offset = 0; offset < record_arch_buf_used; offset += size)
     {
-      record_arch_list_head = rec;
-      record_arch_list_tail = rec;
+      struct record_header *rec;
+
+      rec = (struct record_header *) (record_arch_buf + offset);
+      size = record_size (rec);
+      record_list_append (rec, size);
     }
+
+  record_arch_buf_used = 0;
 }
 
-/* Return the value storage location of a record entry.  */
-static inline gdb_byte *
-record_get_loc (struct record_entry *rec)
+/* Alloc a record_reg record in record_arch_buf.  */
+
+static inline struct record_header *
+record_reg_alloc (struct regcache *regcache, int regnum)
 {
-  switch (rec->type) {
-  case record_mem:
-    if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-      return rec->u.mem.u.ptr;
-    else
-      return rec->u.mem.u.buf;
-  case record_reg:
-    if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-      return rec->u.reg.u.ptr;
-    else
-      return rec->u.reg.u.buf;
-  case record_end:
-  default:
-    gdb_assert (0);
-    return NULL;
-  }
+  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  int len = register_size (gdbarch, regnum);
+  struct record_header *rec;
+
+  rec = record_arch_list_add (RECORD_ALIGN_SIZE
+			      (sizeof (struct record_reg_entry) + len));
+  rec->type = record_reg;
+  RECORD_REG (rec)->num = regnum;
+  RECORD_REG (rec)->len = len;
+
+  return rec;
+}
+
+/* Alloc a record_mem record in record_arch_buf.  */
+
+static inline struct record_header *
+record_mem_alloc (CORE_ADDR addr, int len)
+{
+  struct record_header *rec;
+
+  rec = record_arch_list_add (RECORD_ALIGN_SIZE
+			      (sizeof (struct record_mem_entry) + len));
+  rec->type = record_mem;
+  RECORD_MEM (rec)->addr = addr;
+  RECORD_MEM (rec)->len = len;
+
+  return rec;
+}
+
+/* Alloc a record_end record in record_arch_buf.  */
+
+static inline struct record_header *
+record_end_alloc (void)
+{
+  struct record_header *rec;
+
+  rec = record_arch_list_add (RECORD_ALIGN_SIZE
+			      (sizeof (struct record_end_entry)));
+  rec->type = record_end;
+
+  return rec;
 }
 
 /* Record the value of a register NUM to record_arch_list.  */
@@ -464,7 +673,7 @@ record_get_loc (struct record_entry *rec)
 int
 record_arch_list_add_reg (struct regcache *regcache, int regnum)
 {
-  struct record_entry *rec;
+  struct record_header *rec;
 
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
@@ -476,8 +685,6 @@ record_arch_list_add_reg (struct regcache *regcache, int regnum)
 
   regcache_raw_read (regcache, regnum, record_get_loc (rec));
 
-  record_arch_list_add (rec);
-
   return 0;
 }
 
@@ -487,7 +694,7 @@ record_arch_list_add_reg (struct regcache *regcache, int regnum)
 int
 record_arch_list_add_mem (CORE_ADDR addr, int len)
 {
-  struct record_entry *rec;
+  struct record_header *rec;
 
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
@@ -507,31 +714,28 @@ record_arch_list_add_mem (CORE_ADDR addr, int len)
 			    "Process record: error reading memory at "
 			    "addr = %s len = %d.\n",
 			    paddress (target_gdbarch, addr), len);
-      record_mem_release (rec);
+      /* REC is the last record of record_arch_buf.  */
+      record_arch_buf_used -= record_size (rec);
       return -1;
     }
 
-  record_arch_list_add (rec);
-
   return 0;
 }
 
-/* Add a record_end type struct record_entry to record_arch_list.  */
+/* Add a record_end type record to record_arch_list.  */
 
 int
 record_arch_list_add_end (void)
 {
-  struct record_entry *rec;
+  struct record_header *rec;
 
   if (record_debug > 1)
     fprintf_unfiltered (gdb_stdlog,
 			"Process record: add end to arch list.\n");
 
   rec = record_end_alloc ();
-  rec->u.end.sigval = TARGET_SIGNAL_0;
-  rec->u.end.insn_num = ++record_insn_count;
-
-  record_arch_list_add (rec);
+  RECORD_END (rec)->sigval = TARGET_SIGNAL_0;
+  RECORD_END (rec)->insn_num = ++record_insn_count;
 
   return 0;
 }
@@ -568,7 +772,7 @@ record_check_insn_num (int set_terminal)
 static void
 record_arch_list_cleanups (void *ignore)
 {
-  record_list_release (record_arch_list_tail);
+  record_arch_list_release ();
 }
 
 /* Before inferior step (when GDB record the running message, inferior
@@ -584,8 +788,7 @@ record_message (struct regcache *regcache, enum target_signal signal)
   struct gdbarch *gdbarch = get_regcache_arch (regcache);
   struct cleanup *old_cleanups = make_cleanup (record_arch_list_cleanups, 0);
 
-  record_arch_list_head = NULL;
-  record_arch_list_tail = NULL;
+  record_arch_list_release ();
 
   /* Check record_insn_num.  */
   record_check_insn_num (1);
@@ -612,10 +815,10 @@ record_message (struct regcache *regcache, enum target_signal signal)
      But we should still deliver the signal to gdb during the replay,
      if we delivered it during the recording.  Therefore we should
      record the signal during record_wait, not record_resume.  */
-  if (record_list != &record_first)    /* FIXME better way to check */
+  if (record_list.block != NULL)
     {
-      gdb_assert (record_list->type == record_end);
-      record_list->u.end.sigval = signal;
+      gdb_assert (record_list.rec->type == record_end);
+      RECORD_END (record_list.rec)->sigval = signal;
     }
 
   if (signal == TARGET_SIGNAL_0
@@ -635,9 +838,7 @@ record_message (struct regcache *regcache, enum target_signal signal)
 
   discard_cleanups (old_cleanups);
 
-  record_list->next = record_arch_list_head;
-  record_arch_list_head->prev = record_list;
-  record_list = record_arch_list_tail;
+  record_arch_list_commit ();
 
   if (record_insn_num == record_insn_max_num && record_insn_max_num)
     record_list_release_first ();
@@ -698,7 +899,7 @@ static int record_hw_watchpoint = 0;
 
 static inline void
 record_exec_insn (struct regcache *regcache, struct gdbarch *gdbarch,
-		  struct record_entry *entry)
+		  struct record_header *entry)
 {
   switch (entry->type)
     {
@@ -711,55 +912,55 @@ record_exec_insn (struct regcache *regcache, struct gdbarch *gdbarch,
                               "Process record: record_reg %s to "
                               "inferior num = %d.\n",
                               host_address_to_string (entry),
-                              entry->u.reg.num);
+                              RECORD_REG (entry)->num);
 
-        regcache_cooked_read (regcache, entry->u.reg.num, reg);
-        regcache_cooked_write (regcache, entry->u.reg.num, 
+        regcache_cooked_read (regcache, RECORD_REG (entry)->num, reg);
+        regcache_cooked_write (regcache, RECORD_REG (entry)->num,
 			       record_get_loc (entry));
-        memcpy (record_get_loc (entry), reg, entry->u.reg.len);
+        memcpy (record_get_loc (entry), reg, RECORD_REG (entry)->len);
       }
       break;
 
     case record_mem: /* mem */
       {
 	/* Nothing to do if the entry is flagged not_accessible.  */
-        if (!entry->u.mem.mem_entry_not_accessible)
+        if (!RECORD_MEM (entry)->mem_entry_not_accessible)
           {
-            gdb_byte *mem = alloca (entry->u.mem.len);
+            gdb_byte *mem = alloca (RECORD_MEM (entry)->len);
 
             if (record_debug > 1)
               fprintf_unfiltered (gdb_stdlog,
                                   "Process record: record_mem %s to "
                                   "inferior addr = %s len = %d.\n",
                                   host_address_to_string (entry),
-                                  paddress (gdbarch, entry->u.mem.addr),
-                                  entry->u.mem.len);
+                                  paddress (gdbarch, RECORD_MEM (entry)->addr),
+                                  RECORD_MEM (entry)->len);
 
-            if (target_read_memory (entry->u.mem.addr, mem, entry->u.mem.len))
+            if (target_read_memory (RECORD_MEM (entry)->addr, mem, RECORD_MEM (entry)->len))
               {
-                entry->u.mem.mem_entry_not_accessible = 1;
+                RECORD_MEM (entry)->mem_entry_not_accessible = 1;
                 if (record_debug)
                   warning ("Process record: error reading memory at "
 			   "addr = %s len = %d.",
-                           paddress (gdbarch, entry->u.mem.addr),
-                           entry->u.mem.len);
+                           paddress (gdbarch, RECORD_MEM (entry)->addr),
+                           RECORD_MEM (entry)->len);
               }
             else
               {
-                if (target_write_memory (entry->u.mem.addr, 
+                if (target_write_memory (RECORD_MEM (entry)->addr, 
 					 record_get_loc (entry),
-					 entry->u.mem.len))
+					 RECORD_MEM (entry)->len))
                   {
-                    entry->u.mem.mem_entry_not_accessible = 1;
+                    RECORD_MEM (entry)->mem_entry_not_accessible = 1;
                     if (record_debug)
                       warning ("Process record: error writing memory at "
 			       "addr = %s len = %d.",
-                               paddress (gdbarch, entry->u.mem.addr),
-                               entry->u.mem.len);
+                               paddress (gdbarch, RECORD_MEM (entry)->addr),
+                               RECORD_MEM (entry)->len);
                   }
                 else
 		  {
-		    memcpy (record_get_loc (entry), mem, entry->u.mem.len);
+		    memcpy (record_get_loc (entry), mem, RECORD_MEM (entry)->len);
 
 		    /* We've changed memory --- check if a hardware
 		       watchpoint should trap.  Note that this
@@ -771,7 +972,7 @@ record_exec_insn (struct regcache *regcache, struct gdbarch *gdbarch,
 		       traps.  */
 		    if (hardware_watchpoint_inserted_in_range
 			(get_regcache_aspace (regcache),
-			 entry->u.mem.addr, entry->u.mem.len))
+			 RECORD_MEM (entry)->addr, RECORD_MEM (entry)->len))
 		      record_hw_watchpoint = 1;
 		  }
               }
@@ -945,8 +1146,7 @@ record_open (char *name, int from_tty)
   /* Reset */
   record_insn_num = 0;
   record_insn_count = 0;
-  record_list = &record_first;
-  record_list->next = NULL;
+  record_pos_first (&record_list);
 
   /* Set the tmp beneath pointers to beneath pointers.  */
   record_beneath_to_resume_ops = tmp_to_resume_ops;
@@ -978,7 +1178,12 @@ record_close (int quitting)
   if (record_debug)
     fprintf_unfiltered (gdb_stdlog, "Process record: record_close\n");
 
-  record_list_release (record_list);
+  record_list_release ();
+
+  xfree (record_arch_buf);
+  record_arch_buf = NULL;
+  record_arch_buf_size = 0;
+  record_arch_buf_used = 0;
 
   /* Release record_core_regbuf.  */
   if (record_core_regbuf)
@@ -1039,12 +1244,9 @@ static void
 record_wait_cleanups (void *ignore)
 {
   if (execution_direction == EXEC_REVERSE)
-    {
-      if (record_list->next)
-	record_list = record_list->next;
-    }
+    record_pos_next (&record_list);
   else
-    record_list = record_list->prev;
+    record_pos_prev (&record_list);
 }
 
 /* "to_wait" target method for process record target.
@@ -1201,8 +1403,8 @@ record_wait (struct target_ops *ops,
 
       /* In EXEC_FORWARD mode, record_list points to the tail of prev
          instruction.  */
-      if (execution_direction == EXEC_FORWARD && record_list->next)
-	record_list = record_list->next;
+      if (execution_direction == EXEC_FORWARD)
+	record_pos_next (&record_list);
 
       /* Loop over the record_list, looking for the next place to
 	 stop.  */
@@ -1210,28 +1412,29 @@ record_wait (struct target_ops *ops,
 	{
 	  /* Check for beginning and end of log.  */
 	  if (execution_direction == EXEC_REVERSE
-	      && record_list == &record_first)
+	      && record_list.block == NULL)
 	    {
 	      /* Hit beginning of record log in reverse.  */
 	      status->kind = TARGET_WAITKIND_NO_HISTORY;
 	      break;
 	    }
-	  if (execution_direction != EXEC_REVERSE && !record_list->next)
+	  if (execution_direction != EXEC_REVERSE
+	      && record_pos_end_p (&record_list))
 	    {
 	      /* Hit end of record log going forward.  */
 	      status->kind = TARGET_WAITKIND_NO_HISTORY;
 	      break;
 	    }
 
-          record_exec_insn (regcache, gdbarch, record_list);
+          record_exec_insn (regcache, gdbarch, record_list.rec);
 
-	  if (record_list->type == record_end)
+	  if (record_list.rec->type == record_end)
 	    {
 	      if (record_debug > 1)
 		fprintf_unfiltered (gdb_stdlog,
 				    "Process record: record_end %s to "
 				    "inferior.\n",
-				    host_address_to_string (record_list));
+				    host_address_to_string (record_list.rec));
 
 	      if (first_record_end && execution_direction == EXEC_REVERSE)
 		{
@@ -1284,7 +1487,7 @@ Process record: hit hw watchpoint.\n");
 		      continue_flag = 0;
 		    }
 		  /* Check target signal */
-		  if (record_list->u.end.sigval != TARGET_SIGNAL_0)
+		  if (RECORD_END (record_list.rec)->sigval != TARGET_SIGNAL_0)
 		    /* FIXME: better way to check */
 		    continue_flag = 0;
 		}
@@ -1293,15 +1496,9 @@ Process record: hit hw watchpoint.\n");
 	  if (continue_flag)
 	    {
 	      if (execution_direction == EXEC_REVERSE)
-		{
-		  if (record_list->prev)
-		    record_list = record_list->prev;
-		}
+		record_pos_prev (&record_list);
 	      else
-		{
-		  if (record_list->next)
-		    record_list = record_list->next;
-		}
+		record_pos_next (&record_list);
 	    }
 	}
       while (continue_flag);
@@ -1309,9 +1506,10 @@ Process record: hit hw watchpoint.\n");
 replay_out:
       if (record_get_sig)
 	status->value.sig = TARGET_SIGNAL_INT;
-      else if (record_list->u.end.sigval != TARGET_SIGNAL_0)
+      else if (record_list.rec->type == record_end
+	       && RECORD_END (record_list.rec)->sigval != TARGET_SIGNAL_0)
 	/* FIXME: better way to check */
-	status->value.sig = record_list->u.end.sigval;
+	status->value.sig = RECORD_END (record_list.rec)->sigval;
       else
 	status->value.sig = TARGET_SIGNAL_TRAP;
 
@@ -1399,8 +1597,7 @@ record_registers_change (struct regcache *regcache, int regnum)
   /* Check record_insn_num.  */
   record_check_insn_num (0);
 
-  record_arch_list_head = NULL;
-  record_arch_list_tail = NULL;
+  record_arch_list_release ();
 
   if (regnum < 0)
     {
@@ -1410,7 +1607,7 @@ record_registers_change (struct regcache *regcache, int regnum)
 	{
 	  if (record_arch_list_add_reg (regcache, i))
 	    {
-	      record_list_release (record_arch_list_tail);
+	      record_arch_list_release ();
 	      error (_("Process record: failed to record execution log."));
 	    }
 	}
@@ -1419,18 +1616,16 @@ record_registers_change (struct regcache *regcache, int regnum)
     {
       if (record_arch_list_add_reg (regcache, regnum))
 	{
-	  record_list_release (record_arch_list_tail);
+	  record_arch_list_release ();
 	  error (_("Process record: failed to record execution log."));
 	}
     }
   if (record_arch_list_add_end ())
     {
-      record_list_release (record_arch_list_tail);
+      record_arch_list_release ();
       error (_("Process record: failed to record execution log."));
     }
-  record_list->next = record_arch_list_head;
-  record_arch_list_head->prev = record_list;
-  record_list = record_arch_list_tail;
+  record_arch_list_commit ();
 
   if (record_insn_num == record_insn_max_num && record_insn_max_num)
     record_list_release_first ();
@@ -1485,7 +1680,7 @@ record_store_registers (struct target_ops *ops, struct regcache *regcache,
 	    }
 
 	  /* Destroy the record from here forward.  */
-	  record_list_release_following (record_list);
+	  record_list_release_following (&record_list);
 	}
 
       record_registers_change (regcache, regno);
@@ -1517,18 +1712,17 @@ record_xfer_partial (struct target_ops *ops, enum target_object object,
 	    error (_("Process record canceled the operation."));
 
 	  /* Destroy the record from here forward.  */
-	  record_list_release_following (record_list);
+	  record_list_release_following (&record_list);
 	}
 
       /* Check record_insn_num */
       record_check_insn_num (0);
 
       /* Record registers change to list as an instruction.  */
-      record_arch_list_head = NULL;
-      record_arch_list_tail = NULL;
+      record_arch_list_release ();
       if (record_arch_list_add_mem (offset, len))
 	{
-	  record_list_release (record_arch_list_tail);
+	  record_arch_list_release ();
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog,
 				"Process record: failed to record "
@@ -1537,16 +1731,14 @@ record_xfer_partial (struct target_ops *ops, enum target_object object,
 	}
       if (record_arch_list_add_end ())
 	{
-	  record_list_release (record_arch_list_tail);
+	  record_arch_list_release ();
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog,
 				"Process record: failed to record "
 				"execution log.");
 	  return -1;
 	}
-      record_list->next = record_arch_list_head;
-      record_arch_list_head->prev = record_list;
-      record_list = record_arch_list_tail;
+      record_arch_list_commit ();
 
       if (record_insn_num == record_insn_max_num && record_insn_max_num)
 	record_list_release_first ();
@@ -1615,8 +1807,8 @@ record_get_bookmark (char *args, int from_tty)
   gdb_byte *ret = NULL;
 
   /* Return stringified form of instruction count.  */
-  if (record_list && record_list->type == record_end)
-    ret = xstrdup (pulongest (record_list->u.end.insn_num));
+  if (record_list.rec->type == record_end)
+    ret = xstrdup (pulongest (RECORD_END (record_list.rec)->insn_num));
 
   if (record_debug)
     {
@@ -1928,7 +2120,7 @@ cmd_record_delete (char *args, int from_tty)
 	  if (!from_tty || query (_("Delete the log from this point forward "
 		                    "and begin to record the running message "
 		                    "at current PC?")))
-	    record_list_release_following (record_list);
+	    record_list_release_following (&record_list);
 	}
       else
 	  printf_unfiltered (_("Already at end of record list.\n"));
@@ -1991,7 +2183,7 @@ show_record_command (char *args, int from_tty)
 static void
 info_record_command (char *args, int from_tty)
 {
-  struct record_entry *p;
+  struct record_pos p;
 
   if (current_target.to_stratum == record_stratum)
     {
@@ -2001,22 +2193,21 @@ info_record_command (char *args, int from_tty)
 	printf_filtered (_("Record mode:\n"));
 
       /* Find entry for first actual instruction in the log.  */
-      for (p = record_first.next;
-	   p != NULL && p->type != record_end;
-	   p = p->next)
+      record_pos_first (&p);
+      while (record_pos_next (&p) && p.rec->type != record_end)
 	;
 
       /* Do we have a log at all?  */
-      if (p != NULL && p->type == record_end)
+      if (p.block != NULL && p.rec->type == record_end)
 	{
 	  /* Display instruction number for first instruction in the log.  */
 	  printf_filtered (_("Lowest recorded instruction number is %s.\n"),
-			   pulongest (p->u.end.insn_num));
+			   pulongest (RECORD_END (p.rec)->insn_num));
 
 	  /* If in replay mode, display where we are in the log.  */
 	  if (RECORD_IS_REPLAY)
 	    printf_filtered (_("Current instruction number is %s.\n"),
-			     pulongest (record_list->u.end.insn_num));
+			     pulongest (RECORD_END (record_list.rec)->insn_num));
 
 	  /* Display instruction number for last instruction in the log.  */
 	  printf_filtered (_("Highest recorded instruction number is %s.\n"), 
@@ -2128,13 +2319,22 @@ netorder16 (uint16_t input)
   return ret;
 }
 
+/* Cleanup for record_restore: drop the partially restored log.  */
+
+static void
+record_restore_cleanups (void *ignore)
+{
+  record_arch_list_release ();
+  record_list_release ();
+}
+
 /* Restore the execution log from a core_bfd file.  */
 static void
 record_restore (void)
 {
   uint32_t magic;
   struct cleanup *old_cleanups;
-  struct record_entry *rec;
+  struct record_header *rec;
   asection *osec;
   uint32_t osec_size;
   int bfd_offset = 0;
@@ -2146,7 +2346,7 @@ record_restore (void)
     return;
 
   /* "record_restore" can only be called when record list is empty.  */
-  gdb_assert (record_first.next == NULL);
+  gdb_assert (record_first_block == NULL);
  
   if (record_debug)
     fprintf_unfiltered (gdb_stdlog, "Restoring recording from core file.\n");
@@ -2172,12 +2372,11 @@ record_restore (void)
   Reading 4-byte magic cookie RECORD_FILE_MAGIC (0x%s)\n",
 			phex_nz (netorder32 (magic), 4));
 
-  /* Restore the entries in recfd into record_arch_list_head and
-     record_arch_list_tail.  */
-  record_arch_list_head = NULL;
-  record_arch_list_tail = NULL;
+  /* Restore the entries in recfd into the log, one instruction at a
+     time.  */
+  record_arch_list_release ();
   record_insn_num = 0;
-  old_cleanups = make_cleanup (record_arch_list_cleanups, 0);
+  old_cleanups = make_cleanup (record_restore_cleanups, 0);
   regcache = get_current_regcache ();
 
   while (1)
@@ -2203,14 +2402,14 @@ record_restore (void)
 
           /* Get val.  */
           bfdcore_read (core_bfd, osec, record_get_loc (rec),
-			rec->u.reg.len, &bfd_offset);
+			RECORD_REG (rec)->len, &bfd_offset);
 
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog, "\
   Reading register %d (1 plus %lu plus %d bytes)\n",
-				rec->u.reg.num,
+				RECORD_REG (rec)->num,
 				(unsigned long) sizeof (regnum),
-				rec->u.reg.len);
+				RECORD_REG (rec)->len);
           break;
 
         case record_mem: /* mem */
@@ -2228,16 +2427,16 @@ record_restore (void)
 
           /* Get val.  */
           bfdcore_read (core_bfd, osec, record_get_loc (rec),
-			rec->u.mem.len, &bfd_offset);
+			RECORD_MEM (rec)->len, &bfd_offset);
 
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog, "\
   Reading memory %s (1 plus %lu plus %lu plus %d bytes)\n",
 				paddress (get_current_arch (),
-					  rec->u.mem.addr),
+					  RECORD_MEM (rec)->addr),
 				(unsigned long) sizeof (addr),
 				(unsigned long) sizeof (len),
-				rec->u.mem.len);
+				RECORD_MEM (rec)->len);
           break;
 
         case record_end: /* end */
@@ -2248,13 +2447,13 @@ record_restore (void)
 	  bfdcore_read (core_bfd, osec, &signal, 
 			sizeof (signal), &bfd_offset);
 	  signal = netorder32 (signal);
-	  rec->u.end.sigval = signal;
+	  RECORD_END (rec)->sigval = signal;
 
 	  /* Get insn count.  */
 	  bfdcore_read (core_bfd, osec, &count, 
 			sizeof (count), &bfd_offset);
 	  count = netorder32 (count);
-	  rec->u.end.insn_num = count;
+	  RECORD_END (rec)->insn_num = count;
 	  record_insn_count = count + 1;
 	  if (record_debug)
 	    fprintf_unfiltered (gdb_stdlog, "\
@@ -2263,6 +2462,9 @@ record_restore (void)
 				(unsigned long) sizeof (count),
 				paddress (get_current_arch (),
 					  bfd_offset));
+
+	  /* Add the instruction to the log.  */
+	  record_arch_list_commit ();
           break;
 
         default:
@@ -2270,18 +2472,13 @@ record_restore (void)
 		 bfd_get_filename (core_bfd));
           break;
         }
-
-      /* Add rec to record arch list.  */
-      record_arch_list_add (rec);
     }
 
   discard_cleanups (old_cleanups);
 
-  /* Add record_arch_list_head to the end of record list.  */
-  record_first.next = record_arch_list_head;
-  record_arch_list_head->prev = &record_first;
-  record_arch_list_tail->next = NULL;
-  record_list = &record_first;
+  /* Add what follows the last record_end, if anything.  */
+  record_arch_list_commit ();
+  record_pos_first (&record_list);
 
   /* Update record_insn_max_num.  */
   if (record_insn_num > record_insn_max_num)
@@ -2341,7 +2538,7 @@ static void
 cmd_record_save (char *args, int from_tty)
 {
   char *recfilename, recfilename_buffer[40];
-  struct record_entry *cur_record_list;
+  struct record_pos cur_record_list, p;
   uint32_t magic;
   struct regcache *regcache;
   struct gdbarch *gdbarch;
@@ -2389,29 +2586,27 @@ cmd_record_save (char *args, int from_tty)
   while (1)
     {
       /* Check for beginning and end of log.  */
-      if (record_list == &record_first)
+      if (record_list.block == NULL)
         break;
 
-      record_exec_insn (regcache, gdbarch, record_list);
+      record_exec_insn (regcache, gdbarch, record_list.rec);
 
-      if (record_list->prev)
-        record_list = record_list->prev;
+      record_pos_prev (&record_list);
     }
 
   /* Compute the size needed for the extra bfd section.  */
   save_size = 4;	/* magic cookie */
-  for (record_list = record_first.next; record_list;
-       record_list = record_list->next)
-    switch (record_list->type)
+  for (p = record_list; record_pos_next (&p); )
+    switch (p.rec->type)
       {
       case record_end:
 	save_size += 1 + 4 + 4;
 	break;
       case record_reg:
-	save_size += 1 + 4 + record_list->u.reg.len;
+	save_size += 1 + 4 + RECORD_REG (p.rec)->len;
 	break;
       case record_mem:
-	save_size += 1 + 4 + 8 + record_list->u.mem.len;
+	save_size += 1 + 4 + 8 + RECORD_MEM (p.rec)->len;
 	break;
       }
 
@@ -2442,37 +2637,36 @@ cmd_record_save (char *args, int from_tty)
 
   /* Save the entries to recfd and forward execute to the end of
      record list.  */
-  record_list = &record_first;
   while (1)
     {
       /* Save entry.  */
-      if (record_list != &record_first)
+      if (record_list.block != NULL)
         {
 	  uint8_t type;
 	  uint32_t regnum, len, signal, count;
           uint64_t addr;
 
-	  type = record_list->type;
+	  type = record_list.rec->type;
           bfdcore_write (obfd, osec, &type, sizeof (type), &bfd_offset);
 
-          switch (record_list->type)
+          switch (record_list.rec->type)
             {
             case record_reg: /* reg */
 	      if (record_debug)
 		fprintf_unfiltered (gdb_stdlog, "\
   Writing register %d (1 plus %lu plus %d bytes)\n",
-				    record_list->u.reg.num,
+				    RECORD_REG (record_list.rec)->num,
 				    (unsigned long) sizeof (regnum),
-				    record_list->u.reg.len);
+				    RECORD_REG (record_list.rec)->len);
 
               /* Write regnum.  */
-              regnum = netorder32 (record_list->u.reg.num);
+              regnum = netorder32 (RECORD_REG (record_list.rec)->num);
               bfdcore_write (obfd, osec, &regnum,
 			     sizeof (regnum), &bfd_offset);
 
               /* Write regval.  */
-              bfdcore_write (obfd, osec, record_get_loc (record_list),
-			     record_list->u.reg.len, &bfd_offset);
+              bfdcore_write (obfd, osec, record_get_loc (record_list.rec),
+			     RECORD_REG (record_list.rec)->len, &bfd_offset);
               break;
 
             case record_mem: /* mem */
@@ -2480,23 +2674,23 @@ cmd_record_save (char *args, int from_tty)
 		fprintf_unfiltered (gdb_stdlog, "\
   Writing memory %s (1 plus %lu plus %lu plus %d bytes)\n",
 				    paddress (gdbarch,
-					      record_list->u.mem.addr),
+					      RECORD_MEM (record_list.rec)->addr),
 				    (unsigned long) sizeof (addr),
 				    (unsigned long) sizeof (len),
-				    record_list->u.mem.len);
+				    RECORD_MEM (record_list.rec)->len);
 
 	      /* Write memlen.  */
-	      len = netorder32 (record_list->u.mem.len);
+	      len = netorder32 (RECORD_MEM (record_list.rec)->len);
 	      bfdcore_write (obfd, osec, &len, sizeof (len), &bfd_offset);
 
 	      /* Write memaddr.  */
-	      addr = netorder64 (record_list->u.mem.addr);
+	      addr = netorder64 (RECORD_MEM (record_list.rec)->addr);
 	      bfdcore_write (obfd, osec, &addr, 
 			     sizeof (addr), &bfd_offset);
 
 	      /* Write memval.  */
-	      bfdcore_write (obfd, osec, record_get_loc (record_list),
-			     record_list->u.mem.len, &bfd_offset);
+	      bfdcore_write (obfd, osec, record_get_loc (record_list.rec),
+			     RECORD_MEM (record_list.rec)->len, &bfd_offset);
               break;
 
               case record_end:
@@ -2506,12 +2700,12 @@ cmd_record_save (char *args, int from_tty)
 				      (unsigned long) sizeof (signal),
 				      (unsigned long) sizeof (count));
 		/* Write signal value.  */
-		signal = netorder32 (record_list->u.end.sigval);
+		signal = netorder32 (RECORD_END (record_list.rec)->sigval);
 		bfdcore_write (obfd, osec, &signal,
 			       sizeof (signal), &bfd_offset);
 
 		/* Write insn count.  */
-		count = netorder32 (record_list->u.end.insn_num);
+		count = netorder32 (RECORD_END (record_list.rec)->insn_num);
 		bfdcore_write (obfd, osec, &count,
 			       sizeof (count), &bfd_offset);
                 break;
@@ -2519,11 +2713,9 @@ cmd_record_save (char *args, int from_tty)
         }
 
       /* Execute entry.  */
-      record_exec_insn (regcache, gdbarch, record_list);
+      record_exec_insn (regcache, gdbarch, record_list.rec);
 
-      if (record_list->next)
-        record_list = record_list->next;
-      else
+      if (!record_pos_next (&record_list))
         break;
     }
 
@@ -2531,13 +2723,12 @@ cmd_record_save (char *args, int from_tty)
   while (1)
     {
       /* Check for beginning and end of log.  */
-      if (record_list == cur_record_list)
+      if (record_list.rec == cur_record_list.rec)
         break;
 
-      record_exec_insn (regcache, gdbarch, record_list);
+      record_exec_insn (regcache, gdbarch, record_list.rec);
 
-      if (record_list->prev)
-        record_list = record_list->prev;
+      record_pos_prev (&record_list);
     }
 
   do_cleanups (set_cleanups);
@@ -2554,7 +2745,7 @@ cmd_record_save (char *args, int from_tty)
    correspondingly.  */
 
 static void
-record_goto_insn (struct record_entry *entry,
+record_goto_insn (struct record_pos *entry,
 		  enum exec_direction_kind dir)
 {
   struct cleanup *set_cleanups = record_gdb_operation_disable_set ();
@@ -2565,16 +2756,16 @@ record_goto_insn (struct record_entry *entry,
      and we will not hit the end of the recording.  */
 
   if (dir == EXEC_FORWARD)
-    record_list = record_list->next;
+    record_pos_next (&record_list);
 
   do
     {
-      record_exec_insn (regcache, gdbarch, record_list);
+      record_exec_insn (regcache, gdbarch, record_list.rec);
       if (dir == EXEC_REVERSE)
-	record_list = record_list->prev;
+	record_pos_prev (&record_list);
       else
-	record_list = record_list->next;
-    } while (record_list != entry);
+	record_pos_next (&record_list);
+    } while (record_list.rec != entry->rec);
   do_cleanups (set_cleanups);
 }
 
@@ -2586,7 +2777,8 @@ record_goto_insn (struct record_entry *entry,
 static void
 cmd_record_goto (char *arg, int from_tty)
 {
-  struct record_entry *p = NULL;
+  struct record_pos p;
+  int found = 0;
   ULONGEST target_insn = 0;
 
   if (arg == NULL || *arg == '\0')
@@ -2596,48 +2788,49 @@ cmd_record_goto (char *arg, int from_tty)
       || strncmp (arg, "begin", strlen ("begin")) == 0)
     {
       /* Special case.  Find first insn.  */
-      for (p = &record_first; p != NULL; p = p->next)
-	if (p->type == record_end)
-	  break;
-      if (p)
-	target_insn = p->u.end.insn_num;
+      record_pos_first (&p);
+      found = 1;
     }
   else if (strncmp (arg, "end", strlen ("end")) == 0)
     {
       /* Special case.  Find last insn.  */
-      for (p = record_list; p->next != NULL; p = p->next)
+      record_pos_last (&p);
+      while (p.rec->type != record_end && record_pos_prev (&p))
 	;
-      for (; p!= NULL; p = p->prev)
-	if (p->type == record_end)
-	  break;
-      if (p)
-	target_insn = p->u.end.insn_num;
+      found = 1;
     }
   else
     {
       /* General case.  Find designated insn.  */
       target_insn = parse_and_eval_long (arg);
 
-      for (p = &record_first; p != NULL; p = p->next)
-	if (p->type == record_end && p->u.end.insn_num == target_insn)
-	  break;
+      record_pos_first (&p);
+      do
+	if (p.rec->type == record_end
+	    && RECORD_END (p.rec)->insn_num == target_insn)
+	  {
+	    found = 1;
+	    break;
+	  }
+      while (record_pos_next (&p));
     }
-
-  if (p == NULL)
+  if (!found)
     error (_("Target insn '%s' not found."), arg);
-  else if (p == record_list)
+
+  target_insn = RECORD_END (p.rec)->insn_num;
+  if (p.rec == record_list.rec)
     error (_("Already at insn '%s'."), arg);
-  else if (p->u.end.insn_num > record_list->u.end.insn_num)
+  else if (target_insn > RECORD_END (record_list.rec)->insn_num)
     {
       printf_filtered (_("Go forward to insn number %s\n"),
 		       pulongest (target_insn));
-      record_goto_insn (p, EXEC_FORWARD);
+      record_goto_insn (&p, EXEC_FORWARD);
     }
   else
     {
       printf_filtered (_("Go backward to insn number %s\n"),
 		       pulongest (target_insn));
-      record_goto_insn (p, EXEC_REVERSE);
+      record_goto_insn (&p, EXEC_REVERSE);
     }
   registers_changed ();
   reinit_frame_cache ();
@@ -2650,9 +2843,7 @@ _initialize_record (void)
   struct cmd_list_element *c;
 
   /* Init record_first.  */
-  record_first.prev = NULL;
-  record_first.next = NULL;
-  record_first.type = record_end;
+  record_first.h.type = record_end;
 
   init_record_ops ();
   add_target (&record_ops);
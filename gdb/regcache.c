@@ -604,6 +604,41 @@ regcache_raw_read (struct regcache *regcache, int regnum, gdb_byte *buf)
 	  regcache->descr->sizeof_register[regnum]);
 }
 
+void
+regcache_raw_prefetch (struct regcache *regcache, int nregs,
+		       const int *regnums)
+{
+  struct cleanup *old_chain;
+  int *wanted;
+  int i, count = 0;
+
+  gdb_assert (regcache != NULL);
+  if (regcache->readonly_p || nregs <= 0)
+    return;
+
+  wanted = xmalloc (nregs * sizeof (int));
+  old_chain = make_cleanup (xfree, wanted);
+
+  for (i = 0; i < nregs; i++)
+    {
+      int regnum = regnums[i];
+
+      if (regnum >= 0 && regnum < regcache->descr->nr_raw_registers
+	  && !regcache->register_valid_p[regnum])
+	wanted[count++] = regnum;
+    }
+
+  /* A single register is no cheaper to prefetch than to read.  */
+  if (count > 1)
+    {
+      save_inferior_ptid ();
+      inferior_ptid = regcache->ptid;
+      target_prefetch_registers (regcache, count, wanted);
+    }
+
+  do_cleanups (old_chain);
+}
+
 void
 regcache_raw_read_signed (struct regcache *regcache, int regnum, LONGEST *val)
 {
@@ -48,6 +48,14 @@ extern struct address_space *get_regcache_aspace (const struct regcache *regcach
 void regcache_raw_read (struct regcache *regcache, int rawnum, gdb_byte *buf);
 void regcache_raw_write (struct regcache *regcache, int rawnum,
 			 const gdb_byte *buf);
+
+/* Tell REGCACHE that the NREGS raw registers listed in REGNUMS are
+   about to be read, so that those not yet cached can be fetched from
+   the target together rather than one at a time.  Entries outside
+   [0..NUM_REGS) are ignored.  */
+
+extern void regcache_raw_prefetch (struct regcache *regcache,
+				   int nregs, const int *regnums);
 extern void regcache_raw_read_signed (struct regcache *regcache,
 				      int regnum, LONGEST *val);
 extern void regcache_raw_read_unsigned (struct regcache *regcache,
@@ -375,6 +375,8 @@ struct packet_reg
   long regnum; /* GDB's internal register number.  */
   LONGEST pnum; /* Remote protocol register number.  */
   int in_g_packet; /* Always part of G packet.  */
+  int expedite; /* Number of further stops for which to ask the stub to
+		   include it in stop replies; -1 for all of them.  */
   /* long size in bytes;  == register_size (target_gdbarch, regnum);
      at present.  */
   /* char *name; == gdbarch_register_name (target_gdbarch, regnum);
@@ -589,6 +591,16 @@ init_remote_state (struct gdbarch *gdbarch)
      to be smaller.  */
   rsa->sizeof_g_packet = offset;
 
+  /* Every unwinder needs the PC and the stack pointer; other registers
+     are added to the expedited set for a while when we find we need
+     them.  */
+  if (gdbarch_pc_regnum (gdbarch) >= 0
+      && gdbarch_pc_regnum (gdbarch) < gdbarch_num_regs (gdbarch))
+    rsa->regs[gdbarch_pc_regnum (gdbarch)].expedite = -1;
+  if (gdbarch_sp_regnum (gdbarch) >= 0
+      && gdbarch_sp_regnum (gdbarch) < gdbarch_num_regs (gdbarch))
+    rsa->regs[gdbarch_sp_regnum (gdbarch)].expedite = -1;
+
   /* Default maximum number of characters in a packet body. Many
      remote stubs have a hardwired buffer size of 400 bytes
      (c.f. BUFMAX in m68k-stub.c and i386-stub.c).  BUFMAX-1 is used
@@ -1221,6 +1233,9 @@ enum {
   PACKET_bs,
   PACKET_TracepointSource,
   PACKET_QAllow,
+  PACKET_qFetchRegs,
+  PACKET_QExpedite,
+  PACKET_qReadMemRegions,
   PACKET_MAX
 };
 
@@ -1605,6 +1620,86 @@ remote_pass_signals (void)
     }
 }
 
+/* The number of bytes of stack memory above the stack pointer that
+   the stub should include in every stop reply.  */
+
+static int remote_expedite_stack_size = 256;
+
+static char *last_expedite_packet;
+
+/* The number of stops for which a register that we had to fetch on its
+   own after a stop stays in the expedited set.  A register that is
+   needed after every stop is fetched again once it ages out, which
+   puts it back; one that was only needed once drops out, so the stop
+   replies do not keep growing.  */
+
+#define REMOTE_EXPEDITE_STOPS 16
+
+/* If 'QExpedite' is supported, tell the remote stub which registers,
+   and how much of the stack, to send with every stop reply, if they've
+   changed since we last told it.  The register set is the PC, the
+   stack pointer, and the registers we had to fetch on their own after
+   one of the last REMOTE_EXPEDITE_STOPS stops.  */
+
+static void
+remote_expedite (void)
+{
+  struct remote_state *rs = get_remote_state ();
+  struct remote_arch_state *rsa;
+  char *expedite_packet, *p;
+  int sp_regnum, i;
+  long max_size;
+
+  if (remote_protocol_packets[PACKET_QExpedite].support == PACKET_DISABLE)
+    return;
+
+  rsa = get_remote_arch_state ();
+  max_size = get_remote_packet_size ();
+  expedite_packet = xmalloc (max_size);
+  p = expedite_packet;
+  p += xsnprintf (p, max_size, "QExpedite:");
+  for (i = 0; i < gdbarch_num_regs (target_gdbarch); i++)
+    {
+      struct packet_reg *reg = &rsa->regs[i];
+
+      if (reg->expedite == 0)
+	continue;
+      if (reg->expedite > 0)
+	reg->expedite--;
+
+      /* Leave room for the stack window.  */
+      if (reg->pnum == -1 || (p - expedite_packet) + 48 >= max_size)
+	continue;
+
+      if (p[-1] != ':')
+	*p++ = ',';
+      p += hexnumstr (p, reg->pnum);
+    }
+
+  sp_regnum = gdbarch_sp_regnum (target_gdbarch);
+  if (remote_expedite_stack_size > 0
+      && sp_regnum >= 0 && sp_regnum < gdbarch_num_regs (target_gdbarch)
+      && rsa->regs[sp_regnum].pnum != -1)
+    {
+      *p++ = ';';
+      p += hexnumstr (p, rsa->regs[sp_regnum].pnum);
+      p += xsnprintf (p, max_size - (p - expedite_packet), ",0,%x",
+		      remote_expedite_stack_size);
+    }
+  *p = '\0';
+
+  if (!last_expedite_packet || strcmp (last_expedite_packet, expedite_packet))
+    {
+      putpkt (expedite_packet);
+      getpkt (&rs->buf, &rs->buf_size, 0);
+      packet_ok (rs->buf, &remote_protocol_packets[PACKET_QExpedite]);
+      xfree (last_expedite_packet);
+      last_expedite_packet = expedite_packet;
+    }
+  else
+    xfree (expedite_packet);
+}
+
 static void
 remote_notice_signals (ptid_t ptid)
 {
@@ -3712,6 +3807,12 @@ static struct protocol_feature remote_protocol_features[] = {
     PACKET_TracepointSource },
   { "QAllow", PACKET_DISABLE, remote_supported_packet,
     PACKET_QAllow },
+  { "qFetchRegs", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qFetchRegs },
+  { "QExpedite", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QExpedite },
+  { "qReadMemRegions", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qReadMemRegions },
 };
 
 static char *remote_support_xml;
@@ -3942,6 +4043,10 @@ remote_open_1 (char *name, int from_tty, struct target_ops *target, int extended
   xfree (last_pass_packet);
   last_pass_packet = NULL;
 
+  /* Likewise the expedited registers and stack window.  */
+  xfree (last_expedite_packet);
+  last_expedite_packet = NULL;
+
   remote_fileio_reset ();
   reopen_exec_file ();
   reread_symbols ();
@@ -4512,6 +4617,9 @@ remote_resume (struct target_ops *ops,
   /* Update the inferior on signals to silently pass, if they've changed.  */
   remote_pass_signals ();
 
+  /* Likewise what to include in the stop reply.  */
+  remote_expedite ();
+
   /* The vCont packet doesn't need to specify threads via Hc.  */
   /* No reverse support (yet) for vCont.  */
   if (execution_direction != EXEC_REVERSE)
@@ -4859,6 +4967,11 @@ struct stop_reply
   int replay_event;
 
   int core;
+
+  /* Memory the stub sent along with the stop reply.  */
+  CORE_ADDR expedited_mem_addr;
+  gdb_byte *expedited_mem;
+  int expedited_mem_len;
 };
 
 /* The list of already fetched and acknowledged stop events.  */
@@ -4879,6 +4992,7 @@ stop_reply_xfree (struct stop_reply *r)
   if (r != NULL)
     {
       VEC_free (cached_reg_t, r->regcache);
+      xfree (r->expedited_mem);
       xfree (r);
     }
 }
@@ -5022,6 +5136,8 @@ remote_parse_stop_reply (char *buf, struct stop_reply *event)
   event->stopped_by_watchpoint_p = 0;
   event->regcache = NULL;
   event->core = -1;
+  event->expedited_mem = NULL;
+  event->expedited_mem_len = 0;
 
   switch (buf[0])
     {
@@ -5102,6 +5218,27 @@ Packet: '%s'\n"),
 		  p = unpack_varlen_hex (++p1, &c);
 		  event->core = c;
 		}
+	      else if (p1 - p == strlen ("memory")
+		       && strncmp (p, "memory", p1 - p) == 0)
+		{
+		  int len;
+
+		  p = unpack_varlen_hex (++p1, &addr);
+		  if (*p != ',')
+		    error (_("Malformed packet(c) (missing comma): %s\n\
+Packet: '%s'\n"),
+			   p, buf);
+		  ++p;
+
+		  p_temp = strchr (p, ';');
+		  len = (p_temp != NULL ? p_temp - p : strlen (p)) / 2;
+		  xfree (event->expedited_mem);
+		  event->expedited_mem = xmalloc (len);
+		  event->expedited_mem_len = hex2bin (p, event->expedited_mem,
+						      len);
+		  event->expedited_mem_addr = addr;
+		  p += 2 * event->expedited_mem_len;
+		}
 	      else
 		{
 		  /* Silently skip unknown optional info.  */
@@ -5339,6 +5476,12 @@ process_stop_reply (struct stop_reply *stop_reply,
 	  VEC_free (cached_reg_t, stop_reply->regcache);
 	}
 
+      /* Expedited stack memory.  */
+      if (stop_reply->expedited_mem_len > 0)
+	target_dcache_fill (ptid, stop_reply->expedited_mem_addr,
+			    stop_reply->expedited_mem,
+			    stop_reply->expedited_mem_len);
+
       remote_stopped_by_watchpoint_p = stop_reply->stopped_by_watchpoint_p;
       remote_watch_data_address = stop_reply->watch_data_address;
 
@@ -5767,12 +5910,141 @@ fetch_registers_using_g (struct regcache *regcache)
   process_g_packet (regcache);
 }
 
+/* Fetch the NREGS registers in REGS using as few 'qFetchRegs'
+   packets as will fit in the remote packet size.  Return 0 if the
+   stub does not support the packet or reports an error, in which case
+   the caller should fall back to 'p'; any registers already fetched
+   stay valid.  */
+
+static int
+fetch_registers_using_qFetchRegs (struct regcache *regcache,
+				  struct packet_reg **regs, int nregs)
+{
+  struct remote_state *rs = get_remote_state ();
+  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  long max_size = get_remote_packet_size ();
+  char regp[MAX_REGISTER_SIZE];
+  int first, last;
+
+  if (remote_protocol_packets[PACKET_qFetchRegs].support == PACKET_DISABLE)
+    return 0;
+
+  for (first = 0; first < nregs; first = last)
+    {
+      char *p = rs->buf;
+      long reply_size = 0;
+
+      p += xsnprintf (p, max_size, "qFetchRegs:");
+
+      /* Fill the request with as many registers as will fit, both in
+	 the request itself and in the stub's reply.  Each register
+	 costs two hex digits per byte plus a ';' separator in the
+	 reply, and at most eight hex digits plus a separator in the
+	 request.  */
+      for (last = first; last < nregs; last++)
+	{
+	  long size = 2 * register_size (gdbarch, regs[last]->regnum) + 1;
+
+	  if (last > first
+	      && ((p - rs->buf) + 9 >= max_size
+		  || reply_size + size >= max_size))
+	    break;
+
+	  if (last > first)
+	    *p++ = ';';
+	  p += hexnumstr (p, regs[last]->pnum);
+	  reply_size += size;
+	}
+      *p = '\0';
+
+      putpkt (rs->buf);
+      getpkt (&rs->buf, &rs->buf_size, 0);
+
+      switch (packet_ok (rs->buf, &remote_protocol_packets[PACKET_qFetchRegs]))
+	{
+	case PACKET_OK:
+	  break;
+	case PACKET_UNKNOWN:
+	case PACKET_ERROR:
+	  return 0;
+	}
+
+      /* The reply holds one value per requested register, in request
+	 order, separated by ';'.  An unfetchable register reads as
+	 'x'.  */
+      p = rs->buf;
+      for (; first < last; first++)
+	{
+	  struct packet_reg *reg = regs[first];
+	  int i = 0;
+
+	  if (*p == 'x')
+	    {
+	      regcache_raw_supply (regcache, reg->regnum, NULL);
+	      while (*p != ';' && *p != '\0')
+		p++;
+	    }
+	  else
+	    {
+	      while (*p != ';' && *p != '\0')
+		{
+		  if (p[1] == 0 || p[1] == ';' || i >= MAX_REGISTER_SIZE)
+		    error (_("Remote 'qFetchRegs' reply is malformed: %s"),
+			   rs->buf);
+
+		  regp[i++] = fromhex (p[0]) * 16 + fromhex (p[1]);
+		  p += 2;
+		}
+	      if (i != register_size (gdbarch, reg->regnum))
+		error (_("Remote 'qFetchRegs' reply has %d bytes for "
+			 "register \"%s\", expected %d: %s"),
+		       i, gdbarch_register_name (gdbarch, reg->regnum),
+		       register_size (gdbarch, reg->regnum), rs->buf);
+	      regcache_raw_supply (regcache, reg->regnum, regp);
+	    }
+
+	  if (*p == ';')
+	    p++;
+	  else if (first + 1 < last)
+	    error (_("Remote 'qFetchRegs' reply is too short: %s"), rs->buf);
+	}
+    }
+
+  return 1;
+}
+
+/* Fetch the registers in REGS that the 'g' packet does not cover,
+   preferring a single 'qFetchRegs' round trip over one 'p' packet per
+   register.  */
+
+static void
+fetch_registers_not_in_g (struct regcache *regcache,
+			  struct packet_reg **regs, int nregs)
+{
+  int i;
+
+  if (nregs > 1 && fetch_registers_using_qFetchRegs (regcache, regs, nregs))
+    return;
+
+  /* Skip the registers that a partly successful 'qFetchRegs' already
+     supplied.  */
+  for (i = 0; i < nregs; i++)
+    if (!regcache_valid_p (regcache, regs[i]->regnum)
+	&& !fetch_register_using_p (regcache, regs[i]))
+      {
+	/* This register is not available.  */
+	regcache_raw_supply (regcache, regs[i]->regnum, NULL);
+      }
+}
+
 static void
 remote_fetch_registers (struct target_ops *ops,
 			struct regcache *regcache, int regnum)
 {
   struct remote_arch_state *rsa = get_remote_arch_state ();
-  int i;
+  int num_regs = gdbarch_num_regs (get_regcache_arch (regcache));
+  struct packet_reg **regs;
+  int i, nregs = 0;
 
   set_general_thread (inferior_ptid);
 
@@ -5782,6 +6054,11 @@ remote_fetch_registers (struct target_ops *ops,
 
       gdb_assert (reg != NULL);
 
+      /* The stop reply didn't include this register; have the stub
+	 send it along for the next few stops.  */
+      if (reg->expedite >= 0)
+	reg->expedite = REMOTE_EXPEDITE_STOPS;
+
       /* If this register might be in the 'g' packet, try that first -
 	 we are likely to read more than one register.  If this is the
 	 first 'g' packet, we might be overly optimistic about its
@@ -5804,13 +6081,70 @@ remote_fetch_registers (struct target_ops *ops,
 
   fetch_registers_using_g (regcache);
 
-  for (i = 0; i < gdbarch_num_regs (get_regcache_arch (regcache)); i++)
+  regs = alloca (num_regs * sizeof (struct packet_reg *));
+  for (i = 0; i < num_regs; i++)
     if (!rsa->regs[i].in_g_packet)
-      if (!fetch_register_using_p (regcache, &rsa->regs[i]))
-	{
+      {
+	if (rsa->regs[i].pnum == -1)
 	  /* This register is not available.  */
 	  regcache_raw_supply (regcache, i, NULL);
+	else
+	  regs[nregs++] = &rsa->regs[i];
+      }
+
+  fetch_registers_not_in_g (regcache, regs, nregs);
+}
+
+/* Fetch the NREGS registers listed in REGNUMS ahead of their use, so
+   that registers outside the 'g' packet cost one round trip between
+   them instead of one each.  */
+
+static void
+remote_prefetch_registers (struct target_ops *ops, struct regcache *regcache,
+			   int nregs, const int *regnums)
+{
+  struct remote_arch_state *rsa = get_remote_arch_state ();
+  struct packet_reg **regs;
+  int i, want_g = 0, count = 0;
+
+  regs = alloca (nregs * sizeof (struct packet_reg *));
+  for (i = 0; i < nregs; i++)
+    {
+      struct packet_reg *reg = packet_reg_from_regnum (rsa, regnums[i]);
+
+      if (reg == NULL || reg->pnum == -1)
+	continue;
+      if (reg->in_g_packet)
+	want_g = 1;
+      else
+	regs[count++] = reg;
+    }
+
+  set_general_thread (inferior_ptid);
+
+  /* The first 'g' reply may reveal that some registers must be
+     fetched with 'p' after all.  */
+  if (want_g)
+    {
+      int j;
+
+      fetch_registers_using_g (regcache);
+      for (i = 0; i < nregs; i++)
+	{
+	  struct packet_reg *reg = packet_reg_from_regnum (rsa, regnums[i]);
+
+	  if (reg == NULL || reg->pnum == -1 || reg->in_g_packet)
+	    continue;
+	  for (j = 0; j < count; j++)
+	    if (regs[j] == reg)
+	      break;
+	  if (j == count)
+	    regs[count++] = reg;
 	}
+    }
+
+  if (count > 1)
+    fetch_registers_using_qFetchRegs (regcache, regs, count);
 }
 
 /* Prepare to store registers.  Since we may send them all (using a
@@ -6464,6 +6798,112 @@ remote_read_bytes (CORE_ADDR memaddr, gdb_byte *myaddr, int len)
   return origlen;
 }
 
+/* Read the COUNT memory regions in REGIONS using as few
+   'qReadMemRegions' packets as will fit in the remote packet size.
+   Return the number of regions, from the start of REGIONS, that were
+   read this way; the caller reads the others one at a time.  */
+
+static int
+remote_read_memory_regions (struct target_ops *ops,
+			    struct mem_region_read *regions, int count)
+{
+  struct remote_state *rs;
+  long max_size = get_memory_read_packet_size ();
+  int first, last;
+
+  if (remote_protocol_packets[PACKET_qReadMemRegions].support
+      == PACKET_DISABLE)
+    return 0;
+
+  /* If the remote target is connected but not running, memory comes
+     from a lower stratum.  */
+  if (!target_has_execution)
+    return 0;
+
+  set_general_thread (inferior_ptid);
+  rs = get_remote_state ();
+
+  for (first = 0; first < count; first = last)
+    {
+      char *p = rs->buf;
+      long reply_size = 0;
+
+      p += xsnprintf (p, max_size, "qReadMemRegions:");
+
+      /* Fill the request with as many regions as will fit, both in
+	 the request itself and in the stub's reply.  Each region
+	 costs two hex digits per byte plus a ';' separator in the
+	 reply, and at most two sixteen-digit numbers and two
+	 separators in the request.  */
+      for (last = first; last < count; last++)
+	{
+	  CORE_ADDR addr = remote_address_masked (regions[last].addr);
+	  long size = 2 * (long) regions[last].len + 1;
+
+	  if ((p - rs->buf) + 34 >= max_size || reply_size + size >= max_size)
+	    break;
+
+	  if (last > first)
+	    *p++ = ';';
+	  p += hexnumstr (p, (ULONGEST) addr);
+	  *p++ = ',';
+	  p += hexnumstr (p, (ULONGEST) regions[last].len);
+	  reply_size += size;
+	}
+      *p = '\0';
+
+      /* A region too large for a reply of its own is read with 'm'
+	 packets.  */
+      if (last == first)
+	break;
+
+      putpkt (rs->buf);
+      getpkt (&rs->buf, &rs->buf_size, 0);
+
+      switch (packet_ok (rs->buf,
+			 &remote_protocol_packets[PACKET_qReadMemRegions]))
+	{
+	case PACKET_OK:
+	  break;
+	case PACKET_UNKNOWN:
+	case PACKET_ERROR:
+	  return first;
+	}
+
+      /* The reply holds the contents of each region, in request
+	 order, separated by ';'.  A region that could not be read in
+	 full is an empty field.  */
+      p = rs->buf;
+      for (; first < last; first++)
+	{
+	  struct mem_region_read *r = &regions[first];
+	  char *end = p;
+
+	  while (*end != ';' && *end != '\0')
+	    end++;
+
+	  if (end == p)
+	    r->status = EIO;
+	  else if (end - p == 2 * r->len)
+	    {
+	      hex2bin (p, r->buf, r->len);
+	      r->status = 0;
+	    }
+	  else
+	    error (_("Remote 'qReadMemRegions' reply is malformed: %s"),
+		   rs->buf);
+
+	  p = end;
+	  if (*p == ';')
+	    p++;
+	  else if (first + 1 < last)
+	    error (_("Remote 'qReadMemRegions' reply is too short: %s"),
+		   rs->buf);
+	}
+    }
+
+  return first;
+}
 
 /* Remote notification handler.  */
 
@@ -10184,6 +10624,7 @@ Specify the serial device it is connected to\n\
   remote_ops.to_fetch_registers = remote_fetch_registers;
   remote_ops.to_store_registers = remote_store_registers;
   remote_ops.to_prepare_to_store = remote_prepare_to_store;
+  remote_ops.to_prefetch_registers = remote_prefetch_registers;
   remote_ops.deprecated_xfer_memory = remote_xfer_memory;
   remote_ops.to_files_info = remote_files_info;
   remote_ops.to_insert_breakpoint = remote_insert_breakpoint;
@@ -10206,6 +10647,7 @@ Specify the serial device it is connected to\n\
   remote_ops.to_get_ada_task_ptid = remote_get_ada_task_ptid;
   remote_ops.to_stop = remote_stop;
   remote_ops.to_xfer_partial = remote_xfer_partial;
+  remote_ops.to_read_memory_regions = remote_read_memory_regions;
   remote_ops.to_rcmd = remote_rcmd;
   remote_ops.to_log_command = serial_log_command;
   remote_ops.to_get_thread_local_address = remote_get_thread_local_address;
@@ -10600,6 +11042,16 @@ Specify a negative limit for unlimited."),
 			    NULL, NULL, /* FIXME: i18n: The maximum number of target hardware breakpoints is %s.  */
 			    &remote_set_cmdlist, &remote_show_cmdlist);
 
+  add_setshow_zinteger_cmd ("expedite-stack-size", no_class,
+			    &remote_expedite_stack_size, _("\
+Set the amount of stack memory the stub sends with every stop."), _("\
+Show the amount of stack memory the stub sends with every stop."), _("\
+When the stub supports it, GDB asks for this many bytes above the stack\n\
+pointer to be included in every stop reply, so that unwinding the\n\
+innermost frames doesn't need any further memory reads.  Zero disables."),
+			    NULL, NULL,
+			    &remote_set_cmdlist, &remote_show_cmdlist);
+
   add_setshow_integer_cmd ("remoteaddresssize", class_obscure,
 			   &remote_address_size, _("\
 Set the maximum size of the address (in bits) in a memory packet."), _("\
@@ -10738,6 +11190,15 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_qXfer_statictrace_read],
                          "qXfer:statictrace:read", "read-sdata-object", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qFetchRegs],
+			 "qFetchRegs", "fetch-register-list", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_QExpedite],
+			 "QExpedite", "stop-reply-expedite", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_qReadMemRegions],
+			 "qReadMemRegions", "read-memory-regions", 0);
+
   /* Keep the old ``set remote Z-packet ...'' working.  Each individual
      Z sub-packet has its own set and show commands, but users may
      have sets to this variable in their .gdbinit files (or in their
@@ -0,0 +1,323 @@
+/* Target-dependent code for GNU/Linux on RISC-V.
+
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "defs.h"
+#include "gdbarch.h"
+#include "osabi.h"
+#include "regcache.h"
+#include "symtab.h"
+#include "riscv-tdep.h"
+#include "solib-svr4.h"
+#include "glibc-tdep.h"
+#include "linux-tdep.h"
+
+#include "record.h"
+#include "linux-record.h"
+
+/* The system call number is passed in v0, the arguments in a0 to a5,
+   and the result is returned in v0.  */
+
+#define RISCV_LINUX_A0_REGNUM 18
+
+/* System calls handled here rather than by record_linux_system_call,
+   numbered as in the asm-generic interface.  */
+
+enum riscv_linux_syscall
+{
+  riscv_sys_rt_sigreturn = 139
+};
+
+/* The sizes of the types system calls use differ between RV32 and
+   RV64; keep a table for each.  */
+
+static struct linux_record_tdep riscv32_linux_record_tdep;
+static struct linux_record_tdep riscv64_linux_record_tdep;
+
+/* Record all the registers but the PC, which the caller records.  */
+
+static int
+riscv_linux_all_but_pc_registers_record (struct regcache *regcache)
+{
+  int i;
+
+  for (i = RISCV_ZERO_REGNUM + 1; i <= RISCV_FRM_REGNUM; i++)
+    if (i != RISCV_PC_REGNUM && record_arch_list_add_reg (regcache, i))
+      return -1;
+
+  return 0;
+}
+
+/* Record the side effects of the system call about to be executed by
+   an SCALL instruction.  */
+
+static int
+riscv_linux_syscall_record (struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+  struct linux_record_tdep *record_tdep;
+  int ret;
+  ULONGEST syscall_native;
+  int syscall_gdb;
+
+  regcache_raw_read_unsigned (regcache, RISCV_V0_REGNUM, &syscall_native);
+
+  if (syscall_native == riscv_sys_rt_sigreturn)
+    return riscv_linux_all_but_pc_registers_record (regcache);
+
+  syscall_gdb = record_linux_generic_syscall (syscall_native);
+  if (syscall_gdb < 0)
+    {
+      printf_unfiltered (_("Process record and replay target doesn't "
+                           "support syscall number %s\n"),
+			 pulongest (syscall_native));
+      return -1;
+    }
+
+  if (riscv_isa_regsize (gdbarch) == 4)
+    record_tdep = &riscv32_linux_record_tdep;
+  else
+    record_tdep = &riscv64_linux_record_tdep;
+
+  ret = record_linux_system_call (syscall_gdb, regcache, record_tdep);
+  if (ret)
+    return ret;
+
+  /* Record the return value of the system call.  */
+  if (record_arch_list_add_reg (regcache, RISCV_V0_REGNUM))
+    return -1;
+
+  return 0;
+}
+
+/* Fill RECORD_TDEP in for GDBARCH, RV32 or RV64.  */
+
+static void
+riscv_linux_init_record_tdep (struct linux_record_tdep *record_tdep,
+			      struct gdbarch *gdbarch)
+{
+  int rv32 = riscv_isa_regsize (gdbarch) == 4;
+
+  /* These values are the size of the type that will be used in a system
+     call.  They are obtained from Linux Kernel source, for the
+     asm-generic interface.  */
+  record_tdep->size_pointer
+    = gdbarch_ptr_bit (gdbarch) / TARGET_CHAR_BIT;
+  record_tdep->size__old_kernel_stat = 32;
+  record_tdep->size_tms = rv32 ? 16 : 32;
+  record_tdep->size_loff_t = 8;
+  record_tdep->size_flock = rv32 ? 16 : 32;
+  record_tdep->size_oldold_utsname = 45;
+  record_tdep->size_ustat = rv32 ? 20 : 32;
+  /* RISC-V doesn't need this size because it doesn't have sys_sigaction
+     but sys_rt_sigaction.  */
+  record_tdep->size_old_sigaction = rv32 ? 140 : 152;
+  /* RISC-V doesn't need this size because it doesn't have sys_sigpending
+     but sys_rt_sigpending.  */
+  record_tdep->size_old_sigset_t = 128;
+  record_tdep->size_rlimit = rv32 ? 8 : 16;
+  record_tdep->size_rusage = rv32 ? 72 : 144;
+  record_tdep->size_timeval = rv32 ? 8 : 16;
+  record_tdep->size_timezone = 8;
+  /* RISC-V doesn't need this size because it doesn't have sys_getgroups16
+     but sys_getgroups.  */
+  record_tdep->size_old_gid_t = 2;
+  /* RISC-V doesn't need this size because it doesn't have sys_getresuid16
+     but sys_getresuid.  */
+  record_tdep->size_old_uid_t = 2;
+  record_tdep->size_fd_set = 128;
+  record_tdep->size_dirent = rv32 ? 268 : 280;
+  record_tdep->size_dirent64 = rv32 ? 276 : 280;
+  record_tdep->size_statfs = rv32 ? 64 : 120;
+  record_tdep->size_statfs64 = rv32 ? 84 : 120;
+  record_tdep->size_sockaddr = 16;
+  record_tdep->size_int
+    = gdbarch_int_bit (gdbarch) / TARGET_CHAR_BIT;
+  record_tdep->size_long
+    = gdbarch_long_bit (gdbarch) / TARGET_CHAR_BIT;
+  record_tdep->size_ulong
+    = gdbarch_long_bit (gdbarch) / TARGET_CHAR_BIT;
+  record_tdep->size_msghdr = rv32 ? 28 : 56;
+  record_tdep->size_itimerval = rv32 ? 16 : 32;
+  record_tdep->size_stat = rv32 ? 72 : 128;
+  record_tdep->size_old_utsname = 325;
+  record_tdep->size_sysinfo = rv32 ? 64 : 112;
+  record_tdep->size_msqid_ds = rv32 ? 88 : 120;
+  record_tdep->size_shmid_ds = rv32 ? 84 : 112;
+  record_tdep->size_new_utsname = 390;
+  record_tdep->size_timex = rv32 ? 128 : 208;
+  record_tdep->size_mem_dqinfo = 24;
+  record_tdep->size_if_dqblk = rv32 ? 68 : 72;
+  record_tdep->size_fs_quota_stat = rv32 ? 68 : 80;
+  record_tdep->size_timespec = rv32 ? 8 : 16;
+  record_tdep->size_pollfd = 8;
+  record_tdep->size_NFS_FHSIZE = 32;
+  record_tdep->size_knfsd_fh = 132;
+  record_tdep->size_TASK_COMM_LEN = 16;
+  record_tdep->size_sigaction = rv32 ? 140 : 152;
+  record_tdep->size_sigset_t = 128;
+  record_tdep->size_siginfo_t = 128;
+  record_tdep->size_cap_user_data_t = 8;
+  record_tdep->size_stack_t = rv32 ? 12 : 24;
+  record_tdep->size_off_t = rv32 ? 4 : 8;
+  record_tdep->size_stat64 = rv32 ? 104 : 128;
+  record_tdep->size_gid_t = 4;
+  record_tdep->size_uid_t = 4;
+  record_tdep->size_PAGE_SIZE = 4096;
+  record_tdep->size_flock64 = rv32 ? 24 : 32;
+  record_tdep->size_user_desc = 16;
+  record_tdep->size_io_event = 32;
+  record_tdep->size_iocb = 64;
+  record_tdep->size_epoll_event = 16;
+  record_tdep->size_itimerspec = rv32 ? 16 : 32;
+  record_tdep->size_mq_attr = rv32 ? 32 : 64;
+  record_tdep->size_siginfo = 128;
+  record_tdep->size_termios = 60;
+  record_tdep->size_termios2 = 44;
+  record_tdep->size_pid_t = 4;
+  record_tdep->size_winsize = 8;
+  record_tdep->size_serial_struct = rv32 ? 60 : 72;
+  record_tdep->size_serial_icounter_struct = 80;
+  record_tdep->size_hayes_esp_config = 12;
+  record_tdep->size_size_t = rv32 ? 4 : 8;
+  record_tdep->size_iovec = rv32 ? 8 : 16;
+
+  /* These values are the second argument of system call "sys_ioctl".
+     They are obtained from Linux Kernel source.  */
+  record_tdep->ioctl_TCGETS = 0x5401;
+  record_tdep->ioctl_TCSETS = 0x5402;
+  record_tdep->ioctl_TCSETSW = 0x5403;
+  record_tdep->ioctl_TCSETSF = 0x5404;
+  record_tdep->ioctl_TCGETA = 0x5405;
+  record_tdep->ioctl_TCSETA = 0x5406;
+  record_tdep->ioctl_TCSETAW = 0x5407;
+  record_tdep->ioctl_TCSETAF = 0x5408;
+  record_tdep->ioctl_TCSBRK = 0x5409;
+  record_tdep->ioctl_TCXONC = 0x540A;
+  record_tdep->ioctl_TCFLSH = 0x540B;
+  record_tdep->ioctl_TIOCEXCL = 0x540C;
+  record_tdep->ioctl_TIOCNXCL = 0x540D;
+  record_tdep->ioctl_TIOCSCTTY = 0x540E;
+  record_tdep->ioctl_TIOCGPGRP = 0x540F;
+  record_tdep->ioctl_TIOCSPGRP = 0x5410;
+  record_tdep->ioctl_TIOCOUTQ = 0x5411;
+  record_tdep->ioctl_TIOCSTI = 0x5412;
+  record_tdep->ioctl_TIOCGWINSZ = 0x5413;
+  record_tdep->ioctl_TIOCSWINSZ = 0x5414;
+  record_tdep->ioctl_TIOCMGET = 0x5415;
+  record_tdep->ioctl_TIOCMBIS = 0x5416;
+  record_tdep->ioctl_TIOCMBIC = 0x5417;
+  record_tdep->ioctl_TIOCMSET = 0x5418;
+  record_tdep->ioctl_TIOCGSOFTCAR = 0x5419;
+  record_tdep->ioctl_TIOCSSOFTCAR = 0x541A;
+  record_tdep->ioctl_FIONREAD = 0x541B;
+  record_tdep->ioctl_TIOCINQ
+    = record_tdep->ioctl_FIONREAD;
+  record_tdep->ioctl_TIOCLINUX = 0x541C;
+  record_tdep->ioctl_TIOCCONS = 0x541D;
+  record_tdep->ioctl_TIOCGSERIAL = 0x541E;
+  record_tdep->ioctl_TIOCSSERIAL = 0x541F;
+  record_tdep->ioctl_TIOCPKT = 0x5420;
+  record_tdep->ioctl_FIONBIO = 0x5421;
+  record_tdep->ioctl_TIOCNOTTY = 0x5422;
+  record_tdep->ioctl_TIOCSETD = 0x5423;
+  record_tdep->ioctl_TIOCGETD = 0x5424;
+  record_tdep->ioctl_TCSBRKP = 0x5425;
+  record_tdep->ioctl_TIOCTTYGSTRUCT = 0x5426;
+  record_tdep->ioctl_TIOCSBRK = 0x5427;
+  record_tdep->ioctl_TIOCCBRK = 0x5428;
+  record_tdep->ioctl_TIOCGSID = 0x5429;
+  record_tdep->ioctl_TCGETS2 = 0x802c542a;
+  record_tdep->ioctl_TCSETS2 = 0x402c542b;
+  record_tdep->ioctl_TCSETSW2 = 0x402c542c;
+  record_tdep->ioctl_TCSETSF2 = 0x402c542d;
+  record_tdep->ioctl_TIOCGPTN = 0x80045430;
+  record_tdep->ioctl_TIOCSPTLCK = 0x40045431;
+  record_tdep->ioctl_FIONCLEX = 0x5450;
+  record_tdep->ioctl_FIOCLEX = 0x5451;
+  record_tdep->ioctl_FIOASYNC = 0x5452;
+  record_tdep->ioctl_TIOCSERCONFIG = 0x5453;
+  record_tdep->ioctl_TIOCSERGWILD = 0x5454;
+  record_tdep->ioctl_TIOCSERSWILD = 0x5455;
+  record_tdep->ioctl_TIOCGLCKTRMIOS = 0x5456;
+  record_tdep->ioctl_TIOCSLCKTRMIOS = 0x5457;
+  record_tdep->ioctl_TIOCSERGSTRUCT = 0x5458;
+  record_tdep->ioctl_TIOCSERGETLSR = 0x5459;
+  record_tdep->ioctl_TIOCSERGETMULTI = 0x545A;
+  record_tdep->ioctl_TIOCSERSETMULTI = 0x545B;
+  record_tdep->ioctl_TIOCMIWAIT = 0x545C;
+  record_tdep->ioctl_TIOCGICOUNT = 0x545D;
+  record_tdep->ioctl_TIOCGHAYESESP = 0x545E;
+  record_tdep->ioctl_TIOCSHAYESESP = 0x545F;
+  record_tdep->ioctl_FIOQSIZE = 0x5460;
+
+  /* These values are the second argument of system call "sys_fcntl"
+     and "sys_fcntl64".  They are obtained from Linux Kernel source.  */
+  record_tdep->fcntl_F_GETLK = 5;
+  record_tdep->fcntl_F_GETLK64 = 12;
+  record_tdep->fcntl_F_SETLK64 = 13;
+  record_tdep->fcntl_F_SETLKW64 = 14;
+
+  record_tdep->arg1 = RISCV_LINUX_A0_REGNUM;
+  record_tdep->arg2 = RISCV_LINUX_A0_REGNUM + 1;
+  record_tdep->arg3 = RISCV_LINUX_A0_REGNUM + 2;
+  record_tdep->arg4 = RISCV_LINUX_A0_REGNUM + 3;
+  record_tdep->arg5 = RISCV_LINUX_A0_REGNUM + 4;
+  record_tdep->arg6 = RISCV_LINUX_A0_REGNUM + 5;
+}
+
+static void
+riscv_linux_init_abi (struct gdbarch_info info, struct gdbarch *gdbarch)
+{
+  struct gdbarch_tdep *tdep = gdbarch_tdep (gdbarch);
+
+  if (riscv_isa_regsize (gdbarch) == 4)
+    {
+      riscv_linux_init_record_tdep (&riscv32_linux_record_tdep, gdbarch);
+      set_solib_svr4_fetch_link_map_offsets
+	(gdbarch, svr4_ilp32_fetch_link_map_offsets);
+    }
+  else
+    {
+      riscv_linux_init_record_tdep (&riscv64_linux_record_tdep, gdbarch);
+      set_solib_svr4_fetch_link_map_offsets
+	(gdbarch, svr4_lp64_fetch_link_map_offsets);
+    }
+
+  /* Shared library handling.  */
+  set_gdbarch_skip_trampoline_code (gdbarch, find_solib_trampoline_target);
+  set_gdbarch_skip_solib_resolver (gdbarch, glibc_skip_solib_resolver);
+
+  /* Enable TLS support.  */
+  set_gdbarch_fetch_tls_load_module_address (gdbarch,
+					     svr4_fetch_objfile_link_map);
+
+  set_gdbarch_get_siginfo_type (gdbarch, linux_get_siginfo_type);
+
+  tdep->riscv_syscall_record = riscv_linux_syscall_record;
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_riscv_linux_tdep;
+
+void
+_initialize_riscv_linux_tdep (void)
+{
+  gdbarch_register_osabi (bfd_arch_riscv, 0, GDB_OSABI_LINUX,
+			  riscv_linux_init_abi);
+}
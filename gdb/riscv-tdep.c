@@ -47,6 +47,7 @@
 #include "elf-bfd.h"
 #include "symcat.h"
 #include "sim-regno.h"
+#include "gdb/sim-riscv.h"
 #include "dis-asm.h"
 #include "frame-unwind.h"
 #include "frame-base.h"
@@ -59,6 +60,8 @@
 #include "user-regs.h"
 #include "valprint.h"
 #include "opcode/riscv-opc.h"
+#include "record.h"
+#include "exceptions.h"
 
 static const struct objfile_data *riscv_pdr_data;
 static struct cmd_list_element *setriscvcmdlist = NULL;
@@ -699,6 +702,22 @@ riscv_print_registers_info (struct gdbarch    *gdbarch,
     fprintf_filtered (file, "\n");
   }
   else {
+    volatile struct gdb_exception ex;
+    int regnums[RISCV_LAST_REGNUM];
+    int nregs = 0;
+
+    /* Fetch everything we are about to print in one go; on remote
+       targets this saves a round trip per CSR.  */
+    for (regnum = 0; regnum < RISCV_LAST_REGNUM; regnum++) {
+      if (all || TYPE_CODE (register_type (gdbarch, regnum)) != TYPE_CODE_FLT)
+	regnums[nregs++] = regnum;
+    }
+    // This is only an optimization; any error is reported when the
+    // register is printed.
+    TRY_CATCH (ex, RETURN_MASK_ERROR) {
+      regcache_raw_prefetch (get_current_regcache (), nregs, regnums);
+    }
+
     regnum = 0;
     while(regnum < RISCV_LAST_REGNUM) {
       if ('\0' == *(riscv_register_name (gdbarch, regnum))) {
@@ -715,6 +734,38 @@ riscv_print_registers_info (struct gdbarch    *gdbarch,
   }
 }
 
+/* Map GDB register number REGNUM to the simulator's numbering.  */
+
+static int
+riscv_register_sim_regno (struct gdbarch *gdbarch, int regnum)
+{
+  if (regnum >= RISCV_ZERO_REGNUM && regnum <= RISCV_GP_REGNUM)
+    return sim_riscv_x0_regnum + regnum;
+  if (regnum >= RISCV_FIRST_FP_REGNUM && regnum <= RISCV_LAST_FP_REGNUM)
+    return sim_riscv_f0_regnum + (regnum - RISCV_FIRST_FP_REGNUM);
+
+  switch (regnum)
+    {
+    case RISCV_PC_REGNUM:
+      return sim_riscv_pc_regnum;
+    case RISCV_FCSR_REGNUM:
+      return sim_riscv_fcsr_regnum;
+    case RISCV_FFLAGS_REGNUM:
+      return sim_riscv_fflags_regnum;
+    case RISCV_FRM_REGNUM:
+      return sim_riscv_frm_regnum;
+    case RISCV_CYCLE_REGNUM:
+      return sim_riscv_cycle_regnum;
+    case RISCV_TIME_REGNUM:
+      return sim_riscv_time_regnum;
+    case RISCV_INSTRET_REGNUM:
+      return sim_riscv_instret_regnum;
+    }
+
+  /* The simulator has no supervisor state.  */
+  return SIM_REGNO_DOES_NOT_EXIST;
+}
+
 static int
 riscv_register_reggroup_p (struct gdbarch  *gdbarch,
 			   int              regnum,
@@ -1025,6 +1076,340 @@ static const struct frame_unwind riscv_frame_unwind = {
 };
 
 
+// Process record and replay.  Each instruction is decoded into the
+// registers it writes and the memory it stores to, which is all that
+// record needs to know about it.  Since the same instructions are
+// recorded over and over again when stepping through loops, the
+// decoded form is kept in a small direct-mapped cache indexed by PC.
+// An entry is only used if the instruction found at PC is still the
+// one that was decoded, so that breakpoints and self-modifying code do
+// not need any special handling.
+
+#define RISCV_RECORD_CACHE_SIZE 4096
+
+struct riscv_record_insn
+{
+  CORE_ADDR pc;
+  ULONGEST insn;
+
+  // Non-zero if this entry holds a decoded instruction
+  unsigned char valid;
+
+  // Non-zero for SCALL, whose effects depend on the system call
+  unsigned char syscall;
+
+  // The registers written, besides the PC
+  unsigned char nregs;
+  unsigned char regs[4];
+
+  // The memory stored to is MEM_LEN bytes at register MEM_BASE plus
+  // MEM_OFFSET; MEM_BASE is -1 if the instruction does not store
+  signed char mem_base;
+  unsigned char mem_len;
+  LONGEST mem_offset;
+};
+
+static void
+riscv_record_reg (struct riscv_record_insn *r, int regnum)
+{
+  // Writes to x0 are discarded
+  if (regnum == RISCV_ZERO_REGNUM)
+    return;
+  gdb_assert (r->nregs < ARRAY_SIZE (r->regs));
+  r->regs[r->nregs++] = regnum;
+}
+
+static void
+riscv_record_fpu_flags (struct riscv_record_insn *r)
+{
+  riscv_record_reg (r, RISCV_FFLAGS_REGNUM);
+  riscv_record_reg (r, RISCV_FCSR_REGNUM);
+}
+
+static void
+riscv_record_mem (struct riscv_record_insn *r, int base, LONGEST offset, int len)
+{
+  r->mem_base = base;
+  r->mem_offset = offset;
+  r->mem_len = len;
+}
+
+// Decode INSN, a 32-bit instruction of RV32G or RV64G, into R.
+// Return 0 on success, or -1 if the instruction is not supported.
+
+static int
+riscv_record_decode (struct gdbarch *gdbarch, ULONGEST insn,
+		     struct riscv_record_insn *r)
+{
+  int opcode = insn & 0x7f;
+  int rd = (insn >> 7) & 0x1f;
+  int funct3 = (insn >> 12) & 0x7;
+  int rs1 = (insn >> 15) & 0x1f;
+  int funct7 = (insn >> 25) & 0x7f;
+  int csr;
+  LONGEST imm;
+
+  switch (opcode) {
+    case 0x03:			// LOAD
+    case 0x13:			// OP-IMM
+    case 0x17:			// AUIPC
+    case 0x1b:			// OP-IMM-32
+    case 0x33:			// OP
+    case 0x37:			// LUI
+    case 0x3b:			// OP-32
+    case 0x67:			// JALR
+    case 0x6f:			// JAL
+      riscv_record_reg (r, rd);
+      return 0;
+
+    case 0x07:			// LOAD-FP
+      riscv_record_reg (r, RISCV_FIRST_FP_REGNUM + rd);
+      return 0;
+
+    case 0x0f:			// MISC-MEM
+    case 0x63:			// BRANCH
+      return 0;
+
+    case 0x23:			// STORE
+    case 0x27:			// STORE-FP
+      if (opcode == 0x23 ? funct3 > 3 : funct3 != 2 && funct3 != 3)
+	return -1;
+      imm = ((insn >> 25) << 5) | ((insn >> 7) & 0x1f);
+      if (imm & 0x800)
+	imm -= 0x1000;
+      riscv_record_mem (r, rs1, imm, 1 << funct3);
+      return 0;
+
+    case 0x2f:			// AMO
+      if (funct3 != 2 && funct3 != 3)
+	return -1;
+      riscv_record_reg (r, rd);
+      if ((insn >> 27) != 2)	// all but LR store to memory
+	riscv_record_mem (r, rs1, 0, 1 << funct3);
+      return 0;
+
+    case 0x43:			// MADD
+    case 0x47:			// MSUB
+    case 0x4b:			// NMSUB
+    case 0x4f:			// NMADD
+      riscv_record_reg (r, RISCV_FIRST_FP_REGNUM + rd);
+      riscv_record_fpu_flags (r);
+      return 0;
+
+    case 0x53:			// OP-FP
+      switch (funct7) {
+	case 0x50: case 0x51:	// feq, flt, fle
+	case 0x60: case 0x61:	// fcvt to integer
+	  riscv_record_reg (r, rd);
+	  riscv_record_fpu_flags (r);
+	  return 0;
+	case 0x70: case 0x71:	// fmv to integer, fclass
+	  riscv_record_reg (r, rd);
+	  return 0;
+	case 0x10: case 0x11:	// fsgnj, fsgnjn, fsgnjx
+	case 0x78: case 0x79:	// fmv from integer
+	  riscv_record_reg (r, RISCV_FIRST_FP_REGNUM + rd);
+	  return 0;
+	default:
+	  riscv_record_reg (r, RISCV_FIRST_FP_REGNUM + rd);
+	  riscv_record_fpu_flags (r);
+	  return 0;
+      }
+
+    case 0x73:			// SYSTEM
+      if (insn == MATCH_SCALL) {
+	r->syscall = 1;
+	return 0;
+      }
+      if (insn == MATCH_SBREAK)
+	return 0;
+      if ((funct3 & 0x3) == 0)
+	return -1;
+      riscv_record_reg (r, rd);
+      // csrrw and csrrwi always write the CSR, the others only with a
+      // non-zero source
+      if ((funct3 & 0x3) == 1 || rs1 != 0) {
+	csr = insn >> 20;
+	if (csr != CSR_FFLAGS && csr != CSR_FRM && csr != CSR_FCSR)
+	  return -1;
+	riscv_record_reg (r, RISCV_FFLAGS_REGNUM);
+	riscv_record_reg (r, RISCV_FRM_REGNUM);
+	riscv_record_reg (r, RISCV_FCSR_REGNUM);
+      }
+      return 0;
+  }
+
+  return -1;
+}
+
+// Decode INSN, a 16-bit compressed instruction, into R.  This follows
+// the draft RVC encoding of opcode/riscv-opc.h, where the 3-bit
+// register fields name the registers of rvc_rs1_regmap and friends.
+// Return 0 on success, or -1 if the instruction is not supported.
+
+#define RVC_IS_INSN(x, op) (((x) & MASK_##op) == MATCH_##op)
+#define RVC_OPERAND(x, op) (((x) >> OP_SH_##op) & OP_MASK_##op)
+
+static int
+riscv_record_decode_rvc (struct gdbarch *gdbarch, ULONGEST insn,
+			 struct riscv_record_insn *r)
+{
+  int crd = RVC_OPERAND (insn, CRD);
+  int crds = rvc_rd_regmap[RVC_OPERAND (insn, CRDS)];
+  int crs1s = rvc_rs1_regmap[RVC_OPERAND (insn, CRS1S)];
+  LONGEST imm6 = RVC_OPERAND (insn, CIMM6);
+  LONGEST imm5 = RVC_OPERAND (insn, CIMM5);
+
+  if (imm6 & 0x20)
+    imm6 -= 0x40;
+  if (imm5 & 0x10)
+    imm5 -= 0x20;
+
+  // c.addi with a zero destination is c.jalr, which links if the
+  // immediate is negative
+  if (RVC_IS_INSN (insn, C_ADDI)) {
+    if (crd != 0)
+      riscv_record_reg (r, crd);
+    else if (imm6 < 0)
+      riscv_record_reg (r, RISCV_RA_REGNUM);
+    return 0;
+  }
+
+  if (RVC_IS_INSN (insn, C_ADDIW) || RVC_IS_INSN (insn, C_LI)
+      || RVC_IS_INSN (insn, C_MOVE) || RVC_IS_INSN (insn, C_ADD)
+      || RVC_IS_INSN (insn, C_SUB) || RVC_IS_INSN (insn, C_LDSP)
+      || RVC_IS_INSN (insn, C_LWSP) || RVC_IS_INSN (insn, C_LD0)
+      || RVC_IS_INSN (insn, C_LW0)) {
+    riscv_record_reg (r, crd);
+    return 0;
+  }
+
+  if (RVC_IS_INSN (insn, C_SLLI) || RVC_IS_INSN (insn, C_SLLI32)
+      || RVC_IS_INSN (insn, C_SRLI) || RVC_IS_INSN (insn, C_SRLI32)
+      || RVC_IS_INSN (insn, C_SRAI) || RVC_IS_INSN (insn, C_SRAI32)
+      || RVC_IS_INSN (insn, C_SLLIW) || RVC_IS_INSN (insn, C_ADD3)
+      || RVC_IS_INSN (insn, C_SUB3) || RVC_IS_INSN (insn, C_AND3)
+      || RVC_IS_INSN (insn, C_OR3) || RVC_IS_INSN (insn, C_LD)
+      || RVC_IS_INSN (insn, C_LW)) {
+    riscv_record_reg (r, crds);
+    return 0;
+  }
+
+  if (RVC_IS_INSN (insn, C_FLD) || RVC_IS_INSN (insn, C_FLW)) {
+    riscv_record_reg (r, RISCV_FIRST_FP_REGNUM + crds);
+    return 0;
+  }
+
+  // c.j does not link
+  if (RVC_IS_INSN (insn, C_J) || RVC_IS_INSN (insn, C_BEQ)
+      || RVC_IS_INSN (insn, C_BNE))
+    return 0;
+
+  if (RVC_IS_INSN (insn, C_SDSP)) {
+    riscv_record_mem (r, RISCV_SP_REGNUM, imm6 * 8, 8);
+    return 0;
+  }
+  if (RVC_IS_INSN (insn, C_SWSP)) {
+    riscv_record_mem (r, RISCV_SP_REGNUM, imm6 * 4, 4);
+    return 0;
+  }
+  if (RVC_IS_INSN (insn, C_SD) || RVC_IS_INSN (insn, C_FSD)) {
+    riscv_record_mem (r, crs1s, imm5 * 8, 8);
+    return 0;
+  }
+  if (RVC_IS_INSN (insn, C_SW) || RVC_IS_INSN (insn, C_FSW)) {
+    riscv_record_mem (r, crs1s, imm5 * 4, 4);
+    return 0;
+  }
+
+  return -1;
+}
+
+#undef RVC_IS_INSN
+#undef RVC_OPERAND
+
+// Record the registers and memory the instruction at ADDR will change,
+// for process record and replay.  Return 0 on success, -1 if the
+// instruction cannot be recorded.
+
+static int
+riscv_process_record (struct gdbarch *gdbarch, struct regcache *regcache,
+		      CORE_ADDR addr)
+{
+  struct gdbarch_tdep *tdep = gdbarch_tdep (gdbarch);
+  enum bfd_endian byte_order = gdbarch_byte_order_for_code (gdbarch);
+  struct riscv_record_insn *r;
+  gdb_byte buf[4];
+  ULONGEST insn;
+  int len = 2;
+  int i;
+
+  if (record_debug > 1)
+    fprintf_unfiltered (gdb_stdlog, "Process record: riscv_process_record "
+			"addr = %s\n", paddress (gdbarch, addr));
+
+  if (target_read_memory (addr, buf, 2) != 0
+      || ((buf[byte_order == BFD_ENDIAN_BIG ? 1 : 0] & 0x3) == 0x3
+	  && target_read_memory (addr, buf, len = 4) != 0)) {
+    if (record_debug)
+      printf_unfiltered (_("Process record: error reading memory at "
+			   "addr %s len = %d.\n"),
+			 paddress (gdbarch, addr), len);
+    return -1;
+  }
+  insn = extract_unsigned_integer (buf, len, byte_order);
+
+  if (tdep->record_cache == NULL)
+    tdep->record_cache = xcalloc (RISCV_RECORD_CACHE_SIZE,
+				  sizeof (struct riscv_record_insn));
+  r = &tdep->record_cache[(addr >> 1) & (RISCV_RECORD_CACHE_SIZE - 1)];
+
+  if (!r->valid || r->pc != addr || r->insn != insn) {
+    memset (r, 0, sizeof (*r));
+    r->mem_base = -1;
+    if ((len == 2
+	 ? riscv_record_decode_rvc (gdbarch, insn, r)
+	 : riscv_record_decode (gdbarch, insn, r)) != 0) {
+      printf_unfiltered (_("Process record does not support instruction "
+			   "0x%s at address %s.\n"),
+			 phex_nz (insn, len), paddress (gdbarch, addr));
+      return -1;
+    }
+    r->pc = addr;
+    r->insn = insn;
+    r->valid = 1;
+  }
+
+  for (i = 0; i < r->nregs; i++)
+    if (record_arch_list_add_reg (regcache, r->regs[i]))
+      return -1;
+
+  if (r->mem_base >= 0) {
+    ULONGEST base;
+
+    regcache_raw_read_unsigned (regcache, r->mem_base, &base);
+    if (record_arch_list_add_mem (base + r->mem_offset, r->mem_len))
+      return -1;
+  }
+
+  if (r->syscall) {
+    if (tdep->riscv_syscall_record == NULL) {
+      printf_unfiltered (_("Process record doesn't support instruction "
+			   "scall.\n"));
+      return -1;
+    }
+    if (tdep->riscv_syscall_record (regcache))
+      return -1;
+  }
+
+  if (record_arch_list_add_reg (regcache, RISCV_PC_REGNUM))
+    return -1;
+  if (record_arch_list_add_end ())
+    return -1;
+
+  return 0;
+}
+
 static struct gdbarch *
 riscv_gdbarch_init (struct gdbarch_info  info, 
 		    struct gdbarch_list *arches)
@@ -1048,7 +1433,7 @@ riscv_gdbarch_init (struct gdbarch_info  info,
   // we actually know which target we are talking to, but put in some defaults for now.
 
   binfo                     = info.bfd_arch_info;
-  tdep                      = xmalloc (sizeof *tdep);
+  tdep                      = xcalloc (1, sizeof *tdep);
   gdbarch                   = gdbarch_alloc (&info, tdep);
   tdep->riscv_abi           = 0;
   tdep->register_size_valid = 0;
@@ -1107,6 +1492,7 @@ riscv_gdbarch_init (struct gdbarch_info  info,
   set_gdbarch_register_type         (gdbarch, riscv_register_type);
   set_gdbarch_print_registers_info  (gdbarch, riscv_print_registers_info);
   set_gdbarch_register_reggroup_p   (gdbarch, riscv_register_reggroup_p);
+  set_gdbarch_register_sim_regno    (gdbarch, riscv_register_sim_regno);
 
   // functions to analyze frames
   set_gdbarch_skip_prologue         (gdbarch, riscv_skip_prologue); 
@@ -1128,6 +1514,12 @@ riscv_gdbarch_init (struct gdbarch_info  info,
   dwarf2_append_unwinders           (gdbarch);
   frame_unwind_append_unwinder      (gdbarch, &riscv_frame_unwind);
 
+  // process record and replay
+  set_gdbarch_process_record        (gdbarch, riscv_process_record);
+
+  // hook in OS ABI-specific overrides, if they have been registered
+  gdbarch_init_osabi (info, gdbarch);
+
   // check any target description for validity
   if (tdesc_has_registers (info.target_desc)) {
     const struct tdesc_feature *feature;
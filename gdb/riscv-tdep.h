@@ -118,6 +118,13 @@ struct gdbarch_tdep
 
   // Return the expected next PC if FRAME is stopped at a SCALL instruction
   CORE_ADDR (*scall_next_pc) (struct frame_info *frame);
+
+  // Record the side effects of the system call about to be executed
+  // by an SCALL instruction, for process record and replay
+  int (*riscv_syscall_record) (struct regcache *regcache);
+
+  // Instructions decoded by riscv_process_record, indexed by PC
+  struct riscv_record_insn *record_cache;
 };
 
 
@@ -963,6 +963,7 @@ vmap_exec (void)
 	  table->sections[i].endaddr += vmap->dstart - vmap->dvma;
 	}
     }
+  clear_section_table_index (table);
 }
 
 /* Set the current architecture from the host running GDB.  Called when
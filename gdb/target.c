@@ -44,6 +44,8 @@
 #include "exec.h"
 #include "inline-frame.h"
 #include "tracepoint.h"
+#include "observer.h"
+#include "search-buffer.h"
 
 static void target_info (char *, int);
 
@@ -245,11 +247,27 @@ set_stack_cache_enabled_p (char *args, int from_tty,
 			   struct cmd_list_element *c)
 {
   if (stack_cache_enabled_p != stack_cache_enabled_p_1)
-    target_dcache_invalidate ();
+    {
+      target_dcache_flush ();
+      target_dcache_invalidate ();
+    }
 
   stack_cache_enabled_p = stack_cache_enabled_p_1;
 }
 
+/* Nonzero while memory writes are stack writes; see
+   target_begin_stack_writes.  */
+static int stack_writes_p = 0;
+
+struct cleanup *
+target_begin_stack_writes (void)
+{
+  struct cleanup *old_chain = make_cleanup_restore_integer (&stack_writes_p);
+
+  stack_writes_p = 1;
+  return old_chain;
+}
+
 static void
 show_stack_cache_enabled_p (struct ui_file *file, int from_tty,
 			    struct cmd_list_element *c, const char *value)
@@ -257,17 +275,98 @@ show_stack_cache_enabled_p (struct ui_file *file, int from_tty,
   fprintf_filtered (file, _("Cache use for stack accesses is %s.\n"), value);
 }
 
+/* The option sets this.  */
+static int code_cache_enabled_p_1 = 0;
+/* And set_code_cache_enabled_p updates this, like for the stack
+   cache above.  */
+static int code_cache_enabled_p = 0;
+
+/* This is called *after* the code-cache has been set.  Code that was
+   cached while the option was on may be stale by the time it is turned
+   on again, so flush the cache for both transitions.  */
+
+static void
+set_code_cache_enabled_p (char *args, int from_tty,
+			  struct cmd_list_element *c)
+{
+  if (code_cache_enabled_p != code_cache_enabled_p_1)
+    {
+      target_dcache_flush ();
+      target_dcache_invalidate ();
+    }
+
+  code_cache_enabled_p = code_cache_enabled_p_1;
+}
+
+static void
+show_code_cache_enabled_p (struct ui_file *file, int from_tty,
+			   struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Cache use for code accesses is %s.\n"), value);
+}
+
 /* Cache of memory operations, to speed up remote access.  */
 static DCACHE *target_dcache;
 
-/* Invalidate the target dcache.  */
+/* Invalidate the target dcache.  This is used on paths that must not
+   fail, such as closing a target, so memory writes the dcache deferred
+   are written back if possible but a failure is only reported.
+   Callers that can't afford to lose them call target_dcache_flush
+   first.  */
 
 void
 target_dcache_invalidate (void)
 {
+  volatile struct gdb_exception ex;
+
+  TRY_CATCH (ex, RETURN_MASK_ERROR)
+    {
+      dcache_flush (target_dcache);
+    }
+  if (ex.reason < 0)
+    exception_fprintf (gdb_stderr, ex,
+		       _("Discarding deferred memory writes: "));
+
   dcache_invalidate (target_dcache);
 }
 
+/* Write back the memory writes the target dcache deferred.  */
+
+void
+target_dcache_flush (void)
+{
+  dcache_flush (target_dcache);
+}
+
+/* Write back the memory writes the target dcache deferred, and
+   discard what the inferior may change while it runs.  Read-only
+   memory and code stay cached.  */
+
+void
+target_dcache_invalidate_volatile (void)
+{
+  dcache_flush (target_dcache);
+  dcache_invalidate_volatile (target_dcache);
+}
+
+/* The inferior_exit observer: writes deferred by the dcache can't be
+   done anymore.  */
+
+static void
+target_dcache_inferior_exit (struct inferior *inf)
+{
+  dcache_discard_pid (target_dcache, inf->pid);
+}
+
+void
+target_dcache_fill (ptid_t ptid, CORE_ADDR memaddr,
+		    const gdb_byte *myaddr, int len)
+{
+  /* Only stack accesses would look at it.  */
+  if (stack_cache_enabled_p)
+    dcache_fill (target_dcache, ptid, memaddr, myaddr, len);
+}
+
 /* The user just typed 'target' without the name of a target.  */
 
 static void
@@ -469,6 +568,7 @@ target_kill (void)
 void
 target_load (char *arg, int from_tty)
 {
+  target_dcache_flush ();
   target_dcache_invalidate ();
   (*current_target.to_load) (arg, from_tty);
 }
@@ -597,6 +697,7 @@ update_current_target (void)
       /* Do not inherit to_fetch_registers.  */
       /* Do not inherit to_store_registers.  */
       INHERIT (to_prepare_to_store, t);
+      /* Do not inherit to_prefetch_registers.  */
       INHERIT (deprecated_xfer_memory, t);
       INHERIT (to_files_info, t);
       INHERIT (to_insert_breakpoint, t);
@@ -643,6 +744,7 @@ update_current_target (void)
       INHERIT (to_extra_thread_info, t);
       INHERIT (to_stop, t);
       /* Do not inherit to_xfer_partial.  */
+      /* Do not inherit to_read_memory_regions.  */
       INHERIT (to_rcmd, t);
       INHERIT (to_pid_to_exec_file, t);
       INHERIT (to_log_command, t);
@@ -663,6 +765,7 @@ update_current_target (void)
       INHERIT (to_goto_bookmark, t);
       /* Do not inherit to_get_thread_local_address.  */
       INHERIT (to_can_execute_reverse, t);
+      INHERIT (to_prepare_to_resume_reverse, t);
       INHERIT (to_thread_architecture, t);
       /* Do not inherit to_read_description.  */
       INHERIT (to_get_ada_task_ptid, t);
@@ -835,6 +938,9 @@ update_current_target (void)
   de_fault (to_get_ada_task_ptid,
             (ptid_t (*) (long, long))
             default_get_ada_task_ptid);
+  de_fault (to_prepare_to_resume_reverse,
+	    (void (*) (int))
+	    target_ignore);
   de_fault (to_supports_multi_process,
 	    (int (*) (void))
 	    return_zero);
@@ -1231,17 +1337,34 @@ struct target_section *
 target_section_by_addr (struct target_ops *target, CORE_ADDR addr)
 {
   struct target_section_table *table = target_get_section_table (target);
-  struct target_section *secp;
 
   if (table == NULL)
     return NULL;
 
-  for (secp = table->sections; secp < table->sections_end; secp++)
-    {
-      if (addr >= secp->addr && addr < secp->endaddr)
-	return secp;
-    }
-  return NULL;
+  return section_table_lookup (table, addr, NULL);
+}
+
+/* Return nonzero if the code cache is enabled and the LEN bytes at
+   MEMADDR all lie within a read-only code section of the current
+   target.  The program isn't expected to modify such memory, so the
+   dcache may keep it across resumes; GDB's own writes, such as
+   breakpoint insertions, keep the cache up to date.  */
+
+int
+target_cached_code_p (CORE_ADDR memaddr, LONGEST len)
+{
+  struct target_section *secp;
+  flagword flags;
+
+  if (!code_cache_enabled_p)
+    return 0;
+
+  secp = target_section_by_addr (&current_target, memaddr);
+  if (secp == NULL || memaddr + len > secp->endaddr)
+    return 0;
+
+  flags = bfd_get_section_flags (secp->bfd, secp->the_bfd_section);
+  return (flags & (SEC_CODE | SEC_READONLY)) == (SEC_CODE | SEC_READONLY);
 }
 
 /* Perform a partial memory transfer.
@@ -1276,9 +1399,7 @@ memory_xfer_partial (struct target_ops *ops, enum target_object object,
 	  memaddr = overlay_mapped_address (memaddr, section);
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len,
-						    table->sections,
-						    table->sections_end,
-						    section_name);
+						    table, section_name);
 	}
     }
 
@@ -1296,9 +1417,7 @@ memory_xfer_partial (struct target_ops *ops, enum target_object object,
 	  table = target_get_section_table (ops);
 	  return section_table_xfer_memory_partial (readbuf, writebuf,
 						    memaddr, len,
-						    table->sections,
-						    table->sections_end,
-						    NULL);
+						    table, NULL);
 	}
     }
 
@@ -1343,7 +1462,12 @@ memory_xfer_partial (struct target_ops *ops, enum target_object object,
 	 the collected memory range fails.  */
       && get_traceframe_number () == -1
       && (region->attrib.cache
-	  || (stack_cache_enabled_p && object == TARGET_OBJECT_STACK_MEMORY)))
+	  || (stack_cache_enabled_p
+	      && (object == TARGET_OBJECT_STACK_MEMORY
+		  || (writebuf != NULL && stack_writes_p))
+	      && !region->attrib.nocache)
+	  || (readbuf != NULL && !region->attrib.nocache
+	      && target_cached_code_p (memaddr, 1))))
     {
       if (readbuf != NULL)
 	res = dcache_xfer_memory (ops, target_dcache, memaddr, readbuf,
@@ -1373,7 +1497,12 @@ memory_xfer_partial (struct target_ops *ops, enum target_object object,
      object which can be read from more than one valid target.
      A core file, for instance, could have some of memory but
      delegate other bits to the target below it.  So, we must
-     manually try all targets.  */
+     manually try all targets.
+
+     Anything the dcache holds back here must reach the target
+     first.  */
+
+  dcache_flush_range (target_dcache, memaddr, reg_len);
 
   do
     {
@@ -1395,14 +1524,14 @@ memory_xfer_partial (struct target_ops *ops, enum target_object object,
     breakpoint_restore_shadows (readbuf, memaddr, reg_len);
 
   /* Make sure the cache gets updated no matter what - if we are writing
-     to the stack.  Even if this write is not tagged as such, we still need
-     to update the cache.  */
+     to the stack or to code.  Even if this write is not tagged as such,
+     we still need to update the cache.  */
 
   if (res > 0
       && inf != NULL
       && writebuf != NULL
       && !region->attrib.cache
-      && stack_cache_enabled_p
+      && (stack_cache_enabled_p || code_cache_enabled_p)
       && object != TARGET_OBJECT_STACK_MEMORY)
     {
       dcache_update (target_dcache, memaddr, (void *) writebuf, res);
@@ -1549,6 +1678,39 @@ target_read_stack (CORE_ADDR memaddr, gdb_byte *myaddr, int len)
     return EIO;
 }
 
+/* See target.h.  */
+
+void
+target_read_memory_regions (struct mem_region_read *regions, int count)
+{
+  struct target_ops *t;
+  int i = 0;
+
+  /* Only ask the target that would service the individual reads; a
+     stratum above it that handles memory itself (e.g., a replay log)
+     must see them one at a time.  Targets that leave memory to the
+     ones beneath them use default_xfer_partial.  */
+  for (t = current_target.beneath; t != NULL; t = t->beneath)
+    {
+      if (t->to_read_memory_regions != NULL)
+	{
+	  if (targetdebug)
+	    fprintf_unfiltered (gdb_stdlog,
+				"target_read_memory_regions (%d)\n", count);
+	  i = t->to_read_memory_regions (t, regions, count);
+	  break;
+	}
+      if (t->to_xfer_partial != default_xfer_partial)
+	break;
+    }
+
+  for (; i < count; i++)
+    regions[i].status
+      = (target_read (&current_target, TARGET_OBJECT_RAW_MEMORY, NULL,
+		      regions[i].buf, regions[i].addr, regions[i].len)
+	 == regions[i].len ? 0 : EIO);
+}
+
 /* Write LEN bytes from MYADDR to target memory at address MEMADDR.
    Returns either 0 for success or an errno value if any error occurs.
    If an error occurs, no guarantee is made about how much data got written.
@@ -2088,6 +2250,10 @@ target_pre_inferior (int from_tty)
      Cannot access memory at address 0xdeadbeef
   */
 
+  /* Whatever the dcache holds, including code it would otherwise keep,
+     is from the previous inferior.  */
+  dcache_invalidate (target_dcache);
+
   /* In some OSs, the shared library list is the same/global/shared
      across inferiors.  If code is shared between processes, so are
      memory regions and features.  */
@@ -2167,6 +2333,8 @@ target_detach (char *args, int from_tty)
        them before detaching.  */
     remove_breakpoints_pid (PIDGET (inferior_ptid));
 
+  target_dcache_flush ();
+
   prepare_for_detach ();
 
   for (t = current_target.beneath; t != NULL; t = t->beneath)
@@ -2256,7 +2424,9 @@ target_resume (ptid_t ptid, int step, enum target_signal signal)
 {
   struct target_ops *t;
 
-  target_dcache_invalidate ();
+  /* Read-only memory that is cached stays valid while the inferior
+     runs.  */
+  target_dcache_invalidate_volatile ();
 
   for (t = current_target.beneath; t != NULL; t = t->beneath)
     {
@@ -2363,9 +2533,7 @@ simple_search_memory (struct target_ops *ops,
 		      const gdb_byte *pattern, ULONGEST pattern_len,
 		      CORE_ADDR *found_addrp)
 {
-  /* NOTE: also defined in find.c testcase.  */
-#define SEARCH_CHUNK_SIZE 16000
-  const unsigned chunk_size = SEARCH_CHUNK_SIZE;
+  unsigned chunk_size = SEARCH_CHUNK_SIZE;
   /* Buffer to hold memory contents for searching.  */
   gdb_byte *search_buf;
   unsigned search_buf_size;
@@ -2404,8 +2572,8 @@ simple_search_memory (struct target_ops *ops,
       gdb_byte *found_ptr;
       unsigned nr_search_bytes = min (search_space_len, search_buf_size);
 
-      found_ptr = memmem (search_buf, nr_search_bytes,
-			  pattern, pattern_len);
+      found_ptr = search_buffer (search_buf, nr_search_bytes,
+				 pattern, pattern_len);
 
       if (found_ptr != NULL)
 	{
@@ -2434,6 +2602,20 @@ simple_search_memory (struct target_ops *ops,
 	     of the buffer for the next iteration.  */
 	  gdb_assert (keep_len == pattern_len - 1);
 	  memcpy (search_buf, search_buf + chunk_size, keep_len);
+	  start_addr += chunk_size;
+
+	  if (chunk_size < SEARCH_MAX_CHUNK_SIZE
+	      && search_space_len - keep_len > chunk_size)
+	    {
+	      gdb_byte *new_buf;
+
+	      chunk_size = min (2 * chunk_size, SEARCH_MAX_CHUNK_SIZE);
+	      search_buf_size = chunk_size + keep_len;
+	      new_buf = realloc (search_buf, search_buf_size);
+	      if (new_buf == NULL)
+		error (_("Unable to allocate memory to perform the search."));
+	      search_buf = new_buf;
+	    }
 
 	  nr_to_read = min (search_space_len - keep_len, chunk_size);
 
@@ -2446,8 +2628,6 @@ simple_search_memory (struct target_ops *ops,
 	      do_cleanups (old_cleanups);
 	      return -1;
 	    }
-
-	  start_addr += chunk_size;
 	}
     }
 
@@ -2480,6 +2660,8 @@ target_search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
     fprintf_unfiltered (gdb_stdlog, "target_search_memory (%s, ...)\n",
 			hex_string (start_addr));
 
+  dcache_flush_range (target_dcache, start_addr, search_space_len);
+
   for (t = current_target.beneath; t != NULL; t = t->beneath)
     if (t->to_search_memory != NULL)
       break;
@@ -3136,6 +3318,32 @@ target_fetch_registers (struct regcache *regcache, int regno)
     }
 }
 
+void
+target_prefetch_registers (struct regcache *regcache,
+			   int nregs, const int *regnums)
+{
+  struct target_ops *t;
+
+  /* Only ask the target that would service the individual fetches;
+     a stratum above it may be supplying registers from elsewhere
+     (e.g., a replay log).  */
+  for (t = current_target.beneath; t != NULL; t = t->beneath)
+    {
+      if (t->to_fetch_registers != NULL)
+	{
+	  if (t->to_prefetch_registers != NULL)
+	    {
+	      if (targetdebug)
+		fprintf_unfiltered (gdb_stdlog,
+				    "target_prefetch_registers (%d)\n",
+				    nregs);
+	      t->to_prefetch_registers (t, regcache, nregs, regnums);
+	    }
+	  return;
+	}
+    }
+}
+
 void
 target_store_registers (struct regcache *regcache, int regno)
 {
@@ -3855,6 +4063,18 @@ command."),
 			    show_targetdebug,
 			    &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("code-cache", class_support,
+			   &code_cache_enabled_p_1, _("\
+Set cache use for code accesses."), _("\
+Show cache use for code accesses."), _("\
+When on, use the data cache for reads of the program's read-only code\n\
+sections, and keep what was read while the program runs.  Only writes\n\
+by GDB, such as breakpoint insertions, update the cached code; turn\n\
+this off for programs that modify their own code."),
+			   set_code_cache_enabled_p,
+			   show_code_cache_enabled_p,
+			   &setlist, &showlist);
+
   add_setshow_boolean_cmd ("trust-readonly-sections", class_support,
 			   &trust_readonly, _("\
 Set mode for reading from readonly sections."), _("\
@@ -3950,4 +4170,5 @@ Otherwise, any attempt to interrupt or stop will be ignored."),
 
 
   target_dcache = dcache_init ();
+  observer_attach_inferior_exit (target_dcache_inferior_exit);
 }
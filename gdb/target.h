@@ -363,6 +363,31 @@ extern ULONGEST get_target_memory_unsigned (struct target_ops *ops,
 					    CORE_ADDR addr, int len,
 					    enum bfd_endian byte_order);
 
+/* One region of memory to read, as part of a
+   target_read_memory_regions request.  */
+
+struct mem_region_read
+{
+  /* The region's start address and length.  */
+  CORE_ADDR addr;
+  int len;
+
+  /* Where to store the region's contents.  */
+  gdb_byte *buf;
+
+  /* Set to 0 if the whole region was read, or to an errno value if it
+     could not be.  */
+  int status;
+};
+
+/* Read the COUNT memory regions described by REGIONS, filling in each
+   region's status.  The regions are read from the target that would
+   service individual raw memory reads, in as few operations as it
+   can manage; a remote stub may read them all in one round trip.  */
+
+extern void target_read_memory_regions (struct mem_region_read *regions,
+					int count);
+
 struct thread_info;		/* fwd decl for parameter list below: */
 
 struct target_ops
@@ -395,6 +420,8 @@ struct target_ops
     void (*to_fetch_registers) (struct target_ops *, struct regcache *, int);
     void (*to_store_registers) (struct target_ops *, struct regcache *, int);
     void (*to_prepare_to_store) (struct regcache *);
+    void (*to_prefetch_registers) (struct target_ops *, struct regcache *,
+				   int, const int *);
 
     /* Transfer LEN bytes of memory between GDB address MYADDR and
        target address MEMADDR.  If WRITE, transfer them to the target, else
@@ -545,6 +572,16 @@ struct target_ops
 				gdb_byte *readbuf, const gdb_byte *writebuf,
 				ULONGEST offset, LONGEST len);
 
+    /* Read the COUNT memory regions described by REGIONS, setting the
+       status of each.  Return the number of regions, from the start
+       of REGIONS, that were handled; the others are read one at a
+       time.  NULL if the target has no faster way to do this than one
+       to_xfer_partial call per region.  This should be called through
+       target_read_memory_regions.  */
+    int (*to_read_memory_regions) (struct target_ops *ops,
+				   struct mem_region_read *regions,
+				   int count);
+
     /* Returns the memory map for the target.  A return value of NULL
        means that no memory map is available.  If a memory address
        does not fall within any returned regions, it's assumed to be
@@ -606,6 +643,12 @@ struct target_ops
     /* Can target execute in reverse?  */
     int (*to_can_execute_reverse) (void);
 
+    /* Get ready to resume in reverse, before anything is resumed.  A
+       target that goes backward by re-executing the program does it
+       here, where inferior function calls are still allowed, and
+       leaves the stop it arrives at for to_wait to report.  */
+    void (*to_prepare_to_resume_reverse) (int step);
+
     /* Does this target support debugging multiple processes
        simultaneously?  */
     int (*to_supports_multi_process) (void);
@@ -813,6 +856,14 @@ extern void target_fetch_registers (struct regcache *regcache, int regno);
 
 extern void target_store_registers (struct regcache *regcache, int regs);
 
+/* Hint that the NREGS registers listed in REGNUMS are about to be read
+   from REGCACHE.  Targets that can fetch several registers in a single
+   operation may do so now; other targets ignore the hint, and the
+   registers are fetched on demand as usual.  */
+
+extern void target_prefetch_registers (struct regcache *regcache,
+				       int nregs, const int *regnums);
+
 /* Get ready to modify the registers array.  On machines which store
    individual registers, this doesn't need to do anything.  On machines
    which store all the registers in one fell swoop, this makes sure
@@ -835,6 +886,28 @@ struct address_space *target_thread_address_space (ptid_t);
 /* Invalidate all target dcaches.  */
 extern void target_dcache_invalidate (void);
 
+/* Write back the memory writes the target dcache deferred.  */
+extern void target_dcache_flush (void);
+
+/* Treat memory writes as writes to the stack, and so cache them like
+   stack reads, until the returned cleanup is run.  Used while the
+   frame of an inferior function call is written.  */
+extern struct cleanup *target_begin_stack_writes (void);
+
+/* Write back the memory writes the target dcache deferred, and
+   invalidate what the inferior may change while running.  */
+extern void target_dcache_invalidate_volatile (void);
+
+/* Return nonzero if the LEN bytes at MEMADDR are read-only code that
+   the dcache may keep across resumes.  */
+extern int target_cached_code_p (CORE_ADDR memaddr, LONGEST len);
+
+/* Seed the target dcache with LEN bytes of stack memory at MEMADDR in
+   inferior PTID that the target obtained along with a stop event.  */
+
+extern void target_dcache_fill (ptid_t ptid, CORE_ADDR memaddr,
+				const gdb_byte *myaddr, int len);
+
 extern int target_read_string (CORE_ADDR, char **, int, int *);
 
 extern int target_read_memory (CORE_ADDR memaddr, gdb_byte *myaddr, int len);
@@ -1349,6 +1422,10 @@ extern char *normal_pid_to_str (ptid_t ptid);
      (current_target.to_can_execute_reverse ? \
       current_target.to_can_execute_reverse () : 0)
 
+/* Get ready to resume in reverse.  STEP is as for target_resume.  */
+#define target_prepare_to_resume_reverse(step) \
+     (*current_target.to_prepare_to_resume_reverse) (step)
+
 extern const struct target_desc *target_read_description (struct target_ops *);
 
 #define target_get_ada_task_ptid(lwp, tid) \
@@ -1508,6 +1585,11 @@ struct target_section_table
 {
   struct target_section *sections;
   struct target_section *sections_end;
+
+  /* An index of SECTIONS by address, built on demand; see exec.c.
+     Code that changes the table, or the addresses of its sections,
+     calls clear_section_table_index.  */
+  struct target_section_index *index;
 };
 
 /* Return the "section" containing the specified address.  */
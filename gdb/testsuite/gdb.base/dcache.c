@@ -0,0 +1,53 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+int buffer[256];
+int result;
+
+struct big
+{
+  int a[16];
+} big_arg = { { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 } };
+
+int
+sum_big (struct big b, int x)
+{
+  int i, sum = x;
+
+  for (i = 0; i < 16; i++)
+    sum += b.a[i];
+  return sum;
+}
+
+void
+marker (void)
+{
+}
+
+int
+main (void)
+{
+  int i;
+
+  marker ();
+
+  for (i = 0; i < 256; i++)
+    result += buffer[i] * (i + 1);
+
+  marker ();
+  return 0;
+}
@@ -33,6 +33,8 @@
 
 #define CHUNK_SIZE 16000 /* same as findcmd.c's */
 #define BUF_SIZE (2 * CHUNK_SIZE) /* at least two chunks */
+/* Large enough for the chunk size to grow to its maximum.  */
+#define LARGE_BUF_SIZE (4 * 1024 * 1024)
 
 static int8_t int8_search_buf[100];
 static int16_t int16_search_buf[100];
@@ -42,6 +44,9 @@ static int64_t int64_search_buf[100];
 static char *search_buf;
 static int search_buf_size;
 
+static char *large_buf;
+static int large_buf_size;
+
 static int x;
 
 static void
@@ -58,6 +63,12 @@ init_bufs ()
   if (search_buf == NULL)
     exit (1);
   memset (search_buf, 'x', search_buf_size);
+
+  large_buf_size = LARGE_BUF_SIZE;
+  large_buf = malloc (large_buf_size);
+  if (large_buf == NULL)
+    exit (1);
+  memset (large_buf, 'x', large_buf_size);
 }
 
 int
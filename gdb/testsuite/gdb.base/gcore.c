@@ -26,6 +26,8 @@ int extern_array[4] = {1, 2, 3, 4};
 static int static_array[4] = {5, 6, 7, 8};
 static int un_initialized_array[4];
 static char *heap_string;
+/* Mostly zeros, which gcore leaves as holes in the core file.  */
+static char sparse_array[5 * 4096];
 
 void 
 terminal_func ()
@@ -46,6 +48,9 @@ array_func ()
       un_initialized_array[i] = extern_array[i] + 8;
       local_array[i] = extern_array[i] + 12;
     }
+  sparse_array[0] = 'a';
+  sparse_array[3 * 4096 + 17] = 'b';
+  sparse_array[sizeof (sparse_array) - 1] = 'c';
   terminal_func ();
 }
 
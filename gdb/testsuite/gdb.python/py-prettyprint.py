@@ -200,6 +200,17 @@ def disable_lookup_function ():
 def enable_lookup_function ():
     lookup_function.enabled = True
 
+# A type-only lookup function that never finds a printer, and counts
+# how many times it is called.
+lookup_calls = 0
+
+def counting_lookup_function (val):
+    global lookup_calls
+    lookup_calls = lookup_calls + 1
+    return None
+
+counting_lookup_function.type_only = True
+
 def register_pretty_printers ():
     pretty_printers_dict[re.compile ('^struct s$')]   = pp_s
     pretty_printers_dict[re.compile ('^s$')]   = pp_s
@@ -0,0 +1,85 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2010 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NUM_THREADS 100
+#define NUM_SHORT_LIVED 50
+
+/* Threads that keep running until the program is killed.  */
+
+void *
+spin (void *arg)
+{
+  while (1)
+    usleep (1000);
+
+  return NULL;
+}
+
+/* Threads that are created and exit while GDB runs the program.  */
+
+void *
+short_lived (void *arg)
+{
+  return arg;
+}
+
+void
+all_started (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t thread;
+  int i, ret;
+
+  for (i = 0; i < NUM_THREADS; i++)
+    {
+      ret = pthread_create (&thread, NULL, spin, NULL);
+      if (ret)
+	{
+	  fprintf (stderr, "pthread_create(): %s\n", strerror (ret));
+	  exit (1);
+	}
+    }
+
+  for (i = 0; i < NUM_SHORT_LIVED; i++)
+    {
+      ret = pthread_create (&thread, NULL, short_lived, NULL);
+      if (ret)
+	{
+	  fprintf (stderr, "pthread_create(): %s\n", strerror (ret));
+	  exit (1);
+	}
+      pthread_join (thread, NULL);
+    }
+
+  all_started ();
+
+  /* Wait here until the test kills us.  */
+  while (1)
+    sleep (1);
+
+  return 0;
+}
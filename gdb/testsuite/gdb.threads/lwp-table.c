@@ -0,0 +1,67 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#define NTHREADS 100
+
+static pthread_barrier_t barrier;
+
+volatile int hits;
+
+void
+thread_hit (int n)
+{
+  hits++;
+}
+
+static void *
+thread_function (void *arg)
+{
+  /* Have all the threads run at once, so that GDB has to stop many
+     running LWPs, some of them exiting, each time one of them hits
+     the breakpoint.  */
+  pthread_barrier_wait (&barrier);
+  thread_hit ((int) (long) arg);
+  return NULL;
+}
+
+void
+all_done (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NTHREADS];
+  int i;
+
+  pthread_barrier_init (&barrier, NULL, NTHREADS);
+
+  for (i = 0; i < NTHREADS; i++)
+    if (pthread_create (&threads[i], NULL, thread_function,
+			(void *) (long) i) != 0)
+      abort ();
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  all_done ();
+  return 0;
+}
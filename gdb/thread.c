@@ -55,6 +55,20 @@ void _initialize_thread (void);
 static struct thread_info *thread_list = NULL;
 static int highest_thread_num;
 
+/* Number of threads in THREAD_LIST.  */
+static int thread_list_count;
+
+/* Hash tables indexing THREAD_LIST by ptid and by thread number, so
+   that looking up a thread does not take time proportional to the
+   number of threads.  Both have THREAD_HASH_SIZE buckets, a power of
+   two, and grow with the list.  Within a bucket, threads are kept in
+   list order, newest first, so that a lookup by ptid finds the same
+   thread a walk of the list would, even if an exited thread still
+   shares its ptid with a new one.  */
+static struct thread_info **thread_ptid_hash;
+static struct thread_info **thread_num_hash;
+static int thread_hash_size;
+
 static void thread_command (char *tidstr, int from_tty);
 static void thread_apply_all_command (char *, int);
 static int thread_alive (struct thread_info *);
@@ -125,6 +139,119 @@ free_thread (struct thread_info *tp)
   xfree (tp);
 }
 
+/* Return the bucket of the ptid hash table PTID belongs in.  */
+
+static struct thread_info **
+thread_ptid_bucket (ptid_t ptid)
+{
+  unsigned int hash;
+
+  hash = ptid_get_pid (ptid);
+  hash = hash * 31 + ptid_get_lwp (ptid);
+  hash = hash * 31 + ptid_get_tid (ptid);
+
+  return &thread_ptid_hash[hash & (thread_hash_size - 1)];
+}
+
+/* Return the bucket of the thread number hash table NUM belongs in.  */
+
+static struct thread_info **
+thread_num_bucket (int num)
+{
+  return &thread_num_hash[num & (thread_hash_size - 1)];
+}
+
+/* Add TP to the ptid hash table.  Threads are numbered in order of
+   creation, so keeping the bucket sorted by decreasing number keeps
+   it in list order.  */
+
+static void
+link_thread_ptid (struct thread_info *tp)
+{
+  struct thread_info **slot = thread_ptid_bucket (tp->ptid);
+
+  while (*slot != NULL && (*slot)->num > tp->num)
+    slot = &(*slot)->ptid_hash_next;
+
+  tp->ptid_hash_next = *slot;
+  *slot = tp;
+}
+
+/* Remove TP from the ptid hash table.  */
+
+static void
+unlink_thread_ptid (struct thread_info *tp)
+{
+  struct thread_info **slot = thread_ptid_bucket (tp->ptid);
+
+  while (*slot != tp)
+    slot = &(*slot)->ptid_hash_next;
+
+  *slot = tp->ptid_hash_next;
+}
+
+/* Add TP to the thread number hash table.  */
+
+static void
+link_thread_num (struct thread_info *tp)
+{
+  struct thread_info **slot = thread_num_bucket (tp->num);
+
+  tp->num_hash_next = *slot;
+  *slot = tp;
+}
+
+/* Remove TP from the thread number hash table.  */
+
+static void
+unlink_thread_num (struct thread_info *tp)
+{
+  struct thread_info **slot = thread_num_bucket (tp->num);
+
+  while (*slot != tp)
+    slot = &(*slot)->num_hash_next;
+
+  *slot = tp->num_hash_next;
+}
+
+/* Resize the hash tables to SIZE buckets, and rehash all threads.  */
+
+static void
+resize_thread_hash (int size)
+{
+  struct thread_info *tp;
+
+  xfree (thread_ptid_hash);
+  xfree (thread_num_hash);
+  thread_hash_size = size;
+  thread_ptid_hash = xcalloc (size, sizeof (struct thread_info *));
+  thread_num_hash = xcalloc (size, sizeof (struct thread_info *));
+
+  for (tp = thread_list; tp; tp = tp->next)
+    {
+      link_thread_ptid (tp);
+      link_thread_num (tp);
+    }
+}
+
+/* Remove TP from the thread list and the hash tables, without
+   freeing it.  */
+
+static void
+unlink_thread (struct thread_info *tp)
+{
+  if (tp->prev)
+    tp->prev->next = tp->next;
+  else
+    thread_list = tp->next;
+  if (tp->next)
+    tp->next->prev = tp->prev;
+
+  unlink_thread_ptid (tp);
+  unlink_thread_num (tp);
+  thread_list_count--;
+}
+
 void
 init_thread_list (void)
 {
@@ -142,6 +269,9 @@ init_thread_list (void)
     }
 
   thread_list = NULL;
+  thread_list_count = 0;
+  memset (thread_ptid_hash, 0, thread_hash_size * sizeof (*thread_ptid_hash));
+  memset (thread_num_hash, 0, thread_hash_size * sizeof (*thread_num_hash));
 }
 
 /* Allocate a new thread with target id PTID and add it to the thread
@@ -157,7 +287,18 @@ new_thread (ptid_t ptid)
   tp->ptid = ptid;
   tp->num = ++highest_thread_num;
   tp->next = thread_list;
+  if (thread_list)
+    thread_list->prev = tp;
   thread_list = tp;
+  thread_list_count++;
+
+  if (thread_list_count > thread_hash_size)
+    resize_thread_hash (thread_hash_size ? 2 * thread_hash_size : 64);
+  else
+    {
+      link_thread_ptid (tp);
+      link_thread_num (tp);
+    }
 
   /* Nothing to follow yet.  */
   tp->pending_follow.kind = TARGET_WAITKIND_SPURIOUS;
@@ -197,7 +338,9 @@ add_thread_silent (ptid_t ptid)
 	  delete_thread (ptid);
 
 	  /* Now reset its ptid, and reswitch inferior_ptid to it.  */
+	  unlink_thread_ptid (tp);
 	  tp->ptid = ptid;
+	  link_thread_ptid (tp);
 	  tp->state_ = THREAD_STOPPED;
 	  switch_to_thread (ptid);
 
@@ -242,14 +385,9 @@ add_thread (ptid_t ptid)
 static void
 delete_thread_1 (ptid_t ptid, int silent)
 {
-  struct thread_info *tp, *tpprev;
-
-  tpprev = NULL;
-
-  for (tp = thread_list; tp; tpprev = tp, tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      break;
+  struct thread_info *tp;
 
+  tp = find_thread_ptid (ptid);
   if (!tp)
     return;
 
@@ -274,10 +412,7 @@ delete_thread_1 (ptid_t ptid, int silent)
        return;
      }
 
-  if (tpprev)
-    tpprev->next = tp->next;
-  else
-    thread_list = tp->next;
+  unlink_thread (tp);
 
   /* Notify thread exit, but only if we haven't already.  */
   if (tp->state_ != THREAD_EXITED)
@@ -307,7 +442,10 @@ find_thread_id (int num)
 {
   struct thread_info *tp;
 
-  for (tp = thread_list; tp; tp = tp->next)
+  if (thread_hash_size == 0)
+    return NULL;
+
+  for (tp = *thread_num_bucket (num); tp; tp = tp->num_hash_next)
     if (tp->num == num)
       return tp;
 
@@ -320,7 +458,10 @@ find_thread_ptid (ptid_t ptid)
 {
   struct thread_info *tp;
 
-  for (tp = thread_list; tp; tp = tp->next)
+  if (thread_hash_size == 0)
+    return NULL;
+
+  for (tp = *thread_ptid_bucket (ptid); tp; tp = tp->ptid_hash_next)
     if (ptid_equal (tp->ptid, ptid))
       return tp;
 
@@ -360,35 +501,22 @@ iterate_over_threads (int (*callback) (struct thread_info *, void *),
 int
 thread_count (void)
 {
-  int result = 0;
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    ++result;
-
-  return result;  
+  return thread_list_count;
 }
 
 int
 valid_thread_id (int num)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (tp->num == num)
-      return 1;
-
-  return 0;
+  return find_thread_id (num) != NULL;
 }
 
 int
 pid_to_thread_id (ptid_t ptid)
 {
-  struct thread_info *tp;
+  struct thread_info *tp = find_thread_ptid (ptid);
 
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return tp->num;
+  if (tp)
+    return tp->num;
 
   return 0;
 }
@@ -407,13 +535,7 @@ thread_id_to_pid (int num)
 int
 in_thread_list (ptid_t ptid)
 {
-  struct thread_info *tp;
-
-  for (tp = thread_list; tp; tp = tp->next)
-    if (ptid_equal (tp->ptid, ptid))
-      return 1;
-
-  return 0;			/* Never heard of 'im */
+  return find_thread_ptid (ptid) != NULL;
 }
 
 /* Finds the first thread of the inferior given by PID.  If PID is -1,
@@ -544,7 +666,9 @@ thread_change_ptid (ptid_t old_ptid, ptid_t new_ptid)
   inf->pid = ptid_get_pid (new_ptid);
 
   tp = find_thread_ptid (old_ptid);
+  unlink_thread_ptid (tp);
   tp->ptid = new_ptid;
+  link_thread_ptid (tp);
 
   observer_notify_thread_ptid_changed (old_ptid, new_ptid);
 }
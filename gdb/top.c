@@ -341,9 +341,10 @@ prepare_execute_command (void)
   /* With multiple threads running while the one we're examining is stopped,
      the dcache can get stale without us being able to detect it.
      For the duration of the command, though, use the dcache to help
-     things like backtrace.  */
+     things like backtrace.  Read-only memory and code can't go stale
+     that way.  */
   if (non_stop)
-    target_dcache_invalidate ();
+    target_dcache_invalidate_volatile ();
 }
 
 /* Execute the line P as a command, in the current user context.
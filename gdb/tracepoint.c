@@ -1902,6 +1902,10 @@ tfind_1 (enum trace_find_type type, int num,
       && (has_stack_frames () || traceframe_number >= 0))
     old_frame_id = get_frame_id (get_current_frame ());
 
+  /* Memory writes the dcache deferred are meant for the live
+     program; send them before looking at another frame.  */
+  target_dcache_flush ();
+
   target_frameno = target_trace_find (type, num, addr1, addr2,
 				      &target_tracept);
   
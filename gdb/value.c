@@ -39,6 +39,7 @@
 #include "objfiles.h"
 #include "valprint.h"
 #include "cli/cli-decode.h"
+#include "gdb_obstack.h"
 
 #include "python/python.h"
 
@@ -204,6 +205,10 @@ struct value
      valid if lazy is nonzero.  */
   gdb_byte *contents;
 
+  /* Nonzero if CONTENTS was allocated on the value arena, rather than
+     with xmalloc.  */
+  char contents_in_arena;
+
   /* The number of references to this value.  When a value is created,
      the value chain holds a reference, so REFERENCE_COUNT is 1.  If
      release_value is called, this value is removed from the chain but
@@ -246,6 +251,72 @@ static int value_history_count;	/* Abs number of last entry stored */
 
 static struct value *all_values;
 
+/* The value arena.  The contents of a value are allocated here when
+   the value is the newest one on the all_values chain and nothing
+   else refers to it.  Since values are freed from the chain in the
+   reverse order of their allocation, everything allocated on the
+   arena after the contents of a value belongs to values freed along
+   with it, and value_free_to_mark can release it all at once.  A
+   value that escapes the chain has its contents moved to the heap
+   first; see promote_value.  */
+
+static struct obstack value_arena;
+
+/* Nonzero once VALUE_ARENA has been initialized.  Values can be
+   created by other modules' initialization functions, before
+   _initialize_values runs, so this is done on first use.  */
+
+static int value_arena_initialized;
+
+/* Value objects freed by value_free, chained through their NEXT
+   field, ready to be reused by allocate_value_lazy.  */
+
+static struct value *value_freelist;
+
+/* Return zeroed storage for LENGTH bytes of contents of VAL.  */
+
+static gdb_byte *
+allocate_contents (struct value *val, int length)
+{
+  gdb_byte *contents;
+
+  if (val == all_values && val->reference_count == 1)
+    {
+      if (!value_arena_initialized)
+	{
+	  obstack_init (&value_arena);
+	  value_arena_initialized = 1;
+	}
+      contents = obstack_alloc (&value_arena, length);
+      memset (contents, 0, length);
+      val->contents_in_arena = 1;
+    }
+  else
+    {
+      contents = xzalloc (length);
+      val->contents_in_arena = 0;
+    }
+
+  return contents;
+}
+
+/* Move the contents of VAL off the value arena, if they are there, so
+   that VAL can outlive the values freed along with it.  */
+
+static void
+promote_value (struct value *val)
+{
+  if (val->contents_in_arena)
+    {
+      int length = TYPE_LENGTH (val->enclosing_type);
+      gdb_byte *contents = xmalloc (length);
+
+      memcpy (contents, val->contents, length);
+      val->contents = contents;
+      val->contents_in_arena = 0;
+    }
+}
+
 /* Allocate a lazy value for type TYPE.  Its actual content is
    "lazily" allocated too: the content field of the return value is
    NULL; it will be allocated when it is fetched from the target.  */
@@ -263,7 +334,14 @@ allocate_value_lazy (struct type *type)
      description correctly.  */
   check_typedef (type);
 
-  val = (struct value *) xzalloc (sizeof (struct value));
+  if (value_freelist != NULL)
+    {
+      val = value_freelist;
+      value_freelist = val->next;
+      memset (val, 0, sizeof (struct value));
+    }
+  else
+    val = (struct value *) xzalloc (sizeof (struct value));
   val->contents = NULL;
   val->next = all_values;
   all_values = val;
@@ -295,7 +373,7 @@ void
 allocate_value_contents (struct value *val)
 {
   if (!val->contents)
-    val->contents = (gdb_byte *) xzalloc (TYPE_LENGTH (val->enclosing_type));
+    val->contents = allocate_contents (val, TYPE_LENGTH (val->enclosing_type));
 }
 
 /* Allocate a  value  and its contents for type TYPE.  */
@@ -652,6 +730,7 @@ value_mark (void)
 void
 value_incref (struct value *val)
 {
+  promote_value (val);
   val->reference_count++;
 }
 
@@ -682,9 +761,12 @@ value_free (struct value *val)
 	    funcs->free_closure (val);
 	}
 
-      xfree (val->contents);
+      if (!val->contents_in_arena)
+	xfree (val->contents);
+
+      val->next = value_freelist;
+      value_freelist = val;
     }
-  xfree (val);
 }
 
 /* Free all values allocated since MARK was obtained by value_mark
@@ -694,13 +776,21 @@ value_free_to_mark (struct value *mark)
 {
   struct value *val;
   struct value *next;
+  gdb_byte *arena_mark = NULL;
 
   for (val = all_values; val && val != mark; val = next)
     {
       next = val->next;
+      if (val->contents_in_arena)
+	arena_mark = val->contents;
       value_free (val);
     }
   all_values = val;
+
+  /* The oldest arena contents freed above mark the start of the arena
+     storage that no remaining value uses.  */
+  if (arena_mark != NULL)
+    obstack_free (&value_arena, arena_mark);
 }
 
 /* Free all the values that have been allocated (except for those released).
@@ -710,16 +800,7 @@ value_free_to_mark (struct value *mark)
 void
 free_all_values (void)
 {
-  struct value *val;
-  struct value *next;
-
-  for (val = all_values; val; val = next)
-    {
-      next = val->next;
-      value_free (val);
-    }
-
-  all_values = 0;
+  value_free_to_mark (NULL);
 }
 
 /* Frees all the elements in a chain of values.  */
@@ -744,6 +825,8 @@ release_value (struct value *val)
 {
   struct value *v;
 
+  promote_value (val);
+
   if (all_values == val)
     {
       all_values = val->next;
@@ -768,12 +851,15 @@ value_release_to_mark (struct value *mark)
   struct value *next;
 
   for (val = next = all_values; next; next = next->next)
-    if (next->next == mark)
-      {
-	all_values = next->next;
-	next->next = NULL;
-	return val;
-      }
+    {
+      promote_value (next);
+      if (next->next == mark)
+	{
+	  all_values = next->next;
+	  next->next = NULL;
+	  return val;
+	}
+    }
   all_values = 0;
   return val;
 }
@@ -1931,8 +2017,11 @@ struct value *
 value_change_enclosing_type (struct value *val, struct type *new_encl_type)
 {
   if (TYPE_LENGTH (new_encl_type) > TYPE_LENGTH (value_enclosing_type (val))) 
-    val->contents =
-      (gdb_byte *) xrealloc (val->contents, TYPE_LENGTH (new_encl_type));
+    {
+      promote_value (val);
+      val->contents =
+	(gdb_byte *) xrealloc (val->contents, TYPE_LENGTH (new_encl_type));
+    }
 
   val->enclosing_type = new_encl_type;
   return val;
@@ -0,0 +1,39 @@
+/* sim-riscv.h --- interface between RISC-V simulator and GDB.
+
+   Copyright 2026 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#if !defined (SIM_RISCV_H)
+#define SIM_RISCV_H
+
+enum sim_riscv_regnum
+  {
+    sim_riscv_x0_regnum,
+    sim_riscv_x31_regnum = sim_riscv_x0_regnum + 31,
+    sim_riscv_pc_regnum,
+    sim_riscv_f0_regnum,
+    sim_riscv_f31_regnum = sim_riscv_f0_regnum + 31,
+    sim_riscv_fcsr_regnum,
+    sim_riscv_fflags_regnum,
+    sim_riscv_frm_regnum,
+    sim_riscv_cycle_regnum,
+    sim_riscv_time_regnum,
+    sim_riscv_instret_regnum,
+    sim_riscv_num_regs
+  };
+
+#endif /* SIM_RISCV_H */
@@ -38,6 +38,7 @@
 #if EXTERN_SIM_CORE_P
 static MODULE_INIT_FN sim_core_init;
 static MODULE_UNINSTALL_FN sim_core_uninstall;
+static void sim_core_flush_tlbs (SIM_DESC sd);
 #endif
 
 #if EXTERN_SIM_CORE_P
@@ -78,6 +79,7 @@ sim_core_uninstall (SIM_DESC sd)
     }
     core->common.map[map].first = NULL;
   }
+  sim_core_flush_tlbs (sd);
 }
 #endif
 
@@ -86,12 +88,37 @@ sim_core_uninstall (SIM_DESC sd)
 static SIM_RC
 sim_core_init (SIM_DESC sd)
 {
-  /* Nothing to do */
+  sim_core_flush_tlbs (sd);
   return SIM_RC_OK;
 }
 #endif
 
 
+/* Empty the translation cache of every processor.  Must be called
+   after any change to the memory maps.  */
+
+#if EXTERN_SIM_CORE_P
+static void
+sim_core_flush_tlbs (SIM_DESC sd)
+{
+  int i;
+  for (i = 0; i < MAX_NR_PROCESSORS; i++)
+    {
+      sim_cpu_core *cpu_core = CPU_CORE (STATE_CPU (sd, i));
+      unsigned map;
+      int entry;
+      for (map = 0; map < nr_maps; map++)
+	for (entry = 0; entry < SIM_CORE_TLB_SIZE; entry++)
+	  {
+	    cpu_core->tlb[map][entry].page = SIM_CORE_TLB_INVALID_PAGE;
+	    cpu_core->tlb[map][entry].mapping = NULL;
+	    cpu_core->tlb[map][entry].host = NULL;
+	  }
+    }
+}
+#endif
+
+
 
 #ifndef SIM_CORE_SIGNAL
 #define SIM_CORE_SIGNAL(SD,CPU,CIA,MAP,NR_BYTES,ADDR,TRANSFER,ERROR) \
@@ -396,6 +423,7 @@ sim_core_attach (SIM_DESC sd,
 	CPU_CORE (STATE_CPU (sd, i))->common = STATE_CORE (sd)->common;
       }
   }
+  sim_core_flush_tlbs (sd);
 }
 #endif
 
@@ -454,6 +482,7 @@ sim_core_detach (SIM_DESC sd,
 	CPU_CORE (STATE_CPU (sd, i))->common = STATE_CORE (sd)->common;
       }
   }
+  sim_core_flush_tlbs (sd);
 }
 #endif
 
@@ -503,6 +532,65 @@ sim_core_translate (sim_core_mapping *mapping,
 }
 
 
+/* Find the mapping for an N byte aligned processor transfer at ADDR,
+   aborting if there is none, and enter the page containing ADDR into
+   the translation cache when that is safe.  The caller has already
+   checked the cache and missed.  */
+
+STATIC_INLINE_SIM_CORE\
+(sim_core_mapping *)
+sim_core_tlb_fill (sim_cpu_core *cpu_core,
+		   unsigned map,
+		   address_word addr,
+		   unsigned nr_bytes,
+		   transfer_type transfer,
+		   sim_cpu *cpu,
+		   sim_cia cia)
+{
+  address_word page = SIM_CORE_TLB_PAGE (addr);
+  address_word page_bound = page + (SIM_CORE_TLB_PAGE_SIZE - 1);
+  sim_core_mapping *mapping = cpu_core->common.map[map].first;
+  int overlapped = 0;
+  ASSERT ((addr & (nr_bytes - 1)) == 0); /* must be aligned */
+  ASSERT ((addr + (nr_bytes - 1)) >= addr); /* must not wrap */
+  while (mapping != NULL)
+    {
+      if (addr >= mapping->base
+	  && (addr + (nr_bytes - 1)) <= mapping->bound)
+	break;
+      /* A higher priority mapping covering part of the page rules
+	 out caching it.  */
+      if (mapping->base <= page_bound && mapping->bound >= page)
+	overlapped = 1;
+      mapping = mapping->next;
+    }
+  if (mapping == NULL)
+    {
+      SIM_CORE_SIGNAL (CPU_STATE (cpu), cpu, cia, map, nr_bytes, addr, transfer,
+		       sim_core_unmapped_signal);
+      return NULL;
+    }
+  if (!overlapped
+      && mapping->base <= page
+      && mapping->bound >= page_bound)
+    {
+      sim_core_tlb_entry *entry = SIM_CORE_TLB_ENTRY (cpu_core, map, addr);
+      entry->page = page;
+      entry->mapping = mapping;
+      /* Raw memory is only contiguous over the page if the page does
+	 not straddle the end of a modulo window.  */
+      if (mapping->device == NULL
+	  && (!WITH_MODULO_MEMORY
+	      || (((page - mapping->base) & mapping->mask)
+		  + (SIM_CORE_TLB_PAGE_SIZE - 1)) <= mapping->mask))
+	entry->host = sim_core_translate (mapping, page);
+      else
+	entry->host = NULL;
+    }
+  return mapping;
+}
+
+
 #if EXTERN_SIM_CORE_P
 unsigned
 sim_core_read_buffer (SIM_DESC sd,
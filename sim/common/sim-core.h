@@ -88,12 +88,52 @@ struct _sim_core {
 };
 
 
+/* Per CPU translation cache.
+
+   The fixed sized, processor oriented, transfers below first look up
+   the page containing the address in a small direct mapped table
+   before falling back to a search of the (level ordered) mapping
+   list.  A page is only entered when a single mapping covers all of
+   it and no other mapping of a lower level overlaps it, so that a hit
+   always yields the mapping the list search would have found.  For
+   raw memory the host address of the start of the page is cached as
+   well; for callback memory, HOST is NULL and only the mapping is
+   remembered.
+
+   The table is flushed whenever a mapping is attached or detached.  */
+
+#ifndef SIM_CORE_TLB_PAGE_BITS
+#define SIM_CORE_TLB_PAGE_BITS 12
+#endif
+#ifndef SIM_CORE_TLB_SIZE
+#define SIM_CORE_TLB_SIZE 64 /* must be a power of two */
+#endif
+
+#define SIM_CORE_TLB_PAGE_SIZE ((address_word) 1 << SIM_CORE_TLB_PAGE_BITS)
+#define SIM_CORE_TLB_PAGE(ADDR) ((ADDR) & ~(SIM_CORE_TLB_PAGE_SIZE - 1))
+#define SIM_CORE_TLB_OFFSET(ADDR) ((ADDR) & (SIM_CORE_TLB_PAGE_SIZE - 1))
+#define SIM_CORE_TLB_ENTRY(CPU_CORE,MAP,ADDR) \
+(&(CPU_CORE)->tlb[MAP][((ADDR) >> SIM_CORE_TLB_PAGE_BITS) \
+		       & (SIM_CORE_TLB_SIZE - 1)])
+
+/* An empty entry; never matches a page address.  */
+#define SIM_CORE_TLB_INVALID_PAGE ((address_word) 1)
+
+typedef struct _sim_core_tlb_entry sim_core_tlb_entry;
+struct _sim_core_tlb_entry {
+  address_word page;
+  sim_core_mapping *mapping;
+  unsigned8 *host;
+};
+
+
 /* Per CPU distributed component of the core.  At present this is
    mostly a clone of the global core data structure. */
 
 typedef struct _sim_cpu_core {
   sim_core_common common;
   address_word xor[WITH_XOR_ENDIAN + 1]; /* +1 to avoid zero-sized array */
+  sim_core_tlb_entry tlb[nr_maps][SIM_CORE_TLB_SIZE];
 } sim_cpu_core;
 
 
@@ -151,7 +151,7 @@ sim_core_read_aligned_N(sim_cpu *cpu,
 			address_word xaddr)
 {
   sim_cpu_core *cpu_core = CPU_CORE (cpu);
-  sim_core_common *core = &cpu_core->common;
+  sim_core_tlb_entry *tlb;
   unsigned_M val;
   sim_core_mapping *mapping;
   address_word addr;
@@ -161,9 +161,18 @@ sim_core_read_aligned_N(sim_cpu *cpu,
   else
 #endif
     addr = xaddr;
-  mapping = sim_core_find_mapping (core, map, addr, N, read_transfer, 1 /*abort*/, cpu, cia);
+  tlb = SIM_CORE_TLB_ENTRY (cpu_core, map, addr);
+  if (tlb->page == SIM_CORE_TLB_PAGE (addr))
+    mapping = tlb->mapping;
+  else
+    mapping = sim_core_tlb_fill (cpu_core, map, addr, N, read_transfer, cpu, cia);
   do
     {
+      if (tlb->page == SIM_CORE_TLB_PAGE (addr) && tlb->host != NULL)
+	{
+	  val = T2H_M (*(unsigned_M*) (tlb->host + SIM_CORE_TLB_OFFSET (addr)));
+	  break;
+	}
 #if (WITH_DEVICES)
       if (WITH_CALLBACK_MEMORY && mapping->device != NULL)
 	{
@@ -283,7 +292,7 @@ sim_core_write_aligned_N(sim_cpu *cpu,
 			 unsigned_M val)
 {
   sim_cpu_core *cpu_core = CPU_CORE (cpu);
-  sim_core_common *core = &cpu_core->common;
+  sim_core_tlb_entry *tlb;
   sim_core_mapping *mapping;
   address_word addr;
 #if WITH_XOR_ENDIAN != 0
@@ -292,9 +301,18 @@ sim_core_write_aligned_N(sim_cpu *cpu,
   else
 #endif
     addr = xaddr;
-  mapping = sim_core_find_mapping (core, map, addr, N, write_transfer, 1 /*abort*/, cpu, cia);
+  tlb = SIM_CORE_TLB_ENTRY (cpu_core, map, addr);
+  if (tlb->page == SIM_CORE_TLB_PAGE (addr))
+    mapping = tlb->mapping;
+  else
+    mapping = sim_core_tlb_fill (cpu_core, map, addr, N, write_transfer, cpu, cia);
   do
     {
+      if (tlb->page == SIM_CORE_TLB_PAGE (addr) && tlb->host != NULL)
+	{
+	  *(unsigned_M*) (tlb->host + SIM_CORE_TLB_OFFSET (addr)) = H2T_M (val);
+	  break;
+	}
 #if (WITH_DEVICES)
       if (WITH_CALLBACK_MEMORY && mapping->device != NULL)
 	{
@@ -0,0 +1,1442 @@
+/* RISC-V simulator: instruction decoding and execution.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* This implements the RV64G instruction set: RV64I, with the M, A, F
+   and D extensions.
+
+   Instructions are not interpreted straight from memory.  The first
+   time an instruction is executed, it is decoded into a `struct
+   riscv_idesc' holding its semantic routine and its operands, and the
+   result is kept in a direct-mapped cache indexed by PC.  The main
+   loop then only has to check the cache tag and call through the
+   semantic routine.
+
+   The cache has to be kept coherent with memory.  Writes made by GDB
+   (sim_write, which is also how programs are loaded) invalidate the
+   entries they cover.  Like the hardware, the simulator does not
+   notice stores made by the program itself to code it has already
+   executed until the program runs a FENCE.I.  */
+
+#include "config.h"
+#include "sim-main.h"
+#include "sim-assert.h"
+#include "libiberty.h"
+
+#include <math.h>
+#include <fenv.h>
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+/* Instruction fields.  */
+#define OPCODE(insn)	((insn) & 0x7f)
+#define FIELD_RD(insn)	(((insn) >> 7) & 0x1f)
+#define FUNCT3(insn)	(((insn) >> 12) & 0x7)
+#define FIELD_RS1(insn)	(((insn) >> 15) & 0x1f)
+#define FIELD_RS2(insn)	(((insn) >> 20) & 0x1f)
+#define FIELD_RS3(insn)	(((insn) >> 27) & 0x1f)
+#define FUNCT7(insn)	(((insn) >> 25) & 0x7f)
+
+/* Immediates, sign-extended.  */
+#define SEXT_BITS(value, bits) \
+  ((signed64) ((unsigned64) (value) << (64 - (bits))) >> (64 - (bits)))
+#define IMM_I(insn)	SEXT_BITS ((insn) >> 20, 12)
+#define IMM_S(insn)	SEXT_BITS ((((insn) >> 25) << 5) | (((insn) >> 7) & 0x1f), 12)
+#define IMM_B(insn)						\
+  SEXT_BITS ((((insn) >> 31) << 12) | ((((insn) >> 7) & 1) << 11)	\
+	| ((((insn) >> 25) & 0x3f) << 5)			\
+	| ((((insn) >> 8) & 0xf) << 1), 13)
+#define IMM_U(insn)	SEXT_BITS ((insn) & 0xfffff000, 32)
+#define IMM_J(insn)						\
+  SEXT_BITS ((((insn) >> 31) << 20) | ((((insn) >> 12) & 0xff) << 12)	\
+	| ((((insn) >> 20) & 1) << 11)				\
+	| ((((insn) >> 21) & 0x3ff) << 1), 21)
+
+/* Sign-extend the low 32 bits of VALUE, as all the word-sized
+   instructions do with their result.  */
+#define SEXT_W(value)	((unsigned64) (signed64) (signed32) (unsigned32) (value))
+
+#define INT64_MIN_VALUE	((signed64) ((unsigned64) 1 << 63))
+#define INT32_MIN_VALUE	((signed32) ((unsigned32) 1 << 31))
+
+/* Rounding modes.  */
+#define RM_RNE 0
+#define RM_RTZ 1
+#define RM_RDN 2
+#define RM_RUP 3
+#define RM_RMM 4
+#define RM_DYN 7
+
+/* Shorthands for the semantic routines.  */
+#define SEM(name)						\
+  static address_word name (sim_cpu *cpu,			\
+			    const struct riscv_idesc *id,	\
+			    address_word pc)
+#define RD	(cpu->regs[id->rd])
+#define RS1	(cpu->regs[id->rs1])
+#define RS2	(cpu->regs[id->rs2])
+#define IMM	(id->imm)
+#define NEXT_PC	(pc + 4)
+
+static void
+illegal_insn (sim_cpu *cpu, address_word pc)
+{
+  sim_engine_halt (CPU_STATE (cpu), cpu, NULL, pc, sim_stopped, SIM_SIGILL);
+}
+
+static void
+misaligned (sim_cpu *cpu, address_word pc)
+{
+  sim_engine_halt (CPU_STATE (cpu), cpu, NULL, pc, sim_stopped, SIM_SIGBUS);
+}
+
+
+/* The decoded-instruction cache.  */
+
+void
+riscv_icache_flush (sim_cpu *cpu)
+{
+  unsigned int i;
+
+  for (i = 0; i < cpu->icache_size; i++)
+    cpu->icache[i].pc = INVALID_INSTRUCTION_ADDRESS;
+  cpu->icache_flushes++;
+}
+
+/* Forget the decoded instructions overlapping [ADDR, ADDR + LEN).  */
+
+void
+riscv_icache_invalidate (sim_cpu *cpu, address_word addr, int len)
+{
+  address_word start = addr & ~(address_word) 3;
+  address_word end = addr + len;
+  address_word a;
+
+  if (cpu->icache == NULL)
+    return;
+
+  /* Past a cache's worth of instructions, a flush is cheaper.  */
+  if ((end - start) / 4 >= cpu->icache_size)
+    {
+      riscv_icache_flush (cpu);
+      return;
+    }
+
+  for (a = start; a < end; a += 4)
+    {
+      struct riscv_idesc *id
+	= &cpu->icache[(a >> 2) & (cpu->icache_size - 1)];
+
+      if (id->pc == a)
+	id->pc = INVALID_INSTRUCTION_ADDRESS;
+    }
+}
+
+/* Set the number of entries of the cache to SIZE, which must be a
+   power of two.  */
+
+SIM_RC
+riscv_icache_resize (sim_cpu *cpu, unsigned int size)
+{
+  if (size == 0 || (size & (size - 1)) != 0)
+    return SIM_RC_FAIL;
+
+  if (cpu->icache != NULL)
+    free (cpu->icache);
+  cpu->icache = xmalloc (size * sizeof (struct riscv_idesc));
+  cpu->icache_size = size;
+  riscv_icache_flush (cpu);
+  return SIM_RC_OK;
+}
+
+
+/* Integer instructions.  */
+
+#define DEF_ALU(name, expr) \
+  SEM (name) { RD = (expr); return NEXT_PC; }
+
+DEF_ALU (sem_lui, IMM)
+DEF_ALU (sem_auipc, pc + IMM)
+
+DEF_ALU (sem_addi, RS1 + IMM)
+DEF_ALU (sem_slti, (signed64) RS1 < IMM)
+DEF_ALU (sem_sltiu, RS1 < (unsigned64) IMM)
+DEF_ALU (sem_xori, RS1 ^ IMM)
+DEF_ALU (sem_ori, RS1 | IMM)
+DEF_ALU (sem_andi, RS1 & IMM)
+DEF_ALU (sem_slli, RS1 << IMM)
+DEF_ALU (sem_srli, RS1 >> IMM)
+DEF_ALU (sem_srai, (signed64) RS1 >> IMM)
+
+DEF_ALU (sem_add, RS1 + RS2)
+DEF_ALU (sem_sub, RS1 - RS2)
+DEF_ALU (sem_sll, RS1 << (RS2 & 63))
+DEF_ALU (sem_slt, (signed64) RS1 < (signed64) RS2)
+DEF_ALU (sem_sltu, RS1 < RS2)
+DEF_ALU (sem_xor, RS1 ^ RS2)
+DEF_ALU (sem_srl, RS1 >> (RS2 & 63))
+DEF_ALU (sem_sra, (signed64) RS1 >> (RS2 & 63))
+DEF_ALU (sem_or, RS1 | RS2)
+DEF_ALU (sem_and, RS1 & RS2)
+
+DEF_ALU (sem_addiw, SEXT_W (RS1 + IMM))
+DEF_ALU (sem_slliw, SEXT_W ((unsigned32) RS1 << IMM))
+DEF_ALU (sem_srliw, SEXT_W ((unsigned32) RS1 >> IMM))
+DEF_ALU (sem_sraiw, SEXT_W ((signed32) RS1 >> IMM))
+DEF_ALU (sem_addw, SEXT_W (RS1 + RS2))
+DEF_ALU (sem_subw, SEXT_W (RS1 - RS2))
+DEF_ALU (sem_sllw, SEXT_W ((unsigned32) RS1 << (RS2 & 31)))
+DEF_ALU (sem_srlw, SEXT_W ((unsigned32) RS1 >> (RS2 & 31)))
+DEF_ALU (sem_sraw, SEXT_W ((signed32) RS1 >> (RS2 & 31)))
+
+/* Return the high 64 bits of the 128-bit product of A and B.  */
+
+static unsigned64
+mulhu (unsigned64 a, unsigned64 b)
+{
+  unsigned64 a0 = a & 0xffffffff, a1 = a >> 32;
+  unsigned64 b0 = b & 0xffffffff, b1 = b >> 32;
+  unsigned64 p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+  unsigned64 mid = (p00 >> 32) + (p01 & 0xffffffff) + (p10 & 0xffffffff);
+
+  return p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+static unsigned64
+mulh (signed64 a, signed64 b)
+{
+  unsigned64 r = mulhu (a, b);
+
+  if (a < 0)
+    r -= b;
+  if (b < 0)
+    r -= a;
+  return r;
+}
+
+static unsigned64
+mulhsu (signed64 a, unsigned64 b)
+{
+  unsigned64 r = mulhu (a, b);
+
+  if (a < 0)
+    r -= b;
+  return r;
+}
+
+static signed64
+div64 (signed64 a, signed64 b)
+{
+  if (b == 0)
+    return -1;
+  if (a == INT64_MIN_VALUE && b == -1)
+    return a;
+  return a / b;
+}
+
+static signed64
+rem64 (signed64 a, signed64 b)
+{
+  if (b == 0)
+    return a;
+  if (a == INT64_MIN_VALUE && b == -1)
+    return 0;
+  return a % b;
+}
+
+static signed32
+div32 (signed32 a, signed32 b)
+{
+  if (b == 0)
+    return -1;
+  if (a == INT32_MIN_VALUE && b == -1)
+    return a;
+  return a / b;
+}
+
+static signed32
+rem32 (signed32 a, signed32 b)
+{
+  if (b == 0)
+    return a;
+  if (a == INT32_MIN_VALUE && b == -1)
+    return 0;
+  return a % b;
+}
+
+DEF_ALU (sem_mul, RS1 * RS2)
+DEF_ALU (sem_mulh, mulh (RS1, RS2))
+DEF_ALU (sem_mulhsu, mulhsu (RS1, RS2))
+DEF_ALU (sem_mulhu, mulhu (RS1, RS2))
+DEF_ALU (sem_div, div64 (RS1, RS2))
+DEF_ALU (sem_divu, RS2 == 0 ? ~(unsigned64) 0 : RS1 / RS2)
+DEF_ALU (sem_rem, rem64 (RS1, RS2))
+DEF_ALU (sem_remu, RS2 == 0 ? RS1 : RS1 % RS2)
+DEF_ALU (sem_mulw, SEXT_W (RS1 * RS2))
+DEF_ALU (sem_divw, SEXT_W (div32 (RS1, RS2)))
+DEF_ALU (sem_divuw, SEXT_W ((unsigned32) RS2 == 0 ? ~(unsigned32) 0
+			    : (unsigned32) RS1 / (unsigned32) RS2))
+DEF_ALU (sem_remw, SEXT_W (rem32 (RS1, RS2)))
+DEF_ALU (sem_remuw, SEXT_W ((unsigned32) RS2 == 0 ? (unsigned32) RS1
+			    : (unsigned32) RS1 % (unsigned32) RS2))
+
+SEM (sem_jal)
+{
+  RD = NEXT_PC;
+  return pc + IMM;
+}
+
+SEM (sem_jalr)
+{
+  address_word target = (RS1 + IMM) & ~(address_word) 1;
+
+  RD = NEXT_PC;
+  return target;
+}
+
+#define DEF_BRANCH(name, cond) \
+  SEM (name) { return (cond) ? pc + IMM : NEXT_PC; }
+
+DEF_BRANCH (sem_beq, RS1 == RS2)
+DEF_BRANCH (sem_bne, RS1 != RS2)
+DEF_BRANCH (sem_blt, (signed64) RS1 < (signed64) RS2)
+DEF_BRANCH (sem_bge, (signed64) RS1 >= (signed64) RS2)
+DEF_BRANCH (sem_bltu, RS1 < RS2)
+DEF_BRANCH (sem_bgeu, RS1 >= RS2)
+
+
+/* Loads and stores.  */
+
+#define EA	((address_word) (RS1 + IMM))
+
+#define DEF_LOAD(name, size, convert)					\
+  SEM (name)								\
+  {									\
+    RD = convert (sim_core_read_unaligned_##size (cpu, pc, read_map,	\
+						  EA));			\
+    return NEXT_PC;							\
+  }
+
+#define SEXT_B(value)	((unsigned64) (signed64) (signed8) (value))
+#define SEXT_H(value)	((unsigned64) (signed64) (signed16) (value))
+#define ZEXT(value)	((unsigned64) (value))
+
+DEF_LOAD (sem_lb, 1, SEXT_B)
+DEF_LOAD (sem_lh, 2, SEXT_H)
+DEF_LOAD (sem_lw, 4, SEXT_W)
+DEF_LOAD (sem_ld, 8, ZEXT)
+DEF_LOAD (sem_lbu, 1, ZEXT)
+DEF_LOAD (sem_lhu, 2, ZEXT)
+DEF_LOAD (sem_lwu, 4, ZEXT)
+
+#define DEF_STORE(name, size)						\
+  SEM (name)								\
+  {									\
+    sim_core_write_unaligned_##size (cpu, pc, write_map, EA, RS2);	\
+    return NEXT_PC;							\
+  }
+
+DEF_STORE (sem_sb, 1)
+DEF_STORE (sem_sh, 2)
+DEF_STORE (sem_sw, 4)
+DEF_STORE (sem_sd, 8)
+
+
+/* Atomic memory operations.  There is a single hart, so these only
+   have to be atomic with respect to the simulated program.  */
+
+SEM (sem_lr_w)
+{
+  address_word addr = RS1;
+
+  if (addr & 3)
+    misaligned (cpu, pc);
+  RD = SEXT_W (sim_core_read_aligned_4 (cpu, pc, read_map, addr));
+  cpu->reservation = addr;
+  return NEXT_PC;
+}
+
+SEM (sem_lr_d)
+{
+  address_word addr = RS1;
+
+  if (addr & 7)
+    misaligned (cpu, pc);
+  RD = sim_core_read_aligned_8 (cpu, pc, read_map, addr);
+  cpu->reservation = addr;
+  return NEXT_PC;
+}
+
+SEM (sem_sc_w)
+{
+  address_word addr = RS1;
+
+  if (addr & 3)
+    misaligned (cpu, pc);
+  if (cpu->reservation == addr)
+    {
+      sim_core_write_aligned_4 (cpu, pc, write_map, addr, RS2);
+      RD = 0;
+    }
+  else
+    RD = 1;
+  cpu->reservation = INVALID_INSTRUCTION_ADDRESS;
+  return NEXT_PC;
+}
+
+SEM (sem_sc_d)
+{
+  address_word addr = RS1;
+
+  if (addr & 7)
+    misaligned (cpu, pc);
+  if (cpu->reservation == addr)
+    {
+      sim_core_write_aligned_8 (cpu, pc, write_map, addr, RS2);
+      RD = 0;
+    }
+  else
+    RD = 1;
+  cpu->reservation = INVALID_INSTRUCTION_ADDRESS;
+  return NEXT_PC;
+}
+
+/* Define an AMO instruction storing EXPR, a function of the old memory
+   value A and of the register operand B, both of TYPE.  */
+
+#define DEF_AMO(name, size, type, expr)					\
+  SEM (name)								\
+  {									\
+    address_word addr = RS1;						\
+    type a, b = (type) RS2;						\
+									\
+    if (addr & (size - 1))						\
+      misaligned (cpu, pc);						\
+    a = (type) sim_core_read_aligned_##size (cpu, pc, read_map, addr);	\
+    sim_core_write_aligned_##size (cpu, pc, write_map, addr, (expr));	\
+    RD = (signed64) a;							\
+    return NEXT_PC;							\
+  }
+
+DEF_AMO (sem_amoswap_w, 4, signed32, b)
+DEF_AMO (sem_amoadd_w, 4, signed32, a + b)
+DEF_AMO (sem_amoxor_w, 4, signed32, a ^ b)
+DEF_AMO (sem_amoand_w, 4, signed32, a & b)
+DEF_AMO (sem_amoor_w, 4, signed32, a | b)
+DEF_AMO (sem_amomin_w, 4, signed32, a < b ? a : b)
+DEF_AMO (sem_amomax_w, 4, signed32, a > b ? a : b)
+DEF_AMO (sem_amominu_w, 4, signed32,
+	 (unsigned32) a < (unsigned32) b ? a : b)
+DEF_AMO (sem_amomaxu_w, 4, signed32,
+	 (unsigned32) a > (unsigned32) b ? a : b)
+DEF_AMO (sem_amoswap_d, 8, signed64, b)
+DEF_AMO (sem_amoadd_d, 8, signed64, a + b)
+DEF_AMO (sem_amoxor_d, 8, signed64, a ^ b)
+DEF_AMO (sem_amoand_d, 8, signed64, a & b)
+DEF_AMO (sem_amoor_d, 8, signed64, a | b)
+DEF_AMO (sem_amomin_d, 8, signed64, a < b ? a : b)
+DEF_AMO (sem_amomax_d, 8, signed64, a > b ? a : b)
+DEF_AMO (sem_amominu_d, 8, signed64,
+	 (unsigned64) a < (unsigned64) b ? a : b)
+DEF_AMO (sem_amomaxu_d, 8, signed64,
+	 (unsigned64) a > (unsigned64) b ? a : b)
+
+
+/* System instructions.  */
+
+SEM (sem_fence)
+{
+  return NEXT_PC;
+}
+
+SEM (sem_fence_i)
+{
+  /* This drops the entry we are executing from as well; ID must not
+     be used past this point.  */
+  riscv_icache_flush (cpu);
+  return NEXT_PC;
+}
+
+SEM (sem_scall)
+{
+  return riscv_syscall (cpu, pc);
+}
+
+SEM (sem_sbreak)
+{
+  sim_engine_halt (CPU_STATE (cpu), cpu, NULL, pc, sim_stopped, SIM_SIGTRAP);
+  return pc;
+}
+
+SEM (sem_illegal)
+{
+  illegal_insn (cpu, pc);
+  return pc;
+}
+
+/* Read CSR into *VALUE.  Return zero if there is no such CSR.  */
+
+static int
+csr_read (sim_cpu *cpu, int csr, unsigned64 *value)
+{
+  switch (csr)
+    {
+    case 0x001:			/* fflags */
+      *value = cpu->fflags;
+      return 1;
+    case 0x002:			/* frm */
+      *value = cpu->frm;
+      return 1;
+    case 0x003:			/* fcsr */
+      *value = (cpu->frm << 5) | cpu->fflags;
+      return 1;
+    case 0xc00:			/* cycle */
+    case 0xc01:			/* time */
+    case 0xc02:			/* instret */
+      *value = cpu->instret;
+      return 1;
+    default:
+      return 0;
+    }
+}
+
+/* Write VALUE to CSR.  Return zero if CSR can not be written.  */
+
+static int
+csr_write (sim_cpu *cpu, int csr, unsigned64 value)
+{
+  switch (csr)
+    {
+    case 0x001:			/* fflags */
+      cpu->fflags = value & 0x1f;
+      return 1;
+    case 0x002:			/* frm */
+      cpu->frm = value & 0x7;
+      return 1;
+    case 0x003:			/* fcsr */
+      cpu->fflags = value & 0x1f;
+      cpu->frm = (value >> 5) & 0x7;
+      return 1;
+    default:
+      return 0;
+    }
+}
+
+/* Define a CSR instruction.  SRC is the source operand, WRITE says
+   whether the CSR is written at all, and EXPR is the new value as a
+   function of the old value OLD.  */
+
+#define DEF_CSR(name, src, write, expr)				\
+  SEM (name)							\
+  {								\
+    unsigned64 old, val = (src);				\
+								\
+    if (!csr_read (cpu, IMM, &old))				\
+      illegal_insn (cpu, pc);					\
+    if ((write) && !csr_write (cpu, IMM, (expr)))		\
+      illegal_insn (cpu, pc);					\
+    RD = old;							\
+    return NEXT_PC;						\
+  }
+
+DEF_CSR (sem_csrrw, RS1, 1, val)
+DEF_CSR (sem_csrrs, RS1, id->rs1 != 0, old | val)
+DEF_CSR (sem_csrrc, RS1, id->rs1 != 0, old & ~val)
+DEF_CSR (sem_csrrwi, id->rs1, 1, val)
+DEF_CSR (sem_csrrsi, id->rs1, val != 0, old | val)
+DEF_CSR (sem_csrrci, id->rs1, val != 0, old & ~val)
+
+
+/* Floating-point instructions.  */
+
+static float
+get_f32 (sim_cpu *cpu, int regno)
+{
+  union { unsigned32 i; float f; } u;
+
+  u.i = (unsigned32) cpu->fpregs[regno];
+  return u.f;
+}
+
+static void
+set_f32 (sim_cpu *cpu, int regno, float value)
+{
+  union { unsigned32 i; float f; } u;
+
+  u.f = value;
+  cpu->fpregs[regno] = ((unsigned64) 0xffffffff << 32) | u.i;
+}
+
+static double
+get_f64 (sim_cpu *cpu, int regno)
+{
+  union { unsigned64 i; double f; } u;
+
+  u.i = cpu->fpregs[regno];
+  return u.f;
+}
+
+static void
+set_f64 (sim_cpu *cpu, int regno, double value)
+{
+  union { unsigned64 i; double f; } u;
+
+  u.f = value;
+  cpu->fpregs[regno] = u.i;
+}
+
+/* Prepare the host FPU for an operation rounding as RM says, and
+   return the rounding mode in effect.  */
+
+static int
+fp_begin (sim_cpu *cpu, int rm, address_word pc)
+{
+  if (rm == RM_DYN)
+    rm = cpu->frm;
+
+  switch (rm)
+    {
+    case RM_RNE:
+    case RM_RMM:
+      break;
+    case RM_RTZ:
+      fesetround (FE_TOWARDZERO);
+      break;
+    case RM_RDN:
+      fesetround (FE_DOWNWARD);
+      break;
+    case RM_RUP:
+      fesetround (FE_UPWARD);
+      break;
+    default:
+      illegal_insn (cpu, pc);
+    }
+
+  feclearexcept (FE_ALL_EXCEPT);
+  return rm;
+}
+
+/* Accumulate the exceptions raised since fp_begin into fflags, and
+   restore the host rounding mode.  */
+
+static void
+fp_end (sim_cpu *cpu, int rm)
+{
+  int raised = fetestexcept (FE_ALL_EXCEPT);
+
+  if (raised & FE_INEXACT)
+    cpu->fflags |= RISCV_FFLAG_NX;
+  if (raised & FE_UNDERFLOW)
+    cpu->fflags |= RISCV_FFLAG_UF;
+  if (raised & FE_OVERFLOW)
+    cpu->fflags |= RISCV_FFLAG_OF;
+  if (raised & FE_DIVBYZERO)
+    cpu->fflags |= RISCV_FFLAG_DZ;
+  if (raised & FE_INVALID)
+    cpu->fflags |= RISCV_FFLAG_NV;
+
+  if (rm != RM_RNE && rm != RM_RMM)
+    fesetround (FE_TONEAREST);
+}
+
+/* The floating-point operands of the instruction being executed.  */
+#define FA	GET (cpu, id->rs1)
+#define FB	GET (cpu, id->rs2)
+#define FC	GET (cpu, id->rs3)
+
+/* Define an arithmetic instruction computing EXPR in TYPE.  The result
+   is volatile so that the compiler keeps the computation between
+   fp_begin and fp_end.  */
+
+#define DEF_FP(name, type, expr)				\
+  SEM (name)							\
+  {								\
+    volatile type r;						\
+    int rm = fp_begin (cpu, id->rm, pc);			\
+								\
+    r = (expr);							\
+    fp_end (cpu, rm);						\
+    SET (cpu, id->rd, r);					\
+    return NEXT_PC;						\
+  }
+
+#define GET get_f32
+#define SET set_f32
+DEF_FP (sem_fadd_s, float, FA + FB)
+DEF_FP (sem_fsub_s, float, FA - FB)
+DEF_FP (sem_fmul_s, float, FA * FB)
+DEF_FP (sem_fdiv_s, float, FA / FB)
+DEF_FP (sem_fsqrt_s, float, sqrtf (FA))
+DEF_FP (sem_fmadd_s, float, fmaf (FA, FB, FC))
+DEF_FP (sem_fmsub_s, float, fmaf (FA, FB, -FC))
+DEF_FP (sem_fnmsub_s, float, fmaf (-FA, FB, FC))
+DEF_FP (sem_fnmadd_s, float, fmaf (-FA, FB, -FC))
+#undef GET
+#undef SET
+
+#define GET get_f64
+#define SET set_f64
+DEF_FP (sem_fadd_d, double, FA + FB)
+DEF_FP (sem_fsub_d, double, FA - FB)
+DEF_FP (sem_fmul_d, double, FA * FB)
+DEF_FP (sem_fdiv_d, double, FA / FB)
+DEF_FP (sem_fsqrt_d, double, sqrt (FA))
+DEF_FP (sem_fmadd_d, double, fma (FA, FB, FC))
+DEF_FP (sem_fmsub_d, double, fma (FA, FB, -FC))
+DEF_FP (sem_fnmsub_d, double, fma (-FA, FB, FC))
+DEF_FP (sem_fnmadd_d, double, fma (-FA, FB, -FC))
+#undef GET
+#undef SET
+
+/* Sign injection works on the raw bits.  */
+
+#define SIGN32 ((unsigned64) 1 << 31)
+#define SIGN64 ((unsigned64) 1 << 63)
+#define BOX32(bits) (((unsigned64) 0xffffffff << 32) | (unsigned32) (bits))
+
+#define DEF_FSGNJ(name, box, sign, expr)			\
+  SEM (name)							\
+  {								\
+    unsigned64 a = cpu->fpregs[id->rs1];			\
+    unsigned64 b = cpu->fpregs[id->rs2];			\
+								\
+    cpu->fpregs[id->rd] = box ((a & ~sign) | ((expr) & sign));	\
+    return NEXT_PC;						\
+  }
+
+DEF_FSGNJ (sem_fsgnj_s, BOX32, SIGN32, b)
+DEF_FSGNJ (sem_fsgnjn_s, BOX32, SIGN32, ~b)
+DEF_FSGNJ (sem_fsgnjx_s, BOX32, SIGN32, a ^ b)
+DEF_FSGNJ (sem_fsgnj_d, ZEXT, SIGN64, b)
+DEF_FSGNJ (sem_fsgnjn_d, ZEXT, SIGN64, ~b)
+DEF_FSGNJ (sem_fsgnjx_d, ZEXT, SIGN64, a ^ b)
+
+/* FMIN and FMAX return the non-NaN operand if there is one, and order
+   -0 before +0.  */
+
+#define DEF_FMINMAX(name, type, get, set, canonical_nan, less)	\
+  SEM (name)							\
+  {								\
+    type a = get (cpu, id->rs1), b = get (cpu, id->rs2);	\
+								\
+    if (isnan (a) && isnan (b))					\
+      cpu->fpregs[id->rd] = canonical_nan;			\
+    else if (isnan (a))						\
+      set (cpu, id->rd, b);					\
+    else if (isnan (b))						\
+      set (cpu, id->rd, a);					\
+    else							\
+      set (cpu, id->rd, (less) ? a : b);			\
+    return NEXT_PC;						\
+  }
+
+#define CANONICAL_NAN32 BOX32 (0x7fc00000)
+#define CANONICAL_NAN64 ((unsigned64) 0x7ff8 << 48)
+
+DEF_FMINMAX (sem_fmin_s, float, get_f32, set_f32, CANONICAL_NAN32,
+	     a == b ? signbit (a) != 0 : a < b)
+DEF_FMINMAX (sem_fmax_s, float, get_f32, set_f32, CANONICAL_NAN32,
+	     a == b ? signbit (a) == 0 : a > b)
+DEF_FMINMAX (sem_fmin_d, double, get_f64, set_f64, CANONICAL_NAN64,
+	     a == b ? signbit (a) != 0 : a < b)
+DEF_FMINMAX (sem_fmax_d, double, get_f64, set_f64, CANONICAL_NAN64,
+	     a == b ? signbit (a) == 0 : a > b)
+
+/* Comparisons.  FEQ is a quiet comparison; FLT and FLE signal on any
+   NaN.  */
+
+#define DEF_FCMP(name, type, get, expr, signal)			\
+  SEM (name)							\
+  {								\
+    type a = get (cpu, id->rs1), b = get (cpu, id->rs2);	\
+								\
+    if ((signal) && (isnan (a) || isnan (b)))			\
+      cpu->fflags |= RISCV_FFLAG_NV;				\
+    RD = (expr);						\
+    return NEXT_PC;						\
+  }
+
+DEF_FCMP (sem_feq_s, float, get_f32, a == b, 0)
+DEF_FCMP (sem_flt_s, float, get_f32, a < b, 1)
+DEF_FCMP (sem_fle_s, float, get_f32, a <= b, 1)
+DEF_FCMP (sem_feq_d, double, get_f64, a == b, 0)
+DEF_FCMP (sem_flt_d, double, get_f64, a < b, 1)
+DEF_FCMP (sem_fle_d, double, get_f64, a <= b, 1)
+
+/* Return the FCLASS mask of a value with sign SIGN, biased exponent
+   EXP (MAX_EXP if all ones) and fraction FRAC, whose most significant
+   bit is QUIET_BIT.  */
+
+static unsigned64
+fclass (int sign, unsigned64 exp, unsigned64 max_exp, unsigned64 frac,
+	unsigned64 quiet_bit)
+{
+  if (exp == max_exp)
+    {
+      if (frac == 0)
+	return sign ? 1 << 0 : 1 << 7;
+      return (frac & quiet_bit) ? 1 << 9 : 1 << 8;
+    }
+  if (exp == 0)
+    {
+      if (frac == 0)
+	return sign ? 1 << 3 : 1 << 4;
+      return sign ? 1 << 2 : 1 << 5;
+    }
+  return sign ? 1 << 1 : 1 << 6;
+}
+
+SEM (sem_fclass_s)
+{
+  unsigned32 bits = cpu->fpregs[id->rs1];
+
+  RD = fclass (bits >> 31, (bits >> 23) & 0xff, 0xff, bits & 0x7fffff,
+	       0x400000);
+  return NEXT_PC;
+}
+
+SEM (sem_fclass_d)
+{
+  unsigned64 bits = cpu->fpregs[id->rs1];
+
+  RD = fclass (bits >> 63, (bits >> 52) & 0x7ff, 0x7ff,
+	       bits & (((unsigned64) 1 << 52) - 1), (unsigned64) 1 << 51);
+  return NEXT_PC;
+}
+
+/* Round VALUE to an integer as RM says, and saturate it to
+   [MIN, MAX].  Set *FLAGS to the exceptions to raise: invalid if
+   VALUE is a NaN or out of range, inexact if it was rounded.  */
+
+static double
+fp_to_integral (double value, int rm, double min, double max,
+		unsigned32 *flags)
+{
+  volatile double r;
+
+  *flags = 0;
+  if (isnan (value))
+    {
+      *flags = RISCV_FFLAG_NV;
+      return max;
+    }
+
+  r = rm == RM_RMM ? round (value) : nearbyint (value);
+  if (r < min)
+    {
+      *flags = RISCV_FFLAG_NV;
+      return min;
+    }
+  if (r > max)
+    {
+      *flags = RISCV_FFLAG_NV;
+      return max;
+    }
+  if (r != value)
+    *flags = RISCV_FFLAG_NX;
+  return r;
+}
+
+#define TWO_31 2147483648.0
+#define TWO_32 4294967296.0
+#define TWO_63 9223372036854775808.0
+#define TWO_64 18446744073709551616.0
+
+/* Define a conversion to an integer of the register operand fetched
+   with GET.  The rounded and saturated value R is converted to the
+   destination with CONVERT; OVERFLOW is the result for a NaN or a
+   too large input.  */
+
+#define DEF_FCVT_TO_INT(name, get, min, max, convert, overflow)		\
+  SEM (name)								\
+  {									\
+    int rm = fp_begin (cpu, id->rm, pc);				\
+    unsigned32 flags;							\
+    double v = get (cpu, id->rs1);					\
+    double r = fp_to_integral (v, rm, min, max, &flags);		\
+									\
+    fp_end (cpu, rm);							\
+    cpu->fflags |= flags;						\
+    if ((flags & RISCV_FFLAG_NV) && (isnan (v) || r >= max))		\
+      RD = (overflow);							\
+    else								\
+      RD = convert;							\
+    return NEXT_PC;							\
+  }
+
+/* The upper bounds are the largest doubles below 2^N, which are
+   exact for the 32-bit conversions.  */
+#define MAX_I32 (TWO_31 - 1)
+#define MAX_U32 (TWO_32 - 1)
+#define MAX_I64 9223372036854774784.0
+#define MAX_U64 18446744073709549568.0
+
+DEF_FCVT_TO_INT (sem_fcvt_w_s, get_f32, -TWO_31, MAX_I32,
+		 SEXT_W ((signed32) r), SEXT_W (0x7fffffff))
+DEF_FCVT_TO_INT (sem_fcvt_wu_s, get_f32, 0.0, MAX_U32,
+		 SEXT_W ((unsigned32) r), ~(unsigned64) 0)
+DEF_FCVT_TO_INT (sem_fcvt_l_s, get_f32, -TWO_63, MAX_I64,
+		 (unsigned64) (signed64) r,
+		 ~(unsigned64) 0 >> 1)
+DEF_FCVT_TO_INT (sem_fcvt_lu_s, get_f32, 0.0, MAX_U64,
+		 (unsigned64) r, ~(unsigned64) 0)
+DEF_FCVT_TO_INT (sem_fcvt_w_d, get_f64, -TWO_31, MAX_I32,
+		 SEXT_W ((signed32) r), SEXT_W (0x7fffffff))
+DEF_FCVT_TO_INT (sem_fcvt_wu_d, get_f64, 0.0, MAX_U32,
+		 SEXT_W ((unsigned32) r), ~(unsigned64) 0)
+DEF_FCVT_TO_INT (sem_fcvt_l_d, get_f64, -TWO_63, MAX_I64,
+		 (unsigned64) (signed64) r,
+		 ~(unsigned64) 0 >> 1)
+DEF_FCVT_TO_INT (sem_fcvt_lu_d, get_f64, 0.0, MAX_U64,
+		 (unsigned64) r, ~(unsigned64) 0)
+
+/* Define a conversion computing EXPR in TYPE, from the integer
+   operand RS1 or the floating-point operand fetched by GET.  */
+
+#define DEF_FCVT(name, type, set, expr)					\
+  SEM (name)								\
+  {									\
+    volatile type r;							\
+    int rm = fp_begin (cpu, id->rm, pc);				\
+									\
+    r = (expr);								\
+    fp_end (cpu, rm);							\
+    set (cpu, id->rd, r);						\
+    return NEXT_PC;							\
+  }
+
+DEF_FCVT (sem_fcvt_s_w, float, set_f32, (float) (signed32) RS1)
+DEF_FCVT (sem_fcvt_s_wu, float, set_f32, (float) (unsigned32) RS1)
+DEF_FCVT (sem_fcvt_s_l, float, set_f32, (float) (signed64) RS1)
+DEF_FCVT (sem_fcvt_s_lu, float, set_f32, (float) RS1)
+DEF_FCVT (sem_fcvt_d_w, double, set_f64, (double) (signed32) RS1)
+DEF_FCVT (sem_fcvt_d_wu, double, set_f64, (double) (unsigned32) RS1)
+DEF_FCVT (sem_fcvt_d_l, double, set_f64, (double) (signed64) RS1)
+DEF_FCVT (sem_fcvt_d_lu, double, set_f64, (double) RS1)
+DEF_FCVT (sem_fcvt_s_d, float, set_f32, (float) get_f64 (cpu, id->rs1))
+DEF_FCVT (sem_fcvt_d_s, double, set_f64, (double) get_f32 (cpu, id->rs1))
+
+SEM (sem_fmv_x_s)
+{
+  RD = SEXT_W (cpu->fpregs[id->rs1]);
+  return NEXT_PC;
+}
+
+SEM (sem_fmv_s_x)
+{
+  cpu->fpregs[id->rd] = BOX32 (RS1);
+  return NEXT_PC;
+}
+
+SEM (sem_fmv_x_d)
+{
+  RD = cpu->fpregs[id->rs1];
+  return NEXT_PC;
+}
+
+SEM (sem_fmv_d_x)
+{
+  cpu->fpregs[id->rd] = RS1;
+  return NEXT_PC;
+}
+
+SEM (sem_flw)
+{
+  cpu->fpregs[id->rd] = BOX32 (sim_core_read_unaligned_4 (cpu, pc, read_map,
+							  EA));
+  return NEXT_PC;
+}
+
+SEM (sem_fld)
+{
+  cpu->fpregs[id->rd] = sim_core_read_unaligned_8 (cpu, pc, read_map, EA);
+  return NEXT_PC;
+}
+
+SEM (sem_fsw)
+{
+  sim_core_write_unaligned_4 (cpu, pc, write_map, EA,
+			      cpu->fpregs[id->rs2]);
+  return NEXT_PC;
+}
+
+SEM (sem_fsd)
+{
+  sim_core_write_unaligned_8 (cpu, pc, write_map, EA,
+			      cpu->fpregs[id->rs2]);
+  return NEXT_PC;
+}
+
+
+/* The decoder.  */
+
+/* Decode the OP-FP instruction INSN.  Return its semantic routine, or
+   NULL if INSN is not valid.  Set *INT_DEST if the destination is an
+   integer register.  */
+
+static riscv_sem_fn *
+decode_op_fp (unsigned32 insn, int *int_dest)
+{
+  int funct3 = FUNCT3 (insn);
+  int rs2 = FIELD_RS2 (insn);
+
+  switch (FUNCT7 (insn))
+    {
+    case 0x00: return sem_fadd_s;
+    case 0x01: return sem_fadd_d;
+    case 0x04: return sem_fsub_s;
+    case 0x05: return sem_fsub_d;
+    case 0x08: return sem_fmul_s;
+    case 0x09: return sem_fmul_d;
+    case 0x0c: return sem_fdiv_s;
+    case 0x0d: return sem_fdiv_d;
+    case 0x2c: return rs2 == 0 ? sem_fsqrt_s : NULL;
+    case 0x2d: return rs2 == 0 ? sem_fsqrt_d : NULL;
+
+    case 0x10:
+      switch (funct3)
+	{
+	case 0: return sem_fsgnj_s;
+	case 1: return sem_fsgnjn_s;
+	case 2: return sem_fsgnjx_s;
+	}
+      return NULL;
+    case 0x11:
+      switch (funct3)
+	{
+	case 0: return sem_fsgnj_d;
+	case 1: return sem_fsgnjn_d;
+	case 2: return sem_fsgnjx_d;
+	}
+      return NULL;
+
+    case 0x14:
+      switch (funct3)
+	{
+	case 0: return sem_fmin_s;
+	case 1: return sem_fmax_s;
+	}
+      return NULL;
+    case 0x15:
+      switch (funct3)
+	{
+	case 0: return sem_fmin_d;
+	case 1: return sem_fmax_d;
+	}
+      return NULL;
+
+    case 0x20: return rs2 == 1 ? sem_fcvt_s_d : NULL;
+    case 0x21: return rs2 == 0 ? sem_fcvt_d_s : NULL;
+
+    case 0x50:
+      *int_dest = 1;
+      switch (funct3)
+	{
+	case 0: return sem_fle_s;
+	case 1: return sem_flt_s;
+	case 2: return sem_feq_s;
+	}
+      return NULL;
+    case 0x51:
+      *int_dest = 1;
+      switch (funct3)
+	{
+	case 0: return sem_fle_d;
+	case 1: return sem_flt_d;
+	case 2: return sem_feq_d;
+	}
+      return NULL;
+
+    case 0x60:
+      *int_dest = 1;
+      switch (rs2)
+	{
+	case 0: return sem_fcvt_w_s;
+	case 1: return sem_fcvt_wu_s;
+	case 2: return sem_fcvt_l_s;
+	case 3: return sem_fcvt_lu_s;
+	}
+      return NULL;
+    case 0x61:
+      *int_dest = 1;
+      switch (rs2)
+	{
+	case 0: return sem_fcvt_w_d;
+	case 1: return sem_fcvt_wu_d;
+	case 2: return sem_fcvt_l_d;
+	case 3: return sem_fcvt_lu_d;
+	}
+      return NULL;
+
+    case 0x68:
+      switch (rs2)
+	{
+	case 0: return sem_fcvt_s_w;
+	case 1: return sem_fcvt_s_wu;
+	case 2: return sem_fcvt_s_l;
+	case 3: return sem_fcvt_s_lu;
+	}
+      return NULL;
+    case 0x69:
+      switch (rs2)
+	{
+	case 0: return sem_fcvt_d_w;
+	case 1: return sem_fcvt_d_wu;
+	case 2: return sem_fcvt_d_l;
+	case 3: return sem_fcvt_d_lu;
+	}
+      return NULL;
+
+    case 0x70:
+      *int_dest = 1;
+      if (rs2 != 0)
+	return NULL;
+      switch (funct3)
+	{
+	case 0: return sem_fmv_x_s;
+	case 1: return sem_fclass_s;
+	}
+      return NULL;
+    case 0x71:
+      *int_dest = 1;
+      if (rs2 != 0)
+	return NULL;
+      switch (funct3)
+	{
+	case 0: return sem_fmv_x_d;
+	case 1: return sem_fclass_d;
+	}
+      return NULL;
+
+    case 0x78: return rs2 == 0 && funct3 == 0 ? sem_fmv_s_x : NULL;
+    case 0x79: return rs2 == 0 && funct3 == 0 ? sem_fmv_d_x : NULL;
+    }
+
+  return NULL;
+}
+
+/* Decode the AMO instruction INSN.  */
+
+static riscv_sem_fn *
+decode_amo (unsigned32 insn)
+{
+  static riscv_sem_fn * const amo_w[32] = {
+    [0x00] = sem_amoadd_w, [0x01] = sem_amoswap_w, [0x02] = sem_lr_w,
+    [0x03] = sem_sc_w, [0x04] = sem_amoxor_w, [0x08] = sem_amoor_w,
+    [0x0c] = sem_amoand_w, [0x10] = sem_amomin_w, [0x14] = sem_amomax_w,
+    [0x18] = sem_amominu_w, [0x1c] = sem_amomaxu_w
+  };
+  static riscv_sem_fn * const amo_d[32] = {
+    [0x00] = sem_amoadd_d, [0x01] = sem_amoswap_d, [0x02] = sem_lr_d,
+    [0x03] = sem_sc_d, [0x04] = sem_amoxor_d, [0x08] = sem_amoor_d,
+    [0x0c] = sem_amoand_d, [0x10] = sem_amomin_d, [0x14] = sem_amomax_d,
+    [0x18] = sem_amominu_d, [0x1c] = sem_amomaxu_d
+  };
+  int funct5 = insn >> 27;
+
+  if (funct5 == 0x02 && FIELD_RS2 (insn) != 0)
+    return NULL;
+
+  switch (FUNCT3 (insn))
+    {
+    case 2: return amo_w[funct5];
+    case 3: return amo_d[funct5];
+    }
+  return NULL;
+}
+
+/* Decode INSN, found at PC, into ID.  */
+
+static void
+decode (unsigned32 insn, address_word pc, struct riscv_idesc *id)
+{
+  riscv_sem_fn *sem = NULL;
+  int funct3 = FUNCT3 (insn);
+  int funct7 = FUNCT7 (insn);
+  /* Whether the destination is an integer register.  */
+  int int_dest = 1;
+
+  id->rd = FIELD_RD (insn);
+  id->rs1 = FIELD_RS1 (insn);
+  id->rs2 = FIELD_RS2 (insn);
+  id->rs3 = FIELD_RS3 (insn);
+  id->rm = funct3;
+  id->imm = 0;
+
+  switch (OPCODE (insn))
+    {
+    case 0x37:			/* LUI */
+      id->imm = IMM_U (insn);
+      sem = sem_lui;
+      break;
+
+    case 0x17:			/* AUIPC */
+      id->imm = IMM_U (insn);
+      sem = sem_auipc;
+      break;
+
+    case 0x6f:			/* JAL */
+      id->imm = IMM_J (insn);
+      sem = sem_jal;
+      break;
+
+    case 0x67:			/* JALR */
+      id->imm = IMM_I (insn);
+      if (funct3 == 0)
+	sem = sem_jalr;
+      break;
+
+    case 0x63:			/* BRANCH */
+      id->imm = IMM_B (insn);
+      switch (funct3)
+	{
+	case 0: sem = sem_beq; break;
+	case 1: sem = sem_bne; break;
+	case 4: sem = sem_blt; break;
+	case 5: sem = sem_bge; break;
+	case 6: sem = sem_bltu; break;
+	case 7: sem = sem_bgeu; break;
+	}
+      break;
+
+    case 0x03:			/* LOAD */
+      id->imm = IMM_I (insn);
+      switch (funct3)
+	{
+	case 0: sem = sem_lb; break;
+	case 1: sem = sem_lh; break;
+	case 2: sem = sem_lw; break;
+	case 3: sem = sem_ld; break;
+	case 4: sem = sem_lbu; break;
+	case 5: sem = sem_lhu; break;
+	case 6: sem = sem_lwu; break;
+	}
+      break;
+
+    case 0x23:			/* STORE */
+      id->imm = IMM_S (insn);
+      switch (funct3)
+	{
+	case 0: sem = sem_sb; break;
+	case 1: sem = sem_sh; break;
+	case 2: sem = sem_sw; break;
+	case 3: sem = sem_sd; break;
+	}
+      break;
+
+    case 0x13:			/* OP-IMM */
+      id->imm = IMM_I (insn);
+      switch (funct3)
+	{
+	case 0: sem = sem_addi; break;
+	case 2: sem = sem_slti; break;
+	case 3: sem = sem_sltiu; break;
+	case 4: sem = sem_xori; break;
+	case 6: sem = sem_ori; break;
+	case 7: sem = sem_andi; break;
+	case 1:
+	  id->imm &= 63;
+	  if ((insn >> 26) == 0)
+	    sem = sem_slli;
+	  break;
+	case 5:
+	  id->imm &= 63;
+	  if ((insn >> 26) == 0)
+	    sem = sem_srli;
+	  else if ((insn >> 26) == 0x10)
+	    sem = sem_srai;
+	  break;
+	}
+      break;
+
+    case 0x1b:			/* OP-IMM-32 */
+      id->imm = IMM_I (insn);
+      switch (funct3)
+	{
+	case 0: sem = sem_addiw; break;
+	case 1:
+	  id->imm &= 31;
+	  if (funct7 == 0)
+	    sem = sem_slliw;
+	  break;
+	case 5:
+	  id->imm &= 31;
+	  if (funct7 == 0)
+	    sem = sem_srliw;
+	  else if (funct7 == 0x20)
+	    sem = sem_sraiw;
+	  break;
+	}
+      break;
+
+    case 0x33:			/* OP */
+      switch ((funct7 << 3) | funct3)
+	{
+	case 0x000: sem = sem_add; break;
+	case 0x100: sem = sem_sub; break;
+	case 0x001: sem = sem_sll; break;
+	case 0x002: sem = sem_slt; break;
+	case 0x003: sem = sem_sltu; break;
+	case 0x004: sem = sem_xor; break;
+	case 0x005: sem = sem_srl; break;
+	case 0x105: sem = sem_sra; break;
+	case 0x006: sem = sem_or; break;
+	case 0x007: sem = sem_and; break;
+	case 0x008: sem = sem_mul; break;
+	case 0x009: sem = sem_mulh; break;
+	case 0x00a: sem = sem_mulhsu; break;
+	case 0x00b: sem = sem_mulhu; break;
+	case 0x00c: sem = sem_div; break;
+	case 0x00d: sem = sem_divu; break;
+	case 0x00e: sem = sem_rem; break;
+	case 0x00f: sem = sem_remu; break;
+	}
+      break;
+
+    case 0x3b:			/* OP-32 */
+      switch ((funct7 << 3) | funct3)
+	{
+	case 0x000: sem = sem_addw; break;
+	case 0x100: sem = sem_subw; break;
+	case 0x001: sem = sem_sllw; break;
+	case 0x005: sem = sem_srlw; break;
+	case 0x105: sem = sem_sraw; break;
+	case 0x008: sem = sem_mulw; break;
+	case 0x00c: sem = sem_divw; break;
+	case 0x00d: sem = sem_divuw; break;
+	case 0x00e: sem = sem_remw; break;
+	case 0x00f: sem = sem_remuw; break;
+	}
+      break;
+
+    case 0x0f:			/* MISC-MEM */
+      if (funct3 == 0)
+	sem = sem_fence;
+      else if (funct3 == 1)
+	sem = sem_fence_i;
+      break;
+
+    case 0x73:			/* SYSTEM */
+      id->imm = (insn >> 20) & 0xfff;
+      switch (funct3)
+	{
+	case 0:
+	  if ((insn & ~0x00100000) == 0x73)
+	    sem = (insn & 0x00100000) ? sem_sbreak : sem_scall;
+	  break;
+	case 1: sem = sem_csrrw; break;
+	case 2: sem = sem_csrrs; break;
+	case 3: sem = sem_csrrc; break;
+	case 5: sem = sem_csrrwi; break;
+	case 6: sem = sem_csrrsi; break;
+	case 7: sem = sem_csrrci; break;
+	}
+      break;
+
+    case 0x2f:			/* AMO */
+      sem = decode_amo (insn);
+      break;
+
+    case 0x07:			/* LOAD-FP */
+      int_dest = 0;
+      id->imm = IMM_I (insn);
+      if (funct3 == 2)
+	sem = sem_flw;
+      else if (funct3 == 3)
+	sem = sem_fld;
+      break;
+
+    case 0x27:			/* STORE-FP */
+      id->imm = IMM_S (insn);
+      if (funct3 == 2)
+	sem = sem_fsw;
+      else if (funct3 == 3)
+	sem = sem_fsd;
+      break;
+
+    case 0x43:			/* FMADD */
+    case 0x47:			/* FMSUB */
+    case 0x4b:			/* FNMSUB */
+    case 0x4f:			/* FNMADD */
+      {
+	static riscv_sem_fn * const fused[2][4] = {
+	  { sem_fmadd_s, sem_fmsub_s, sem_fnmsub_s, sem_fnmadd_s },
+	  { sem_fmadd_d, sem_fmsub_d, sem_fnmsub_d, sem_fnmadd_d }
+	};
+	int fmt = (insn >> 25) & 3;
+
+	int_dest = 0;
+	if (fmt < 2)
+	  sem = fused[fmt][(OPCODE (insn) >> 2) & 3];
+      }
+      break;
+
+    case 0x53:			/* OP-FP */
+      int_dest = 0;
+      sem = decode_op_fp (insn, &int_dest);
+      break;
+    }
+
+  if (sem == NULL)
+    sem = sem_illegal;
+  if (int_dest && id->rd == 0)
+    id->rd = RISCV_SINK_REGNUM;
+  id->sem = sem;
+  id->pc = pc;
+}
+
+void
+sim_engine_run (SIM_DESC sd,
+		int next_cpu_nr, /* ignore */
+		int nr_cpus, /* ignore */
+		int siggnal) /* ignore */
+{
+  sim_cpu *cpu;
+  address_word pc;
+
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+  cpu = STATE_CPU (sd, 0);
+  pc = CIA_GET (cpu);
+
+  while (1)
+    {
+      struct riscv_idesc *id
+	= &cpu->icache[(pc >> 2) & (cpu->icache_size - 1)];
+
+      if (id->pc != pc)
+	{
+	  if (pc & 3)
+	    misaligned (cpu, pc);
+	  decode (sim_core_read_aligned_4 (cpu, pc, exec_map, pc), pc, id);
+	  cpu->icache_misses++;
+	}
+      else
+	cpu->icache_hits++;
+
+      pc = (*id->sem) (cpu, id, pc);
+      cpu->instret++;
+
+      /* Process any events.  */
+      if (sim_events_tick (sd))
+	{
+	  CIA_SET (cpu, pc);
+	  sim_events_process (sd);
+	}
+    }
+}
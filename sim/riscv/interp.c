@@ -0,0 +1,594 @@
+/* RISC-V simulator: interface to GDB and to the host.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "config.h"
+#include "sim-main.h"
+#include "sim-options.h"
+#include "sim-assert.h"
+#include "libiberty.h"
+#include "gdb/callback.h"
+#include "gdb/remote-sim.h"
+#include "gdb/sim-riscv.h"
+
+#include <errno.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#ifdef HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif
+
+/* System call numbers.  The number is passed in v0, the arguments in
+   a0 through a3, and the result is returned in v0, negated if it is
+   an error number.  */
+#define RISCV_SYS_exit		93
+#define RISCV_SYS_exit_group	94
+#define RISCV_SYS_getpid	172
+#define RISCV_SYS_kill		129
+#define RISCV_SYS_read		63
+#define RISCV_SYS_write		64
+#define RISCV_SYS_open		1024
+#define RISCV_SYS_close		57
+#define RISCV_SYS_lseek		62
+#define RISCV_SYS_brk		214
+#define RISCV_SYS_unlink	1026
+#define RISCV_SYS_chdir		49
+#define RISCV_SYS_fstat		80
+#define RISCV_SYS_stat		1038
+#define RISCV_SYS_lstat		1039
+#define RISCV_SYS_time		1062
+#define RISCV_SYS_gettimeofday	169
+
+static CB_TARGET_DEFS_MAP riscv_syscall_map[] =
+{
+  { CB_SYS_exit, RISCV_SYS_exit },
+  { CB_SYS_getpid, RISCV_SYS_getpid },
+  { CB_SYS_kill, RISCV_SYS_kill },
+  { CB_SYS_read, RISCV_SYS_read },
+  { CB_SYS_write, RISCV_SYS_write },
+  { CB_SYS_open, RISCV_SYS_open },
+  { CB_SYS_close, RISCV_SYS_close },
+  { CB_SYS_lseek, RISCV_SYS_lseek },
+  { CB_SYS_unlink, RISCV_SYS_unlink },
+  { CB_SYS_chdir, RISCV_SYS_chdir },
+  { CB_SYS_fstat, RISCV_SYS_fstat },
+  { CB_SYS_stat, RISCV_SYS_stat },
+  { CB_SYS_lstat, RISCV_SYS_lstat },
+  { CB_SYS_time, RISCV_SYS_time },
+  { 0, -1 }
+};
+
+/* The layout of struct stat for newlib on RV64.  */
+static const char riscv_stat_map[] =
+  "st_dev,8:st_ino,8:st_mode,4:st_nlink,4:st_uid,4:st_gid,4:st_rdev,8:"
+  "space,8:st_size,8:st_blksize,4:space,4:st_blocks,8:st_atime,8:space,8:"
+  "st_mtime,8:space,8:st_ctime,8:space,8:space,8";
+
+static int
+syscall_read_mem (host_callback *cb, struct cb_syscall *sc,
+		  unsigned long taddr, char *buf, int bytes)
+{
+  SIM_DESC sd = (SIM_DESC) sc->p1;
+  sim_cpu *cpu = (sim_cpu *) sc->p2;
+
+  return sim_core_read_buffer (sd, cpu, read_map, buf, taddr, bytes);
+}
+
+static int
+syscall_write_mem (host_callback *cb, struct cb_syscall *sc,
+		   unsigned long taddr, const char *buf, int bytes)
+{
+  SIM_DESC sd = (SIM_DESC) sc->p1;
+  sim_cpu *cpu = (sim_cpu *) sc->p2;
+
+  return sim_core_write_buffer (sd, cpu, write_map, buf, taddr, bytes);
+}
+
+/* Execute the system call requested by the SCALL instruction at PC.
+   Return the address of the next instruction.  */
+
+address_word
+riscv_syscall (sim_cpu *cpu, address_word pc)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  host_callback *cb = STATE_CALLBACK (sd);
+  unsigned64 func = cpu->regs[RISCV_V0_REGNUM];
+  unsigned64 *args = &cpu->regs[RISCV_A0_REGNUM];
+  CB_SYSCALL s;
+
+  switch (func)
+    {
+    case RISCV_SYS_exit:
+    case RISCV_SYS_exit_group:
+      sim_engine_halt (sd, cpu, NULL, pc, sim_exited, (int) args[0]);
+      break;
+
+    case RISCV_SYS_brk:
+      /* All of memory is mapped; only keep track of the break.  */
+      if (args[0] != 0)
+	cpu->brk = args[0];
+      cpu->regs[RISCV_V0_REGNUM] = cpu->brk;
+      return pc + 4;
+
+    case RISCV_SYS_gettimeofday:
+      {
+	unsigned char buf[16];
+	struct timeval tv;
+	int i;
+
+	gettimeofday (&tv, NULL);
+	for (i = 0; i < 8; i++)
+	  {
+	    buf[i] = (unsigned64) tv.tv_sec >> (i * 8);
+	    buf[i + 8] = (unsigned64) tv.tv_usec >> (i * 8);
+	  }
+	if (args[0] != 0
+	    && sim_core_write_buffer (sd, cpu, write_map, buf, args[0],
+				      sizeof buf) != sizeof buf)
+	  cpu->regs[RISCV_V0_REGNUM] = -cb_host_to_target_errno (cb, EFAULT);
+	else
+	  cpu->regs[RISCV_V0_REGNUM] = 0;
+	return pc + 4;
+      }
+    }
+
+  CB_SYSCALL_INIT (&s);
+  s.func = func;
+  s.arg1 = args[0];
+  s.arg2 = args[1];
+  s.arg3 = args[2];
+  s.arg4 = args[3];
+  s.p1 = (PTR) sd;
+  s.p2 = (PTR) cpu;
+  s.read_mem = syscall_read_mem;
+  s.write_mem = syscall_write_mem;
+  cb_syscall (cb, &s);
+
+  if (s.errcode != 0)
+    cpu->regs[RISCV_V0_REGNUM] = -(signed64) s.errcode;
+  else
+    cpu->regs[RISCV_V0_REGNUM] = s.result;
+  return pc + 4;
+}
+
+
+/* Register access.  Registers are transferred in target (little
+   endian) byte order.  */
+
+static int
+put_reg (unsigned char *buf, int length, unsigned64 value, int size)
+{
+  int i;
+
+  if (length != size)
+    return size;
+  for (i = 0; i < size; i++)
+    buf[i] = value >> (i * 8);
+  return size;
+}
+
+static int
+get_reg (const unsigned char *buf, int length, unsigned64 *value, int size)
+{
+  int i;
+
+  if (length != size)
+    return 0;
+  *value = 0;
+  for (i = size - 1; i >= 0; i--)
+    *value = (*value << 8) | buf[i];
+  return 1;
+}
+
+int
+sim_fetch_register (SIM_DESC sd, int rn, unsigned char *buf, int length)
+{
+  sim_cpu *cpu = STATE_CPU (sd, 0);
+
+  if (rn >= sim_riscv_x0_regnum && rn <= sim_riscv_x31_regnum)
+    return put_reg (buf, length,
+		    rn == sim_riscv_x0_regnum ? 0 : cpu->regs[rn], 8);
+  if (rn >= sim_riscv_f0_regnum && rn <= sim_riscv_f31_regnum)
+    return put_reg (buf, length, cpu->fpregs[rn - sim_riscv_f0_regnum], 8);
+
+  switch (rn)
+    {
+    case sim_riscv_pc_regnum:
+      return put_reg (buf, length, cpu->pc, 8);
+    case sim_riscv_fcsr_regnum:
+      return put_reg (buf, length, (cpu->frm << 5) | cpu->fflags, 4);
+    case sim_riscv_fflags_regnum:
+      return put_reg (buf, length, cpu->fflags, 4);
+    case sim_riscv_frm_regnum:
+      return put_reg (buf, length, cpu->frm, 4);
+    case sim_riscv_cycle_regnum:
+    case sim_riscv_time_regnum:
+    case sim_riscv_instret_regnum:
+      return put_reg (buf, length, cpu->instret, 8);
+    }
+
+  return 0;
+}
+
+int
+sim_store_register (SIM_DESC sd, int rn, unsigned char *buf, int length)
+{
+  sim_cpu *cpu = STATE_CPU (sd, 0);
+  unsigned64 value;
+
+  if (rn >= sim_riscv_x0_regnum && rn <= sim_riscv_x31_regnum)
+    {
+      if (!get_reg (buf, length, &value, 8))
+	return 8;
+      if (rn != sim_riscv_x0_regnum)
+	cpu->regs[rn] = value;
+      return 8;
+    }
+  if (rn >= sim_riscv_f0_regnum && rn <= sim_riscv_f31_regnum)
+    {
+      if (get_reg (buf, length, &value, 8))
+	cpu->fpregs[rn - sim_riscv_f0_regnum] = value;
+      return 8;
+    }
+
+  switch (rn)
+    {
+    case sim_riscv_pc_regnum:
+      if (get_reg (buf, length, &value, 8))
+	cpu->pc = value;
+      return 8;
+    case sim_riscv_fcsr_regnum:
+      if (get_reg (buf, length, &value, 4))
+	{
+	  cpu->fflags = value & 0x1f;
+	  cpu->frm = (value >> 5) & 0x7;
+	}
+      return 4;
+    case sim_riscv_fflags_regnum:
+      if (get_reg (buf, length, &value, 4))
+	cpu->fflags = value & 0x1f;
+      return 4;
+    case sim_riscv_frm_regnum:
+      if (get_reg (buf, length, &value, 4))
+	cpu->frm = value & 0x7;
+      return 4;
+    case sim_riscv_cycle_regnum:
+    case sim_riscv_time_regnum:
+    case sim_riscv_instret_regnum:
+      if (get_reg (buf, length, &value, 8))
+	cpu->instret = value;
+      return 8;
+    }
+
+  return 0;
+}
+
+static sim_cia
+riscv_pc_get (sim_cpu *cpu)
+{
+  return cpu->pc;
+}
+
+static void
+riscv_pc_set (sim_cpu *cpu, sim_cia pc)
+{
+  cpu->pc = pc;
+}
+
+
+/* Memory access from GDB.  Writes have to drop the decoded copies of
+   the instructions they overwrite; this is also how breakpoints get
+   inserted and programs loaded.  */
+
+int
+sim_read (SIM_DESC sd, SIM_ADDR mem, unsigned char *buf, int length)
+{
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+  return sim_core_read_buffer (sd, NULL, read_map, buf, mem, length);
+}
+
+int
+sim_write (SIM_DESC sd, SIM_ADDR mem, const unsigned char *buf, int length)
+{
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+  riscv_icache_invalidate (STATE_CPU (sd, 0), mem, length);
+  return sim_core_write_buffer (sd, NULL, write_map, buf, mem, length);
+}
+
+
+/* Simulator options.  */
+
+enum {
+  OPTION_ICACHE_SIZE = OPTION_START
+};
+
+static DECLARE_OPTION_HANDLER (riscv_option_handler);
+
+static const OPTION riscv_options[] =
+{
+  { {"icache-size", required_argument, NULL, OPTION_ICACHE_SIZE},
+      '\0', "SIZE", "Set the number of entries of the decoded-instruction cache",
+      riscv_option_handler },
+  { {NULL, no_argument, NULL, 0}, '\0', NULL, NULL, NULL }
+};
+
+static SIM_RC
+riscv_option_handler (SIM_DESC sd, sim_cpu *cpu, int opt, char *arg,
+		      int is_command)
+{
+  switch (opt)
+    {
+    case OPTION_ICACHE_SIZE:
+      {
+	unsigned long n = strtoul (arg, NULL, 0);
+	unsigned int size;
+
+	if (n < 1 || n > 0x1000000)
+	  {
+	    sim_io_eprintf (sd, "Invalid icache size `%s'\n", arg);
+	    return SIM_RC_FAIL;
+	  }
+	/* Round up to a power of two.  */
+	for (size = 1; size < n; size <<= 1)
+	  ;
+	return riscv_icache_resize (STATE_CPU (sd, 0), size);
+      }
+    }
+
+  return SIM_RC_OK;
+}
+
+static void
+riscv_info (SIM_DESC sd, int verbose)
+{
+  sim_cpu *cpu = STATE_CPU (sd, 0);
+  unsigned64 lookups = cpu->icache_hits + cpu->icache_misses;
+  char buf[20];
+
+  sim_io_printf (sd, "Instructions executed: %s\n",
+		 sim_add_commas (buf, sizeof (buf), cpu->instret));
+  sim_io_printf (sd, "Decoded-instruction cache: %u entries\n",
+		 cpu->icache_size);
+  if (lookups != 0)
+    {
+      sim_io_printf (sd, "  hits:    %s",
+		     sim_add_commas (buf, sizeof (buf), cpu->icache_hits));
+      sim_io_printf (sd, " (%.2f%%)\n", 100.0 * cpu->icache_hits / lookups);
+      sim_io_printf (sd, "  misses:  %s\n",
+		     sim_add_commas (buf, sizeof (buf), cpu->icache_misses));
+      sim_io_printf (sd, "  flushes: %s\n",
+		     sim_add_commas (buf, sizeof (buf), cpu->icache_flushes));
+    }
+}
+
+
+/* Cover function of sim_state_free to free the cpu buffers as well.  */
+
+static void
+free_state (SIM_DESC sd)
+{
+  sim_cpu *cpu = STATE_CPU (sd, 0);
+
+  if (STATE_MODULES (sd) != NULL)
+    sim_module_uninstall (sd);
+  if (cpu != NULL && cpu->icache != NULL)
+    free (cpu->icache);
+  sim_cpu_free_all (sd);
+  sim_state_free (sd);
+}
+
+/* Create an instance of the simulator.  */
+
+SIM_DESC
+sim_open (SIM_OPEN_KIND kind, host_callback *callback, struct bfd *abfd,
+	  char **argv)
+{
+  SIM_DESC sd = sim_state_alloc (kind, callback);
+  sim_cpu *cpu;
+  char c;
+
+  SIM_ASSERT (STATE_MAGIC (sd) == SIM_MAGIC_NUMBER);
+
+  /* The cpu data is kept in a separately allocated chunk of memory.  */
+  if (sim_cpu_alloc_all (sd, 1, 0) != SIM_RC_OK)
+    {
+      free_state (sd);
+      return 0;
+    }
+  cpu = STATE_CPU (sd, 0);
+
+  if (sim_pre_argv_init (sd, argv[0]) != SIM_RC_OK)
+    {
+      free_state (sd);
+      return 0;
+    }
+  sim_add_option_table (sd, NULL, riscv_options);
+  sim_module_add_info_fn (sd, riscv_info);
+
+  /* getopt will print the error message so we just have to exit if this fails.
+     FIXME: Hmmm...  in the case of gdb we need getopt to call
+     print_filtered.  */
+  if (sim_parse_args (sd, argv) != SIM_RC_OK)
+    {
+      free_state (sd);
+      return 0;
+    }
+
+  if (cpu->icache == NULL)
+    riscv_icache_resize (cpu, RISCV_DEFAULT_ICACHE_SIZE);
+
+  /* Allocate core managed memory if none specified by user.  */
+  if (sim_core_read_buffer (sd, NULL, read_map, &c, 0, 1) == 0)
+    sim_do_commandf (sd, "memory region 0,0x%x", RISCV_DEFAULT_MEM_SIZE);
+
+  /* check for/establish the reference program image.  */
+  if (sim_analyze_program (sd,
+			   (STATE_PROG_ARGV (sd) != NULL
+			    ? *STATE_PROG_ARGV (sd)
+			    : NULL), abfd) != SIM_RC_OK)
+    {
+      free_state (sd);
+      return 0;
+    }
+
+  /* Establish any remaining configuration options.  */
+  if (sim_config (sd) != SIM_RC_OK)
+    {
+      free_state (sd);
+      return 0;
+    }
+
+  if (sim_post_argv_init (sd) != SIM_RC_OK)
+    {
+      free_state (sd);
+      return 0;
+    }
+
+  CPU_PC_FETCH (cpu) = riscv_pc_get;
+  CPU_PC_STORE (cpu) = riscv_pc_set;
+
+  /* Newlib's syscall numbers differ from the simulator's defaults.  */
+  callback->syscall_map = riscv_syscall_map;
+  callback->stat_map = riscv_stat_map;
+
+  return sd;
+}
+
+void
+sim_close (SIM_DESC sd, int quitting)
+{
+  sim_cpu *cpu = STATE_CPU (sd, 0);
+
+  sim_module_uninstall (sd);
+  free (cpu->icache);
+  cpu->icache = NULL;
+}
+
+/* Store the LENGTH bytes of BUF at ADDR, with no regard for the
+   memory maps since nothing has run yet.  Return the address past
+   the data.  */
+
+static address_word
+push_bytes (SIM_DESC sd, address_word addr, const void *buf, int length)
+{
+  sim_core_write_buffer (sd, NULL, write_map, buf, addr, length);
+  return addr + length;
+}
+
+static address_word
+push_word (SIM_DESC sd, address_word addr, unsigned64 value)
+{
+  unsigned char buf[8];
+
+  put_reg (buf, 8, value, 8);
+  return push_bytes (sd, addr, buf, 8);
+}
+
+/* Return the address just past the memory region that contains ADDR,
+   or, if no region does, past the highest one.  The memory map is the
+   default one, or whatever the user set up with "memory region" or
+   --memory-size.  */
+
+static address_word
+memory_top (SIM_DESC sd, address_word addr)
+{
+  sim_core_mapping *mapping;
+  address_word top = 0;
+
+  for (mapping = STATE_CORE (sd)->common.map[read_map].first;
+       mapping != NULL;
+       mapping = mapping->next)
+    {
+      /* Only plain memory will do for a stack.  */
+      if (mapping->buffer == NULL)
+	continue;
+
+      if (addr >= mapping->base && addr <= mapping->bound)
+	return mapping->bound + 1;
+
+      if (mapping->bound + 1 > top)
+	top = mapping->bound + 1;
+    }
+
+  return top;
+}
+
+SIM_RC
+sim_create_inferior (SIM_DESC sd, struct bfd *abfd, char **argv, char **envp)
+{
+  sim_cpu *cpu = STATE_CPU (sd, 0);
+  address_word sp, strings, ptrs;
+  int argc, i;
+  size_t len;
+
+  memset (cpu->regs, 0, sizeof (cpu->regs));
+  memset (cpu->fpregs, 0, sizeof (cpu->fpregs));
+  cpu->fflags = 0;
+  cpu->frm = 0;
+  cpu->reservation = INVALID_INSTRUCTION_ADDRESS;
+  cpu->pc = abfd != NULL ? bfd_get_start_address (abfd) : 0;
+
+  /* The program break starts past the highest allocated section.  */
+  cpu->brk = 0;
+  if (abfd != NULL)
+    {
+      asection *s;
+
+      for (s = abfd->sections; s != NULL; s = s->next)
+	if ((bfd_get_section_flags (abfd, s) & SEC_ALLOC)
+	    && (bfd_get_section_vma (abfd, s) + bfd_get_section_size (s)
+		> cpu->brk))
+	  cpu->brk = bfd_get_section_vma (abfd, s) + bfd_get_section_size (s);
+    }
+
+  /* Lay out the arguments at the top of the memory holding the
+     program: argc at the stack pointer, then the argv pointers, a null
+     pointer, and an empty environment, followed by the strings
+     themselves.  */
+  argc = 0;
+  len = 0;
+  if (argv != NULL)
+    for (; argv[argc] != NULL; argc++)
+      len += strlen (argv[argc]) + 1;
+
+  strings = memory_top (sd, cpu->pc) - ((len + 15) & ~(size_t) 15);
+  sp = (strings - (argc + 3) * 8) & ~(address_word) 15;
+
+  ptrs = push_word (sd, sp, argc);
+  for (i = 0; i < argc; i++)
+    {
+      ptrs = push_word (sd, ptrs, strings);
+      strings = push_bytes (sd, strings, argv[i], strlen (argv[i]) + 1);
+    }
+  ptrs = push_word (sd, ptrs, 0);
+  push_word (sd, ptrs, 0);
+
+  cpu->regs[RISCV_SP_REGNUM] = sp;
+  cpu->regs[RISCV_A0_REGNUM] = argc;
+  cpu->regs[RISCV_A0_REGNUM + 1] = sp + 8;
+
+  riscv_icache_flush (cpu);
+  return SIM_RC_OK;
+}
+
+void
+sim_do_command (SIM_DESC sd, char *cmd)
+{
+  if (sim_args_command (sd, cmd) != SIM_RC_OK)
+    sim_io_eprintf (sd, "Unknown command `%s'\n", cmd);
+}
@@ -0,0 +1,138 @@
+/* RISC-V simulator definitions.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+This file is part of GDB, the GNU debugger.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef SIM_MAIN_H
+#define SIM_MAIN_H
+
+#include "sim-basics.h"
+
+typedef address_word sim_cia;
+
+#include "sim-base.h"
+#include "bfd.h"
+
+/* Memory given to the program if the user doesn't ask for something
+   else.  The initial stack pointer is at the top of whichever region
+   holds the program.  */
+#define RISCV_DEFAULT_MEM_SIZE 0x10000000
+
+/* Default number of entries in the decoded-instruction cache.  */
+#define RISCV_DEFAULT_ICACHE_SIZE 16384
+
+/* Registers with a special role in the simulator, numbered as in the
+   instruction encoding.  */
+#define RISCV_SP_REGNUM 14
+#define RISCV_V0_REGNUM 16
+#define RISCV_A0_REGNUM 18
+
+/* Bits of the fflags CSR.  */
+#define RISCV_FFLAG_NX 0x01
+#define RISCV_FFLAG_UF 0x02
+#define RISCV_FFLAG_OF 0x04
+#define RISCV_FFLAG_DZ 0x08
+#define RISCV_FFLAG_NV 0x10
+
+struct riscv_idesc;
+
+/* Execute the decoded instruction IDESC found at PC, and return the
+   address of the next instruction.  */
+typedef address_word (riscv_sem_fn) (sim_cpu *cpu,
+				     const struct riscv_idesc *idesc,
+				     address_word pc);
+
+/* An entry of the decoded-instruction cache.  Instructions are decoded
+   once into their semantic routine and operands, and the cache is
+   indexed by PC, much like the CGEN scache.  Writing to a destination
+   of x0 is redirected to a scratch register, so that the semantic
+   routines need not check for it.  */
+struct riscv_idesc
+{
+  /* Address of the instruction, or INVALID_INSTRUCTION_ADDRESS if the
+     entry is empty.  */
+  address_word pc;
+  riscv_sem_fn *sem;
+  unsigned char rd, rs1, rs2, rs3;
+  /* Rounding mode of floating-point instructions.  */
+  unsigned char rm;
+  /* Immediate operand, sign-extended; the CSR number for CSR
+     instructions.  */
+  signed64 imm;
+};
+
+/* Index of the scratch register that absorbs writes to x0.  */
+#define RISCV_SINK_REGNUM 32
+
+struct _sim_cpu {
+
+  /* The integer registers, plus the scratch register.  */
+  unsigned64 regs[33];
+
+  /* The floating-point registers, as raw bits.  Single-precision
+     values are kept NaN-boxed in the low half.  */
+  unsigned64 fpregs[32];
+
+  address_word pc;
+  unsigned32 fflags;
+  unsigned32 frm;
+
+  /* Number of instructions retired; also used as the cycle count.  */
+  unsigned64 instret;
+
+  /* Address reserved by the last LR instruction, or -1.  */
+  address_word reservation;
+
+  /* The program break, for the brk system call.  */
+  address_word brk;
+
+  /* The decoded-instruction cache, ICACHE_SIZE entries.  */
+  struct riscv_idesc *icache;
+  unsigned int icache_size;
+
+  /* Cache statistics, reported by sim_info.  */
+  unsigned64 icache_hits;
+  unsigned64 icache_misses;
+  unsigned64 icache_flushes;
+
+  sim_cpu_base base;
+};
+
+#define CIA_GET(cpu)		((cpu)->pc)
+#define CIA_SET(cpu, val)	((cpu)->pc = (val))
+
+struct sim_state {
+
+  sim_cpu *cpu[MAX_NR_PROCESSORS];
+#if (WITH_SMP)
+#define STATE_CPU(sd,n) ((sd)->cpu[n])
+#else
+#define STATE_CPU(sd,n) ((sd)->cpu[0])
+#endif
+
+  sim_state_base base;
+};
+
+/* In engine.c.  */
+extern void riscv_icache_flush (sim_cpu *cpu);
+extern void riscv_icache_invalidate (sim_cpu *cpu, address_word addr,
+				     int len);
+extern SIM_RC riscv_icache_resize (sim_cpu *cpu, unsigned int size);
+
+/* In interp.c.  */
+extern address_word riscv_syscall (sim_cpu *cpu, address_word pc);
+
+#endif
@@ -0,0 +1,71 @@
+# riscv testcase for integer computational instructions
+# mach: riscv
+
+	.include "testutils.inc"
+
+	start
+
+	li x1, 0x1234
+	addi x2, x1, -0x234
+	test_h_gr x2, 0x1000
+
+	li x1, -1
+	srli x2, x1, 60
+	test_h_gr x2, 0xf
+	srai x2, x1, 60
+	test_h_gr x2, -1
+	slli x2, x1, 63
+	test_h_gr x2, 0x8000000000000000
+
+	li x1, 0x7fffffff
+	addiw x2, x1, 1
+	test_h_gr x2, -0x80000000
+	addw x3, x1, x1
+	test_h_gr x3, -2
+	subw x3, x2, x1
+	test_h_gr x3, 1
+	sraiw x3, x2, 4
+	test_h_gr x3, -0x8000000
+	srliw x3, x2, 4
+	test_h_gr x3, 0x8000000
+
+	li x1, -5
+	li x2, 3
+	slt x3, x1, x2
+	test_h_gr x3, 1
+	sltu x3, x1, x2
+	test_h_gr x3, 0
+	sltiu x3, x2, -1
+	test_h_gr x3, 1
+	xor x3, x1, x2
+	test_h_gr x3, -8
+	or x3, x1, x2
+	test_h_gr x3, -5
+	and x3, x1, x2
+	test_h_gr x3, 3
+
+	lui x3, 0x80000
+	test_h_gr x3, 0xffffffff80000000
+
+	# Writes to x0 are discarded.
+	addi x0, x0, 1
+	test_h_gr x0, 0
+
+	# Branches and jumps.
+	li x1, 1
+	bltu x0, x1, 1f
+	fail
+1:	bge x0, x1, 9f
+	jal x5, 3f
+2:	j 9f
+3:	lla x6, 2b
+	bne x5, x6, 9f
+	lla x7, 4f
+	jalr x8, 0(x7)
+5:	j 9f
+4:	lla x9, 5b
+	bne x8, x9, 9f
+	j 8f
+9:	fail
+8:
+	pass
@@ -0,0 +1,47 @@
+# riscv testcase for the A extension
+# mach: riscv
+
+	.include "testutils.inc"
+
+	start
+
+	lla x1, word
+	li x2, 5
+	amoadd.w x3, x2, (x1)
+	test_h_gr x3, -1
+	lw x3, 0(x1)
+	test_h_gr x3, 4
+	li x2, -10
+	amomaxu.w x3, x2, (x1)
+	amomin.w x3, x2, (x1)
+	test_h_gr x3, -10
+	amoswap.w x3, x0, (x1)
+	test_h_gr x3, -10
+
+	lla x1, dword
+	li x2, 3
+	amoor.d x3, x2, (x1)
+	amoxor.d x3, x2, (x1)
+	test_h_gr x3, 0xf3
+	amoand.d x3, x0, (x1)
+	test_h_gr x3, 0xf0
+	ld x3, 0(x1)
+	test_h_gr x3, 0
+
+	# A store conditional succeeds only after a matching load reserved.
+	lr.d x3, (x1)
+	addi x3, x3, 9
+	sc.d x4, x3, (x1)
+	test_h_gr x4, 0
+	sc.d x4, x3, (x1)
+	test_h_gr x4, 1
+	ld x3, 0(x1)
+	test_h_gr x3, 9
+
+	pass
+
+	.data
+	.align 3
+word:	.word -1
+	.align 3
+dword:	.dword 0xf0
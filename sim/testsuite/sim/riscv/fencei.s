@@ -0,0 +1,29 @@
+# riscv testcase for fence.i and code modification
+# mach: riscv
+
+	.include "testutils.inc"
+
+	start
+
+	# Run the patched code once, so that it is in the decoded cache,
+	# then overwrite its first instruction.  FENCE.I makes the new
+	# instruction visible.
+	li x5, 0
+	jal x1, patch
+	test_h_gr x5, 1
+
+	lla x2, patch
+	lla x3, newinsn
+	lw x3, 0(x3)
+	sw x3, 0(x2)
+	fence.i
+	jal x1, patch
+	test_h_gr x5, 101
+
+	pass
+
+patch:
+	addi x5, x5, 1
+	jalr x0, 0(x1)
+newinsn:
+	addi x5, x5, 100
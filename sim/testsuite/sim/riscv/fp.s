@@ -0,0 +1,75 @@
+# riscv testcase for the F and D extensions
+# mach: riscv
+
+	.include "testutils.inc"
+
+	start
+
+	# 1.5 + 2.25 = 3.75
+	li x1, 0x3ff8000000000000
+	li x2, 0x4002000000000000
+	fmv.d.x f1, x1
+	fmv.d.x f2, x2
+	fadd.d f3, f1, f2
+	test_h_fr f3, 0x400e000000000000
+	fmul.d f4, f1, f2
+	fmadd.d f5, f1, f2, f3
+	fsub.d f5, f5, f4
+	feq.d x3, f5, f3
+	test_h_gr x3, 1
+	flt.d x3, f2, f1
+	test_h_gr x3, 0
+
+	# Single precision values are NaN-boxed.
+	li x1, 0x40400000
+	fmv.s.x f1, x1
+	test_h_fr f1, 0xffffffff40400000
+	fcvt.d.s f2, f1
+	test_h_fr f2, 0x4008000000000000
+	fsqrt.s f3, f1
+	fmul.s f3, f3, f3
+	fcvt.w.s x3, f3, rne
+	test_h_gr x3, 3
+
+	# Conversions round as told and saturate.
+	li x1, 0x4004000000000000
+	fmv.d.x f1, x1
+	fcvt.l.d x3, f1, rtz
+	test_h_gr x3, 2
+	fcvt.l.d x3, f1, rup
+	test_h_gr x3, 3
+	fneg.d f2, f1
+	fcvt.wu.d x3, f2, rtz
+	test_h_gr x3, 0
+	li x1, 0x7ff8000000000000
+	fmv.d.x f1, x1
+	fcvt.w.d x3, f1, rtz
+	test_h_gr x3, 0x7fffffff
+
+	# Inexact and invalid are accrued in fflags.
+	fsflags x0
+	li x1, 3
+	fcvt.d.l f1, x1
+	li x1, 10
+	fcvt.d.l f2, x1
+	fdiv.d f3, f1, f2
+	frflags x3
+	test_h_gr x3, 1
+	fcvt.w.d x3, f1, rtz
+	feq.d x3, f1, f1
+	frflags x3
+	test_h_gr x3, 1
+	li x1, 0x7ff8000000000000
+	fmv.d.x f1, x1
+	flt.d x3, f1, f1
+	frflags x3
+	test_h_gr x3, 0x11
+
+	# fmin returns the non-NaN operand.
+	fmin.d f3, f1, f2
+	feq.d x3, f3, f2
+	test_h_gr x3, 1
+	fclass.d x3, f1
+	test_h_gr x3, 0x200
+
+	pass
@@ -0,0 +1,36 @@
+# riscv testcase for loads and stores
+# mach: riscv
+
+	.include "testutils.inc"
+
+	start
+
+	lla x1, buf
+	li x2, 0x8081828384858687
+	sd x2, 0(x1)
+	ld x3, 0(x1)
+	test_h_gr x3, 0x8081828384858687
+	lb x3, 0(x1)
+	test_h_gr x3, -0x79
+	lbu x3, 0(x1)
+	test_h_gr x3, 0x87
+	lh x3, 6(x1)
+	test_h_gr x3, -0x7f7f
+	lhu x3, 6(x1)
+	test_h_gr x3, 0x8081
+	lw x3, 4(x1)
+	test_h_gr x3, -0x7f7e7d7d
+	lwu x3, 4(x1)
+	test_h_gr x3, 0x80818283
+
+	sb x0, 8(x1)
+	sh x2, 9(x1)
+	sw x2, 11(x1)
+	ld x3, 8(x1)
+	test_h_gr x3, 0x0084858687868700
+
+	pass
+
+	.data
+	.align 3
+buf:	.space 16
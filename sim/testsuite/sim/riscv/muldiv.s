@@ -0,0 +1,59 @@
+# riscv testcase for the M extension
+# mach: riscv
+
+	.include "testutils.inc"
+
+	start
+
+	li x1, -3
+	li x2, 7
+	mul x3, x1, x2
+	test_h_gr x3, -21
+	mulh x3, x1, x2
+	test_h_gr x3, -1
+	mulhu x3, x1, x2
+	test_h_gr x3, 6
+	mulhsu x3, x1, x2
+	test_h_gr x3, -1
+
+	li x1, 0x100000000
+	mulhu x3, x1, x1
+	test_h_gr x3, 1
+
+	li x1, -7
+	li x2, 2
+	div x3, x1, x2
+	test_h_gr x3, -3
+	rem x3, x1, x2
+	test_h_gr x3, -1
+	divu x3, x2, x1
+	test_h_gr x3, 0
+	remu x3, x2, x1
+	test_h_gr x3, 2
+
+	# Division by zero and overflow do not trap.
+	div x3, x1, x0
+	test_h_gr x3, -1
+	divu x3, x1, x0
+	test_h_gr x3, -1
+	rem x3, x1, x0
+	test_h_gr x3, -7
+	li x1, 0x8000000000000000
+	li x2, -1
+	div x3, x1, x2
+	test_h_gr x3, 0x8000000000000000
+	rem x3, x1, x2
+	test_h_gr x3, 0
+
+	li x1, 0x80000000
+	li x2, -1
+	divw x3, x1, x2
+	test_h_gr x3, -0x80000000
+	mulw x3, x1, x1
+	test_h_gr x3, 0
+	divuw x3, x1, x0
+	test_h_gr x3, -1
+	remuw x3, x1, x0
+	test_h_gr x3, -0x80000000
+
+	pass